@@ -0,0 +1,334 @@
+#include "AnalysisCache.h"
+#include "../../Utils/Constants.h"
+#include "../../Utils/ContentHash.h"
+#include "../../Utils/PlatformPaths.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+constexpr char entryMagic[4] = {'H', 'T', 'A', 'C'};
+constexpr size_t headerSize = 32;
+
+// magic, version, stage, reserved, key, payload size
+struct EntryHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t stage;
+  std::uint32_t reserved;
+  std::uint64_t key;
+  std::uint64_t payloadSize;
+};
+static_assert(sizeof(EntryHeader) == headerSize, "unexpected header padding");
+
+// On-disk note event; fixed layout independent of the in-memory struct
+struct StoredNoteEvent {
+  std::int32_t startFrame;
+  std::int32_t endFrame;
+  float midiNote;
+  std::uint32_t isRest;
+};
+static_assert(sizeof(StoredNoteEvent) == 16, "unexpected note padding");
+
+void hashModelIdentity(ContentHash &hash, const juce::File &modelFile) {
+  hash.updateString(modelFile.getFullPathName().toStdString());
+  hash.updateValue(static_cast<std::int64_t>(modelFile.getSize()));
+  hash.updateValue(static_cast<std::int64_t>(
+      modelFile.getLastModificationTime().toMilliseconds()));
+}
+} // namespace
+
+AnalysisCache &AnalysisCache::getInstance() {
+  static AnalysisCache instance;
+  return instance;
+}
+
+AnalysisCache::AnalysisCache()
+    : directory(PlatformPaths::getCacheDirectory().getChildFile("analysis")) {}
+
+std::uint64_t AnalysisCache::hashAudio(const AudioData &audioData) {
+  const auto &waveform = audioData.waveform;
+  ContentHash hash;
+  hash.updateValue(static_cast<std::int32_t>(waveform.getNumSamples()));
+  hash.updateValue(static_cast<std::int32_t>(audioData.sampleRate));
+  if (waveform.getNumChannels() > 0)
+    hash.update(waveform.getReadPointer(0),
+                static_cast<size_t>(waveform.getNumSamples()) * sizeof(float));
+  return hash.finish();
+}
+
+std::uint64_t AnalysisCache::melKey(std::uint64_t audioHash) {
+  ContentHash hash;
+  hash.updateValue(static_cast<std::uint32_t>(Stage::Mel));
+  hash.updateValue(static_cast<std::int32_t>(FORMAT_VERSION));
+  hash.updateValue(audioHash);
+  hash.updateValue(static_cast<std::int32_t>(HOP_SIZE));
+  hash.updateValue(static_cast<std::int32_t>(N_FFT));
+  hash.updateValue(static_cast<std::int32_t>(WIN_SIZE));
+  hash.updateValue(static_cast<std::int32_t>(NUM_MELS));
+  hash.updateValue(FMIN);
+  hash.updateValue(FMAX);
+  return hash.finish();
+}
+
+std::uint64_t AnalysisCache::f0Key(std::uint64_t audioHash,
+                                   PitchDetectorType type,
+                                   const juce::File &modelFile) {
+  ContentHash hash;
+  hash.updateValue(static_cast<std::uint32_t>(Stage::F0));
+  hash.updateValue(static_cast<std::int32_t>(FORMAT_VERSION));
+  hash.updateValue(audioHash);
+  hash.updateValue(static_cast<std::int32_t>(type));
+  hashModelIdentity(hash, modelFile);
+  return hash.finish();
+}
+
+std::uint64_t AnalysisCache::notesKey(std::uint64_t audioHash,
+                                      const juce::File &modelFile) {
+  ContentHash hash;
+  hash.updateValue(static_cast<std::uint32_t>(Stage::Notes));
+  hash.updateValue(static_cast<std::int32_t>(FORMAT_VERSION));
+  hash.updateValue(audioHash);
+  hash.updateValue(static_cast<std::int32_t>(SOMEDetector::HOP_SIZE));
+  hashModelIdentity(hash, modelFile);
+  return hash.finish();
+}
+
+bool AnalysisCache::loadMel(std::uint64_t key, MelMatrix &mel) {
+  juce::MemoryBlock payload;
+  if (!readEntry(Stage::Mel, key, payload) || payload.getSize() < 8)
+    return false;
+
+  std::int32_t numFrames = 0;
+  std::int32_t numMels = 0;
+  std::memcpy(&numFrames, payload.getData(), sizeof(numFrames));
+  std::memcpy(&numMels, static_cast<const char *>(payload.getData()) + 4,
+              sizeof(numMels));
+  if (numFrames <= 0 || numMels <= 0)
+    return false;
+
+  const size_t numValues =
+      static_cast<size_t>(numFrames) * static_cast<size_t>(numMels);
+  if (payload.getSize() != 8 + numValues * sizeof(float))
+    return false;
+
+  MelMatrix result(numFrames, numMels);
+  std::memcpy(result.data(), static_cast<const char *>(payload.getData()) + 8,
+              numValues * sizeof(float));
+  mel = std::move(result);
+  return true;
+}
+
+void AnalysisCache::storeMel(std::uint64_t key, const MelMatrix &mel) {
+  if (mel.empty())
+    return;
+
+  const size_t valueBytes = mel.size() *
+                            static_cast<size_t>(mel.getNumMels()) *
+                            sizeof(float);
+  juce::MemoryBlock payload(8 + valueBytes);
+  const std::int32_t dims[2] = {mel.getNumFrames(), mel.getNumMels()};
+  payload.copyFrom(dims, 0, sizeof(dims));
+  payload.copyFrom(mel.data(), 8, valueBytes);
+  writeEntry(Stage::Mel, key, payload.getData(), payload.getSize());
+}
+
+bool AnalysisCache::hasMel(std::uint64_t key) {
+  return hasEntry(Stage::Mel, key);
+}
+
+bool AnalysisCache::loadF0(std::uint64_t key, std::vector<float> &f0) {
+  juce::MemoryBlock payload;
+  if (!readEntry(Stage::F0, key, payload) || payload.getSize() == 0 ||
+      payload.getSize() % sizeof(float) != 0)
+    return false;
+
+  f0.resize(payload.getSize() / sizeof(float));
+  std::memcpy(f0.data(), payload.getData(), payload.getSize());
+  return true;
+}
+
+void AnalysisCache::storeF0(std::uint64_t key, const std::vector<float> &f0) {
+  if (f0.empty())
+    return;
+  writeEntry(Stage::F0, key, f0.data(), f0.size() * sizeof(float));
+}
+
+bool AnalysisCache::loadNotes(std::uint64_t key,
+                              std::vector<SOMEDetector::NoteEvent> &notes) {
+  juce::MemoryBlock payload;
+  if (!readEntry(Stage::Notes, key, payload) ||
+      payload.getSize() % sizeof(StoredNoteEvent) != 0)
+    return false;
+
+  const size_t count = payload.getSize() / sizeof(StoredNoteEvent);
+  notes.clear();
+  notes.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    StoredNoteEvent stored;
+    std::memcpy(&stored,
+                static_cast<const char *>(payload.getData()) +
+                    i * sizeof(StoredNoteEvent),
+                sizeof(stored));
+    notes.push_back({stored.startFrame, stored.endFrame, stored.midiNote,
+                     stored.isRest != 0});
+  }
+  return true;
+}
+
+void AnalysisCache::storeNotes(
+    std::uint64_t key, const std::vector<SOMEDetector::NoteEvent> &notes) {
+  std::vector<StoredNoteEvent> stored;
+  stored.reserve(notes.size());
+  for (const auto &note : notes)
+    stored.push_back({note.startFrame, note.endFrame, note.midiNote,
+                      note.isRest ? 1u : 0u});
+  writeEntry(Stage::Notes, key, stored.data(),
+             stored.size() * sizeof(StoredNoteEvent));
+}
+
+void AnalysisCache::setMaxBytes(juce::int64 bytes) {
+  maxBytes = std::max<juce::int64>(0, bytes);
+  std::lock_guard<std::mutex> lock(mutex);
+  evictToBudget();
+}
+
+void AnalysisCache::setDirectory(const juce::File &newDirectory) {
+  std::lock_guard<std::mutex> lock(mutex);
+  directory = newDirectory;
+}
+
+juce::File AnalysisCache::getDirectory() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return directory;
+}
+
+void AnalysisCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  for (const auto &entry :
+       directory.findChildFiles(juce::File::findFiles, false, "*.htac"))
+    entry.deleteFile();
+}
+
+juce::File AnalysisCache::getEntryFile(Stage stage, std::uint64_t key) const {
+  const char *prefix = stage == Stage::Mel  ? "mel"
+                       : stage == Stage::F0 ? "f0"
+                                            : "notes";
+  return directory.getChildFile(
+      juce::String(prefix) + "-" +
+      juce::String::toHexString(static_cast<juce::int64>(key))
+          .paddedLeft('0', 16) +
+      ".htac");
+}
+
+bool AnalysisCache::readEntry(Stage stage, std::uint64_t key,
+                              juce::MemoryBlock &payload) {
+  if (!enabled)
+    return false;
+
+  juce::File file;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    file = getEntryFile(stage, key);
+  }
+  if (!file.existsAsFile())
+    return false;
+
+  juce::MemoryBlock data;
+  if (!file.loadFileAsData(data) || data.getSize() < headerSize)
+    return false;
+
+  EntryHeader header;
+  std::memcpy(&header, data.getData(), headerSize);
+  if (std::memcmp(header.magic, entryMagic, sizeof(entryMagic)) != 0 ||
+      header.version != static_cast<std::uint32_t>(FORMAT_VERSION) ||
+      header.stage != static_cast<std::uint32_t>(stage) || header.key != key ||
+      header.payloadSize != data.getSize() - headerSize) {
+    file.deleteFile();
+    return false;
+  }
+
+  payload.replaceAll(static_cast<const char *>(data.getData()) + headerSize,
+                     static_cast<size_t>(header.payloadSize));
+
+  // Modification time doubles as the LRU timestamp
+  file.setLastModificationTime(juce::Time::getCurrentTime());
+  return true;
+}
+
+bool AnalysisCache::hasEntry(Stage stage, std::uint64_t key) {
+  if (!enabled)
+    return false;
+
+  juce::File file;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    file = getEntryFile(stage, key);
+  }
+  if (!file.existsAsFile())
+    return false;
+
+  file.setLastModificationTime(juce::Time::getCurrentTime());
+  return true;
+}
+
+void AnalysisCache::writeEntry(Stage stage, std::uint64_t key,
+                               const void *payload, size_t numBytes) {
+  if (!enabled)
+    return;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!directory.createDirectory())
+    return;
+
+  EntryHeader header{};
+  std::memcpy(header.magic, entryMagic, sizeof(entryMagic));
+  header.version = static_cast<std::uint32_t>(FORMAT_VERSION);
+  header.stage = static_cast<std::uint32_t>(stage);
+  header.key = key;
+  header.payloadSize = numBytes;
+
+  const auto file = getEntryFile(stage, key);
+  juce::TemporaryFile temp(file);
+  {
+    juce::FileOutputStream out(temp.getFile());
+    if (!out.openedOk() || !out.write(&header, headerSize) ||
+        (numBytes > 0 && !out.write(payload, numBytes)))
+      return;
+    out.flush();
+    if (out.getStatus().failed())
+      return;
+  }
+
+  if (!temp.overwriteTargetFileWithTemporary()) {
+    DBG("AnalysisCache: failed to write " << file.getFullPathName());
+    return;
+  }
+
+  evictToBudget();
+}
+
+void AnalysisCache::evictToBudget() {
+  auto entries =
+      directory.findChildFiles(juce::File::findFiles, false, "*.htac");
+
+  juce::int64 totalBytes = 0;
+  for (const auto &entry : entries)
+    totalBytes += entry.getSize();
+
+  const juce::int64 budget = maxBytes.load();
+  if (totalBytes <= budget)
+    return;
+
+  std::sort(entries.begin(), entries.end(),
+            [](const juce::File &a, const juce::File &b) {
+              return a.getLastModificationTime() < b.getLastModificationTime();
+            });
+
+  for (const auto &entry : entries) {
+    if (totalBytes <= budget)
+      break;
+    const auto size = entry.getSize();
+    if (entry.deleteFile())
+      totalBytes -= size;
+  }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../../JuceHeader.h"
+#include "../../Models/Project.h"
+#include "../../Utils/MelMatrix.h"
+#include "../PitchDetectorType.h"
+#include "../SOMEDetector.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * Content-addressed on-disk cache for analysis results, shared by every
+ * project, editor instance and plugin instance in the process.
+ *
+ * Entries are keyed by a hash of the analyzed PCM and sample rate plus
+ * whatever the stage depends on:
+ * - Mel: the STFT/mel constants
+ * - F0: detector type and the identity (path, size, mtime) of its model
+ * - Notes: the SOME model identity
+ *
+ * Stages are stored separately so a change to one (switching pitch
+ * detector, re-running segmentation) reuses the others. Each entry is one
+ * file under PlatformPaths::getCacheDirectory()/analysis; the directory is
+ * kept under a byte budget by evicting least recently used entries.
+ */
+class AnalysisCache {
+public:
+  static constexpr int FORMAT_VERSION = 1;
+
+  static AnalysisCache &getInstance();
+
+  /** Hash of the first channel's PCM, sample count and sample rate. */
+  static std::uint64_t hashAudio(const AudioData &audioData);
+
+  static std::uint64_t melKey(std::uint64_t audioHash);
+  static std::uint64_t f0Key(std::uint64_t audioHash, PitchDetectorType type,
+                             const juce::File &modelFile);
+  static std::uint64_t notesKey(std::uint64_t audioHash,
+                                const juce::File &modelFile);
+
+  bool loadMel(std::uint64_t key, MelMatrix &mel);
+  void storeMel(std::uint64_t key, const MelMatrix &mel);
+
+  /** True if a mel entry exists for key, without reading it; counts as a
+   *  use for eviction. For skipping a store of a mel computed anyway. */
+  bool hasMel(std::uint64_t key);
+
+  /** Raw detector output, before resampling to vocoder frames. */
+  bool loadF0(std::uint64_t key, std::vector<float> &f0);
+  void storeF0(std::uint64_t key, const std::vector<float> &f0);
+
+  /** SOME note events in detection order, rests included. */
+  bool loadNotes(std::uint64_t key,
+                 std::vector<SOMEDetector::NoteEvent> &notes);
+  void storeNotes(std::uint64_t key,
+                  const std::vector<SOMEDetector::NoteEvent> &notes);
+
+  void setEnabled(bool shouldBeEnabled) { enabled = shouldBeEnabled; }
+  bool isEnabled() const { return enabled.load(); }
+
+  /** Total size the cache directory may grow to before eviction. */
+  void setMaxBytes(juce::int64 bytes);
+  juce::int64 getMaxBytes() const { return maxBytes.load(); }
+
+  void setDirectory(const juce::File &newDirectory);
+  juce::File getDirectory() const;
+
+  /** Delete every cache entry. */
+  void clear();
+
+private:
+  enum class Stage : std::uint32_t { Mel = 1, F0 = 2, Notes = 3 };
+
+  AnalysisCache();
+
+  juce::File getEntryFile(Stage stage, std::uint64_t key) const;
+  bool readEntry(Stage stage, std::uint64_t key, juce::MemoryBlock &payload);
+  bool hasEntry(Stage stage, std::uint64_t key);
+  void writeEntry(Stage stage, std::uint64_t key, const void *payload,
+                  size_t numBytes);
+  void evictToBudget();
+
+  mutable std::mutex mutex;
+  juce::File directory;
+  std::atomic<juce::int64> maxBytes{juce::int64(2) * 1024 * 1024 * 1024};
+  std::atomic<bool> enabled{true};
+
+  JUCE_DECLARE_NON_COPYABLE(AnalysisCache)
+};
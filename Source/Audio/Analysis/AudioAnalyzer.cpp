@@ -1,14 +1,34 @@
 #include "AudioAnalyzer.h"
+#include "AnalysisCache.h"
 #include "../../Utils/Constants.h"
 #include "../../Utils/PlatformPaths.h"
+#include "StageProgress.h"
 #include <climits>
+#include <exception>
+
+namespace {
+// Joins a stage thread when the scope unwinds, so an exception on the
+// calling thread never destroys a joinable std::thread (std::terminate)
+class ScopedJoin {
+public:
+  explicit ScopedJoin(std::thread &threadIn) : thread(threadIn) {}
+  ~ScopedJoin() { join(); }
+
+  void join() const {
+    if (thread.joinable())
+      thread.join();
+  }
+
+private:
+  std::thread &thread;
+};
+} // namespace
 
 AudioAnalyzer::AudioAnalyzer() = default;
 
 AudioAnalyzer::~AudioAnalyzer() {
   cancelFlag = true;
-  if (analysisThread.joinable())
-    analysisThread.join();
+  InferenceScheduler::getInstance().purge(this);
 }
 
 void AudioAnalyzer::initialize() {
@@ -68,40 +88,123 @@ bool AudioAnalyzer::isRMVPEAvailable() const {
 }
 
 void AudioAnalyzer::analyze(Project &project, ProgressCallback onProgress,
-                            CompleteCallback onComplete) {
+                            CompleteCallback onComplete, bool reuseMel) {
   auto &audioData = project.getAudioData();
   if (audioData.waveform.getNumSamples() == 0)
     return;
 
+  std::vector<SOMEDetector::NoteEvent> noteEvents;
+  bool haveNoteEvents = false;
+  if (!analyzeFeatures(audioData, onProgress, noteEvents, haveNoteEvents,
+                       reuseMel))
+    return;
+
+  // Segment into notes
+  if (onProgress)
+    onProgress(0.90, "Segmenting notes...");
+  if (haveNoteEvents) {
+    project.clearNotes();
+    buildNotesFromEvents(project, noteEvents);
+  } else {
+    segmentIntoNotes(project);
+  }
+
+  // Build dense base/delta curves
+  PitchCurveProcessor::rebuildCurvesFromSource(project, audioData.f0);
+
+  if (onComplete)
+    onComplete();
+}
+
+bool AudioAnalyzer::analyzeFeatures(
+    AudioData &audioData, const ProgressCallback &onProgress,
+    std::vector<SOMEDetector::NoteEvent> &noteEvents, bool &haveNoteEvents,
+    bool reuseMel) {
+  noteEvents.clear();
+  haveNoteEvents = false;
+  if (audioData.waveform.getNumSamples() == 0)
+    return false;
+
   const float *samples = audioData.waveform.getReadPointer(0);
   int numSamples = audioData.waveform.getNumSamples();
 
-  // Compute mel spectrogram
-  if (onProgress)
-    onProgress(0.35, "Computing mel spectrogram...");
   MelSpectrogram melComputer(audioData.sampleRate, N_FFT, HOP_SIZE, NUM_MELS,
                              FMIN, FMAX);
-  audioData.melSpectrogram = melComputer.compute(samples, numSamples);
-
-  int targetFrames = static_cast<int>(audioData.melSpectrogram.size());
-
-  if (cancelFlag.load())
-    return;
+  const int targetFrames = melComputer.getNumFrames(numSamples);
+  const auto audioHash = AnalysisCache::hashAudio(audioData);
+
+  // Mel, F0 and SOME note events each depend only on the waveform, so they
+  // run side by side: mel on CPU threads while F0 and SOME chunks share the
+  // scheduler's run slots. Notes are built once all three are in.
+  enum Stage { melStage = 0, f0Stage, notesStage };
+  StageProgress stageProgress(onProgress, 0.35, 0.85, {1.0, 3.0, 2.0});
+
+  // A stage that throws hands its exception to this thread, which rethrows
+  // it once every stage has been joined
+  std::exception_ptr melError;
+  std::exception_ptr notesError;
+
+  std::thread melThread([&]() {
+    try {
+      stageProgress.update(melStage, 0.0, "Computing mel spectrogram...");
+      auto &analysisCache = AnalysisCache::getInstance();
+      const auto melKey = AnalysisCache::melKey(audioHash);
+      if (reuseMel && audioData.getNumFrames() == targetFrames) {
+        if (!analysisCache.hasMel(melKey))
+          analysisCache.storeMel(melKey, audioData.melSpectrogram);
+      } else if (!analysisCache.loadMel(melKey, audioData.melSpectrogram)) {
+        // Leave cores for the concurrent F0 and SOME stages
+        melComputer.setMaxThreads(
+            std::max(1, ParallelFor::getDefaultThreadCount() / 2));
+        audioData.melSpectrogram = melComputer.compute(
+            samples, numSamples, getCancelFlag(), [&](double fraction) {
+              stageProgress.update(melStage, fraction,
+                                   "Computing mel spectrogram...");
+            });
+        if (!audioData.melSpectrogram.empty())
+          analysisCache.storeMel(melKey, audioData.melSpectrogram);
+      }
+      stageProgress.update(melStage, 1.0, "Computing mel spectrogram...");
+    } catch (...) {
+      melError = std::current_exception();
+    }
+  });
+  const ScopedJoin melJoin(melThread);
+
+  std::thread notesThread;
+  if (auto *detector = getSOMEDetector(); detector && detector->isLoaded()) {
+    notesThread = std::thread([&, detector]() {
+      try {
+        haveNoteEvents = detectNoteEvents(
+            audioData, audioHash, noteEvents, onNotesPreview,
+            [&](double fraction) {
+              stageProgress.update(notesStage, fraction,
+                                   "Segmenting notes...");
+            },
+            getCancelFlag());
+      } catch (...) {
+        notesError = std::current_exception();
+      }
+    });
+  }
+  const ScopedJoin notesJoin(notesThread);
 
   // Extract F0 based on selected detector type
-  if (onProgress)
-    onProgress(0.55, "Extracting pitch (F0)...");
+  auto onF0Progress = [&](double fraction) {
+    stageProgress.update(f0Stage, fraction, "Extracting pitch (F0)...");
+  };
+  onF0Progress(0.0);
 
   bool extracted = false;
 
   // Try selected detector first
   if (detectorType == PitchDetectorType::RMVPE && isRMVPEAvailable()) {
     DBG("Using RMVPE pitch detector");
-    extractF0WithRMVPE(audioData, targetFrames);
+    extractF0WithRMVPE(audioData, audioHash, targetFrames, onF0Progress);
     extracted = true;
   } else if (detectorType == PitchDetectorType::FCPE && isFCPEAvailable()) {
     DBG("Using FCPE pitch detector");
-    extractF0WithFCPE(audioData, targetFrames);
+    extractF0WithFCPE(audioData, audioHash, targetFrames, onF0Progress);
     extracted = true;
   }
 
@@ -109,41 +212,38 @@ void AudioAnalyzer::analyze(Project &project, ProgressCallback onProgress,
   if (!extracted) {
     if (isRMVPEAvailable()) {
       DBG("Fallback: Using RMVPE pitch detector");
-      extractF0WithRMVPE(audioData, targetFrames);
+      extractF0WithRMVPE(audioData, audioHash, targetFrames, onF0Progress);
     } else if (isFCPEAvailable()) {
       DBG("Fallback: Using FCPE pitch detector");
-      extractF0WithFCPE(audioData, targetFrames);
+      extractF0WithFCPE(audioData, audioHash, targetFrames, onF0Progress);
     }
   }
+  onF0Progress(1.0);
 
-  if (cancelFlag.load())
-    return;
+  melJoin.join();
+  notesJoin.join();
+  if (melError)
+    std::rethrow_exception(melError);
+  if (notesError)
+    std::rethrow_exception(notesError);
 
-  // Smooth F0
+  if (isCancelled())
+    return false;
+
+  // Smooth F0; the concurrent stages above end at 0.85
   if (onProgress)
-    onProgress(0.65, "Smoothing pitch curve...");
+    onProgress(0.87, "Smoothing pitch curve...");
   audioData.f0 = F0Smoother::smoothF0(audioData.f0, audioData.voicedMask);
   audioData.f0 = PitchCurveProcessor::interpolateWithUvMask(
       audioData.f0, audioData.voicedMask);
 
-  if (cancelFlag.load())
-    return;
-
-  // Segment into notes
-  if (onProgress)
-    onProgress(0.90, "Segmenting notes...");
-  segmentIntoNotes(project);
-
-  // Build dense base/delta curves
-  PitchCurveProcessor::rebuildCurvesFromSource(project, audioData.f0);
-
-  if (onComplete)
-    onComplete();
+  return !isCancelled();
 }
 
 void AudioAnalyzer::analyzeAsync(std::shared_ptr<Project> project,
                                  ProgressCallback onProgress,
-                                 CompleteCallback onComplete) {
+                                 CompleteCallback onComplete,
+                                 FailedCallback onFailed) {
   if (isRunning.load())
     return;
 
@@ -153,27 +253,67 @@ void AudioAnalyzer::analyzeAsync(std::shared_ptr<Project> project,
   cancelFlag = false;
   isRunning = true;
 
-  if (analysisThread.joinable())
-    analysisThread.join();
-
-  analysisThread = std::thread(
-      [this, project = std::move(project), onProgress, onComplete]() mutable {
-        analyze(*project, onProgress, [this, onComplete]() {
-          isRunning = false;
-          if (onComplete)
-            onComplete();
-        });
+  InferenceScheduler::JobRequest request;
+  request.priority = InferencePriority::Analysis;
+  request.owner = this;
+  request.onCancelled = [this]() { isRunning = false; };
+  request.run = [this, project = std::move(project), onProgress, onComplete,
+                 onFailed]() mutable {
+    // The scheduler only logs a job's exception, so report it here and
+    // never leave isRunning set, which would refuse every later request
+    bool failed = true;
+    juce::String error = "Unknown error";
+    try {
+      analyze(*project, onProgress, [this, onComplete]() {
         isRunning = false;
+        if (onComplete)
+          onComplete();
       });
+      failed = false;
+    } catch (const std::exception &e) {
+      error = e.what();
+    } catch (...) {
+    }
+    isRunning = false;
+
+    if (failed) {
+      DBG("AudioAnalyzer: analysis failed: " << error);
+      if (onFailed)
+        onFailed(error);
+    }
+  };
+  InferenceScheduler::getInstance().submit(std::move(request));
 }
 
-void AudioAnalyzer::extractF0WithRMVPE(AudioData &audioData, int targetFrames) {
+void AudioAnalyzer::extractF0WithRMVPE(
+    AudioData &audioData, std::uint64_t audioHash, int targetFrames,
+    const std::function<void(double)> &onProgress) {
   const float *samples = audioData.waveform.getReadPointer(0);
   int numSamples = audioData.waveform.getNumSamples();
 
   auto *detector = rmvpeDetector ? rmvpeDetector.get() : externalRMVPEDetector;
-  std::vector<float> rmvpeF0 =
-      detector->extractF0(samples, numSamples, audioData.sampleRate);
+  auto &analysisCache = AnalysisCache::getInstance();
+  const auto f0Key = AnalysisCache::f0Key(audioHash, PitchDetectorType::RMVPE,
+                                          detector->getModelFile());
+  std::vector<float> rmvpeF0;
+  // Batched output is not cached, so cache entries always match extractF0
+  if (!analysisCache.loadF0(f0Key, rmvpeF0) &&
+      !takePrecomputedF0(PitchDetectorType::RMVPE, rmvpeF0)) {
+    const int expectedFrames =
+        std::max(1, detector->getNumFrames(numSamples, audioData.sampleRate));
+    rmvpeF0 = detector->extractF0(
+        samples, numSamples, audioData.sampleRate,
+        RMVPEPitchDetector::DEFAULT_THRESHOLD, getCancelFlag(),
+        [&](int startFrame, const std::vector<float> &chunkF0) {
+          if (onProgress)
+            onProgress(std::min(
+                1.0, static_cast<double>(startFrame + chunkF0.size()) /
+                         expectedFrames));
+        });
+    if (isCancelled())
+      return;
+    analysisCache.storeF0(f0Key, rmvpeF0);
+  }
 
   if (!rmvpeF0.empty() && targetFrames > 0) {
     audioData.f0.resize(targetFrames);
@@ -224,13 +364,26 @@ void AudioAnalyzer::extractF0WithRMVPE(AudioData &audioData, int targetFrames) {
   }
 }
 
-void AudioAnalyzer::extractF0WithFCPE(AudioData &audioData, int targetFrames) {
+void AudioAnalyzer::extractF0WithFCPE(
+    AudioData &audioData, std::uint64_t audioHash, int targetFrames,
+    const std::function<void(double)> &onProgress) {
   const float *samples = audioData.waveform.getReadPointer(0);
   int numSamples = audioData.waveform.getNumSamples();
 
   auto *detector = fcpeDetector ? fcpeDetector.get() : externalFCPEDetector;
-  std::vector<float> fcpeF0 =
-      detector->extractF0(samples, numSamples, audioData.sampleRate);
+  auto &analysisCache = AnalysisCache::getInstance();
+  const auto f0Key = AnalysisCache::f0Key(audioHash, PitchDetectorType::FCPE,
+                                          detector->getModelFile());
+  std::vector<float> fcpeF0;
+  if (!analysisCache.loadF0(f0Key, fcpeF0) &&
+      !takePrecomputedF0(PitchDetectorType::FCPE, fcpeF0)) {
+    fcpeF0 = detector->extractF0WithProgress(samples, numSamples,
+                                             audioData.sampleRate, 0.05f,
+                                             onProgress, getCancelFlag());
+    if (isCancelled())
+      return;
+    analysisCache.storeF0(f0Key, fcpeF0);
+  }
 
   if (!fcpeF0.empty() && targetFrames > 0) {
     audioData.f0.resize(targetFrames);
@@ -281,10 +434,18 @@ void AudioAnalyzer::extractF0WithFCPE(AudioData &audioData, int targetFrames) {
   }
 }
 
+bool AudioAnalyzer::takePrecomputedF0(PitchDetectorType type,
+                                      std::vector<float> &f0) {
+  if (precomputedF0Type != type || precomputedF0.empty())
+    return false;
+  f0 = std::move(precomputedF0);
+  precomputedF0.clear();
+  return true;
+}
+
 void AudioAnalyzer::segmentIntoNotes(Project &project) {
   auto &audioData = project.getAudioData();
-  auto &notes = project.getNotes();
-  notes.clear();
+  project.clearNotes();
 
   if (audioData.f0.empty())
     return;
@@ -303,93 +464,131 @@ void AudioAnalyzer::segmentIntoNotes(Project &project) {
 
 void AudioAnalyzer::segmentWithSOME(Project &project) {
   auto &audioData = project.getAudioData();
-  auto &notes = project.getNotes();
 
-  const float *samples = audioData.waveform.getReadPointer(0);
-  int numSamples = audioData.waveform.getNumSamples();
-  const int f0Size = static_cast<int>(audioData.f0.size());
-  const int melSize = static_cast<int>(audioData.melSpectrogram.size());
+  std::vector<SOMEDetector::NoteEvent> events;
+  detectNoteEvents(audioData, AnalysisCache::hashAudio(audioData), events,
+                   onNotesPreview, nullptr, getCancelFlag());
+  buildNotesFromEvents(project, events);
+
+  juce::Thread::sleep(100);
+
+  if (!audioData.f0.empty())
+    PitchCurveProcessor::rebuildCurvesFromSource(project, audioData.f0);
+}
+
+bool AudioAnalyzer::detectNoteEvents(
+    const AudioData &audioData, std::uint64_t audioHash,
+    std::vector<SOMEDetector::NoteEvent> &events,
+    const NotesPreviewCallback &onChunk,
+    const std::function<void(double)> &onProgress,
+    const std::atomic<bool> *cancelFlag) {
+  events.clear();
+  auto *detector = getSOMEDetector();
+  if (detector == nullptr)
+    return false;
+
+  // Segmentation depends only on the audio and SOME model, so re-running
+  // it (or re-analysing after a detector switch) reuses earlier events
+  auto &analysisCache = AnalysisCache::getInstance();
+  const auto notesKey =
+      AnalysisCache::notesKey(audioHash, detector->getModelFile());
+
+  if (analysisCache.loadNotes(notesKey, events)) {
+    DBG("AudioAnalyzer: note events restored from analysis cache");
+    if (onChunk && !events.empty())
+      onChunk(events);
+    return true;
+  }
 
-  auto *detector = someDetector ? someDetector.get() : externalSOMEDetector;
   detector->detectNotesStreaming(
-      samples, numSamples, SOMEDetector::SAMPLE_RATE,
+      audioData.waveform.getReadPointer(0), audioData.waveform.getNumSamples(),
+      SOMEDetector::SAMPLE_RATE,
       [&](const std::vector<SOMEDetector::NoteEvent> &chunkNotes) {
-        for (const auto &someNote : chunkNotes) {
-          if (someNote.isRest)
-            continue;
-
-          int f0Start = std::max(0, std::min(someNote.startFrame, f0Size - 1));
-          int f0End =
-              std::max(f0Start + 1, std::min(someNote.endFrame, f0Size));
-
-          if (f0End - f0Start < 3)
-            continue;
-
-          // Calculate average MIDI from actual F0 data
-          float midiSum = 0.0f;
-          int midiCount = 0;
-          for (int j = f0Start; j < f0End; ++j) {
-            if (j < static_cast<int>(audioData.voicedMask.size()) &&
-                audioData.voicedMask[j] && audioData.f0[j] > 0) {
-              midiSum += freqToMidi(audioData.f0[j]);
-              midiCount++;
-            }
-          }
-
-          float midi = someNote.midiNote;
-          if (midiCount > 0) {
-            midi = midiSum / midiCount;
-          }
-
-          Note note(f0Start, f0End, midi);
-          std::vector<float> f0Values(audioData.f0.begin() + f0Start,
-                                      audioData.f0.begin() + f0End);
-          note.setF0Values(std::move(f0Values));
-
-          // Extract waveform clip for this note
-          if (audioData.waveform.getNumSamples() > 0) {
-            int startSample = f0Start * HOP_SIZE;
-            int endSample = f0End * HOP_SIZE;
-            startSample =
-                std::max(0, std::min(startSample,
-                                     audioData.waveform.getNumSamples()));
-            endSample = std::max(startSample,
-                                 std::min(endSample,
-                                          audioData.waveform.getNumSamples()));
-            std::vector<float> clip;
-            clip.reserve(static_cast<size_t>(endSample - startSample));
-            const float *src = audioData.waveform.getReadPointer(0);
-            for (int i = startSample; i < endSample; ++i)
-              clip.push_back(src[i]);
-            note.setClipWaveform(std::move(clip));
-          }
-
-          // Extract mel spectrogram clip for this note
-          if (!audioData.melSpectrogram.empty() && f0Start < melSize) {
-            int melStart = std::max(0, f0Start);
-            int melEnd = std::min(f0End, melSize);
-            if (melEnd > melStart) {
-              std::vector<std::vector<float>> melClip(
-                  audioData.melSpectrogram.begin() + melStart,
-                  audioData.melSpectrogram.begin() + melEnd);
-              note.setClipMel(std::move(melClip));
-            }
-          }
-
-          notes.push_back(note);
-        }
+        events.insert(events.end(), chunkNotes.begin(), chunkNotes.end());
+        if (onChunk)
+          onChunk(chunkNotes);
       },
-      nullptr);
+      onProgress, cancelFlag);
 
-  juce::Thread::sleep(100);
+  if (cancelFlag != nullptr && cancelFlag->load())
+    return false;
 
-  if (!audioData.f0.empty())
-    PitchCurveProcessor::rebuildCurvesFromSource(project, audioData.f0);
+  if (!events.empty())
+    analysisCache.storeNotes(notesKey, events);
+  return true;
+}
+
+void AudioAnalyzer::buildNotesFromEvents(
+    Project &project, const std::vector<SOMEDetector::NoteEvent> &events) {
+  auto &audioData = project.getAudioData();
+  const int f0Size = static_cast<int>(audioData.f0.size());
+  const int melSize = static_cast<int>(audioData.melSpectrogram.size());
+
+  for (const auto &someNote : events) {
+    if (someNote.isRest)
+      continue;
+
+    int f0Start = std::max(0, std::min(someNote.startFrame, f0Size - 1));
+    int f0End = std::max(f0Start + 1, std::min(someNote.endFrame, f0Size));
+
+    if (f0End - f0Start < 3)
+      continue;
+
+    // Calculate average MIDI from actual F0 data
+    float midiSum = 0.0f;
+    int midiCount = 0;
+    for (int j = f0Start; j < f0End; ++j) {
+      if (j < static_cast<int>(audioData.voicedMask.size()) &&
+          audioData.voicedMask[j] && audioData.f0[j] > 0) {
+        midiSum += freqToMidi(audioData.f0[j]);
+        midiCount++;
+      }
+    }
+
+    float midi = someNote.midiNote;
+    if (midiCount > 0) {
+      midi = midiSum / midiCount;
+    }
+
+    Note note(f0Start, f0End, midi);
+    std::vector<float> f0Values(audioData.f0.begin() + f0Start,
+                                audioData.f0.begin() + f0End);
+    note.setF0Values(std::move(f0Values));
+
+    // Extract waveform clip for this note
+    if (audioData.waveform.getNumSamples() > 0) {
+      int startSample = f0Start * HOP_SIZE;
+      int endSample = f0End * HOP_SIZE;
+      startSample =
+          std::max(0, std::min(startSample,
+                               audioData.waveform.getNumSamples()));
+      endSample = std::max(startSample,
+                           std::min(endSample,
+                                    audioData.waveform.getNumSamples()));
+      std::vector<float> clip;
+      clip.reserve(static_cast<size_t>(endSample - startSample));
+      const float *src = audioData.waveform.getReadPointer(0);
+      for (int i = startSample; i < endSample; ++i)
+        clip.push_back(src[i]);
+      note.setClipWaveform(std::move(clip));
+    }
+
+    // Extract mel spectrogram clip for this note
+    if (!audioData.melSpectrogram.empty() && f0Start < melSize) {
+      int melStart = std::max(0, f0Start);
+      int melEnd = std::min(f0End, melSize);
+      if (melEnd > melStart) {
+        note.setClipMel(
+            MelMatrix(audioData.melSpectrogram.view(melStart, melEnd)));
+      }
+    }
+
+    project.addNote(std::move(note));
+  }
 }
 
 void AudioAnalyzer::segmentFallback(Project &project) {
   auto &audioData = project.getAudioData();
-  auto &notes = project.getNotes();
   const int melSize = static_cast<int>(audioData.melSpectrogram.size());
 
   auto finalizeNote = [&](int start, int end) {
@@ -436,14 +635,12 @@ void AudioAnalyzer::segmentFallback(Project &project) {
       int melStart = std::max(0, start);
       int melEnd = std::min(end, melSize);
       if (melEnd > melStart) {
-        std::vector<std::vector<float>> melClip(
-            audioData.melSpectrogram.begin() + melStart,
-            audioData.melSpectrogram.begin() + melEnd);
-        note.setClipMel(std::move(melClip));
+        note.setClipMel(
+            MelMatrix(audioData.melSpectrogram.view(melStart, melEnd)));
       }
     }
 
-    notes.push_back(note);
+    project.addNote(std::move(note));
   };
 
   constexpr float pitchSplitThreshold = 0.5f;
@@ -7,13 +7,16 @@
 #include "../../Utils/MelSpectrogram.h"
 #include "../../Utils/PitchCurveProcessor.h"
 #include "../FCPEPitchDetector.h"
+#include "../Inference/InferenceScheduler.h"
 #include "../PitchDetectorType.h"
 #include "../RMVPEPitchDetector.h"
 #include "../SOMEDetector.h"
 #include <atomic>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <thread>
+#include <vector>
 
 /**
  * Coordinates audio analysis operations including:
@@ -21,12 +24,21 @@
  * - F0 (pitch) extraction using RMVPE or FCPE
  * - F0 smoothing and interpolation
  * - Note segmentation using SOME model
+ *
+ * The mel, F0 and SOME stages only read the waveform, so analyze() runs them
+ * concurrently and joins before smoothing and note building. The editor
+ * runs the same stages through analyzeFeatures() and builds notes itself.
  */
 class AudioAnalyzer {
 public:
   using ProgressCallback =
       std::function<void(double progress, const juce::String &message)>;
   using CompleteCallback = std::function<void()>;
+  // Called from the analysis thread when analysis threw instead of finishing
+  using FailedCallback = std::function<void(const juce::String &error)>;
+  // Called from the analysis thread with each batch of detected note events
+  using NotesPreviewCallback =
+      std::function<void(const std::vector<SOMEDetector::NoteEvent> &)>;
 
   AudioAnalyzer();
   ~AudioAnalyzer();
@@ -46,19 +58,62 @@ public:
   void setPitchDetectorType(PitchDetectorType type) { detectorType = type; }
   PitchDetectorType getPitchDetectorType() const { return detectorType; }
 
-  // Main analysis function - runs synchronously (call from background thread)
+  // Main analysis function - runs synchronously (call from background thread).
+  // With reuseMel, a mel already in the project that matches the waveform
+  // (computed while the file was decoded) is kept instead of recomputed,
+  // and written to the analysis cache only if it has no entry for it yet.
   void analyze(Project &project, ProgressCallback onProgress,
-               CompleteCallback onComplete = nullptr);
-
-  // Async wrapper - spawns background thread
+               CompleteCallback onComplete = nullptr, bool reuseMel = false);
+
+  // The concurrent stages of analyze() without note building: mel, F0
+  // (resampled to vocoder frames and smoothed) and SOME note events, with
+  // progress from 0.35 to 0.87. haveNoteEvents is false when SOME is not
+  // loaded. Returns false if cancelled; a stage's exception is rethrown
+  // here after all stages have stopped.
+  bool analyzeFeatures(AudioData &audioData, const ProgressCallback &onProgress,
+                       std::vector<SOMEDetector::NoteEvent> &noteEvents,
+                       bool &haveNoteEvents, bool reuseMel = false);
+
+  // Async wrapper - runs on the shared InferenceScheduler (Analysis priority).
+  // isAnalyzing() is cleared however the job ends; if analyze() throws,
+  // onFailed gets the error and onComplete is not called.
   void analyzeAsync(std::shared_ptr<Project> project,
-                    ProgressCallback onProgress, CompleteCallback onComplete);
+                    ProgressCallback onProgress, CompleteCallback onComplete,
+                    FailedCallback onFailed = nullptr);
 
   // Note segmentation
   void segmentIntoNotes(Project &project);
 
+  // Run the SOME detector over the audio, or read its events from the
+  // analysis cache. onChunk sees each chunk's events as they are detected
+  // (all of them at once on a cache hit). Returns false if cancelled.
+  bool detectNoteEvents(const AudioData &audioData, std::uint64_t audioHash,
+                        std::vector<SOMEDetector::NoteEvent> &events,
+                        const NotesPreviewCallback &onChunk,
+                        const std::function<void(double)> &onProgress,
+                        const std::atomic<bool> *cancelFlag);
+
+  // Preview of SOME note events as chunks finish, before notes are built
+  void setNotesPreviewCallback(NotesPreviewCallback callback) {
+    onNotesPreview = std::move(callback);
+  }
+
+  // Raw detector output (as extractF0 returns it) for the next analyze() to
+  // use instead of running the detector, e.g. from a batched extractF0Batch
+  // call. Ignored if F0 comes from another detector or from the cache.
+  void setPrecomputedF0(PitchDetectorType type, std::vector<float> f0) {
+    precomputedF0Type = type;
+    precomputedF0 = std::move(f0);
+  }
+
   // Cancel ongoing analysis
   void cancel() { cancelFlag = true; }
+
+  // Check flag instead of the analyzer's own (cancel() then has no
+  // effect), for owners that cancel analysis together with other work
+  void setCancelFlag(const std::atomic<bool> *flag) {
+    externalCancelFlag = flag;
+  }
   bool isAnalyzing() const { return isRunning.load(); }
 
   // Access to detectors for configuration
@@ -85,14 +140,30 @@ public:
 
 private:
   // Extract F0 using RMVPE
-  void extractF0WithRMVPE(AudioData &audioData, int targetFrames);
+  void extractF0WithRMVPE(AudioData &audioData, std::uint64_t audioHash,
+                          int targetFrames,
+                          const std::function<void(double)> &onProgress);
 
   // Extract F0 using FCPE
-  void extractF0WithFCPE(AudioData &audioData, int targetFrames);
+  void extractF0WithFCPE(AudioData &audioData, std::uint64_t audioHash,
+                         int targetFrames,
+                         const std::function<void(double)> &onProgress);
+
+  const std::atomic<bool> *getCancelFlag() const {
+    return externalCancelFlag != nullptr ? externalCancelFlag : &cancelFlag;
+  }
+  bool isCancelled() const { return getCancelFlag()->load(); }
+
+  // Move out F0 given to setPrecomputedF0 if it came from this detector
+  bool takePrecomputedF0(PitchDetectorType type, std::vector<float> &f0);
 
   // Segment notes using SOME model
   void segmentWithSOME(Project &project);
 
+  // Turn SOME events into notes; needs final F0 and mel
+  void buildNotesFromEvents(Project &project,
+                            const std::vector<SOMEDetector::NoteEvent> &events);
+
   // Fallback segmentation based on F0 changes
   void segmentFallback(Project &project);
 
@@ -108,8 +179,11 @@ private:
   bool useFCPE = true;
   PitchDetectorType detectorType = PitchDetectorType::RMVPE;
   std::atomic<bool> cancelFlag{false};
+  const std::atomic<bool> *externalCancelFlag = nullptr;
   std::atomic<bool> isRunning{false};
-  std::thread analysisThread;
+  NotesPreviewCallback onNotesPreview;
+  PitchDetectorType precomputedF0Type = PitchDetectorType::RMVPE;
+  std::vector<float> precomputedF0;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioAnalyzer)
 };
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "../../Utils/Constants.h"
+#include "../../Utils/MelSpectrogram.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/**
+ * Computes the analysis mel spectrogram on its own thread while a file is
+ * still being decoded.
+ *
+ * The decoder calls publish() each time more leading samples of the final
+ * buffer are valid; frames whose window lies within them are computed
+ * straight away, so by the time decoding ends little of the mel is left.
+ * finish() waits for the remaining frames and returns the same matrix
+ * MelSpectrogram::compute() would, or an empty one if nothing was
+ * published or the load was cancelled.
+ */
+class DecodedMelStream {
+public:
+  explicit DecodedMelStream(const std::atomic<bool> *cancelFlagIn)
+      : cancelFlag(cancelFlagIn),
+        melComputer(SAMPLE_RATE, N_FFT, HOP_SIZE, NUM_MELS, FMIN, FMAX) {}
+
+  ~DecodedMelStream() { finish(); }
+
+  /** audio stays valid, and its first samplesReady samples unchanged, until
+   *  finish() returns. */
+  void publish(const float *audio, int samplesReady, int numSamples) {
+    if (numSamples <= 0)
+      return;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      source = audio;
+      totalSamples = numSamples;
+      availableSamples = samplesReady;
+    }
+    if (!worker.joinable())
+      worker = std::thread([this]() { run(); });
+    wakeUp.notify_one();
+  }
+
+  MelMatrix finish() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      finished = true;
+    }
+    wakeUp.notify_one();
+    if (worker.joinable())
+      worker.join();
+
+    if (!complete)
+      return {};
+    complete = false;
+    return std::move(mel);
+  }
+
+private:
+  void run() {
+    int framesDone = 0;
+    for (;;) {
+      const float *audio = nullptr;
+      int numSamples = 0;
+      int targetFrames = 0;
+      bool lastPass = false;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        wakeUp.wait(lock, [&]() {
+          return finished ||
+                 melComputer.getNumFramesAvailable(availableSamples,
+                                                   totalSamples) > framesDone;
+        });
+        audio = source;
+        numSamples = totalSamples;
+        targetFrames =
+            melComputer.getNumFramesAvailable(availableSamples, totalSamples);
+        lastPass = finished;
+      }
+
+      if (mel.empty())
+        mel = MelMatrix(melComputer.getNumFrames(numSamples), NUM_MELS);
+
+      if (targetFrames > framesDone) {
+        if (!melComputer.computeRange(audio, numSamples, framesDone,
+                                      targetFrames, mel, cancelFlag))
+          return;
+        framesDone = targetFrames;
+      }
+
+      if (framesDone == mel.getNumFrames()) {
+        complete = true;
+        return;
+      }
+      if (lastPass)
+        return; // Decoding stopped early
+    }
+  }
+
+  const std::atomic<bool> *cancelFlag;
+  MelSpectrogram melComputer;
+  MelMatrix mel;
+  bool complete = false; // Written by the worker, read after join
+
+  std::mutex mutex;
+  std::condition_variable wakeUp;
+  const float *source = nullptr;
+  int totalSamples = 0;
+  int availableSamples = 0;
+  bool finished = false;
+
+  std::thread worker;
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "../../JuceHeader.h"
+#include <functional>
+#include <mutex>
+#include <vector>
+
+/**
+ * Folds the progress of analysis stages that run concurrently into a single
+ * value in [begin, end] for one progress callback.
+ *
+ * Each stage has a weight; the reported value is the weighted mean of the
+ * stages' completed fractions. update() may be called from any thread. The
+ * callback is invoked under a lock and only when the value grows, so it sees
+ * a monotonic sequence even when stages report out of order.
+ */
+class StageProgress {
+public:
+  using Callback =
+      std::function<void(double progress, const juce::String &message)>;
+
+  StageProgress(Callback callbackIn, double beginIn, double endIn,
+                std::vector<double> weightsIn)
+      : callback(std::move(callbackIn)), begin(beginIn), end(endIn),
+        weights(std::move(weightsIn)), fractions(weights.size(), 0.0) {
+    for (double w : weights)
+      totalWeight += w;
+  }
+
+  void update(size_t stage, double fraction, const juce::String &message) {
+    if (!callback || stage >= weights.size() || totalWeight <= 0.0)
+      return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    fractions[stage] = juce::jlimit(fractions[stage], 1.0, fraction);
+
+    double done = 0.0;
+    for (size_t i = 0; i < weights.size(); ++i)
+      done += weights[i] * fractions[i];
+    const double value = begin + (end - begin) * done / totalWeight;
+    if (value <= lastReported)
+      return;
+
+    lastReported = value;
+    callback(value, message);
+  }
+
+private:
+  Callback callback;
+  double begin;
+  double end;
+  std::vector<double> weights;
+  std::vector<double> fractions;
+  double totalWeight = 0.0;
+  double lastReported = -1.0;
+  std::mutex mutex;
+};
@@ -1,5 +1,8 @@
 #include "AudioEngine.h"
+#include "../Utils/RealtimeCheck.h"
 #include <algorithm>
+#include <chrono>
+#include <thread>
 
 AudioEngine::AudioEngine() {}
 
@@ -36,13 +39,12 @@ void AudioEngine::shutdownAudio() {
 void AudioEngine::prepareToPlay(int samplesPerBlockExpected,
                                 double sampleRate) {
   currentSampleRate = sampleRate;
-  playbackRatio = static_cast<double>(waveformSampleRate) / sampleRate;
+  playbackRatio = static_cast<double>(waveformSampleRate.load()) / sampleRate;
   interpolator.reset();
-  fractionalPosition = 0.0;
 
   DBG("AudioEngine::prepareToPlay - Device sample rate: " +
       juce::String(sampleRate) +
-      " Hz, Waveform sample rate: " + juce::String(waveformSampleRate) +
+      " Hz, Waveform sample rate: " + juce::String(waveformSampleRate.load()) +
       " Hz, Playback ratio: " + juce::String(playbackRatio));
 }
 
@@ -50,37 +52,45 @@ void AudioEngine::releaseResources() {}
 
 void AudioEngine::getNextAudioBlock(
     const juce::AudioSourceChannelInfo &bufferToFill) {
-  if (!playing || currentWaveform.getNumSamples() == 0) {
-    bufferToFill.clearActiveBufferRegion();
-    return;
+  // Writers wait for this scope to end before touching the buffer we read
+  const AudioReadScope readScope(audioReadEpoch);
+  const PlaybackBuffer *live = liveBuffer.load();
+
+  if (interpolatorResetPending.exchange(false))
+    interpolator.reset();
+  const int64_t seekTarget = pendingSeek.exchange(-1);
+  if (seekTarget >= 0) {
+    currentPosition.store(seekTarget);
+    interpolator.reset();
   }
 
-  const juce::SpinLock::ScopedTryLockType lock(waveformLock);
-  if (!lock.isLocked()) {
-    // Waveform is being updated, output silence to avoid glitches
+  const int64_t liveLength = live->audio.getNumSamples();
+  if (!playing || liveLength == 0) {
     bufferToFill.clearActiveBufferRegion();
     return;
   }
 
+  playbackRatio =
+      static_cast<double>(waveformSampleRate.load()) / currentSampleRate;
+
   auto *outputBuffer = bufferToFill.buffer;
   auto numOutputSamples = bufferToFill.numSamples;
   auto startSample = bufferToFill.startSample;
 
-  int64_t pos = currentPosition.load();
-  int64_t waveformLength = currentWaveform.getNumSamples();
+  int64_t pos = std::min(currentPosition.load(), liveLength);
 
   bool loopActive = loopEnabled.load();
   int64_t loopStart = loopStartSample.load();
   int64_t loopEnd = loopEndSample.load();
 
   if (loopActive) {
-    loopStart = juce::jlimit<int64_t>(0, waveformLength, loopStart);
-    loopEnd = juce::jlimit<int64_t>(0, waveformLength, loopEnd);
+    loopStart = juce::jlimit<int64_t>(0, liveLength, loopStart);
+    loopEnd = juce::jlimit<int64_t>(0, liveLength, loopEnd);
     if (loopEnd <= loopStart)
       loopActive = false;
   }
 
-  if (!loopActive && pos >= waveformLength) {
+  if (!loopActive && pos >= liveLength) {
     bufferToFill.clearActiveBufferRegion();
     playing = false;
 
@@ -96,7 +106,7 @@ void AudioEngine::getNextAudioBlock(
   }
 
   // Use interpolator for sample rate conversion
-  const float *inputData = currentWaveform.getReadPointer(0);
+  const float *inputData = live->audio.getReadPointer(0);
   float *outputData = outputBuffer->getWritePointer(0, startSample);
 
   outputBuffer->clear(startSample, numOutputSamples);
@@ -105,7 +115,7 @@ void AudioEngine::getNextAudioBlock(
   int writeOffset = 0;
 
   while (samplesRemaining > 0) {
-    int64_t segmentEnd = loopActive ? loopEnd : waveformLength;
+    int64_t segmentEnd = loopActive ? loopEnd : liveLength;
     int64_t inputAvailable = segmentEnd - pos;
 
     if (inputAvailable <= 0) {
@@ -170,7 +180,7 @@ void AudioEngine::getNextAudioBlock(
   if (auto cb = std::atomic_load(&positionCallback)) {
     auto state = positionUpdateState;
     state->latestSeconds.store(static_cast<double>(currentPosition.load()) /
-                               waveformSampleRate);
+                               waveformSampleRate.load());
 
     // Schedule at most one pending callback to avoid flooding the message
     // thread
@@ -185,51 +195,62 @@ void AudioEngine::getNextAudioBlock(
 
 void AudioEngine::changeListenerCallback(juce::ChangeBroadcaster *source) {}
 
-void AudioEngine::loadWaveform(const juce::AudioBuffer<float> &buffer,
-                               int sampleRate, bool preservePosition) {
-  // Save playing state if we need to preserve it
-  bool wasPlaying = playing.load();
+AudioEngine::PlaybackBuffer *AudioEngine::getStandbyBuffer() {
+  return liveBuffer.load() == &buffers[0] ? &buffers[1] : &buffers[0];
+}
 
-  // Stop playback first to safely update waveform
-  playing = false;
+void AudioEngine::publishStandby() {
+  RealtimeCheck::checkNotRealtime("waiting for the audio thread");
 
-  {
-    const juce::SpinLock::ScopedLockType lock(waveformLock);
-    currentWaveform = buffer;
-    waveformSampleRate = sampleRate;
+  auto *standby = getStandbyBuffer();
+  waveformLength.store(standby->audio.getNumSamples());
+  liveBuffer.store(standby);
 
-    if (!preservePosition) {
-      currentPosition.store(0);
-      fractionalPosition = 0.0;
-    }
+  // Grace period: a callback that began before the swap may still be
+  // reading the previous buffer. Any callback starting now sees the new one.
+  const auto epoch = audioReadEpoch.load();
+  if ((epoch & 1) == 0)
+    return;
+  while (audioReadEpoch.load() == epoch)
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+}
 
-    // Update playback ratio for sample rate conversion
-    if (currentSampleRate > 0)
-      playbackRatio =
-          static_cast<double>(waveformSampleRate) / currentSampleRate;
-    else
-      playbackRatio = 1.0;
+void AudioEngine::loadWaveform(const juce::AudioBuffer<float> &buffer,
+                               int sampleRate, bool preservePosition) {
+  // Only channel 0 is played back
+  auto copyMono = [&buffer](juce::AudioBuffer<float> &dst) {
+    const int numSamples = buffer.getNumSamples();
+    dst.setSize(1, numSamples, false, false, true);
+    if (numSamples > 0 && buffer.getNumChannels() > 0)
+      dst.copyFrom(0, 0, buffer, 0, 0, numSamples);
+  };
+
+  if (!preservePosition)
+    playing = false;
 
-    interpolator.reset();
+  {
+    const std::lock_guard<std::mutex> lock(writerMutex);
+    copyMono(getStandbyBuffer()->audio);
+    waveformSampleRate.store(sampleRate);
+    publishStandby();
+    copyMono(getStandbyBuffer()->audio);
   }
 
-  // Restore playing state if preserving position (e.g., during incremental
-  // synthesis)
-  if (preservePosition && wasPlaying) {
-    playing = true;
-    DBG("Restored playback state after waveform update");
+  if (!preservePosition) {
+    currentPosition.store(0);
+    pendingSeek.store(0);
   }
+  interpolatorResetPending.store(true);
 
   DBG("Loaded waveform: " + juce::String(buffer.getNumSamples()) +
-      " samples at " + juce::String(sampleRate) +
-      " Hz, playback ratio: " + juce::String(playbackRatio));
+      " samples at " + juce::String(sampleRate) + " Hz");
 
   if (loopEnabled.load()) {
     auto loopStart = loopStartSample.load();
     auto loopEnd = loopEndSample.load();
-    const int64_t waveformLength = currentWaveform.getNumSamples();
-    loopStart = juce::jlimit<int64_t>(0, waveformLength, loopStart);
-    loopEnd = juce::jlimit<int64_t>(0, waveformLength, loopEnd);
+    const int64_t length = waveformLength.load();
+    loopStart = juce::jlimit<int64_t>(0, length, loopStart);
+    loopEnd = juce::jlimit<int64_t>(0, length, loopEnd);
     loopStartSample.store(loopStart);
     loopEndSample.store(loopEnd);
     if (loopEnd <= loopStart)
@@ -237,8 +258,23 @@ void AudioEngine::loadWaveform(const juce::AudioBuffer<float> &buffer,
   }
 }
 
+bool AudioEngine::patchWaveform(int startSample, const float *samples,
+                                int numSamples) {
+  if (samples == nullptr || numSamples <= 0 || startSample < 0)
+    return false;
+
+  const std::lock_guard<std::mutex> lock(writerMutex);
+  if (static_cast<int64_t>(startSample) + numSamples > waveformLength.load())
+    return false;
+
+  getStandbyBuffer()->audio.copyFrom(0, startSample, samples, numSamples);
+  publishStandby();
+  getStandbyBuffer()->audio.copyFrom(0, startSample, samples, numSamples);
+  return true;
+}
+
 void AudioEngine::play() {
-  if (currentWaveform.getNumSamples() == 0) {
+  if (waveformLength.load() == 0) {
     DBG("Cannot play: no waveform loaded");
     return;
   }
@@ -252,34 +288,29 @@ void AudioEngine::pause() { playing = false; }
 
 void AudioEngine::stop() {
   playing = false;
-
-  const juce::SpinLock::ScopedLockType lock(waveformLock);
   currentPosition.store(0);
-  interpolator.reset();
-  fractionalPosition = 0.0;
+  pendingSeek.store(0);
 }
 
 void AudioEngine::seek(double timeSeconds) {
-  const juce::SpinLock::ScopedLockType lock(waveformLock);
-  int64_t newPos = static_cast<int64_t>(timeSeconds * waveformSampleRate);
-  newPos = juce::jlimit<int64_t>(0, currentWaveform.getNumSamples(), newPos);
+  int64_t newPos =
+      static_cast<int64_t>(timeSeconds * waveformSampleRate.load());
+  newPos = juce::jlimit<int64_t>(0, waveformLength.load(), newPos);
   currentPosition.store(newPos);
-  interpolator.reset();
-  fractionalPosition = 0.0;
+  pendingSeek.store(newPos);
 }
 
 void AudioEngine::setLoopRange(double startSeconds, double endSeconds) {
   if (startSeconds > endSeconds)
     std::swap(startSeconds, endSeconds);
 
-  const juce::SpinLock::ScopedLockType lock(waveformLock);
-  const int64_t waveformLength = currentWaveform.getNumSamples();
-  int64_t startSample =
-      static_cast<int64_t>(startSeconds * waveformSampleRate);
-  int64_t endSample = static_cast<int64_t>(endSeconds * waveformSampleRate);
+  const int64_t length = waveformLength.load();
+  const int sampleRate = waveformSampleRate.load();
+  int64_t startSample = static_cast<int64_t>(startSeconds * sampleRate);
+  int64_t endSample = static_cast<int64_t>(endSeconds * sampleRate);
 
-  startSample = juce::jlimit<int64_t>(0, waveformLength, startSample);
-  endSample = juce::jlimit<int64_t>(0, waveformLength, endSample);
+  startSample = juce::jlimit<int64_t>(0, length, startSample);
+  endSample = juce::jlimit<int64_t>(0, length, endSample);
 
   loopStartSample.store(startSample);
   loopEndSample.store(endSample);
@@ -300,14 +331,15 @@ void AudioEngine::clearLoopRange() {
 }
 
 double AudioEngine::getPosition() const {
-  return static_cast<double>(currentPosition.load()) / waveformSampleRate;
+  return static_cast<double>(currentPosition.load()) /
+         waveformSampleRate.load();
 }
 
 double AudioEngine::getDuration() const {
-  if (currentWaveform.getNumSamples() == 0)
+  const int64_t length = waveformLength.load();
+  if (length == 0)
     return 0.0;
-  return static_cast<double>(currentWaveform.getNumSamples()) /
-         waveformSampleRate;
+  return static_cast<double>(length) / waveformSampleRate.load();
 }
 
 void AudioEngine::setVolumeDb(float dB) {
@@ -5,9 +5,17 @@
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
 
 /**
  * Audio engine for playback and synthesis.
+ *
+ * The playback waveform is double-buffered. The audio thread reads
+ * whichever buffer the live pointer names, without locking. Writers update
+ * the standby buffer, swap the pointer, wait for any audio callback still
+ * reading the old buffer to finish, then bring the old buffer up to date.
+ * Writers never block the audio thread, and an incremental-synthesis
+ * update copies only the patched samples.
  */
 class AudioEngine : public juce::AudioSource, public juce::ChangeListener {
 public:
@@ -28,6 +36,13 @@ public:
   void loadWaveform(const juce::AudioBuffer<float> &buffer, int sampleRate,
                     bool preservePosition = false);
 
+  /**
+   * Replace samples [startSample, startSample + numSamples) of the loaded
+   * waveform. Safe from any non-audio thread; returns false if the range
+   * is outside the loaded waveform.
+   */
+  bool patchWaveform(int startSample, const float *samples, int numSamples);
+
   void play();
   void pause();
   void stop();
@@ -78,9 +93,34 @@ private:
   juce::AudioDeviceManager deviceManager;
   juce::AudioSourcePlayer audioSourcePlayer;
 
+  // Mono playback waveform. Immutable while live; only the writer touches
+  // the standby buffer.
+  struct PlaybackBuffer {
+    juce::AudioBuffer<float> audio;
+  };
+
+  /** Scoped marker for an audio callback that may read the live buffer. */
+  struct AudioReadScope {
+    explicit AudioReadScope(std::atomic<uint64_t> &e) : epoch(e) { ++epoch; }
+    ~AudioReadScope() { ++epoch; }
+    std::atomic<uint64_t> &epoch;
+  };
+
+  /**
+   * Make the standby buffer live, then wait until no audio callback can
+   * still be reading the previous one. Caller holds writerMutex.
+   */
+  void publishStandby();
+  PlaybackBuffer *getStandbyBuffer();
+
   Project *project = nullptr;
-  juce::AudioBuffer<float> currentWaveform;
-  int waveformSampleRate = 44100;
+
+  PlaybackBuffer buffers[2];
+  std::atomic<PlaybackBuffer *> liveBuffer{&buffers[0]};
+  std::atomic<uint64_t> audioReadEpoch{0}; // Odd while a callback reads
+  std::mutex writerMutex; // Serialises writers; never taken on audio thread
+  std::atomic<int64_t> waveformLength{0};
+  std::atomic<int> waveformSampleRate{44100};
 
   std::atomic<int64_t> currentPosition{0}; // Position in waveform samples
   std::atomic<bool> playing{false};
@@ -94,13 +134,13 @@ private:
 
   double currentSampleRate = 44100.0;
 
-  // For sample rate conversion
+  // For sample rate conversion (audio thread only)
   juce::LagrangeInterpolator interpolator;
-  double playbackRatio = 1.0;      // waveformSampleRate / deviceSampleRate
-  double fractionalPosition = 0.0; // Sub-sample position for interpolation
+  double playbackRatio = 1.0; // waveformSampleRate / deviceSampleRate
 
-  // Thread safety for waveform updates
-  juce::SpinLock waveformLock;
+  // Requests handled by the audio thread at the start of the next block
+  std::atomic<int64_t> pendingSeek{-1};
+  std::atomic<bool> interpolatorResetPending{false};
 
   // Volume control (linear gain, lock-free for audio thread)
   std::atomic<float> volumeGain{1.0f};
@@ -1,6 +1,10 @@
 #include "EditorController.h"
+#include "Analysis/AnalysisCache.h"
+#include "Analysis/DecodedMelStream.h"
+#include "IO/AudioFileManager.h"
+#include "../Models/ProjectCache.h"
+#include "../Models/ProjectSerializer.h"
 #include "../Utils/Constants.h"
-#include "../Utils/F0Smoother.h"
 #include "../Utils/Localization.h"
 #include "../Utils/MelSpectrogram.h"
 #include "../Utils/PitchCurveProcessor.h"
@@ -34,6 +38,12 @@ EditorController::EditorController(bool enableAudioDevice) {
   audioAnalyzer->setRMVPEDetector(rmvpePitchDetector.get());
   audioAnalyzer->setSOMEDetector(someDetector.get());
   audioAnalyzer->setPitchDetectorType(pitchDetectorType);
+  audioAnalyzer->setCancelFlag(&cancelLoadingFlag);
+  audioAnalyzer->setNotesPreviewCallback(
+      [this](const std::vector<SOMEDetector::NoteEvent> &chunkNotes) {
+        if (onAnalysisPreview)
+          onAnalysisPreview(chunkNotes);
+      });
 
   incrementalSynth->setVocoder(vocoder.get());
   if (audioEngine)
@@ -49,8 +59,7 @@ EditorController::~EditorController() {
   if (loaderJoinerThread.joinable())
     loaderJoinerThread.join();
   cancelRenderFlag = true;
-  if (renderThread.joinable())
-    renderThread.join();
+  InferenceScheduler::getInstance().purge(&cancelRenderFlag);
 }
 
 void EditorController::setProject(std::unique_ptr<Project> newProject) {
@@ -188,77 +197,54 @@ void EditorController::loadAudioFileAsync(
         onProgress(p, msg);
     };
 
-    updateProgress(0.05, TR("progress.loading_audio"));
-
-    juce::AudioFormatManager formatManager;
-    formatManager.registerBasicFormats();
-
-    std::unique_ptr<juce::AudioFormatReader> reader(
-        formatManager.createReaderFor(file));
-    if (reader == nullptr || cancelLoadingFlag.load()) {
-      isLoadingAudio = false;
-      if (onCancelled)
-        juce::MessageManager::callAsync(onCancelled);
-      return;
+    // A .htpx project is opened by loading its JSON, then its audio
+    std::unique_ptr<Project> restoredProject;
+    juce::File audioFile = file;
+    if (file.hasFileExtension("htpx")) {
+      restoredProject = std::make_unique<Project>();
+      if (!ProjectSerializer::loadFromFile(*restoredProject, file)) {
+        isLoadingAudio = false;
+        if (onCancelled)
+          juce::MessageManager::callAsync(onCancelled);
+        return;
+      }
+      audioFile = restoredProject->getFilePath();
     }
 
-    const int numSamples = static_cast<int>(reader->lengthInSamples);
-    const int srcSampleRate = static_cast<int>(reader->sampleRate);
-
-    juce::AudioBuffer<float> buffer(1, numSamples);
-
-    updateProgress(0.10, "Reading audio...");
-    if (reader->numChannels == 1) {
-      reader->read(&buffer, 0, numSamples, 0, true, false);
-    } else {
-      juce::AudioBuffer<float> stereoBuffer(2, numSamples);
-      reader->read(&stereoBuffer, 0, numSamples, 0, true, true);
-
-      const float *left = stereoBuffer.getReadPointer(0);
-      const float *right = stereoBuffer.getReadPointer(1);
-      float *mono = buffer.getWritePointer(0);
+    updateProgress(0.05, TR("progress.loading_audio"));
 
-      for (int i = 0; i < numSamples; ++i)
-        mono[i] = (left[i] + right[i]) * 0.5f;
-    }
+    // For a plain audio file the mel is computed as blocks are decoded, so
+    // analysis does not wait for the whole file before starting on it
+    const bool streamMel = audioFile == file;
+    DecodedMelStream melStream(&cancelLoadingFlag);
+    juce::AudioBuffer<float> buffer;
+    const bool read = AudioFileManager::readAudioFile(
+        audioFile, buffer, &cancelLoadingFlag, updateProgress,
+        [&](int samplesReady) {
+          if (streamMel)
+            melStream.publish(buffer.getReadPointer(0), samplesReady,
+                              buffer.getNumSamples());
+        });
+    auto streamedMel = melStream.finish();
 
-    if (cancelLoadingFlag.load()) {
+    if (!read || cancelLoadingFlag.load()) {
       isLoadingAudio = false;
       if (onCancelled)
         juce::MessageManager::callAsync(onCancelled);
       return;
     }
 
-    if (srcSampleRate != SAMPLE_RATE) {
-      updateProgress(0.18, "Resampling...");
-      const double ratio = static_cast<double>(srcSampleRate) / SAMPLE_RATE;
-      const int newNumSamples = static_cast<int>(numSamples / ratio);
-
-      juce::AudioBuffer<float> resampledBuffer(1, newNumSamples);
-      const float *src = buffer.getReadPointer(0);
-      float *dst = resampledBuffer.getWritePointer(0);
-
-      for (int i = 0; i < newNumSamples; ++i) {
-        const double srcPos = i * ratio;
-        const int srcIndex = static_cast<int>(srcPos);
-        const double frac = srcPos - srcIndex;
-
-        if (srcIndex + 1 < numSamples)
-          dst[i] = static_cast<float>(src[srcIndex] * (1.0 - frac) +
-                                      src[srcIndex + 1] * frac);
-        else
-          dst[i] = src[srcIndex];
-      }
-
-      buffer = std::move(resampledBuffer);
-    }
-
     updateProgress(0.22, "Preparing project...");
-    auto newProject = std::make_unique<Project>();
-    newProject->setFilePath(file);
+    auto newProject = restoredProject ? std::move(restoredProject)
+                                      : std::make_unique<Project>();
+    newProject->setFilePath(audioFile);
+    if (audioFile != file)
+      newProject->setProjectFilePath(file);
     auto &audioData = newProject->getAudioData();
     audioData.waveform = std::move(buffer);
     audioData.sampleRate = SAMPLE_RATE;
+    if (streamMel)
+      audioData.melSpectrogram = std::move(streamedMel);
 
     if (cancelLoadingFlag.load()) {
       isLoadingAudio = false;
@@ -268,7 +254,9 @@ void EditorController::loadAudioFileAsync(
     }
 
     updateProgress(0.25, TR("progress.analyzing_audio"));
-    analyzeAudio(*newProject, updateProgress);
+    if (audioFile == file ||
+        !restoreProjectAnalysis(*newProject, file, updateProgress))
+      analyzeAudio(*newProject, updateProgress, nullptr, streamMel);
 
     if (cancelLoadingFlag.load()) {
       isLoadingAudio = false;
@@ -279,6 +267,9 @@ void EditorController::loadAudioFileAsync(
 
     updateProgress(0.95, "Finalizing...");
 
+    // Build the drawing peaks here rather than on the first repaint
+    newProject->getWaveformPeaks();
+
     juce::AudioBuffer<float> originalWaveform;
     originalWaveform.makeCopyOf(audioData.waveform);
 
@@ -368,6 +359,8 @@ void EditorController::setHostAudioAsync(
       return;
     }
 
+    projectCopy->getWaveformPeaks();
+
     juce::AudioBuffer<float> originalWaveform;
     originalWaveform.makeCopyOf(projectCopy->getAudioData().waveform);
 
@@ -392,9 +385,10 @@ void EditorController::renderProcessedAudioAsync(
     const Project &project,
     float globalPitchOffset,
     const std::function<void(bool)> &onComplete) {
+  // Render jobs are tagged with the render cancel flag so they can be
+  // purged without touching other jobs owned by this controller.
   cancelRenderFlag = true;
-  if (renderThread.joinable())
-    renderThread.join();
+  InferenceScheduler::getInstance().purge(&cancelRenderFlag);
   isRenderingFlag = false;
   cancelRenderFlag = false;
 
@@ -403,7 +397,10 @@ void EditorController::renderProcessedAudioAsync(
   auto melSpecSnapshot = project.getAudioData().melSpectrogram;
   Vocoder *voc = vocoder.get();
 
-  renderThread = std::thread(
+  InferenceScheduler::JobRequest request;
+  request.priority = InferencePriority::Export;
+  request.owner = &cancelRenderFlag;
+  request.run =
       [this, f0Snapshot = std::move(f0Snapshot),
        voicedMaskSnapshot = std::move(voicedMaskSnapshot),
        melSpecSnapshot = std::move(melSpecSnapshot), globalPitchOffset, voc,
@@ -434,7 +431,8 @@ void EditorController::renderProcessedAudioAsync(
         if (cancelRenderFlag.load())
           return finishRendering();
 
-        auto synthesized = voc ? voc->infer(melSpecSnapshot, f0Snapshot)
+        auto synthesized = voc ? voc->inferChunked(melSpecSnapshot, f0Snapshot,
+                                                   &cancelRenderFlag)
                                : std::vector<float>{};
 
         if (cancelRenderFlag.load())
@@ -444,7 +442,8 @@ void EditorController::renderProcessedAudioAsync(
           juce::MessageManager::callAsync(
               [onComplete, ok = !synthesized.empty()]() { onComplete(ok); });
         finishRendering();
-      });
+      };
+  InferenceScheduler::getInstance().submit(std::move(request));
 }
 
 void EditorController::resynthesizeIncrementalAsync(
@@ -502,13 +501,33 @@ void EditorController::resynthesizeIncrementalAsync(
   if (!isPluginMode && audioEngine)
     audioEnginePtr = audioEngine.get();
 
+  // Patch playback region by region as they are spliced in; fall back to a
+  // full reload at the end if any patch no longer fits the loaded buffer.
+  auto needsFullReload = std::make_shared<std::atomic<bool>>(false);
+  if (audioEnginePtr || onWaveformPatched) {
+    synth->setRegionCommittedCallback(
+        [audioEnginePtr, projectPtr = &project, needsFullReload,
+         patched = onWaveformPatched](int startSample, int numSamples) {
+          const auto &waveform = projectPtr->getAudioData().waveform;
+          if (audioEnginePtr &&
+              !audioEnginePtr->patchWaveform(
+                  startSample, waveform.getReadPointer(0, startSample),
+                  numSamples))
+            needsFullReload->store(true);
+          if (patched)
+            patched(startSample, numSamples);
+        });
+  } else {
+    synth->setRegionCommittedCallback(nullptr);
+  }
+
   synth->synthesizeRegion(
       [onProgress](const juce::String &message) {
         if (onProgress)
           onProgress(message);
       },
       [this, projectPtr = &project, pending = &pendingRerun, onComplete,
-       audioEnginePtr, isPluginMode](bool success) {
+       audioEnginePtr, isPluginMode, needsFullReload](bool success) {
         if (!success) {
           if (pending->exchange(false)) {
             juce::MessageManager::callAsync([this, projectPtr, pending, onComplete,
@@ -522,7 +541,7 @@ void EditorController::resynthesizeIncrementalAsync(
           return;
         }
 
-        if (audioEnginePtr && !isPluginMode) {
+        if (audioEnginePtr && !isPluginMode && needsFullReload->load()) {
           auto &audioData = projectPtr->getAudioData();
           try {
             audioEnginePtr->loadWaveform(audioData.waveform,
@@ -548,7 +567,7 @@ void EditorController::resynthesizeIncrementalAsync(
 void EditorController::analyzeAudio(
     Project &targetProject,
     const std::function<void(double, const juce::String &)> &onProgress,
-    std::function<void()> onComplete) {
+    std::function<void()> onComplete, bool reuseMel) {
   auto &audioData = targetProject.getAudioData();
   if (audioData.waveform.getNumSamples() == 0)
     return;
@@ -563,19 +582,6 @@ void EditorController::analyzeAudio(
     });
   };
 
-  // Extract F0
-  const float *samples = audioData.waveform.getReadPointer(0);
-  int numSamples = audioData.waveform.getNumSamples();
-
-  onProgress(0.35, "Computing mel spectrogram...");
-  MelSpectrogram melComputer(audioData.sampleRate, N_FFT, HOP_SIZE, NUM_MELS,
-                             FMIN, FMAX);
-  audioData.melSpectrogram = melComputer.compute(samples, numSamples);
-
-  int targetFrames = static_cast<int>(audioData.melSpectrogram.size());
-
-  onProgress(0.55, "Extracting pitch (F0)...");
-
   if (pitchDetectorType == PitchDetectorType::RMVPE) {
     if (!rmvpeModelPath.existsAsFile() || !rmvpePitchDetector ||
         !rmvpePitchDetector->isLoaded()) {
@@ -608,16 +614,15 @@ void EditorController::analyzeAudio(
       juce::String(fcpePitchDetector && fcpePitchDetector->isLoaded() ? "YES"
                                                                       : "NO"));
 
-  std::vector<float> extractedF0;
-  if (pitchDetectorType == PitchDetectorType::RMVPE) {
-    extractedF0 = rmvpePitchDetector->extractF0(samples, numSamples,
-                                                audioData.sampleRate);
-  } else if (pitchDetectorType == PitchDetectorType::FCPE) {
-    extractedF0 =
-        fcpePitchDetector->extractF0(samples, numSamples, audioData.sampleRate);
-  }
+  // Mel, F0 and SOME events run concurrently in the analyzer; SOME chunks
+  // feed the loading preview as they finish
+  std::vector<SOMEDetector::NoteEvent> noteEvents;
+  bool haveNoteEvents = false;
+  if (!audioAnalyzer->analyzeFeatures(audioData, onProgress, noteEvents,
+                                      haveNoteEvents, reuseMel))
+    return;
 
-  if (extractedF0.empty() || targetFrames <= 0) {
+  if (audioData.f0.empty()) {
     juce::MessageManager::callAsync([]() {
       juce::AlertWindow::showMessageBoxAsync(
           juce::AlertWindow::WarningIcon, "Inference failed",
@@ -627,55 +632,7 @@ void EditorController::analyzeAudio(
     return;
   }
 
-  {
-    audioData.f0.resize(targetFrames);
-
-    const double neuralFrameTime = 160.0 / 16000.0;
-    const double vocoderFrameTime =
-        static_cast<double>(HOP_SIZE) /
-        static_cast<double>(std::max(1, audioData.sampleRate));
-
-    for (int i = 0; i < targetFrames; ++i) {
-      double vocoderTime = i * vocoderFrameTime;
-      double neuralFramePos = vocoderTime / neuralFrameTime;
-      int srcIdx = static_cast<int>(neuralFramePos);
-      double frac = neuralFramePos - srcIdx;
-
-      if (srcIdx + 1 < static_cast<int>(extractedF0.size())) {
-        float f0_a = extractedF0[srcIdx];
-        float f0_b = extractedF0[srcIdx + 1];
-
-        if (f0_a > 0.0f && f0_b > 0.0f) {
-          float logF0_a = std::log(f0_a);
-          float logF0_b = std::log(f0_b);
-          float logF0_interp = logF0_a * (1.0 - frac) + logF0_b * frac;
-          audioData.f0[i] = std::exp(logF0_interp);
-        } else if (f0_a > 0.0f) {
-          audioData.f0[i] = f0_a;
-        } else if (f0_b > 0.0f) {
-          audioData.f0[i] = f0_b;
-        } else {
-          audioData.f0[i] = 0.0f;
-        }
-      } else if (srcIdx < static_cast<int>(extractedF0.size())) {
-        audioData.f0[i] = extractedF0[srcIdx];
-      } else {
-        audioData.f0[i] = extractedF0.back() > 0.0f ? extractedF0.back() : 0.0f;
-      }
-    }
-
-    audioData.voicedMask.resize(audioData.f0.size());
-    for (size_t i = 0; i < audioData.f0.size(); ++i) {
-      audioData.voicedMask[i] = audioData.f0[i] > 0;
-    }
-
-    onProgress(0.65, "Smoothing pitch curve...");
-    audioData.f0 = F0Smoother::smoothF0(audioData.f0, audioData.voicedMask);
-    audioData.f0 = PitchCurveProcessor::interpolateWithUvMask(
-        audioData.f0, audioData.voicedMask);
-  }
-
-  onProgress(0.75, TR("progress.loading_vocoder"));
+  onProgress(0.88, TR("progress.loading_vocoder"));
   auto modelPath =
       PlatformPaths::getModelsDirectory().getChildFile("pc_nsf_hifigan.onnx");
 
@@ -699,7 +656,10 @@ void EditorController::analyzeAudio(
   }
 
   onProgress(0.90, "Segmenting notes...");
-  segmentIntoNotes(targetProject);
+  if (haveNoteEvents)
+    segmentIntoNotes(targetProject, nullptr, &noteEvents);
+  else
+    segmentIntoNotes(targetProject);
 
   PitchCurveProcessor::rebuildCurvesFromSource(targetProject, audioData.f0);
 
@@ -707,6 +667,70 @@ void EditorController::analyzeAudio(
     onComplete();
 }
 
+bool EditorController::restoreProjectAnalysis(
+    Project &targetProject, const juce::File &projectFile,
+    const std::function<void(double, const juce::String &)> &onProgress) {
+  auto &audioData = targetProject.getAudioData();
+  if (audioData.waveform.getNumSamples() == 0)
+    return false;
+
+  onProgress(0.30, "Reading analysis cache...");
+  const auto key = ProjectCache::computeKey(audioData);
+  if (ProjectCache::load(targetProject, key,
+                         ProjectCache::getCacheFileFor(projectFile))) {
+    LOG("Restored analysis from project cache: " +
+        ProjectCache::getCacheFileFor(projectFile).getFullPathName());
+    return true;
+  }
+
+  // No usable cache. Pitch data and notes from the JSON are still valid for
+  // this audio; only the mel spectrogram and note clips need rebuilding.
+  if (audioData.f0.empty())
+    return false;
+
+  // The JSON pitch data must line up with the mel about to be computed;
+  // check that first so a mismatch does not compute the mel twice (here
+  // and again in the full analysis that follows)
+  MelSpectrogram melComputer(audioData.sampleRate, N_FFT, HOP_SIZE, NUM_MELS,
+                             FMIN, FMAX);
+  const int numFrames =
+      melComputer.getNumFrames(audioData.waveform.getNumSamples());
+  if (static_cast<int>(audioData.f0.size()) != numFrames)
+    return false;
+
+  onProgress(0.35, "Computing mel spectrogram...");
+  audioData.melSpectrogram = melComputer.compute(
+      audioData.waveform.getReadPointer(0), audioData.waveform.getNumSamples(),
+      &cancelLoadingFlag, [&](double fraction) {
+        onProgress(0.35 + 0.2 * fraction, "Computing mel spectrogram...");
+      });
+  if (audioData.melSpectrogram.empty())
+    return false;
+
+  const float *samples = audioData.waveform.getReadPointer(0);
+  const int numSamples = audioData.waveform.getNumSamples();
+  for (auto &note : targetProject.getNotes()) {
+    const int start = std::clamp(note.getStartFrame(), 0, numFrames);
+    const int end = std::clamp(note.getEndFrame(), start, numFrames);
+    if (end <= start)
+      continue;
+
+    note.setSrcStartFrame(start);
+    note.setSrcEndFrame(end);
+    note.setF0Values(std::vector<float>(audioData.f0.begin() + start,
+                                        audioData.f0.begin() + end));
+    note.setClipMel(MelMatrix(audioData.melSpectrogram.view(start, end)));
+
+    const int startSample = std::min(start * HOP_SIZE, numSamples);
+    const int endSample = std::min(end * HOP_SIZE, numSamples);
+    note.setClipWaveform(
+        std::vector<float>(samples + startSample, samples + endSample));
+  }
+
+  LOG("Project cache missing or stale; recomputed mel only");
+  return true;
+}
+
 void EditorController::analyzeAudioAsync(
     const std::function<void(Project &)> &onProjectReady,
     const std::function<void()> &onProjectChanged) {
@@ -763,6 +787,7 @@ void EditorController::segmentIntoNotesAsync(
         return;
 
       project->getNotes() = projectCopy->getNotes();
+      project->notifyNoteLayoutChanged();
 
       if (onProjectReady)
         onProjectReady(*project);
@@ -772,11 +797,11 @@ void EditorController::segmentIntoNotesAsync(
   });
 }
 
-void EditorController::segmentIntoNotes(Project &targetProject,
-                                        std::function<void()> onStreamingUpdate) {
+void EditorController::segmentIntoNotes(
+    Project &targetProject, std::function<void()> onStreamingUpdate,
+    const std::vector<SOMEDetector::NoteEvent> *detectedEvents) {
   auto &audioData = targetProject.getAudioData();
-  auto &notes = targetProject.getNotes();
-  notes.clear();
+  targetProject.clearNotes();
 
   if (audioData.f0.empty())
     return;
@@ -794,42 +819,45 @@ void EditorController::segmentIntoNotes(Project &targetProject,
   if (someDetector && someDetector->isLoaded() &&
       audioData.waveform.getNumSamples() > 0) {
 
-    const float *samples = audioData.waveform.getReadPointer(0);
-    int numSamples = audioData.waveform.getNumSamples();
     const int f0Size = static_cast<int>(audioData.f0.size());
 
-    someDetector->detectNotesStreaming(
-        samples, numSamples, SOMEDetector::SAMPLE_RATE,
-        [&](const std::vector<SOMEDetector::NoteEvent> &chunkNotes) {
-          for (const auto &someNote : chunkNotes) {
-            if (someNote.isRest)
-              continue;
+    auto addNotes = [&](const std::vector<SOMEDetector::NoteEvent> &events) {
+      for (const auto &someNote : events) {
+        if (someNote.isRest)
+          continue;
 
-            int f0Start = someNote.startFrame;
-            int f0End = someNote.endFrame;
+        int f0Start = someNote.startFrame;
+        int f0End = someNote.endFrame;
 
-            f0Start = std::max(0, std::min(f0Start, f0Size - 1));
-            f0End = std::max(f0Start + 1, std::min(f0End, f0Size));
+        f0Start = std::max(0, std::min(f0Start, f0Size - 1));
+        f0End = std::max(f0Start + 1, std::min(f0End, f0Size));
 
-            if (f0End - f0Start < 3)
-              continue;
+        if (f0End - f0Start < 3)
+          continue;
 
-            Note note(f0Start, f0End, someNote.midiNote);
-            std::vector<float> f0Values(audioData.f0.begin() + f0Start,
-                                        audioData.f0.begin() + f0End);
-            note.setF0Values(std::move(f0Values));
-            notes.push_back(note);
-          }
+        Note note(f0Start, f0End, someNote.midiNote);
+        std::vector<float> f0Values(audioData.f0.begin() + f0Start,
+                                    audioData.f0.begin() + f0End);
+        note.setF0Values(std::move(f0Values));
+        targetProject.addNote(std::move(note));
+      }
 
-          if (onStreamingUpdate) {
-            juce::MessageManager::callAsync(onStreamingUpdate);
-          }
-        },
-        nullptr);
+      if (onStreamingUpdate) {
+        juce::MessageManager::callAsync(onStreamingUpdate);
+      }
+    };
 
-    juce::Thread::sleep(100);
+    if (detectedEvents != nullptr) {
+      addNotes(*detectedEvents);
+    } else {
+      std::vector<SOMEDetector::NoteEvent> events;
+      audioAnalyzer->detectNoteEvents(audioData,
+                                      AnalysisCache::hashAudio(audioData),
+                                      events, addNotes, nullptr, nullptr);
+      juce::Thread::sleep(100);
+    }
 
-    DBG("SOME segmented into " << notes.size() << " notes");
+    DBG("SOME segmented into " << targetProject.getNotes().size() << " notes");
 
     if (!audioData.f0.empty())
       PitchCurveProcessor::rebuildCurvesFromSource(targetProject, audioData.f0);
@@ -859,7 +887,7 @@ void EditorController::segmentIntoNotes(Project &targetProject,
     std::vector<float> f0Values(audioData.f0.begin() + start,
                                 audioData.f0.begin() + end);
     note.setF0Values(std::move(f0Values));
-    notes.push_back(note);
+    targetProject.addNote(std::move(note));
   };
 
   constexpr float pitchSplitThreshold = 0.5f;
@@ -74,6 +74,30 @@ public:
                                  const std::function<void(bool)> &onComplete);
   void requestCancelRender();
 
+  using WaveformPatchedCallback =
+      std::function<void(int startSample, int numSamples)>;
+
+  /**
+   * Called from a worker thread each time incremental synthesis rewrites a
+   * span of the project waveform, so other consumers (the plugin's realtime
+   * processor) can refresh just that span.
+   */
+  void setOnWaveformPatched(WaveformPatchedCallback callback) {
+    onWaveformPatched = std::move(callback);
+  }
+
+  using AnalysisPreviewCallback =
+      std::function<void(const std::vector<SOMEDetector::NoteEvent> &)>;
+
+  /**
+   * Called from an analysis thread with each chunk of SOME note events while
+   * a file is being analysed, before the project is handed over, so the
+   * piano roll can show notes as they are found.
+   */
+  void setOnAnalysisPreview(AnalysisPreviewCallback callback) {
+    onAnalysisPreview = std::move(callback);
+  }
+
   void resynthesizeIncrementalAsync(
       Project &project,
       const std::function<void(const juce::String &)> &onProgress,
@@ -81,13 +105,24 @@ public:
       std::atomic<bool> &pendingRerun,
       bool isPluginMode);
 
+  /**
+   * Run the full analysis. With reuseMel, a mel spectrogram already in the
+   * project that matches the waveform (computed while the file was being
+   * decoded) is kept instead of being computed again.
+   */
   void analyzeAudio(Project &targetProject,
                     const std::function<void(double, const juce::String &)>
                         &onProgress,
-                    std::function<void()> onComplete = nullptr);
+                    std::function<void()> onComplete = nullptr,
+                    bool reuseMel = false);
 
-  void segmentIntoNotes(Project &targetProject,
-                        std::function<void()> onStreamingUpdate = nullptr);
+  /**
+   * Build notes from SOME events, running SOME unless detectedEvents (from
+   * a pipelined analysis pass) is given.
+   */
+  void segmentIntoNotes(
+      Project &targetProject, std::function<void()> onStreamingUpdate = nullptr,
+      const std::vector<SOMEDetector::NoteEvent> *detectedEvents = nullptr);
 
   void analyzeAudioAsync(
       const std::function<void(Project &)> &onProjectReady,
@@ -100,6 +135,15 @@ public:
 private:
   GPUProvider getProviderFromDevice(const juce::String &device) const;
 
+  /**
+   * Fill in analysis data for a project opened from a .htpx file, from its
+   * ProjectCache sidecar or, failing that, from the JSON pitch data plus a
+   * fresh mel spectrogram. Returns false if full analysis is still needed.
+   */
+  bool restoreProjectAnalysis(
+      Project &targetProject, const juce::File &projectFile,
+      const std::function<void(double, const juce::String &)> &onProgress);
+
   std::unique_ptr<Project> project;
   std::unique_ptr<AudioEngine> audioEngine;
   std::unique_ptr<FCPEPitchDetector> fcpePitchDetector;
@@ -109,6 +153,8 @@ private:
   std::unique_ptr<AudioAnalyzer> audioAnalyzer;
   std::unique_ptr<IncrementalSynthesizer> incrementalSynth;
   std::unique_ptr<PlaybackController> playbackController;
+  WaveformPatchedCallback onWaveformPatched;
+  AnalysisPreviewCallback onAnalysisPreview;
 
   juce::File fcpeModelPath;
   juce::File melFilterbankPath;
@@ -130,8 +176,7 @@ private:
   std::atomic<bool> cancelLoadingFlag{false};
   std::atomic<std::uint64_t> hostAnalysisJobId{0};
 
-  // Async render state
-  std::thread renderThread;
+  // Async render state (render runs on the InferenceScheduler)
   std::atomic<bool> cancelRenderFlag{false};
   std::atomic<bool> isRenderingFlag{false};
 
@@ -1,7 +1,11 @@
 #include "FCPEPitchDetector.h"
+#include "Inference/InferenceScheduler.h"
+#include "../Utils/SystemMemory.h"
 #include <algorithm>
 #include <cmath>
+#include <memory>
 #include <numeric>
+#include <stdexcept>
 
 FCPEPitchDetector::FCPEPitchDetector() {
   initMelFilterbank();
@@ -12,58 +16,10 @@ FCPEPitchDetector::FCPEPitchDetector() {
 FCPEPitchDetector::~FCPEPitchDetector() = default;
 
 void FCPEPitchDetector::initMelFilterbank() {
-  // Create mel filterbank matching librosa's implementation (Slaney
-  // normalization)
-  const int numBins = N_FFT / 2 + 1; // 513
-
-  // Hz to Mel conversion (HTK formula used by librosa by default when htk=False
-  // is NOT used) Actually librosa uses Slaney by default, but the mel function
-  // with htk=False uses HTK For compatibility with FCPE, we use the HTK formula
-  auto hzToMel = [](float hz) -> float {
-    return 2595.0f * std::log10(1.0f + hz / 700.0f);
-  };
-
-  auto melToHz = [](float mel) -> float {
-    return 700.0f * (std::pow(10.0f, mel / 2595.0f) - 1.0f);
-  };
-
-  float melMin = hzToMel(FMIN);
-  float melMax = hzToMel(FMAX);
-
-  // Create mel points (N_MELS + 2 for triangular filters)
-  std::vector<float> melPoints(N_MELS + 2);
-  for (int i = 0; i <= N_MELS + 1; ++i) {
-    melPoints[i] = melMin + (melMax - melMin) * i / (N_MELS + 1);
-  }
-
-  // Convert to Hz
-  std::vector<float> hzPoints(N_MELS + 2);
-  for (int i = 0; i <= N_MELS + 1; ++i) {
-    hzPoints[i] = melToHz(melPoints[i]);
-  }
-
-  // Create filterbank with Slaney normalization
-  melFilterbank.resize(N_MELS);
-  for (int m = 0; m < N_MELS; ++m) {
-    melFilterbank[m].resize(numBins, 0.0f);
-
-    float fLow = hzPoints[m];
-    float fCenter = hzPoints[m + 1];
-    float fHigh = hzPoints[m + 2];
-
-    // Slaney normalization: 2 / (fHigh - fLow)
-    float enorm = 2.0f / (fHigh - fLow);
-
-    for (int k = 0; k < numBins; ++k) {
-      float freq = static_cast<float>(k) * FCPE_SAMPLE_RATE / N_FFT;
-
-      if (freq >= fLow && freq < fCenter) {
-        melFilterbank[m][k] = enorm * (freq - fLow) / (fCenter - fLow);
-      } else if (freq >= fCenter && freq <= fHigh) {
-        melFilterbank[m][k] = enorm * (fHigh - freq) / (fHigh - fCenter);
-      }
-    }
-  }
+  // Triangular filters with Slaney normalization. librosa's default mel
+  // scale is Slaney, but FCPE was trained with the HTK formula, so use that.
+  melFilterbank = MelFilterbank(FCPE_SAMPLE_RATE, N_FFT, N_MELS, FMIN, FMAX,
+                                MelFilterbank::Scale::Htk);
 }
 
 void FCPEPitchDetector::initHannWindow() {
@@ -101,13 +57,7 @@ bool FCPEPitchDetector::loadModel(const juce::File &modelPath,
         std::vector<float> data(N_MELS * numBins);
         stream.read(data.data(), data.size() * sizeof(float));
 
-        melFilterbank.resize(N_MELS);
-        for (int m = 0; m < N_MELS; ++m) {
-          melFilterbank[m].resize(numBins);
-          for (int k = 0; k < numBins; ++k) {
-            melFilterbank[m][k] = data[m * numBins + k];
-          }
-        }
+        melFilterbank = MelFilterbank::fromDense(data.data(), N_MELS, numBins);
         DBG("Loaded mel filterbank from file");
       }
     }
@@ -214,6 +164,7 @@ bool FCPEPitchDetector::loadModel(const juce::File &modelPath,
     for (const auto &name : outputNameStrings)
       outputNames.push_back(name.c_str());
 
+    modelFile = modelPath;
     loaded = true;
     DBG("FCPE model loaded successfully");
     return true;
@@ -263,7 +214,9 @@ std::vector<float> FCPEPitchDetector::resampleTo16k(const float *audio,
 }
 
 std::vector<std::vector<float>>
-FCPEPitchDetector::extractMel(const std::vector<float> &audio) {
+FCPEPitchDetector::extractMel(const std::vector<float> &audio,
+                              const std::atomic<bool> *cancelFlag,
+                              const ParallelFor::ProgressCallback &onProgress) {
   const int numBins = N_FFT / 2 + 1;
 
   // Pad audio (same as PyTorch FCPE)
@@ -309,44 +262,39 @@ FCPEPitchDetector::extractMel(const std::vector<float> &audio) {
 
   std::vector<std::vector<float>> mel(numFrames);
 
-  // FFT buffer (real + imaginary interleaved for JUCE FFT)
-  std::vector<float> fftBuffer(N_FFT * 2, 0.0f);
-  juce::dsp::FFT fft(static_cast<int>(std::log2(N_FFT)));
-
-  for (int frame = 0; frame < numFrames; ++frame) {
-    int start = frame * HOP_SIZE;
+  // Each worker owns its FFT and scratch; frames land in their own rows
+  auto makeWorker = [&]() {
+    return [&, fft = std::make_unique<juce::dsp::FFT>(
+                   static_cast<int>(std::log2(N_FFT))),
+            fftBuffer = std::vector<float>(N_FFT * 2),
+            mag = std::vector<float>(numBins)](int begin, int end) mutable {
+      const int paddedSize = static_cast<int>(paddedAudio.size());
+      for (int frame = begin; frame < end; ++frame) {
+        int start = frame * HOP_SIZE;
+
+        // Apply window and prepare FFT input
+        std::fill(fftBuffer.begin(), fftBuffer.end(), 0.0f);
+        for (int i = 0; i < WIN_SIZE && start + i < paddedSize; ++i) {
+          fftBuffer[i] = paddedAudio[start + i] * hannWindow[i];
+        }
 
-    // Apply window and prepare FFT input
-    std::fill(fftBuffer.begin(), fftBuffer.end(), 0.0f);
-    for (int i = 0;
-         i < WIN_SIZE && start + i < static_cast<int>(paddedAudio.size());
-         ++i) {
-      fftBuffer[i] = paddedAudio[start + i] * hannWindow[i];
-    }
+        // Perform FFT
+        fft->performRealOnlyForwardTransform(fftBuffer.data());
 
-    // Perform FFT
-    fft.performRealOnlyForwardTransform(fftBuffer.data());
+        // Compute magnitude spectrum
+        MelFilterbank::computeMagnitude(fftBuffer.data(), mag.data(), numBins);
 
-    // Compute magnitude spectrum
-    std::vector<float> mag(numBins);
-    for (int k = 0; k < numBins; ++k) {
-      float real = fftBuffer[k * 2];
-      float imag = fftBuffer[k * 2 + 1];
-      mag[k] = std::sqrt(real * real + imag * imag + 1e-9f);
-    }
-
-    // Apply mel filterbank
-    mel[frame].resize(N_MELS);
-    for (int m = 0; m < N_MELS; ++m) {
-      float sum = 0.0f;
-      for (int k = 0; k < numBins; ++k) {
-        sum += mag[k] * melFilterbank[m][k];
+        // Apply mel filterbank with dynamic range compression (log)
+        mel[frame].resize(N_MELS);
+        melFilterbank.applyLog(mag.data(), mel[frame].data(), CLIP_VAL);
       }
+    };
+  };
 
-      // Dynamic range compression (log)
-      mel[frame][m] = std::log(std::max(sum, CLIP_VAL));
-    }
-  }
+  // 400 frames = 4 s of 16 kHz audio per work item
+  if (!ParallelFor::forEachBlock(numFrames, 400, 0, makeWorker, cancelFlag,
+                                 onProgress))
+    return {};
 
   return mel;
 }
@@ -399,9 +347,9 @@ FCPEPitchDetector::decodeF0(const std::vector<std::vector<float>> &latent,
   return f0;
 }
 
-std::vector<float> FCPEPitchDetector::extractF0(const float *audio,
-                                                int numSamples, int sampleRate,
-                                                float threshold) {
+std::vector<float> FCPEPitchDetector::extractF0(
+    const float *audio, int numSamples, int sampleRate, float threshold,
+    const std::atomic<bool> *cancelFlag) {
 #ifdef HAVE_ONNXRUNTIME
   if (!loaded) {
     DBG("FCPE model not loaded");
@@ -413,7 +361,7 @@ std::vector<float> FCPEPitchDetector::extractF0(const float *audio,
     auto audio16k = resampleTo16k(audio, numSamples, sampleRate);
 
     // Step 2: Extract mel spectrogram
-    auto mel = extractMel(audio16k);
+    auto mel = extractMel(audio16k, cancelFlag);
 
     if (mel.empty()) {
       DBG("Empty mel spectrogram");
@@ -440,6 +388,8 @@ std::vector<float> FCPEPitchDetector::extractF0(const float *audio,
         inputShape.size());
 
     // Step 4: Run inference
+    auto runSlot = InferenceScheduler::getInstance().acquireRunSlot(
+        InferencePriority::Analysis);
     auto outputTensors =
         onnxSession->Run(Ort::RunOptions{nullptr}, inputNames.data(),
                          &inputTensor, 1, outputNames.data(), 1);
@@ -476,7 +426,8 @@ std::vector<float> FCPEPitchDetector::extractF0(const float *audio,
 
 std::vector<float> FCPEPitchDetector::extractF0WithProgress(
     const float *audio, int numSamples, int sampleRate, float threshold,
-    std::function<void(double)> progressCallback) {
+    std::function<void(double)> progressCallback,
+    const std::atomic<bool> *cancelFlag) {
 #ifdef HAVE_ONNXRUNTIME
   if (!loaded) {
     DBG("FCPE model not loaded");
@@ -494,7 +445,10 @@ std::vector<float> FCPEPitchDetector::extractF0WithProgress(
       progressCallback(0.3);
 
     // Step 2: Extract mel spectrogram
-    auto mel = extractMel(audio16k);
+    auto mel = extractMel(audio16k, cancelFlag, [&](double fraction) {
+      if (progressCallback)
+        progressCallback(0.3 + 0.2 * fraction);
+    });
 
     if (mel.empty()) {
       DBG("Empty mel spectrogram");
@@ -527,6 +481,8 @@ std::vector<float> FCPEPitchDetector::extractF0WithProgress(
       progressCallback(0.6);
 
     // Step 4: Run inference
+    auto runSlot = InferenceScheduler::getInstance().acquireRunSlot(
+        InferencePriority::Analysis);
     auto outputTensors =
         onnxSession->Run(Ort::RunOptions{nullptr}, inputNames.data(),
                          &inputTensor, 1, outputNames.data(), 1);
@@ -572,6 +528,169 @@ std::vector<float> FCPEPitchDetector::extractF0WithProgress(
 #endif
 }
 
+std::vector<std::vector<float>> FCPEPitchDetector::runMelBatch(
+    const std::vector<const std::vector<std::vector<float>> *> &mels,
+    int maxFrames, float threshold) {
+#ifdef HAVE_ONNXRUNTIME
+  const int batchSize = static_cast<int>(mels.size());
+  const float silence = std::log(CLIP_VAL);
+
+  std::vector<float> inputData(static_cast<size_t>(batchSize) * maxFrames *
+                                   N_MELS,
+                               silence);
+  for (int b = 0; b < batchSize; ++b) {
+    float *row = inputData.data() + static_cast<size_t>(b) * maxFrames * N_MELS;
+    const auto &mel = *mels[b];
+    for (size_t t = 0; t < mel.size(); ++t)
+      std::copy(mel[t].begin(), mel[t].end(), row + t * N_MELS);
+  }
+
+  std::array<int64_t, 3> inputShape = {batchSize, maxFrames, N_MELS};
+
+  Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(
+      OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+
+  Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
+      memoryInfo, inputData.data(), inputData.size(), inputShape.data(),
+      inputShape.size());
+
+  auto runSlot = InferenceScheduler::getInstance().acquireRunSlot(
+      InferencePriority::Analysis);
+  auto outputTensors =
+      onnxSession->Run(Ort::RunOptions{nullptr}, inputNames.data(),
+                       &inputTensor, 1, outputNames.data(), 1);
+
+  // Output [B, T, OUT_DIMS]
+  const float *outputData = outputTensors[0].GetTensorMutableData<float>();
+  auto outputShape = outputTensors[0].GetTensorTypeAndShapeInfo().GetShape();
+  if (outputShape.size() != 3 || outputShape[0] != batchSize)
+    throw std::runtime_error("unexpected FCPE batch output shape");
+
+  const int outFrames = static_cast<int>(outputShape[1]);
+  std::vector<std::vector<float>> result(mels.size());
+  for (int b = 0; b < batchSize; ++b) {
+    const float *rowOut =
+        outputData + static_cast<size_t>(b) * outFrames * OUT_DIMS;
+    const int numFrames =
+        std::min(outFrames, static_cast<int>(mels[b]->size()));
+    std::vector<std::vector<float>> latent(numFrames);
+    for (int t = 0; t < numFrames; ++t)
+      latent[t].assign(rowOut + t * OUT_DIMS, rowOut + (t + 1) * OUT_DIMS);
+    result[b] = decodeF0(latent, threshold);
+  }
+  return result;
+#else
+  return {};
+#endif
+}
+
+std::vector<std::vector<float>>
+FCPEPitchDetector::extractF0Batch(const std::vector<Clip> &clips,
+                                  float threshold,
+                                  const std::atomic<bool> *cancelFlag) {
+#ifdef HAVE_ONNXRUNTIME
+  if (!loaded) {
+    DBG("FCPE model not loaded");
+    return {};
+  }
+
+  // Rough per-frame activation footprint, plus the attention map that
+  // grows with the square of the sequence length
+  constexpr size_t BYTES_PER_FRAME = 16 * 1024;
+  constexpr size_t ATTENTION_BYTES_PER_FRAME_PAIR = 8 * sizeof(float);
+  constexpr int MAX_BATCH = 32;
+  // Let rows in one batch differ in length by at most a quarter
+  constexpr double MAX_PADDING_RATIO = 1.25;
+
+  auto isCancelled = [cancelFlag]() {
+    return cancelFlag != nullptr && cancelFlag->load();
+  };
+
+  try {
+    std::vector<std::vector<std::vector<float>>> mels(clips.size());
+    std::vector<size_t> order;
+    for (size_t i = 0; i < clips.size(); ++i) {
+      if (isCancelled())
+        return {};
+      const auto &clip = clips[i];
+      if (clip.audio == nullptr || clip.numSamples <= 0)
+        continue;
+      mels[i] = extractMel(
+          resampleTo16k(clip.audio, clip.numSamples, clip.sampleRate),
+          cancelFlag);
+      if (!mels[i].empty())
+        order.push_back(i);
+    }
+
+    // Sort by length so neighbours pad each other as little as possible
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return mels[a].size() < mels[b].size();
+    });
+
+    std::vector<std::vector<float>> results(clips.size());
+    std::vector<const std::vector<std::vector<float>> *> batch;
+    std::vector<size_t> batchIndices;
+
+    for (size_t begin = 0; begin < order.size();) {
+      if (isCancelled())
+        return {};
+
+      const size_t shortest = mels[order[begin]].size();
+      // Size the batch once, for the longest row the padding limit admits
+      const auto longestAllowed = static_cast<size_t>(
+          static_cast<double>(shortest) * MAX_PADDING_RATIO);
+      const auto maxBatch = static_cast<size_t>(SystemMemory::fitBatchSize(
+          longestAllowed * BYTES_PER_FRAME +
+              longestAllowed * longestAllowed * ATTENTION_BYTES_PER_FRAME_PAIR,
+          MAX_BATCH));
+      size_t end = begin + 1;
+      while (end < order.size() && end - begin < maxBatch &&
+             mels[order[end]].size() <= longestAllowed)
+        ++end;
+      if (!batchSupported.load())
+        end = begin + 1;
+
+      batch.clear();
+      batchIndices.clear();
+      for (size_t k = begin; k < end; ++k) {
+        batch.push_back(&mels[order[k]]);
+        batchIndices.push_back(order[k]);
+      }
+      const int maxFrames = static_cast<int>(mels[order[end - 1]].size());
+
+      std::vector<std::vector<float>> f0Rows;
+      try {
+        f0Rows = runMelBatch(batch, maxFrames, threshold);
+      } catch (const Ort::Exception &e) {
+        if (batch.size() == 1)
+          throw;
+        // Models exported with a fixed batch dimension of 1 end up here;
+        // retry this range one clip at a time
+        DBG("FCPE: batched run failed, falling back to single clips: "
+            << e.what());
+        batchSupported = false;
+        continue;
+      }
+
+      for (size_t k = 0; k < batchIndices.size(); ++k)
+        results[batchIndices[k]] = std::move(f0Rows[k]);
+      begin = end;
+    }
+
+    return results;
+  } catch (const Ort::Exception &e) {
+    DBG("ONNX Runtime error during inference: " << e.what());
+    return {};
+  } catch (const std::exception &e) {
+    DBG("Error during F0 extraction: " << e.what());
+    return {};
+  }
+#else
+  DBG("ONNX Runtime not available");
+  return {};
+#endif
+}
+
 int FCPEPitchDetector::getNumFrames(int numSamples, int sampleRate) const {
   // Convert to 16kHz sample count
   int samples16k = static_cast<int>(
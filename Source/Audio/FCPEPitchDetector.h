@@ -1,8 +1,11 @@
 #pragma once
 
 #include "../JuceHeader.h"
+#include "../Utils/MelFilterbank.h"
+#include "../Utils/ParallelFor.h"
 #include <vector>
 #include <array>
+#include <atomic>
 #include <memory>
 
 #ifdef HAVE_ONNXRUNTIME
@@ -69,6 +72,11 @@ public:
      * Check if model is loaded.
      */
     bool isLoaded() const { return loaded; }
+
+    /**
+     * Model file the current session was loaded from (used to key caches).
+     */
+    juce::File getModelFile() const { return modelFile; }
     
     /**
      * Extract F0 from audio buffer.
@@ -78,17 +86,43 @@ public:
      * @param numSamples Number of samples
      * @param sampleRate Original sample rate
      * @param threshold Confidence threshold (default 0.05)
-     * @return F0 values in Hz (0 for unvoiced frames)
+     * @param cancelFlag Checked during mel extraction; may be null
+     * @return F0 values in Hz (0 for unvoiced frames), empty if cancelled
      */
     std::vector<float> extractF0(const float* audio, int numSamples,
-                                  int sampleRate, float threshold = 0.05f);
+                                  int sampleRate, float threshold = 0.05f,
+                                  const std::atomic<bool>* cancelFlag = nullptr);
+
+    /** One clip for extractF0Batch. */
+    struct Clip {
+        const float* audio = nullptr;
+        int numSamples = 0;
+        int sampleRate = FCPE_SAMPLE_RATE;
+    };
+
+    /**
+     * Extract F0 for many clips, running clips of similar length together as
+     * one [B, T, N_MELS] tensor. Shorter clips are padded with silent mel
+     * frames and their output trimmed; the model's attention is unmasked and
+     * also sees the padding, so results can differ slightly from extractF0
+     * (hachitune_bench reports the deviation). B is capped by an estimate of the
+     * batch's memory against what the system has free. If the model rejects
+     * a batch dimension above 1, every clip is run singly from then on.
+     *
+     * @param cancelFlag Checked between clips and batches; may be null
+     * @return One F0 curve per clip, in input order; empty if cancelled
+     */
+    std::vector<std::vector<float>> extractF0Batch(const std::vector<Clip>& clips,
+                                                   float threshold = 0.05f,
+                                                   const std::atomic<bool>* cancelFlag = nullptr);
 
     /**
      * Extract F0 with progress callback.
      */
     std::vector<float> extractF0WithProgress(const float* audio, int numSamples,
                                               int sampleRate, float threshold,
-                                              std::function<void(double)> progressCallback);
+                                              std::function<void(double)> progressCallback,
+                                              const std::atomic<bool>* cancelFlag = nullptr);
 
     /**
      * Get the number of F0 frames that will be produced for given audio length.
@@ -107,9 +141,10 @@ public:
     
 private:
     bool loaded = false;
+    juce::File modelFile;
     
-    // Mel filterbank matrix [N_MELS x (N_FFT/2+1)]
-    std::vector<std::vector<float>> melFilterbank;
+    // Mel filterbank [N_MELS x (N_FFT/2+1)], stored sparsely
+    MelFilterbank melFilterbank;
     
     // Hann window [WIN_SIZE]
     std::vector<float> hannWindow;
@@ -129,9 +164,18 @@ private:
     // Resample audio to 16kHz
     std::vector<float> resampleTo16k(const float* audio, int numSamples, int srcRate);
     
-    // Extract mel spectrogram
-    std::vector<std::vector<float>> extractMel(const std::vector<float>& audio);
+    // Extract mel spectrogram, frame-parallel; empty if cancelled
+    std::vector<std::vector<float>> extractMel(const std::vector<float>& audio,
+                                               const std::atomic<bool>* cancelFlag = nullptr,
+                                               const ParallelFor::ProgressCallback& onProgress = nullptr);
     
+    // Run mels padded to maxFrames as one [B, T, N_MELS] tensor and decode
+    // each to its own length
+    std::vector<std::vector<float>> runMelBatch(const std::vector<const std::vector<std::vector<float>>*>& mels,
+                                                int maxFrames, float threshold);
+
+    std::atomic<bool> batchSupported{true};
+
     // Decode latent to F0 (local argmax decoder)
     std::vector<float> decodeF0(const std::vector<std::vector<float>>& latent, 
                                  float threshold);
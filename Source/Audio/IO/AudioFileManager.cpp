@@ -1,5 +1,7 @@
 #include "AudioFileManager.h"
 #include "../../Utils/Localization.h"
+#include <algorithm>
+#include <limits>
 
 AudioFileManager::AudioFileManager() {
   workerThread = std::thread([this]() {
@@ -40,46 +42,9 @@ AudioFileManager::AudioFileManager() {
       if (task.onProgress)
         task.onProgress(0.05, TR("progress.loading_audio"));
 
-      juce::AudioFormatManager formatManager;
-      formatManager.registerBasicFormats();
-
-      std::unique_ptr<juce::AudioFormatReader> reader(
-          formatManager.createReaderFor(task.file));
-      if (reader == nullptr || (task.cancelFlag && task.cancelFlag->load()) ||
-          isShuttingDown.load()) {
-        finishTask();
-        continue;
-      }
-
-      const int numSamples = static_cast<int>(reader->lengthInSamples);
-      const int srcSampleRate = static_cast<int>(reader->sampleRate);
-
-      if (task.onProgress)
-        task.onProgress(0.10, TR("progress.reading_audio"));
-
       juce::AudioBuffer<float> buffer;
-      if (reader->numChannels == 1) {
-        buffer.setSize(1, numSamples);
-        reader->read(&buffer, 0, numSamples, 0, true, false);
-      } else {
-        juce::AudioBuffer<float> stereoBuffer(2, numSamples);
-        reader->read(&stereoBuffer, 0, numSamples, 0, true, true);
-        buffer = convertToMono(stereoBuffer);
-      }
-
-      if ((task.cancelFlag && task.cancelFlag->load()) ||
-          isShuttingDown.load()) {
-        finishTask();
-        continue;
-      }
-
-      if (srcSampleRate != SAMPLE_RATE) {
-        if (task.onProgress)
-          task.onProgress(0.18, TR("progress.resampling"));
-        buffer = resampleIfNeeded(buffer, srcSampleRate, SAMPLE_RATE);
-      }
-
-      if ((task.cancelFlag && task.cancelFlag->load()) ||
+      if (!readAudioFile(task.file, buffer, task.cancelFlag.get(),
+                         task.onProgress) ||
           isShuttingDown.load()) {
         finishTask();
         continue;
@@ -248,35 +213,147 @@ void AudioFileManager::exportAudioFileAsync(
     onProgress(0.0, TR("progress.exporting"));
 
   // Export synchronously for now (could be made async if needed)
+  const bool success = writeWavFile(file, buffer, sampleRate);
+
+  if (onProgress)
+    onProgress(1.0, success ? TR("progress.export_complete")
+                            : TR("progress.export_failed"));
+
+  if (onComplete)
+    onComplete(success);
+}
+
+bool AudioFileManager::readAudioFile(const juce::File &file,
+                                     juce::AudioBuffer<float> &buffer,
+                                     const std::atomic<bool> *cancelFlag,
+                                     const ProgressCallback &onProgress,
+                                     const BlockCallback &onBlock) {
+  auto isCancelled = [cancelFlag]() {
+    return cancelFlag != nullptr && cancelFlag->load();
+  };
+
+  juce::AudioFormatManager formatManager;
+  formatManager.registerBasicFormats();
+
+  std::unique_ptr<juce::AudioFormatReader> reader(
+      formatManager.createReaderFor(file));
+  if (reader == nullptr || isCancelled())
+    return false;
+  if (reader->lengthInSamples < 0 ||
+      reader->lengthInSamples > std::numeric_limits<int>::max())
+    return false;
+
+  const int numSource = static_cast<int>(reader->lengthInSamples);
+  const int srcSampleRate = static_cast<int>(reader->sampleRate);
+  const bool needsResample = srcSampleRate != SAMPLE_RATE;
+  const double ratio = static_cast<double>(srcSampleRate) / SAMPLE_RATE;
+  const int numOutput =
+      needsResample ? static_cast<int>(numSource / ratio) : numSource;
+
+  // The result is allocated once; decoding, mix-down and resampling go
+  // through block-sized scratch buffers, so peak memory stays close to the
+  // size of the mono result however long or wide the file is
+  buffer.setSize(1, numOutput, false, false, true);
+  float *out = buffer.getWritePointer(0);
+
+  const int numChannels = reader->numChannels == 1 ? 1 : 2;
+  juce::AudioBuffer<float> decoded(numChannels, readBlockSize);
+  // Mono source for the resampler: [0] carries the previous block's last
+  // sample, since an output may interpolate across the block boundary
+  std::vector<float> mono(needsResample ? readBlockSize + 1 : 0);
+
+  if (onProgress)
+    onProgress(0.10, TR("progress.reading_audio"));
+
+  int outputDone = 0;
+  for (int blockStart = 0; blockStart < numSource;
+       blockStart += readBlockSize) {
+    if (isCancelled())
+      return false;
+
+    const int blockLength = std::min(readBlockSize, numSource - blockStart);
+    const int blockEnd = blockStart + blockLength;
+
+    if (!needsResample && numChannels == 1) {
+      reader->read(&buffer, blockStart, blockLength, blockStart, true, false);
+      outputDone = blockEnd;
+    } else {
+      reader->read(&decoded, 0, blockLength, blockStart, true,
+                   numChannels == 2);
+
+      float *dest = needsResample ? mono.data() + 1 : out + blockStart;
+      if (numChannels == 2) {
+        juce::FloatVectorOperations::add(dest, decoded.getReadPointer(0),
+                                         decoded.getReadPointer(1),
+                                         blockLength);
+        juce::FloatVectorOperations::multiply(dest, 0.5f, blockLength);
+      } else {
+        juce::FloatVectorOperations::copy(dest, decoded.getReadPointer(0),
+                                          blockLength);
+      }
+
+      if (!needsResample) {
+        outputDone = blockEnd;
+      } else {
+        // Linear interpolation; mono[k] holds source sample
+        // blockStart - 1 + k
+        auto src = [&mono, blockStart](int index) {
+          return mono[static_cast<size_t>(index - blockStart + 1)];
+        };
+        const bool isLastBlock = blockEnd == numSource;
+        while (outputDone < numOutput) {
+          const double srcPos = outputDone * ratio;
+          const int srcIndex = static_cast<int>(srcPos);
+          const double frac = srcPos - srcIndex;
+
+          if (srcIndex + 1 < numSource) {
+            if (srcIndex + 1 >= blockEnd)
+              break; // Needs the next block
+            out[outputDone] = static_cast<float>(
+                src(srcIndex) * (1.0 - frac) + src(srcIndex + 1) * frac);
+          } else if (isLastBlock) {
+            out[outputDone] = src(srcIndex);
+          } else {
+            break;
+          }
+          ++outputDone;
+        }
+        mono[0] = mono[static_cast<size_t>(blockLength)];
+      }
+    }
+
+    if (onBlock)
+      onBlock(outputDone);
+    if (onProgress)
+      onProgress(0.10 + 0.12 * blockEnd / numSource,
+                 TR("progress.reading_audio"));
+  }
+
+  return !isCancelled();
+}
+
+bool AudioFileManager::writeWavFile(const juce::File &file,
+                                    const juce::AudioBuffer<float> &buffer,
+                                    int sampleRate) {
+  if (file.existsAsFile() && !file.deleteFile())
+    return false;
+
   juce::WavAudioFormat wavFormat;
   auto writerOptions = juce::AudioFormatWriterOptions{}
                            .withSampleRate(sampleRate)
                            .withNumChannels(buffer.getNumChannels())
                            .withBitsPerSample(16);
   auto fileStream = std::make_unique<juce::FileOutputStream>(file);
-  if (!fileStream->openedOk()) {
-    if (onProgress)
-      onProgress(1.0, TR("progress.export_failed"));
-    if (onComplete)
-      onComplete(false);
-    return;
-  }
+  if (!fileStream->openedOk())
+    return false;
+
   std::unique_ptr<juce::OutputStream> outputStream = std::move(fileStream);
   std::unique_ptr<juce::AudioFormatWriter> writer(
       wavFormat.createWriterFor(outputStream, writerOptions));
+  if (writer == nullptr)
+    return false;
 
-  bool success = false;
-  if (writer) {
-    success =
-        writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
-  }
-
-  if (onProgress)
-    onProgress(1.0, success ? TR("progress.export_complete")
-                            : TR("progress.export_failed"));
-
-  if (onComplete)
-    onComplete(success);
+  return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
 }
 
 bool AudioFileManager::isInterestedInFileDrag(const juce::StringArray &files) {
@@ -300,47 +377,3 @@ juce::File AudioFileManager::getFirstAudioFile(const juce::StringArray &files) {
   }
   return {};
 }
-
-juce::AudioBuffer<float>
-AudioFileManager::resampleIfNeeded(const juce::AudioBuffer<float> &buffer,
-                                   int srcSampleRate, int targetSampleRate) {
-  if (srcSampleRate == targetSampleRate)
-    return buffer;
-
-  const double ratio = static_cast<double>(srcSampleRate) / targetSampleRate;
-  const int numSamples = buffer.getNumSamples();
-  const int newNumSamples = static_cast<int>(numSamples / ratio);
-
-  juce::AudioBuffer<float> resampledBuffer(1, newNumSamples);
-  const float *src = buffer.getReadPointer(0);
-  float *dst = resampledBuffer.getWritePointer(0);
-
-  for (int i = 0; i < newNumSamples; ++i) {
-    const double srcPos = i * ratio;
-    const int srcIndex = static_cast<int>(srcPos);
-    const double frac = srcPos - srcIndex;
-
-    if (srcIndex + 1 < numSamples)
-      dst[i] = static_cast<float>(src[srcIndex] * (1.0 - frac) +
-                                  src[srcIndex + 1] * frac);
-    else
-      dst[i] = src[srcIndex];
-  }
-
-  return resampledBuffer;
-}
-
-juce::AudioBuffer<float>
-AudioFileManager::convertToMono(const juce::AudioBuffer<float> &stereoBuffer) {
-  const int numSamples = stereoBuffer.getNumSamples();
-  juce::AudioBuffer<float> monoBuffer(1, numSamples);
-
-  const float *left = stereoBuffer.getReadPointer(0);
-  const float *right = stereoBuffer.getReadPointer(1);
-  float *mono = monoBuffer.getWritePointer(0);
-
-  for (int i = 0; i < numSamples; ++i)
-    mono[i] = (left[i] + right[i]) * 0.5f;
-
-  return monoBuffer;
-}
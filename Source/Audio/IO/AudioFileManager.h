@@ -42,6 +42,30 @@ public:
                             int sampleRate, ProgressCallback onProgress,
                             ExportCompleteCallback onComplete);
 
+  /**
+   * Called as a file is read with the number of leading samples of the
+   * result that are final. The buffer already has its full size, so a
+   * consumer on another thread may read those samples straight away.
+   */
+  using BlockCallback = std::function<void(int samplesReady)>;
+
+  /**
+   * Read an audio file as mono at SAMPLE_RATE on the calling thread.
+   * Decoding, mix-down and resampling run block by block into the result,
+   * so no full-length intermediate buffers are allocated. Stops early and
+   * returns false if cancelFlag (may be null) is set.
+   */
+  static bool readAudioFile(const juce::File &file,
+                            juce::AudioBuffer<float> &buffer,
+                            const std::atomic<bool> *cancelFlag = nullptr,
+                            const ProgressCallback &onProgress = nullptr,
+                            const BlockCallback &onBlock = nullptr);
+
+  /** Write a 16-bit WAV file on the calling thread, replacing any old one. */
+  static bool writeWavFile(const juce::File &file,
+                           const juce::AudioBuffer<float> &buffer,
+                           int sampleRate);
+
   // State
   bool isLoading() const { return isLoadingAudio.load(); }
   void cancelLoading();
@@ -58,14 +82,8 @@ private:
     std::shared_ptr<std::atomic<bool>> cancelFlag;
   };
 
-  // Resample audio to target sample rate
-  static juce::AudioBuffer<float>
-  resampleIfNeeded(const juce::AudioBuffer<float> &buffer, int srcSampleRate,
-                   int targetSampleRate);
-
-  // Convert stereo to mono
-  static juce::AudioBuffer<float>
-  convertToMono(const juce::AudioBuffer<float> &stereoBuffer);
+  // Source frames decoded per step of readAudioFile (~1.5 s at 44.1 kHz)
+  static constexpr int readBlockSize = 1 << 16;
 
   std::unique_ptr<juce::FileChooser> fileChooser;
   std::thread workerThread;
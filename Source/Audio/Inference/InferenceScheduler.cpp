@@ -0,0 +1,233 @@
+#include "InferenceScheduler.h"
+#include <algorithm>
+
+InferenceScheduler::InferenceScheduler() {
+  const int cores =
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  numWorkers = std::clamp(cores / 2, 2, 8);
+  // One model run per two cores, so analysis keeps several slots beside the
+  // one held back for interactive work
+  maxConcurrentRuns = std::clamp(cores / 2, 2, 8);
+
+  std::lock_guard<std::mutex> lock(lifecycleMutex);
+  startWorkers();
+}
+
+InferenceScheduler::~InferenceScheduler() { shutdown(); }
+
+void InferenceScheduler::shutdown() {
+  std::lock_guard<std::mutex> lock(lifecycleMutex);
+  stopWorkers();
+}
+
+void InferenceScheduler::addUser() {
+  std::lock_guard<std::mutex> lock(lifecycleMutex);
+  if (numUsers++ == 0 && workers.empty())
+    startWorkers();
+}
+
+void InferenceScheduler::removeUser() {
+  std::lock_guard<std::mutex> lock(lifecycleMutex);
+  if (--numUsers == 0)
+    stopWorkers();
+}
+
+void InferenceScheduler::startWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    shuttingDown = false;
+  }
+  for (int i = 0; i < numWorkers; ++i)
+    workers.emplace_back([this, i]() { workerLoop(i); });
+}
+
+void InferenceScheduler::stopWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    shuttingDown = true;
+    for (auto &queue : queues) {
+      for (auto &job : queue)
+        job.request.token->store(true);
+      queue.clear();
+    }
+  }
+  queueCondition.notify_all();
+  for (auto &worker : workers)
+    if (worker.joinable())
+      worker.join();
+  workers.clear();
+}
+
+InferenceScheduler::RunSlot::~RunSlot() {
+  if (scheduler)
+    scheduler->releaseRunSlot();
+}
+
+InferenceScheduler::CancelToken
+InferenceScheduler::submit(JobRequest request) {
+  if (!request.token)
+    request.token = makeToken();
+  auto token = request.token;
+
+  std::vector<std::function<void()>> superseded;
+  {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    if (shuttingDown) {
+      lock.unlock();
+      token->store(true);
+      if (request.onCancelled)
+        request.onCancelled();
+      return token;
+    }
+
+    if (!request.coalesceKey.empty()) {
+      auto matches = [&request](const JobRequest &other) {
+        return other.owner == request.owner &&
+               other.coalesceKey == request.coalesceKey;
+      };
+
+      for (auto &queue : queues) {
+        for (auto it = queue.begin(); it != queue.end();) {
+          if (matches(it->request)) {
+            it->request.token->store(true);
+            if (it->request.onCancelled)
+              superseded.push_back(std::move(it->request.onCancelled));
+            it = queue.erase(it);
+          } else {
+            ++it;
+          }
+        }
+      }
+
+      for (auto &entry : running) {
+        if (entry.second.owner == request.owner &&
+            entry.second.coalesceKey == request.coalesceKey)
+          entry.second.token->store(true);
+      }
+    }
+
+    const auto index = static_cast<size_t>(request.priority);
+    queues[index].push_back(QueuedJob{std::move(request), ++nextJobId});
+  }
+  queueCondition.notify_all();
+
+  for (auto &callback : superseded)
+    callback();
+
+  return token;
+}
+
+void InferenceScheduler::purge(const void *owner) {
+  std::unique_lock<std::mutex> lock(queueMutex);
+  for (auto &queue : queues) {
+    queue.erase(std::remove_if(queue.begin(), queue.end(),
+                               [owner](const QueuedJob &job) {
+                                 return job.request.owner == owner;
+                               }),
+                queue.end());
+  }
+
+  idleCondition.wait(lock, [this, owner]() {
+    return std::none_of(running.begin(), running.end(),
+                        [owner](const auto &entry) {
+                          return entry.second.owner == owner;
+                        });
+  });
+}
+
+bool InferenceScheduler::hasJobFor(int workerIndex) const {
+  // Worker 0 is reserved for latency-sensitive work
+  const int lowestPriority =
+      workerIndex == 0 ? static_cast<int>(InferencePriority::PlaybackAhead)
+                       : numPriorities - 1;
+  for (int p = 0; p <= lowestPriority; ++p)
+    if (!queues[static_cast<size_t>(p)].empty())
+      return true;
+  return false;
+}
+
+void InferenceScheduler::workerLoop(int workerIndex) {
+  for (;;) {
+    QueuedJob job;
+    {
+      std::unique_lock<std::mutex> lock(queueMutex);
+      queueCondition.wait(lock, [this, workerIndex]() {
+        return shuttingDown || hasJobFor(workerIndex);
+      });
+      if (shuttingDown)
+        return;
+
+      for (auto &queue : queues) {
+        if (!queue.empty()) {
+          job = std::move(queue.front());
+          queue.pop_front();
+          break;
+        }
+      }
+
+      if (!job.request.token->load())
+        running[job.id] = RunningJob{job.request.owner,
+                                     job.request.coalesceKey,
+                                     job.request.token};
+    }
+
+    if (job.request.token->load()) {
+      if (job.request.onCancelled)
+        job.request.onCancelled();
+      continue;
+    }
+
+    try {
+      if (job.request.run)
+        job.request.run();
+    } catch (const std::exception &e) {
+      DBG("InferenceScheduler: job threw: " << e.what());
+    } catch (...) {
+      DBG("InferenceScheduler: job threw unknown exception");
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(queueMutex);
+      running.erase(job.id);
+    }
+    idleCondition.notify_all();
+  }
+}
+
+bool InferenceScheduler::canStartRun(InferencePriority priority) const {
+  const int freeSlots = maxConcurrentRuns - activeRuns;
+  if (freeSlots <= 0)
+    return false;
+
+  // Strict priority among waiters
+  const int p = static_cast<int>(priority);
+  for (int higher = 0; higher < p; ++higher)
+    if (waitingRuns[static_cast<size_t>(higher)] > 0)
+      return false;
+
+  // Keep the last slot for interactive/playback work
+  if (freeSlots == 1 && maxConcurrentRuns > 1 &&
+      priority > InferencePriority::PlaybackAhead)
+    return false;
+
+  return true;
+}
+
+InferenceScheduler::RunSlot
+InferenceScheduler::acquireRunSlot(InferencePriority priority) {
+  std::unique_lock<std::mutex> lock(slotMutex);
+  auto &waiting = waitingRuns[static_cast<size_t>(priority)];
+  ++waiting;
+  slotCondition.wait(lock, [this, priority]() { return canStartRun(priority); });
+  --waiting;
+  ++activeRuns;
+  return RunSlot(this);
+}
+
+void InferenceScheduler::releaseRunSlot() {
+  {
+    std::lock_guard<std::mutex> lock(slotMutex);
+    --activeRuns;
+  }
+  slotCondition.notify_all();
+}
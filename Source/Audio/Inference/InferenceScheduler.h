@@ -0,0 +1,209 @@
+#pragma once
+
+#include "../../JuceHeader.h"
+#include "../../Utils/ParallelFor.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Priority classes for model work, highest first.
+ */
+enum class InferencePriority {
+  InteractivePreview = 0, // Drag-to-hear / incremental resynthesis
+  PlaybackAhead = 1,      // Rendering ahead of the playhead (plugin)
+  Analysis = 2,           // F0 / note detection
+  Export = 3              // Full renders
+};
+
+/**
+ * Process-wide scheduler for Vocoder, RMVPE, FCPE and SOME work.
+ *
+ * Two entry points:
+ * - submit(): queue a job on a bounded worker pool. Jobs run in priority
+ *   order, can be cancelled through a token, and a job submitted with a
+ *   coalesce key supersedes any queued job of the same owner and key.
+ * - acquireRunSlot(): admission gate around a single model Run() on the
+ *   calling thread. Limits concurrent inference across all models and
+ *   keeps the last slot for interactive/playback work.
+ *
+ * Worker 0 only takes InteractivePreview/PlaybackAhead jobs, so a long
+ * export or analysis can never occupy every worker.
+ *
+ * The app and each plugin processor hold a ScopedUser. When the last one
+ * goes, the workers are joined right there rather than in static
+ * destruction, which may run after a plugin's code has been unloaded.
+ */
+class InferenceScheduler {
+public:
+  using CancelToken = std::shared_ptr<std::atomic<bool>>;
+
+  struct JobRequest {
+    InferencePriority priority = InferencePriority::Analysis;
+    std::function<void()> run;
+    std::function<void()> onCancelled; // Called instead of run when dropped
+    std::string coalesceKey;           // Empty = never coalesced
+    CancelToken token;                 // Created if null
+    const void *owner = nullptr;       // Tag used by coalescing and purge()
+  };
+
+  /**
+   * RAII admission slot for one model run. Movable, not copyable.
+   */
+  class RunSlot {
+  public:
+    RunSlot() = default;
+    RunSlot(RunSlot &&other) noexcept : scheduler(other.scheduler) {
+      other.scheduler = nullptr;
+    }
+    RunSlot &operator=(RunSlot &&) = delete;
+    RunSlot(const RunSlot &) = delete;
+    RunSlot &operator=(const RunSlot &) = delete;
+    ~RunSlot();
+
+  private:
+    friend class InferenceScheduler;
+    explicit RunSlot(InferenceScheduler *s) : scheduler(s) {}
+    InferenceScheduler *scheduler = nullptr;
+  };
+
+  /**
+   * Keeps the worker pool alive for its owner's lifetime; a new user after
+   * the last one left starts the workers again. Tools that never take one
+   * (CLI, bench) keep the pool until exit.
+   */
+  class ScopedUser {
+  public:
+    ScopedUser() { getInstance().addUser(); }
+    ~ScopedUser() { getInstance().removeUser(); }
+    ScopedUser(const ScopedUser &) = delete;
+    ScopedUser &operator=(const ScopedUser &) = delete;
+  };
+
+  static InferenceScheduler &getInstance() {
+    static InferenceScheduler instance;
+    return instance;
+  }
+
+  static CancelToken makeToken() {
+    return std::make_shared<std::atomic<bool>>(false);
+  }
+
+  /**
+   * Queue a job. Returns its cancel token (the one passed in, or a new one).
+   * Jobs whose token is set before they start are dropped and their
+   * onCancelled callback runs instead. Superseded (coalesced) jobs get their
+   * token set; queued ones are dropped, running ones are expected to poll it.
+   */
+  CancelToken submit(JobRequest request);
+
+  /**
+   * Drop all queued jobs of an owner (without calling onCancelled) and wait
+   * for its running jobs to finish. Call from destructors; must not be
+   * called from one of the owner's own jobs.
+   */
+  void purge(const void *owner);
+
+  /**
+   * Block until a run slot is available for this priority.
+   */
+  RunSlot acquireRunSlot(InferencePriority priority);
+
+  /**
+   * Stop and join the workers. Queued jobs are dropped without calling
+   * onCancelled (owners purge before teardown); running ones finish first.
+   * Until a ScopedUser restarts the pool, submit() cancels jobs at once.
+   * Must not be called from a job.
+   */
+  void shutdown();
+
+  /**
+   * Call fn(index) for each index in [0, numItems), claimed in order, on
+   * the calling thread plus helpers from ParallelFor's process-wide budget:
+   * at most maxThreads in all, or getMaxConcurrentRuns() - 1 for 0 so a run
+   * slot stays free for interactive work. For fanning out the independent
+   * chunks or batches of one model call; each Run() inside fn still goes
+   * through acquireRunSlot(). Returns false if cancelFlag was set before
+   * every item ran; the first exception fn threw is rethrown after all
+   * threads have stopped.
+   */
+  template <typename Fn>
+  bool forEachRun(int numItems, Fn &&fn,
+                  const std::atomic<bool> *cancelFlag = nullptr,
+                  int maxThreads = 0) {
+    if (maxThreads <= 0)
+      maxThreads = std::max(1, getMaxConcurrentRuns() - 1);
+    return ParallelFor::forEachBlock(
+        numItems, 1, maxThreads,
+        [&fn]() {
+          return [&fn](int begin, int end) {
+            for (int i = begin; i < end; ++i)
+              fn(static_cast<size_t>(i));
+          };
+        },
+        cancelFlag);
+  }
+
+  int getNumWorkers() const { return numWorkers; }
+  int getMaxConcurrentRuns() const { return maxConcurrentRuns; }
+
+private:
+  InferenceScheduler();
+  ~InferenceScheduler();
+
+  static constexpr int numPriorities = 4;
+
+  struct QueuedJob {
+    JobRequest request;
+    std::uint64_t id = 0;
+  };
+
+  struct RunningJob {
+    const void *owner = nullptr;
+    std::string coalesceKey;
+    CancelToken token;
+  };
+
+  void addUser();
+  void removeUser();
+  void startWorkers();
+  void stopWorkers();
+  void workerLoop(int workerIndex);
+  bool hasJobFor(int workerIndex) const;
+  void releaseRunSlot();
+  bool canStartRun(InferencePriority priority) const;
+
+  // Job queue
+  mutable std::mutex queueMutex;
+  std::condition_variable queueCondition;
+  std::condition_variable idleCondition;
+  std::array<std::deque<QueuedJob>, numPriorities> queues;
+  std::unordered_map<std::uint64_t, RunningJob> running;
+  std::uint64_t nextJobId = 0;
+  bool shuttingDown = false;
+
+  // Worker lifetime; workers is only touched under lifecycleMutex
+  std::mutex lifecycleMutex;
+  std::vector<std::thread> workers;
+  int numWorkers = 2;
+  int numUsers = 0;
+
+  // Run slots
+  mutable std::mutex slotMutex;
+  std::condition_variable slotCondition;
+  std::array<int, numPriorities> waitingRuns{};
+  int activeRuns = 0;
+  int maxConcurrentRuns = 2;
+
+  JUCE_DECLARE_NON_COPYABLE(InferenceScheduler)
+};
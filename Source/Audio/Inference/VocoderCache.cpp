@@ -0,0 +1,89 @@
+#include "VocoderCache.h"
+#include "../../Utils/ContentHash.h"
+
+VocoderCache::VocoderCache(size_t maxBytesIn) : maxBytes(maxBytesIn) {}
+
+std::uint64_t VocoderCache::makeKey(std::uint64_t modelIdentity, MelView mel,
+                                    const std::vector<float> &f0,
+                                    size_t startFrame, size_t numFrames) {
+  ContentHash hash(modelIdentity);
+  hash.updateValue(static_cast<std::uint64_t>(numFrames));
+  hash.updateValue(mel.getNumMels());
+  if (numFrames > 0) {
+    hash.update(mel[startFrame], numFrames *
+                                     static_cast<size_t>(mel.getNumMels()) *
+                                     sizeof(float));
+    hash.update(f0.data() + startFrame, numFrames * sizeof(float));
+  }
+  return hash.finish();
+}
+
+bool VocoderCache::lookup(std::uint64_t key, std::vector<float> &audio,
+                          bool countMiss) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = index.find(key);
+  if (it == index.end()) {
+    if (countMiss)
+      ++misses;
+    return false;
+  }
+
+  entries.splice(entries.begin(), entries, it->second);
+  audio = it->second->audio;
+  ++hits;
+  return true;
+}
+
+void VocoderCache::store(std::uint64_t key, std::vector<float> audio) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (audio.empty() || audio.size() * sizeof(float) > maxBytes)
+    return;
+
+  auto it = index.find(key);
+  if (it != index.end()) {
+    bytesUsed -= getEntryBytes(*it->second);
+    entries.erase(it->second);
+    index.erase(it);
+  }
+
+  entries.push_front({key, std::move(audio)});
+  index[key] = entries.begin();
+  bytesUsed += getEntryBytes(entries.front());
+  trimLocked();
+}
+
+void VocoderCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  entries.clear();
+  index.clear();
+  bytesUsed = 0;
+}
+
+void VocoderCache::setMaxBytes(size_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex);
+  maxBytes = bytes;
+  trimLocked();
+}
+
+size_t VocoderCache::getMaxBytes() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return maxBytes;
+}
+
+VocoderCache::Stats VocoderCache::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  Stats stats;
+  stats.hits = hits;
+  stats.misses = misses;
+  stats.entries = entries.size();
+  stats.bytes = bytesUsed;
+  return stats;
+}
+
+void VocoderCache::trimLocked() {
+  while (bytesUsed > maxBytes && !entries.empty()) {
+    bytesUsed -= getEntryBytes(entries.back());
+    index.erase(entries.back().key);
+    entries.pop_back();
+  }
+}
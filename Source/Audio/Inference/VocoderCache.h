@@ -0,0 +1,77 @@
+#pragma once
+
+#include "../../Utils/MelMatrix.h"
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Bounded cache of vocoder output, keyed by a hash of the model and the
+ * exact mel and F0 frames it was run on.
+ *
+ * Undo/redo and A/B toggling send the vocoder inputs it rendered moments
+ * ago; a hit returns the stored audio instead of running a session. Least
+ * recently used entries are dropped to stay under a byte budget.
+ * Thread-safe.
+ */
+class VocoderCache {
+public:
+  struct Stats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+
+    double getHitRate() const {
+      const auto lookups = hits + misses;
+      return lookups > 0 ? static_cast<double>(hits) / lookups : 0.0;
+    }
+  };
+
+  explicit VocoderCache(size_t maxBytes = 128 * 1024 * 1024);
+
+  /** Key for frames [startFrame, startFrame + numFrames) of mel and f0. */
+  static std::uint64_t makeKey(std::uint64_t modelIdentity, MelView mel,
+                               const std::vector<float> &f0,
+                               size_t startFrame, size_t numFrames);
+
+  /**
+   * Copy the audio stored under key into audio. A miss is only counted in
+   * the stats when countMiss is set, so a caller that probes before
+   * falling through to a counted lookup does not count it twice.
+   */
+  bool lookup(std::uint64_t key, std::vector<float> &audio,
+              bool countMiss = true);
+
+  void store(std::uint64_t key, std::vector<float> audio);
+
+  void clear();
+
+  /** 0 disables caching. */
+  void setMaxBytes(size_t bytes);
+  size_t getMaxBytes() const;
+
+  Stats getStats() const;
+
+private:
+  struct Entry {
+    std::uint64_t key = 0;
+    std::vector<float> audio;
+  };
+
+  static size_t getEntryBytes(const Entry &entry) {
+    return entry.audio.size() * sizeof(float);
+  }
+
+  void trimLocked();
+
+  mutable std::mutex mutex;
+  std::list<Entry> entries; // Most recently used first
+  std::unordered_map<std::uint64_t, std::list<Entry>::iterator> index;
+  size_t maxBytes;
+  size_t bytesUsed = 0;
+  std::uint64_t hits = 0;
+  std::uint64_t misses = 0;
+};
@@ -32,3 +32,12 @@ inline PitchDetectorType stringToPitchDetectorType(const juce::String& str)
     if (str == "FCPE")  return PitchDetectorType::FCPE;
     return PitchDetectorType::RMVPE;  // Default
 }
+
+/**
+ * True if str (as pitchDetectorTypeToString writes it) names a detector,
+ * for inputs that should reject a typo rather than fall back to RMVPE.
+ */
+inline bool isPitchDetectorTypeName(const juce::String& str)
+{
+    return str == "RMVPE" || str == "FCPE";
+}
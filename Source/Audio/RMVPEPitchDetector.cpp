@@ -1,6 +1,10 @@
 #include "RMVPEPitchDetector.h"
+#include "Inference/InferenceScheduler.h"
+#include "../Utils/SystemMemory.h"
 #include <algorithm>
 #include <cmath>
+#include <mutex>
+#include <stdexcept>
 
 RMVPEPitchDetector::RMVPEPitchDetector() = default;
 
@@ -101,6 +105,7 @@ bool RMVPEPitchDetector::loadModel(const juce::File &modelPath,
     for (const auto &name : outputNameStrings)
       outputNames.push_back(name.c_str());
 
+    modelFile = modelPath;
     loaded = true;
     DBG("RMVPE model loaded successfully");
     return true;
@@ -200,56 +205,103 @@ std::vector<float> RMVPEPitchDetector::decodeF0(const float *hidden,
   return f0;
 }
 
-std::vector<float> RMVPEPitchDetector::extractF0(const float *audio,
-                                                 int numSamples, int sampleRate,
-                                                 float threshold) {
+std::vector<float> RMVPEPitchDetector::extractF0(
+    const float *audio, int numSamples, int sampleRate, float threshold,
+    const std::atomic<bool> *cancelFlag, const ChunkCallback &onChunk) {
 #ifdef HAVE_ONNXRUNTIME
   if (!loaded) {
     DBG("RMVPE model not loaded");
     return {};
   }
 
+  auto isCancelled = [cancelFlag]() {
+    return cancelFlag != nullptr && cancelFlag->load();
+  };
+
   try {
     // Step 1: Resample to 16kHz
     auto audio16k = resampleTo16k(audio, numSamples, sampleRate);
 
     // Process in chunks to avoid stack overflow for long audio
-    // Max chunk: 30 seconds at 16kHz = 480000 samples
-    constexpr int MAX_CHUNK_SAMPLES = 16000 * 30;
     constexpr int OVERLAP_SAMPLES = 16000; // 1 second overlap
+    constexpr int OVERLAP_FRAMES = OVERLAP_SAMPLES / HOP_SIZE;
 
     if (static_cast<int>(audio16k.size()) <= MAX_CHUNK_SAMPLES) {
       // Short audio: process directly
-      return extractF0Chunk(audio16k.data(), static_cast<int>(audio16k.size()),
-                            threshold);
+      auto f0 = extractF0Chunk(audio16k.data(),
+                               static_cast<int>(audio16k.size()), threshold);
+      if (isCancelled())
+        return {};
+      if (onChunk && !f0.empty())
+        onChunk(0, f0);
+      return f0;
     }
 
-    // Long audio: process in chunks
+    // Long audio: chunks are independent, so run them on several workers
+    // and stitch them back in order as soon as each prefix is complete
+    const int totalSamples = static_cast<int>(audio16k.size());
+    std::vector<int> chunkStarts;
+    for (int pos = 0; pos < totalSamples;
+         pos += MAX_CHUNK_SAMPLES - OVERLAP_SAMPLES)
+      chunkStarts.push_back(pos);
+
+    const size_t numChunks = chunkStarts.size();
+    std::vector<std::vector<float>> results(numChunks);
+    std::vector<bool> finished(numChunks, false);
+    std::atomic<bool> failed{false};
+
+    std::mutex stitchMutex;
+    size_t nextToStitch = 0;
     std::vector<float> allF0;
-    int pos = 0;
-    int totalSamples = static_cast<int>(audio16k.size());
-
-    while (pos < totalSamples) {
-      int chunkEnd = std::min(pos + MAX_CHUNK_SAMPLES, totalSamples);
-      int chunkSize = chunkEnd - pos;
-
-      auto chunkF0 =
-          extractF0Chunk(audio16k.data() + pos, chunkSize, threshold);
-
-      if (pos == 0) {
-        // First chunk: use all frames
-        allF0 = std::move(chunkF0);
-      } else {
-        // Subsequent chunks: skip overlap frames
-        int overlapFrames = OVERLAP_SAMPLES / HOP_SIZE;
-        if (static_cast<int>(chunkF0.size()) > overlapFrames) {
-          allF0.insert(allF0.end(), chunkF0.begin() + overlapFrames,
-                       chunkF0.end());
+
+    // Caller holds stitchMutex
+    auto stitchReady = [&]() {
+      while (nextToStitch < numChunks && finished[nextToStitch]) {
+        auto &chunkF0 = results[nextToStitch];
+        // First chunk: use all frames; later ones skip the overlap frames
+        const size_t skip = nextToStitch == 0 ? 0 : OVERLAP_FRAMES;
+        if (chunkF0.size() > skip) {
+          const size_t startFrame = allF0.size();
+          allF0.insert(allF0.end(), chunkF0.begin() + skip, chunkF0.end());
+          if (onChunk)
+            onChunk(static_cast<int>(startFrame),
+                    std::vector<float>(allF0.begin() + startFrame,
+                                       allF0.end()));
         }
+        std::vector<float>().swap(chunkF0);
+        ++nextToStitch;
       }
-
-      pos += MAX_CHUNK_SAMPLES - OVERLAP_SAMPLES;
-    }
+    };
+
+    InferenceScheduler::getInstance().forEachRun(
+        static_cast<int>(numChunks),
+        [&](size_t index) {
+          if (failed.load())
+            return;
+
+          const int pos = chunkStarts[index];
+          const int chunkSize =
+              std::min(pos + MAX_CHUNK_SAMPLES, totalSamples) - pos;
+          std::vector<float> chunkF0;
+          try {
+            chunkF0 =
+                extractF0Chunk(audio16k.data() + pos, chunkSize, threshold);
+          } catch (const std::exception &e) {
+            DBG("RMVPE chunk " << static_cast<int>(index)
+                               << " failed: " << e.what());
+            failed = true;
+            return;
+          }
+
+          std::lock_guard<std::mutex> lock(stitchMutex);
+          results[index] = std::move(chunkF0);
+          finished[index] = true;
+          stitchReady();
+        },
+        cancelFlag);
+
+    if (failed.load() || isCancelled())
+      return {};
 
     return allF0;
   } catch (const Ort::Exception &e) {
@@ -291,6 +343,8 @@ std::vector<float> RMVPEPitchDetector::extractF0Chunk(const float *audio16k,
   inputTensors.push_back(std::move(waveformTensor));
   inputTensors.push_back(std::move(thresholdTensor));
 
+  auto runSlot = InferenceScheduler::getInstance().acquireRunSlot(
+      InferencePriority::Analysis);
   auto outputTensors = onnxSession->Run(
       Ort::RunOptions{nullptr}, inputNames.data(), inputTensors.data(),
       inputTensors.size(), outputNames.data(), outputNames.size());
@@ -306,6 +360,190 @@ std::vector<float> RMVPEPitchDetector::extractF0Chunk(const float *audio16k,
 #endif
 }
 
+std::vector<std::vector<float>>
+RMVPEPitchDetector::extractF0Rows(const std::vector<float> &rows, int batchSize,
+                                  int rowSamples, float threshold) {
+#ifdef HAVE_ONNXRUNTIME
+  std::array<int64_t, 2> waveformShape = {static_cast<int64_t>(batchSize),
+                                          static_cast<int64_t>(rowSamples)};
+
+  Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(
+      OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+
+  Ort::Value waveformTensor = Ort::Value::CreateTensor<float>(
+      memoryInfo, const_cast<float *>(rows.data()), rows.size(),
+      waveformShape.data(), waveformShape.size());
+
+  std::array<int64_t, 1> thresholdShape = {1};
+  std::vector<float> thresholdData = {threshold};
+  Ort::Value thresholdTensor = Ort::Value::CreateTensor<float>(
+      memoryInfo, thresholdData.data(), 1, thresholdShape.data(),
+      thresholdShape.size());
+
+  std::vector<Ort::Value> inputTensors;
+  inputTensors.push_back(std::move(waveformTensor));
+  inputTensors.push_back(std::move(thresholdTensor));
+
+  auto runSlot = InferenceScheduler::getInstance().acquireRunSlot(
+      InferencePriority::Analysis);
+  auto outputTensors = onnxSession->Run(
+      Ort::RunOptions{nullptr}, inputNames.data(), inputTensors.data(),
+      inputTensors.size(), outputNames.data(), outputNames.size());
+
+  // f0 [B, n_frames]
+  const float *f0Data = outputTensors[0].GetTensorMutableData<float>();
+  auto f0Shape = outputTensors[0].GetTensorTypeAndShapeInfo().GetShape();
+  if (f0Shape.size() != 2 || f0Shape[0] != batchSize)
+    throw std::runtime_error("unexpected RMVPE batch output shape");
+
+  const int numFrames = static_cast<int>(f0Shape[1]);
+  std::vector<std::vector<float>> result(static_cast<size_t>(batchSize));
+  for (int b = 0; b < batchSize; ++b)
+    result[b].assign(f0Data + static_cast<size_t>(b) * numFrames,
+                     f0Data + static_cast<size_t>(b + 1) * numFrames);
+  return result;
+#else
+  return {};
+#endif
+}
+
+std::vector<std::vector<float>>
+RMVPEPitchDetector::extractF0Batch(const std::vector<Clip> &clips,
+                                   float threshold,
+                                   const std::atomic<bool> *cancelFlag) {
+#ifdef HAVE_ONNXRUNTIME
+  if (!loaded) {
+    DBG("RMVPE model not loaded");
+    return {};
+  }
+
+  // Rough peak activation footprint of the U-Net and BiGRU per 10 ms frame
+  constexpr size_t BYTES_PER_FRAME = 96 * 1024;
+  constexpr int MAX_BATCH = 32;
+  // Let rows in one batch differ in length by at most a quarter
+  constexpr double MAX_PADDING_RATIO = 1.25;
+
+  auto isCancelled = [cancelFlag]() {
+    return cancelFlag != nullptr && cancelFlag->load();
+  };
+
+  std::vector<std::vector<float>> results(clips.size());
+  std::vector<std::vector<float>> audio16k(clips.size());
+  std::vector<size_t> order;
+
+  for (size_t i = 0; i < clips.size(); ++i) {
+    const auto &clip = clips[i];
+    if (clip.audio == nullptr || clip.numSamples <= 0)
+      continue;
+    if (static_cast<int64_t>(clip.numSamples) * SAMPLE_RATE >
+        static_cast<int64_t>(MAX_CHUNK_SAMPLES) * clip.sampleRate) {
+      // Long clips already run as parallel chunks
+      results[i] = extractF0(clip.audio, clip.numSamples, clip.sampleRate,
+                             threshold, cancelFlag);
+      if (isCancelled())
+        return {};
+      continue;
+    }
+    audio16k[i] = resampleTo16k(clip.audio, clip.numSamples, clip.sampleRate);
+    if (!audio16k[i].empty())
+      order.push_back(i);
+  }
+
+  // Sort by length so neighbours pad each other as little as possible
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return audio16k[a].size() < audio16k[b].size();
+  });
+
+  struct Batch {
+    size_t first;
+    size_t count;
+  };
+  std::vector<Batch> batches;
+  for (size_t begin = 0; begin < order.size();) {
+    const size_t shortest = audio16k[order[begin]].size();
+    // Size the batch once, for the longest row the padding limit admits
+    const auto longestAllowed = static_cast<size_t>(
+        static_cast<double>(shortest) * MAX_PADDING_RATIO);
+    const auto maxBatch = static_cast<size_t>(SystemMemory::fitBatchSize(
+        (longestAllowed / HOP_SIZE + 1) * BYTES_PER_FRAME, MAX_BATCH));
+    size_t end = begin + 1;
+    while (end < order.size() && end - begin < maxBatch &&
+           audio16k[order[end]].size() <= longestAllowed)
+      ++end;
+    batches.push_back({begin, end - begin});
+    begin = end;
+  }
+
+  std::atomic<bool> failed{false};
+
+  auto runSingly = [&](const Batch &batch) {
+    for (size_t k = 0; k < batch.count && !isCancelled(); ++k) {
+      const size_t index = order[batch.first + k];
+      results[index] = extractF0Chunk(
+          audio16k[index].data(), static_cast<int>(audio16k[index].size()),
+          threshold);
+    }
+  };
+
+  InferenceScheduler::getInstance().forEachRun(
+      static_cast<int>(batches.size()),
+      [&](size_t b) {
+        if (failed.load())
+          return;
+
+        const auto &batch = batches[b];
+        try {
+          if (batch.count == 1 || !batchSupported.load()) {
+            runSingly(batch);
+            return;
+          }
+
+          const size_t rowSamples =
+              audio16k[order[batch.first + batch.count - 1]].size();
+          std::vector<float> rows(batch.count * rowSamples, 0.0f);
+          for (size_t k = 0; k < batch.count; ++k) {
+            const auto &clipAudio = audio16k[order[batch.first + k]];
+            std::copy(clipAudio.begin(), clipAudio.end(),
+                      rows.begin() + k * rowSamples);
+          }
+
+          std::vector<std::vector<float>> f0Rows;
+          try {
+            f0Rows = extractF0Rows(rows, static_cast<int>(batch.count),
+                                   static_cast<int>(rowSamples), threshold);
+          } catch (const Ort::Exception &e) {
+            // Models exported with a fixed batch dimension of 1 end up here
+            DBG("RMVPE: batched run failed, falling back to single clips: "
+                << e.what());
+            batchSupported = false;
+            runSingly(batch);
+            return;
+          }
+
+          for (size_t k = 0; k < batch.count; ++k) {
+            const size_t index = order[batch.first + k];
+            auto &f0 = f0Rows[k];
+            const size_t numFrames = audio16k[index].size() / HOP_SIZE + 1;
+            f0.resize(std::min(f0.size(), numFrames));
+            results[index] = std::move(f0);
+          }
+        } catch (const std::exception &e) {
+          DBG("RMVPE batch " << static_cast<int>(b) << " failed: " << e.what());
+          failed = true;
+        }
+      },
+      cancelFlag);
+
+  if (failed.load() || isCancelled())
+    return {};
+
+  return results;
+#else
+  DBG("ONNX Runtime not available");
+  return {};
+#endif
+}
+
 std::vector<float> RMVPEPitchDetector::extractF0WithProgress(
     const float *audio, int numSamples, int sampleRate, float threshold,
     std::function<void(double)> progressCallback) {
@@ -351,6 +589,8 @@ std::vector<float> RMVPEPitchDetector::extractF0WithProgress(
     inputTensors.push_back(std::move(waveformTensor));
     inputTensors.push_back(std::move(thresholdTensor));
 
+    auto runSlot = InferenceScheduler::getInstance().acquireRunSlot(
+        InferencePriority::Analysis);
     auto outputTensors = onnxSession->Run(
         Ort::RunOptions{nullptr}, inputNames.data(), inputTensors.data(),
         inputTensors.size(), outputNames.data(), outputNames.size());
@@ -2,6 +2,8 @@
 
 #include "../JuceHeader.h"
 #include "FCPEPitchDetector.h"  // For GPUProvider enum
+#include <atomic>
+#include <functional>
 #include <vector>
 #include <memory>
 
@@ -34,6 +36,9 @@ public:
     static constexpr float RMVPE_CONST = 1997.3794084376191f;  // Renamed from CONST to avoid Windows macro conflict
     static constexpr float DEFAULT_THRESHOLD = 0.03f;
 
+    /** Receives final F0 frames [startFrame, startFrame + f0.size()). */
+    using ChunkCallback = std::function<void(int startFrame, const std::vector<float>& f0)>;
+
     RMVPEPitchDetector();
     ~RMVPEPitchDetector();
 
@@ -53,6 +58,11 @@ public:
      */
     bool isLoaded() const { return loaded; }
 
+    /**
+     * Model file the current session was loaded from (used to key caches).
+     */
+    juce::File getModelFile() const { return modelFile; }
+
     /**
      * Extract F0 from audio buffer.
      * The audio will be resampled to 16kHz internally.
@@ -60,11 +70,48 @@ public:
      * @param audio Audio samples
      * @param numSamples Number of samples
      * @param sampleRate Original sample rate
+     * Long audio is split into overlapping 30 s chunks that run concurrently,
+     * up to the analysis share of InferenceScheduler's run slots. onChunk is
+     * called in frame order as each stretch of the result becomes final, from
+     * whichever worker completed it, never from two threads at once.
+     *
      * @param threshold Confidence threshold (default 0.03)
-     * @return F0 values in Hz (0 for unvoiced frames)
+     * @param cancelFlag Checked between chunks; may be null
+     * @param onChunk Optional ordered partial-result callback
+     * @return F0 values in Hz (0 for unvoiced frames), empty if cancelled
      */
     std::vector<float> extractF0(const float* audio, int numSamples,
-                                 int sampleRate, float threshold = DEFAULT_THRESHOLD);
+                                 int sampleRate, float threshold = DEFAULT_THRESHOLD,
+                                 const std::atomic<bool>* cancelFlag = nullptr,
+                                 const ChunkCallback& onChunk = nullptr);
+
+    /** One clip for extractF0Batch. */
+    struct Clip {
+        const float* audio = nullptr;
+        int numSamples = 0;
+        int sampleRate = SAMPLE_RATE;
+    };
+
+    /**
+     * Extract F0 for many clips, running clips of similar length together as
+     * one [B, T] tensor. Shorter clips in a batch are zero-padded at the end
+     * and their output trimmed. The model has no padding mask: the backward
+     * pass of its BiGRU starts in the padded silence instead of at the clip's
+     * last frame, so F0 toward the end of a padded clip can differ slightly
+     * from extractF0 on the same clip (padding is bounded to a quarter of
+     * the clip; hachitune_bench reports the deviation). Use
+     * extractF0 where results must match the editor exactly. B is capped by
+     * an estimate of the batch's memory against what the system has free.
+     * Clips longer than one extractF0 chunk go through extractF0 on their
+     * own. If the model rejects a batch dimension above 1, every clip is
+     * run singly from then on.
+     *
+     * @param cancelFlag Checked between batches; may be null
+     * @return One F0 curve per clip, in input order; empty if cancelled
+     */
+    std::vector<std::vector<float>> extractF0Batch(const std::vector<Clip>& clips,
+                                                   float threshold = DEFAULT_THRESHOLD,
+                                                   const std::atomic<bool>* cancelFlag = nullptr);
 
     /**
      * Extract F0 with progress callback.
@@ -90,13 +137,24 @@ public:
 
 private:
     bool loaded = false;
+    juce::File modelFile;
 
     // Resample audio to 16kHz
     std::vector<float> resampleTo16k(const float* audio, int numSamples, int srcRate);
 
+    // Max chunk: 30 seconds at 16kHz
+    static constexpr int MAX_CHUNK_SAMPLES = SAMPLE_RATE * 30;
+
     // Process a single chunk of 16kHz audio
     std::vector<float> extractF0Chunk(const float* audio16k, int numSamples, float threshold);
 
+    // Run equal-length rows of 16kHz audio as one [B, T] tensor; returns the
+    // first numFrames of each row's F0
+    std::vector<std::vector<float>> extractF0Rows(const std::vector<float>& rows, int batchSize,
+                                                  int rowSamples, float threshold);
+
+    std::atomic<bool> batchSupported{true};
+
     // Decode hidden states to F0 (matching Python decode function)
     std::vector<float> decodeF0(const float* hidden, int numFrames, float threshold);
 
@@ -1,5 +1,7 @@
 #include "RealtimePitchProcessor.h"
+#include "../Utils/RealtimeCheck.h"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 
 RealtimePitchProcessor::RealtimePitchProcessor() = default;
@@ -12,7 +14,7 @@ RealtimePitchProcessor::~RealtimePitchProcessor() {
 
 void RealtimePitchProcessor::setProject(Project *proj) {
   {
-    const juce::ScopedLock sl(bufferLock);
+    const juce::ScopedLock sl(projectLock);
     project = proj;
   }
   invalidate();
@@ -20,7 +22,7 @@ void RealtimePitchProcessor::setProject(Project *proj) {
 
 void RealtimePitchProcessor::setVocoder(Vocoder *voc) {
   {
-    const juce::ScopedLock sl(bufferLock);
+    const juce::ScopedLock sl(projectLock);
     vocoder = voc;
   }
   // Don't call invalidate() here - wait for project to be set first
@@ -28,18 +30,20 @@ void RealtimePitchProcessor::setVocoder(Vocoder *voc) {
 }
 
 void RealtimePitchProcessor::prepareToPlay(double sr, int) {
-  sampleRate = sr;
+  sampleRate.store(sr);
   position.store(0.0);
 }
 
 bool RealtimePitchProcessor::processBlock(
     juce::AudioBuffer<float> &input, juce::AudioBuffer<float> &output,
     const juce::AudioPlayHead::PositionInfo *posInfo) {
+  const double hostRate = sampleRate.load();
+
   // Get position from host (don't store - let host control position)
   double pos = 0.0;
   if (posInfo) {
     if (auto time = posInfo->getTimeInSamples())
-      pos = static_cast<double>(*time) / sampleRate;
+      pos = static_cast<double>(*time) / hostRate;
     else if (auto time = posInfo->getTimeInSeconds())
       pos = *time;
   }
@@ -47,45 +51,42 @@ bool RealtimePitchProcessor::processBlock(
 
   // Passthrough if not ready
   if (!ready.load()) {
-    output.makeCopyOf(input);
+    output.makeCopyOf(input, true);
     return false;
   }
 
   const int numSamples = output.getNumSamples();
   const int numChannels = output.getNumChannels();
-  auto posSamples = static_cast<juce::int64>(pos * sampleRate);
-
-  // Copy from processed buffer
-  {
-    const juce::ScopedLock sl(bufferLock);
+  auto posSamples = static_cast<juce::int64>(pos * hostRate);
 
-    if (processedBuffer.getNumSamples() == 0) {
-      output.makeCopyOf(input);
-      return false;
-    }
+  // Writers wait for this scope to end before touching the buffer we read
+  const AudioReadScope readScope(audioReadEpoch);
+  const auto &processed = liveBuffer.load()->audio;
 
-    int available =
-        processedBuffer.getNumSamples() - static_cast<int>(posSamples);
-    if (posSamples < 0 || available <= 0) {
-      output.makeCopyOf(input);
-      return false;
-    }
+  if (processed.getNumSamples() == 0) {
+    output.makeCopyOf(input, true);
+    return false;
+  }
 
-    int toCopy = std::min(numSamples, available);
-    int channelsToCopy =
-        std::min(numChannels, processedBuffer.getNumChannels());
+  int available = processed.getNumSamples() - static_cast<int>(posSamples);
+  if (posSamples < 0 || available <= 0) {
+    output.makeCopyOf(input, true);
+    return false;
+  }
 
-    for (int ch = 0; ch < channelsToCopy; ++ch) {
-      output.copyFrom(ch, 0, processedBuffer, ch, static_cast<int>(posSamples),
-                      toCopy);
-      if (toCopy < numSamples)
-        output.clear(ch, toCopy, numSamples - toCopy);
-    }
+  int toCopy = std::min(numSamples, available);
+  int channelsToCopy = std::min(numChannels, processed.getNumChannels());
 
-    for (int ch = channelsToCopy; ch < numChannels; ++ch)
-      output.clear(ch, 0, numSamples);
+  for (int ch = 0; ch < channelsToCopy; ++ch) {
+    output.copyFrom(ch, 0, processed, ch, static_cast<int>(posSamples),
+                    toCopy);
+    if (toCopy < numSamples)
+      output.clear(ch, toCopy, numSamples - toCopy);
   }
 
+  for (int ch = channelsToCopy; ch < numChannels; ++ch)
+    output.clear(ch, 0, numSamples);
+
   return true;
 }
 
@@ -95,17 +96,9 @@ void RealtimePitchProcessor::invalidate() {
   DBG("RealtimePitchProcessor::invalidate() called");
 
   Project *proj = nullptr;
-  juce::AudioBuffer<float> waveformSnapshot;
-  int srcSampleRate = 0;
-
   {
-    const juce::ScopedLock sl(bufferLock);
+    const juce::ScopedLock sl(projectLock);
     proj = project;
-    if (proj) {
-      auto &audioData = proj->getAudioData();
-      waveformSnapshot.makeCopyOf(audioData.waveform);
-      srcSampleRate = audioData.sampleRate;
-    }
   }
 
   if (!proj) {
@@ -113,65 +106,155 @@ void RealtimePitchProcessor::invalidate() {
     return;
   }
 
-  // Safety check: verify waveform has valid dimensions before accessing
-  const int numSamples = waveformSnapshot.getNumSamples();
-  const int numChannels = waveformSnapshot.getNumChannels();
+  const std::lock_guard<std::mutex> lock(writerMutex);
+  if (rebuildFromProject(*proj))
+    ready = true;
+}
 
-  if (numSamples <= 0 || numChannels <= 0) {
-    DBG("  -> Skipped: waveform is empty or invalid (samples="
-        << numSamples << ", channels=" << numChannels << ")");
+void RealtimePitchProcessor::invalidateRange(int startSample, int numSamples) {
+  if (numSamples <= 0)
+    return;
+
+  Project *proj = nullptr;
+  {
+    const juce::ScopedLock sl(projectLock);
+    proj = project;
+  }
+  if (!proj)
+    return;
+
+  const std::lock_guard<std::mutex> lock(writerMutex);
+
+  const auto &audioData = proj->getAudioData();
+  const auto &waveform = audioData.waveform;
+  const int srcSamples = waveform.getNumSamples();
+  const int numChannels = waveform.getNumChannels();
+  const int srcSampleRate = audioData.sampleRate;
+  const double dstSampleRate = sampleRate.load();
+  const bool direct = srcSampleRate <= 0 ||
+                      srcSampleRate == static_cast<int>(dstSampleRate);
+
+  // Anything other than a same-shaped waveform needs a full rebuild
+  auto *standby = getStandbyBuffer();
+  const int expectedLength =
+      direct ? srcSamples
+             : getResampler(srcSampleRate).getOutputLength(srcSamples);
+  if (!ready.load() || srcSampleRate != builtSourceRate ||
+      dstSampleRate != builtTargetRate ||
+      standby->audio.getNumSamples() != expectedLength ||
+      standby->audio.getNumChannels() != numChannels) {
+    ready = false;
+    if (rebuildFromProject(*proj))
+      ready = true;
     return;
   }
 
+  const int srcStart = std::clamp(startSample, 0, srcSamples);
+  const int srcEnd = std::clamp(startSample + numSamples, srcStart, srcSamples);
+  auto [outStart, outEnd] =
+      direct ? std::make_pair(srcStart, srcEnd)
+             : resampler->getAffectedOutputRange(srcStart, srcEnd,
+                                                 expectedLength);
+  if (outEnd <= outStart)
+    return;
+
+  // The kernel reads past the edited span, so the result joins seamlessly
+  // with the untouched samples on either side
+  for (int ch = 0; ch < numChannels; ++ch) {
+    if (direct)
+      standby->audio.copyFrom(ch, outStart, waveform, ch, outStart,
+                              outEnd - outStart);
+    else
+      resampler->process(waveform.getReadPointer(ch), srcSamples,
+                         standby->audio.getWritePointer(ch), outStart,
+                         outEnd);
+  }
+
+  publishStandby();
+
+  const auto &live = liveBuffer.load()->audio;
+  auto &stale = getStandbyBuffer()->audio;
+  for (int ch = 0; ch < numChannels; ++ch)
+    stale.copyFrom(ch, outStart, live, ch, outStart, outEnd - outStart);
+
+  DBG("RealtimePitchProcessor::invalidateRange: refreshed "
+      << (outEnd - outStart) << " samples at " << outStart);
+}
+
+RealtimePitchProcessor::ProcessedBuffer *
+RealtimePitchProcessor::getStandbyBuffer() {
+  return liveBuffer.load() == &buffers[0] ? &buffers[1] : &buffers[0];
+}
+
+void RealtimePitchProcessor::publishStandby() {
+  RealtimeCheck::checkNotRealtime("waiting for the audio thread");
+
+  liveBuffer.store(getStandbyBuffer());
+
+  // Grace period: a block that began before the swap may still be reading
+  // the previous buffer. Any block starting now sees the new one.
+  const auto epoch = audioReadEpoch.load();
+  if ((epoch & 1) == 0)
+    return;
+  while (audioReadEpoch.load() == epoch)
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+}
+
+void RealtimePitchProcessor::publishFull(juce::AudioBuffer<float> &&audio) {
+  getStandbyBuffer()->audio = std::move(audio);
+  publishStandby();
+  getStandbyBuffer()->audio.makeCopyOf(liveBuffer.load()->audio, true);
+}
+
+bool RealtimePitchProcessor::rebuildFromProject(Project &proj) {
   // Use the already-synthesized waveform from project (updated by
   // resynthesizeIncremental) This avoids duplicate synthesis and ensures
   // consistency with standalone mode
-  const int dstSampleRate = static_cast<int>(sampleRate);
+  const auto &audioData = proj.getAudioData();
+  const auto &waveform = audioData.waveform;
+  const int numSamples = waveform.getNumSamples();
+  const int numChannels = waveform.getNumChannels();
+
+  if (numSamples <= 0 || numChannels <= 0) {
+    DBG("  -> Skipped: waveform is empty or invalid (samples="
+        << numSamples << ", channels=" << numChannels << ")");
+    return false;
+  }
+
+  const int srcSampleRate = audioData.sampleRate;
+  const double dstSampleRate = sampleRate.load();
 
   DBG("  -> srcSampleRate=" << srcSampleRate
                             << ", dstSampleRate=" << dstSampleRate);
 
-  if (srcSampleRate == dstSampleRate || srcSampleRate <= 0) {
+  juce::AudioBuffer<float> processed;
+  if (srcSampleRate <= 0 || srcSampleRate == static_cast<int>(dstSampleRate)) {
     // No resampling needed
-    const juce::ScopedLock sl(bufferLock);
-    processedBuffer.makeCopyOf(waveformSnapshot);
-    ready = true;
-    DBG("  -> Using project waveform directly, samples="
-        << processedBuffer.getNumSamples());
+    processed.makeCopyOf(waveform);
+    DBG("  -> Using project waveform directly, samples=" << numSamples);
   } else {
-    // Resample to host sample rate
-    const double ratio = static_cast<double>(srcSampleRate) / dstSampleRate;
-    const int srcSamples = waveformSnapshot.getNumSamples();
-    const int dstSamples = static_cast<int>(srcSamples / ratio);
-    const int numChannels = waveformSnapshot.getNumChannels();
-
-    juce::AudioBuffer<float> resampled(numChannels, dstSamples);
-
-    for (int ch = 0; ch < numChannels; ++ch) {
-      const float *src = waveformSnapshot.getReadPointer(ch);
-      float *dst = resampled.getWritePointer(ch);
-
-      for (int i = 0; i < dstSamples; ++i) {
-        const double srcPos = i * ratio;
-        const int srcIndex = static_cast<int>(srcPos);
-        const double frac = srcPos - srcIndex;
-
-        if (srcIndex + 1 < srcSamples)
-          dst[i] = static_cast<float>(src[srcIndex] * (1.0 - frac) +
-                                      src[srcIndex + 1] * frac);
-        else if (srcIndex < srcSamples)
-          dst[i] = src[srcIndex];
-        else
-          dst[i] = 0.0f;
-      }
-    }
-
-    const juce::ScopedLock sl(bufferLock);
-    processedBuffer = std::move(resampled);
-    ready = true;
-    DBG("  -> Resampled from " << srcSamples << " to " << dstSamples
+    const auto &rs = getResampler(srcSampleRate);
+    const int dstSamples = rs.getOutputLength(numSamples);
+    processed.setSize(numChannels, dstSamples);
+    for (int ch = 0; ch < numChannels; ++ch)
+      rs.process(waveform.getReadPointer(ch), numSamples,
+                 processed.getWritePointer(ch), 0, dstSamples);
+    DBG("  -> Resampled from " << numSamples << " to " << dstSamples
                                << " samples");
   }
+
+  publishFull(std::move(processed));
+  builtSourceRate = srcSampleRate;
+  builtTargetRate = dstSampleRate;
+  return true;
+}
+
+const SincResampler &RealtimePitchProcessor::getResampler(int sourceRate) {
+  const double targetRate = sampleRate.load();
+  if (!resampler || resampler->getSourceRate() != sourceRate ||
+      resampler->getTargetRate() != targetRate)
+    resampler = std::make_unique<SincResampler>(sourceRate, targetRate);
+  return *resampler;
 }
 
 void RealtimePitchProcessor::startComputation() {
@@ -203,13 +286,13 @@ void RealtimePitchProcessor::computeInBackground() {
 
   Project *proj = nullptr;
   Vocoder *voc = nullptr;
-  std::vector<std::vector<float>> melSnapshot;
+  MelMatrix melSnapshot;
   std::vector<float> adjustedF0Snapshot;
   int numChannelsSnapshot = 1;
   float volumeDbSnapshot = 0.0f;
 
   {
-    const juce::ScopedLock sl(bufferLock);
+    const juce::ScopedLock sl(projectLock);
     proj = project;
     voc = vocoder;
 
@@ -254,7 +337,9 @@ void RealtimePitchProcessor::computeInBackground() {
   DBG("  -> Starting vocoder synthesis...");
   std::vector<float> synthesized;
   try {
-    synthesized = voc->infer(melSnapshot, adjustedF0Snapshot);
+    synthesized = voc->inferChunked(melSnapshot, adjustedF0Snapshot,
+                                    &cancelCompute,
+                                    InferencePriority::PlaybackAhead);
   } catch (...) {
     DBG("  -> Vocoder exception!");
     computing = false;
@@ -283,13 +368,14 @@ void RealtimePitchProcessor::computeInBackground() {
   if (volumeDb != 0.0f)
     output.applyGain(std::pow(10.0f, volumeDb / 20.0f));
 
-  // Update buffer directly (with lock)
+  // Publish through the same double buffer as invalidate()
   if (!cancelCompute.load()) {
-    const juce::ScopedLock sl(bufferLock);
-    processedBuffer = std::move(output);
+    const std::lock_guard<std::mutex> lock(writerMutex);
+    publishFull(std::move(output));
+    builtSourceRate = 0; // Not resampled; the next edit rebuilds in full
+    builtTargetRate = 0.0;
     ready = true;
-    DBG("  -> Buffer updated, ready=true, samples="
-        << processedBuffer.getNumSamples());
+    DBG("  -> Buffer updated, ready=true, samples=" << numSamples);
   }
   computing = false;
 }
@@ -2,14 +2,22 @@
 
 #include "../JuceHeader.h"
 #include "../Models/Project.h"
+#include "../Utils/SincResampler.h"
 #include "Vocoder.h"
 #include <atomic>
 #include <memory>
+#include <mutex>
 #include <thread>
 
 /**
  * Real-time pitch correction processor
  * Pre-computes processed audio in background, provides real-time playback
+ *
+ * The processed audio is double-buffered like AudioEngine's waveform:
+ * processBlock reads the live buffer without locking, and writers update
+ * the standby buffer, swap, wait out any block still reading the old one,
+ * then bring it up to date. After an incremental edit only the resynthesized
+ * span is resampled and copied.
  */
 class RealtimePitchProcessor {
 public:
@@ -33,24 +41,58 @@ public:
      */
     void invalidate();
 
+    /**
+     * Refresh only project waveform samples [startSample, startSample +
+     * numSamples), at the project sample rate. Falls back to a full
+     * invalidate() if the processed audio no longer matches the project.
+     * Safe to call from any non-audio thread.
+     */
+    void invalidateRange(int startSample, int numSamples);
+
     bool isReady() const { return ready.load(); }
     double getPosition() const { return position.load(); }
     void setPosition(double positionSeconds) { position.store(positionSeconds); }
 
 private:
+    struct ProcessedBuffer {
+        juce::AudioBuffer<float> audio;
+    };
+
+    /** Scoped marker for a processBlock call that may read the live buffer. */
+    struct AudioReadScope {
+        explicit AudioReadScope(std::atomic<uint64_t>& e) : epoch(e) { ++epoch; }
+        ~AudioReadScope() { ++epoch; }
+        std::atomic<uint64_t>& epoch;
+    };
+
     void startComputation();
     void computeInBackground();
 
+    // Writer helpers; caller holds writerMutex
+    ProcessedBuffer* getStandbyBuffer();
+    void publishStandby();
+    void publishFull(juce::AudioBuffer<float>&& audio);
+    bool rebuildFromProject(Project& proj);
+    const SincResampler& getResampler(int sourceRate);
+
     Project* project = nullptr;
     Vocoder* vocoder = nullptr;
-    double sampleRate = 44100.0;
+    std::atomic<double> sampleRate{44100.0};
+
+    ProcessedBuffer buffers[2];
+    std::atomic<ProcessedBuffer*> liveBuffer{&buffers[0]};
+    std::atomic<uint64_t> audioReadEpoch{0}; // Odd while processBlock reads
+    std::mutex writerMutex; // Serialises writers; never taken on audio thread
+    std::unique_ptr<SincResampler> resampler;
+    // Rates the processed audio was built for; 0 when it came from elsewhere
+    int builtSourceRate = 0;
+    double builtTargetRate = 0.0;
 
-    juce::AudioBuffer<float> processedBuffer;
     std::atomic<bool> ready{false};
     std::atomic<bool> computing{false};
     std::atomic<bool> cancelCompute{false};
     std::atomic<double> position{0.0};
 
-    juce::CriticalSection bufferLock;
+    juce::CriticalSection projectLock; // Guards project and vocoder
     std::unique_ptr<std::thread> computeThread;
 };
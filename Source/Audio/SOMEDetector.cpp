@@ -1,9 +1,11 @@
 #include "SOMEDetector.h"
+#include "Inference/InferenceScheduler.h"
 #include "../Utils/Localization.h"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <juce_core/juce_core.h>
+#include <mutex>
 #include <numeric>
 
 SOMEDetector::SOMEDetector() = default;
@@ -104,6 +106,7 @@ bool SOMEDetector::loadModel(const juce::File &modelPath, GPUProvider provider,
     for (const auto &name : outputNameStrings)
       outputNames.push_back(name.c_str());
 
+    modelFile = modelPath;
     loaded = true;
     DBG("SOME model loaded: " << inputNameStrings.size() << " inputs, "
                               << outputNameStrings.size() << " outputs");
@@ -251,26 +254,27 @@ SOMEDetector::sliceAudio(const std::vector<float> &samples) const {
   return chunks;
 }
 
-bool SOMEDetector::inferChunk(const std::vector<float> &chunk,
-                              std::vector<float> &midi, std::vector<bool> &rest,
-                              std::vector<float> &dur) {
+bool SOMEDetector::inferChunk(const float *samples, size_t numSamples,
+                              ChunkOutput &out) {
 #ifdef HAVE_ONNXRUNTIME
   if (!onnxSession)
     return false;
 
   try {
-    std::vector<int64_t> shape = {1, static_cast<int64_t>(chunk.size())};
+    std::vector<int64_t> shape = {1, static_cast<int64_t>(numSamples)};
     Ort::MemoryInfo memInfo =
         Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
 
-    std::vector<float> chunkCopy = chunk;
+    // The tensor only wraps the caller's samples; inputs are never written
     Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
-        memInfo, chunkCopy.data(), chunkCopy.size(), shape.data(),
+        memInfo, const_cast<float *>(samples), numSamples, shape.data(),
         shape.size());
 
     std::vector<Ort::Value> inputTensors;
     inputTensors.push_back(std::move(inputTensor));
 
+    auto runSlot = InferenceScheduler::getInstance().acquireRunSlot(
+        InferencePriority::Analysis);
     auto outputs = onnxSession->Run(Ort::RunOptions{nullptr}, inputNames.data(),
                                     inputTensors.data(), inputTensors.size(),
                                     outputNames.data(), outputNames.size());
@@ -280,9 +284,9 @@ bool SOMEDetector::inferChunk(const std::vector<float> &chunk,
     float *durData = outputs[2].GetTensorMutableData<float>();
 
     size_t count = outputs[0].GetTensorTypeAndShapeInfo().GetElementCount();
-    midi.assign(midiData, midiData + count);
-    rest.assign(restData, restData + count);
-    dur.assign(durData, durData + count);
+    out.midi.assign(midiData, midiData + count);
+    out.rest.assign(restData, restData + count);
+    out.dur.assign(durData, durData + count);
 
     return true;
   } catch (const Ort::Exception &e) {
@@ -294,6 +298,69 @@ bool SOMEDetector::inferChunk(const std::vector<float> &chunk,
 #endif
 }
 
+bool SOMEDetector::inferChunksInOrder(const std::vector<float> &waveform,
+                                      const MarkerList &chunks,
+                                      const ChunkHandler &onChunk,
+                                      const std::atomic<bool> *cancelFlag) {
+  const int64_t totalSize = static_cast<int64_t>(waveform.size());
+  MarkerList ranges;
+  ranges.reserve(chunks.size());
+  for (const auto &[beginFrame, endFrame] : chunks) {
+    if (endFrame <= beginFrame || beginFrame >= totalSize)
+      continue;
+    ranges.emplace_back(beginFrame, std::min(endFrame, totalSize));
+  }
+
+  const size_t numChunks = ranges.size();
+  std::vector<ChunkOutput> results(numChunks);
+  std::vector<bool> succeeded(numChunks, false);
+  std::vector<bool> finished(numChunks, false);
+  std::atomic<bool> stopped{false};
+
+  std::mutex stitchMutex;
+  size_t nextToStitch = 0;
+
+  auto isCancelled = [&]() {
+    return cancelFlag != nullptr && cancelFlag->load();
+  };
+
+  // Caller holds stitchMutex
+  auto stitchReady = [&]() {
+    while (nextToStitch < numChunks && finished[nextToStitch] &&
+           !stopped.load()) {
+      const auto &[begin, end] = ranges[nextToStitch];
+      if (isCancelled() ||
+          !onChunk(begin, end, succeeded[nextToStitch], results[nextToStitch]))
+        stopped = true;
+      results[nextToStitch] = {};
+      ++nextToStitch;
+    }
+  };
+
+  // Silence-delimited chunks are independent; only the note placement in
+  // onChunk depends on the previous chunk, so inference runs out of order
+  InferenceScheduler::getInstance().forEachRun(
+      static_cast<int>(numChunks),
+      [&](size_t index) {
+        if (stopped.load())
+          return;
+
+        const auto &[begin, end] = ranges[index];
+        ChunkOutput out;
+        const bool ok = inferChunk(waveform.data() + begin,
+                                   static_cast<size_t>(end - begin), out);
+
+        std::lock_guard<std::mutex> lock(stitchMutex);
+        results[index] = std::move(out);
+        succeeded[index] = ok;
+        finished[index] = true;
+        stitchReady();
+      },
+      cancelFlag);
+
+  return !stopped.load() && !isCancelled() && nextToStitch == numChunks;
+}
+
 std::vector<SOMEDetector::NoteEvent>
 SOMEDetector::detectNotes(const float *audio, int numSamples, int sampleRate) {
   return detectNotesWithProgress(audio, numSamples, sampleRate, nullptr);
@@ -312,7 +379,6 @@ std::vector<SOMEDetector::NoteEvent> SOMEDetector::detectNotesWithProgress(
     progressCallback(0.05);
 
   std::vector<float> waveform = resampleTo44k(audio, numSamples, sampleRate);
-  int64_t totalSize = static_cast<int64_t>(waveform.size());
 
   if (progressCallback)
     progressCallback(0.1);
@@ -330,29 +396,21 @@ std::vector<SOMEDetector::NoteEvent> SOMEDetector::detectNotesWithProgress(
 
   std::vector<NoteEvent> allNotes;
   int64_t processedFrames = 0;
-
-  // Process chunks sequentially (like dataset-tools)
-  for (const auto &[beginFrame, endFrame] : chunks) {
-    if (endFrame <= beginFrame || beginFrame >= totalSize)
-      continue;
-
-    int64_t actualEnd = std::min(endFrame, totalSize);
-    std::vector<float> chunkData(waveform.begin() + beginFrame,
-                                 waveform.begin() + actualEnd);
-
-    std::vector<float> noteMidi;
-    std::vector<bool> noteRest;
-    std::vector<float> noteDur;
-
-    if (!inferChunk(chunkData, noteMidi, noteRest, noteDur)) {
-      juce::AlertWindow::showMessageBoxAsync(
-          juce::MessageBoxIconType::WarningIcon, TR("error.some_error"),
-          TR("error.inference_failed"));
-      return {};
+  bool inferenceFailed = false;
+
+  // Chunks are inferred in parallel but placed in order (like dataset-tools)
+  auto placeChunk = [&](int64_t beginFrame, int64_t actualEnd, bool ok,
+                        ChunkOutput &out) {
+    if (!ok) {
+      inferenceFailed = true;
+      return false;
     }
 
+    const auto &noteMidi = out.midi;
+    const auto &noteRest = out.rest;
+    const auto &noteDur = out.dur;
     if (noteMidi.empty())
-      continue;
+      return true;
 
     // Debug: log SOME output for diagnosis
     int restCount =
@@ -452,6 +510,15 @@ std::vector<SOMEDetector::NoteEvent> SOMEDetector::detectNotesWithProgress(
     if (progressCallback)
       progressCallback(0.1 + 0.85 * static_cast<double>(processedFrames) /
                                  totalFrames);
+    return true;
+  };
+
+  if (!inferChunksInOrder(waveform, chunks, placeChunk, nullptr)) {
+    if (inferenceFailed)
+      juce::AlertWindow::showMessageBoxAsync(
+          juce::MessageBoxIconType::WarningIcon, TR("error.some_error"),
+          TR("error.inference_failed"));
+    return {};
   }
 
   if (progressCallback)
@@ -468,7 +535,8 @@ std::vector<SOMEDetector::NoteEvent> SOMEDetector::detectNotesWithProgress(
 void SOMEDetector::detectNotesStreaming(
     const float *audio, int numSamples, int sampleRate,
     std::function<void(const std::vector<NoteEvent> &)> noteCallback,
-    std::function<void(double)> progressCallback) {
+    std::function<void(double)> progressCallback,
+    const std::atomic<bool> *cancelFlag) {
 #ifdef HAVE_ONNXRUNTIME
   DBG("=== detectNotesStreaming CALLED: " << numSamples << " samples ===");
 
@@ -481,7 +549,6 @@ void SOMEDetector::detectNotesStreaming(
     progressCallback(0.05);
 
   std::vector<float> waveform = resampleTo44k(audio, numSamples, sampleRate);
-  int64_t totalSize = static_cast<int64_t>(waveform.size());
 
   if (progressCallback)
     progressCallback(0.1);
@@ -499,26 +566,21 @@ void SOMEDetector::detectNotesStreaming(
   int lastEndFrame = 0;
   int64_t processedFrames = 0;
 
-  for (const auto &[beginFrame, endFrame] : chunks) {
-    if (endFrame <= beginFrame || beginFrame >= totalSize)
-      continue;
-
-    int64_t actualEnd = std::min(endFrame, totalSize);
-    std::vector<float> chunkData(waveform.begin() + beginFrame,
-                                 waveform.begin() + actualEnd);
-
-    std::vector<float> noteMidi;
-    std::vector<bool> noteRest;
-    std::vector<float> noteDur;
-
-    if (!inferChunk(chunkData, noteMidi, noteRest, noteDur)) {
+  // Chunks are inferred in parallel; each is placed after the previous one's
+  // last note and reported as soon as every earlier chunk has been
+  auto placeChunk = [&](int64_t beginFrame, int64_t actualEnd, bool ok,
+                        ChunkOutput &out) {
+    if (!ok) {
       DBG("SOME chunk inference failed");
       std::cout << "[SOME] Chunk inference failed" << std::endl;
-      continue;
+      return true;
     }
 
+    const auto &noteMidi = out.midi;
+    const auto &noteRest = out.rest;
+    const auto &noteDur = out.dur;
     if (noteMidi.empty())
-      continue;
+      return true;
 
     // Debug: log SOME output for diagnosis
     int restCount =
@@ -615,7 +677,11 @@ void SOMEDetector::detectNotesStreaming(
     if (progressCallback)
       progressCallback(0.1 + 0.85 * static_cast<double>(processedFrames) /
                                  totalFrames);
-  }
+    return true;
+  };
+
+  if (!inferChunksInOrder(waveform, chunks, placeChunk, cancelFlag))
+    return;
 
   if (progressCallback)
     progressCallback(1.0);
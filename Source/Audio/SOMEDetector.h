@@ -2,6 +2,7 @@
 
 #include "../JuceHeader.h"
 #include "FCPEPitchDetector.h"
+#include <atomic>
 #include <vector>
 #include <memory>
 #include <functional>
@@ -33,22 +34,26 @@ public:
                    GPUProvider provider = GPUProvider::CPU,
                    int deviceId = 0);
     bool isLoaded() const { return loaded; }
+    juce::File getModelFile() const { return modelFile; }
 
     std::vector<NoteEvent> detectNotes(const float* audio, int numSamples, int sampleRate);
     std::vector<NoteEvent> detectNotesWithProgress(const float* audio, int numSamples,
                                                     int sampleRate,
                                                     std::function<void(double)> progressCallback);
 
-    // Streaming detection - calls noteCallback for each chunk's notes as they're detected
+    // Streaming detection - calls noteCallback for each chunk's notes as they're detected.
+    // Stops between chunks once cancelFlag (may be null) is set.
     void detectNotesStreaming(const float* audio, int numSamples, int sampleRate,
                               std::function<void(const std::vector<NoteEvent>&)> noteCallback,
-                              std::function<void(double)> progressCallback);
+                              std::function<void(double)> progressCallback,
+                              const std::atomic<bool>* cancelFlag = nullptr);
 
     int getFrameForSample(int sampleIndex) const { return sampleIndex / HOP_SIZE; }
     int getSampleForFrame(int frameIndex) const { return frameIndex * HOP_SIZE; }
 
 private:
     bool loaded = false;
+    juce::File modelFile;
 
     std::vector<float> resampleTo44k(const float* audio, int numSamples, int srcRate);
 
@@ -58,8 +63,23 @@ private:
     static std::vector<double> getRms(const std::vector<float>& samples, int frameLength, int hopLength);
 
     // Single chunk inference
-    bool inferChunk(const std::vector<float>& chunk, std::vector<float>& midi,
-                    std::vector<bool>& rest, std::vector<float>& dur);
+    struct ChunkOutput {
+        std::vector<float> midi;
+        std::vector<bool> rest;
+        std::vector<float> dur;
+    };
+    bool inferChunk(const float* samples, size_t numSamples, ChunkOutput& out);
+
+    // Runs the chunks through InferenceScheduler::forEachRun and hands each
+    // result to onChunk in chunk order, under a lock, as soon as all earlier
+    // chunks are done.
+    // onChunk gets the chunk's sample range and whether inference succeeded,
+    // and returns false to stop. Returns false if stopped or cancelled.
+    using ChunkHandler = std::function<bool(int64_t beginSample, int64_t endSample,
+                                            bool ok, ChunkOutput& out)>;
+    bool inferChunksInOrder(const std::vector<float>& waveform, const MarkerList& chunks,
+                            const ChunkHandler& onChunk,
+                            const std::atomic<bool>* cancelFlag);
 
 #ifdef HAVE_ONNXRUNTIME
     std::unique_ptr<Ort::Env> onnxEnv;
@@ -1,9 +1,14 @@
 #include "IncrementalSynthesizer.h"
 #include "../../Utils/Localization.h"
+#include <algorithm>
+#include <cmath>
 
 IncrementalSynthesizer::IncrementalSynthesizer() = default;
 
-IncrementalSynthesizer::~IncrementalSynthesizer() { cancel(); }
+IncrementalSynthesizer::~IncrementalSynthesizer() {
+  cancel();
+  InferenceScheduler::getInstance().purge(this);
+}
 
 void IncrementalSynthesizer::cancel() {
   if (cancelFlag)
@@ -29,15 +34,19 @@ IncrementalSynthesizer::expandToSilenceBoundaries(int dirtyStart,
     return i >= 0 && i < totalFrames && voicedMask[i];
   };
 
-  // Expand start backwards to find silence boundary
+  // Expand start backwards to a nearby silence boundary. Without one, cut
+  // at the dirty edge and let the splice crossfade hide the seam.
+  const int startLimit = std::max(0, dirtyStart - maxSilenceSearchFrames);
   int expandedStart = dirtyStart;
   int silenceCount = 0;
-  for (int i = dirtyStart - 1; i >= 0; --i) {
+  bool foundSilence = false;
+  for (int i = dirtyStart - 1; i >= startLimit; --i) {
     if (!isVoiced(i)) {
       silenceCount++;
       if (silenceCount >= minSilenceFrames) {
         // Found silence boundary
         expandedStart = i + silenceCount;
+        foundSilence = true;
         break;
       }
     } else {
@@ -45,22 +54,22 @@ IncrementalSynthesizer::expandToSilenceBoundaries(int dirtyStart,
       expandedStart = i;
     }
   }
-  if (expandedStart > dirtyStart)
-    expandedStart = dirtyStart;
-  if (silenceCount < minSilenceFrames && expandedStart > 0) {
-    // Didn't find silence, expand to beginning
-    expandedStart = 0;
-  }
+  if (!foundSilence)
+    expandedStart = startLimit == 0 ? 0 : dirtyStart;
+  expandedStart = std::min(expandedStart, dirtyStart);
 
-  // Expand end forwards to find silence boundary
+  // Expand end forwards the same way
+  const int endLimit = std::min(totalFrames, dirtyEnd + maxSilenceSearchFrames);
   int expandedEnd = dirtyEnd;
   silenceCount = 0;
-  for (int i = dirtyEnd; i < totalFrames; ++i) {
+  foundSilence = false;
+  for (int i = dirtyEnd; i < endLimit; ++i) {
     if (!isVoiced(i)) {
       silenceCount++;
       if (silenceCount >= minSilenceFrames) {
         // Found silence boundary
         expandedEnd = i - silenceCount + 1;
+        foundSilence = true;
         break;
       }
     } else {
@@ -68,12 +77,9 @@ IncrementalSynthesizer::expandToSilenceBoundaries(int dirtyStart,
       expandedEnd = i + 1;
     }
   }
-  if (expandedEnd < dirtyEnd)
-    expandedEnd = dirtyEnd;
-  if (silenceCount < minSilenceFrames && expandedEnd < totalFrames) {
-    // Didn't find silence, expand to end
-    expandedEnd = totalFrames;
-  }
+  if (!foundSilence)
+    expandedEnd = endLimit == totalFrames ? totalFrames : dirtyEnd;
+  expandedEnd = std::max(expandedEnd, dirtyEnd);
 
   DBG("expandToSilenceBoundaries: [" << dirtyStart << ", " << dirtyEnd
                                      << "] -> [" << expandedStart << ", "
@@ -104,43 +110,49 @@ void IncrementalSynthesizer::synthesizeRegion(ProgressCallback onProgress,
   }
 
   // Check for dirty regions
-  if (!project->hasDirtyNotes() && !project->hasF0DirtyRange()) {
+  const auto dirtyRanges = project->getDirtyFrameRanges();
+  if (dirtyRanges.empty()) {
     if (onComplete)
       onComplete(false);
     return;
   }
 
-  auto [dirtyStart, dirtyEnd] = project->getDirtyFrameRange();
-  if (dirtyStart < 0 || dirtyEnd < 0) {
-    if (onComplete)
-      onComplete(false);
-    return;
+  // Expand each dirty region to nearby silence where there is some.
+  // Regions whose expansions meet are synthesized together.
+  const int numFrames = static_cast<int>(audioData.melSpectrogram.size());
+  FrameIntervalSet expanded;
+  for (const auto &[dirtyStart, dirtyEnd] : dirtyRanges.getIntervals()) {
+    auto [startFrame, endFrame] =
+        expandToSilenceBoundaries(dirtyStart, dirtyEnd);
+    expanded.add(std::max(0, startFrame), std::min(numFrames, endFrame));
   }
 
-  // Expand to silence boundaries (no padding, no crossfade)
-  auto [startFrame, endFrame] = expandToSilenceBoundaries(dirtyStart, dirtyEnd);
-
-  // Clamp to valid range
-  startFrame = std::max(0, startFrame);
-  endFrame =
-      std::min(static_cast<int>(audioData.melSpectrogram.size()), endFrame);
-
-  if (startFrame >= endFrame) {
-    if (onComplete)
-      onComplete(false);
-    return;
+  // Regions are spliced in concurrently, so their crossfade margins must
+  // not overlap
+  std::vector<SpliceRegion> regions;
+  for (const auto &[startFrame, endFrame] : expanded.getIntervals()) {
+    if (!regions.empty() &&
+        startFrame - regions.back().endFrame < 2 * crossfadeFrames)
+      regions.back().endFrame = endFrame;
+    else
+      regions.push_back({startFrame, endFrame, 0, 0});
+  }
+  for (auto &region : regions) {
+    region.synthStartFrame = std::max(0, region.startFrame - contextFrames);
+    region.synthEndFrame = std::min(numFrames, region.endFrame + contextFrames);
   }
 
-  // Extract mel spectrogram range
-  std::vector<std::vector<float>> melRange(
-      audioData.melSpectrogram.begin() + startFrame,
-      audioData.melSpectrogram.begin() + endFrame);
-
-  // Get adjusted F0 for range
-  std::vector<float> adjustedF0Range =
-      project->getAdjustedF0ForRange(startFrame, endFrame);
-
-  if (melRange.empty() || adjustedF0Range.empty()) {
+  // Note coverage for masking, snapshotted here so commits on worker
+  // threads never walk the live note list. Only notes reaching into a
+  // region matter.
+  auto noteCoverage = std::make_shared<FrameIntervalSet>();
+  for (const auto &region : regions)
+    for (const auto *note : project->getNotesInRange(region.synthStartFrame,
+                                                     region.synthEndFrame))
+      if (!note->isRest())
+        noteCoverage->add(note->getStartFrame(), note->getEndFrame());
+
+  if (regions.empty()) {
     if (onComplete)
       onComplete(false);
     return;
@@ -157,148 +169,192 @@ void IncrementalSynthesizer::synthesizeRegion(ProgressCallback onProgress,
 
   isBusy = true;
 
-  int hopSize = vocoder->getHopSize();
-  int capturedStartFrame = startFrame;
-  int capturedEndFrame = endFrame;
-
-  // Capture for lambda
+  const int hopSize = vocoder->getHopSize();
   auto capturedCancelFlag = cancelFlag;
   auto capturedProject = project;
+  auto regionCommitted = onRegionCommitted;
+
+  auto pass = std::make_shared<PassState>();
+  pass->remaining = static_cast<int>(regions.size());
+
+  // Called once per region, from whichever thread finished it. The last
+  // region to finish owns completion for the whole pass.
+  auto finishRegion = [this, pass, capturedCancelFlag, capturedProject,
+                       currentJobId, onComplete](bool committed) {
+    if (!committed)
+      pass->allCommitted = false;
+    if (--pass->remaining > 0)
+      return;
+
+    // If superseded, a newer job owns completion
+    if (currentJobId != jobId.load())
+      return;
+
+    const bool success =
+        pass->allCommitted.load() && !capturedCancelFlag->load();
+    if (success)
+      capturedProject->clearAllDirty();
+
+    isBusy = false;
+    if (onComplete)
+      juce::MessageManager::callAsync(
+          [onComplete, success]() { onComplete(success); });
+  };
 
-  DBG("synthesizeRegion: frames [" << startFrame << ", " << endFrame << "]");
-
-  // Run vocoder inference asynchronously
-  vocoder->inferAsync(
-      melRange, adjustedF0Range,
-      [this, capturedCancelFlag, capturedProject, capturedStartFrame,
-       capturedEndFrame, hopSize, currentJobId,
-       onComplete](std::vector<float> synthesizedAudio) {
-        // If this callback is for an older job, ignore it completely.
-        // (A newer job is running or has run, and must own completion.)
-        if (currentJobId != jobId.load())
-          return;
-
-        // Check if cancelled
-        if (capturedCancelFlag->load()) {
-          isBusy = false;
-          if (onComplete)
-            onComplete(false);
-          return;
-        }
-
-        if (synthesizedAudio.empty()) {
-          isBusy = false;
-          if (onComplete)
-            onComplete(false);
-          return;
-        }
-
-        // Apply waveform replacement off the message thread to avoid UI stalls.
-        // We keep job ordering by checking jobId again before committing.
-        std::thread([this, capturedCancelFlag, capturedProject,
-                     capturedStartFrame, capturedEndFrame, hopSize,
-                     currentJobId, onComplete,
-                     synthesizedAudio = std::move(synthesizedAudio)]() mutable {
-          // If superseded, abort silently
-          if (currentJobId != jobId.load())
-            return;
+  int regionIndex = 0;
+  for (const auto &region : regions) {
+    // Synthesize with extra context on each side so the vocoder output is
+    // settled across the splice; inferAsync takes its own mel copy
+    MelView melRange = audioData.melSpectrogram.view(region.synthStartFrame,
+                                                     region.synthEndFrame);
+    std::vector<float> adjustedF0Range = project->getAdjustedF0ForRange(
+        region.synthStartFrame, region.synthEndFrame);
+
+    if (melRange.empty() || adjustedF0Range.empty()) {
+      finishRegion(false);
+      continue;
+    }
 
-          if (capturedCancelFlag->load()) {
-            isBusy = false;
-            if (onComplete)
-              juce::MessageManager::callAsync(
-                  [onComplete]() { onComplete(false); });
+    DBG("synthesizeRegion: frames [" << region.startFrame << ", "
+                                     << region.endFrame << "]");
+
+    // Regions run concurrently on the scheduler. A newer pass supersedes
+    // this one's queued regions through the shared cancel flag.
+    vocoder->inferAsync(
+        melRange, adjustedF0Range,
+        [this, capturedCancelFlag, capturedProject, region, hopSize,
+         noteCoverage, currentJobId, finishRegion,
+         regionCommitted](std::vector<float> synthesizedAudio) {
+          // If this callback is for an older job, ignore it completely.
+          // (A newer job is running or has run, and must own completion.)
+          if (currentJobId != jobId.load())
             return;
-          }
 
-          auto &audioData = capturedProject->getAudioData();
-          int totalSamples = audioData.waveform.getNumSamples();
-          int numChannels = audioData.waveform.getNumChannels();
-
-          int startSample = capturedStartFrame * hopSize;
-          int expectedSamples =
-              std::max(0, (capturedEndFrame - capturedStartFrame) * hopSize);
-          if (expectedSamples <= 0) {
-            isBusy = false;
-            if (onComplete)
-              juce::MessageManager::callAsync(
-                  [onComplete]() { onComplete(false); });
+          if (capturedCancelFlag->load() || synthesizedAudio.empty()) {
+            finishRegion(false);
             return;
           }
 
-          if (static_cast<int>(synthesizedAudio.size()) != expectedSamples) {
-            if (static_cast<int>(synthesizedAudio.size()) > expectedSamples) {
-              synthesizedAudio.resize(static_cast<size_t>(expectedSamples));
-            } else {
-              synthesizedAudio.resize(static_cast<size_t>(expectedSamples),
-                                      0.0f);
+          // Apply waveform replacement off the message thread to avoid UI
+          // stalls. Each region commits as soon as its audio is ready.
+          InferenceScheduler::JobRequest commit;
+          commit.priority = InferencePriority::InteractivePreview;
+          commit.owner = this;
+          commit.run = [this, capturedCancelFlag, capturedProject, region,
+                        hopSize, noteCoverage, currentJobId, finishRegion,
+                        regionCommitted,
+                        synthesizedAudio =
+                            std::move(synthesizedAudio)]() mutable {
+            // If superseded, abort silently
+            if (currentJobId != jobId.load())
+              return;
+
+            if (capturedCancelFlag->load()) {
+              finishRegion(false);
+              return;
             }
-          }
 
-          int samplesToReplace =
-              std::min(expectedSamples, totalSamples - startSample);
-          if (samplesToReplace <= 0) {
-            isBusy = false;
-            if (onComplete)
-              juce::MessageManager::callAsync(
-                  [onComplete]() { onComplete(false); });
-            return;
-          }
+            juce::Range<int> spliced;
+            const bool committed =
+                commitRegion(*capturedProject, region, hopSize, *noteCoverage,
+                             synthesizedAudio, spliced);
+            if (committed && regionCommitted && !spliced.isEmpty())
+              regionCommitted(spliced.getStart(), spliced.getLength());
+            finishRegion(committed);
+          };
+          InferenceScheduler::getInstance().submit(std::move(commit));
+        },
+        cancelFlag, InferencePriority::InteractivePreview,
+        "region:" + std::to_string(regionIndex++));
+  }
+}
 
-          if (samplesToReplace < expectedSamples) {
-            synthesizedAudio.resize(static_cast<size_t>(samplesToReplace));
-          }
+bool IncrementalSynthesizer::commitRegion(Project &targetProject,
+                                          const SpliceRegion &region,
+                                          int hopSize,
+                                          const FrameIntervalSet &noteCoverage,
+                                          std::vector<float> &synthesizedAudio,
+                                          juce::Range<int> &splicedSamples) {
+  auto &audioData = targetProject.getAudioData();
+  const int totalSamples = audioData.waveform.getNumSamples();
+  const int numChannels = audioData.waveform.getNumChannels();
+
+  const int synthStartSample = region.synthStartFrame * hopSize;
+  const int expectedSamples =
+      std::max(0, (region.synthEndFrame - region.synthStartFrame) * hopSize);
+  if (expectedSamples <= 0 || synthStartSample >= totalSamples)
+    return false;
+
+  if (static_cast<int>(synthesizedAudio.size()) != expectedSamples)
+    synthesizedAudio.resize(static_cast<size_t>(expectedSamples), 0.0f);
+
+  // Silence frames of the region not covered by any note. This ensures
+  // that when notes are shrunk, the silence is preserved.
+  auto silenceFrames = [&](int fromFrame, int toFrame) {
+    const int from = (fromFrame - region.synthStartFrame) * hopSize;
+    const int to = (toFrame - region.synthStartFrame) * hopSize;
+    std::fill(synthesizedAudio.begin() + from, synthesizedAudio.begin() + to,
+              0.0f);
+  };
+  const auto &covered = noteCoverage.getIntervals();
+  auto next = std::upper_bound(
+      covered.begin(), covered.end(), region.startFrame,
+      [](int frame, const FrameIntervalSet::Interval &iv) {
+        return frame < iv.second;
+      });
+  int frame = region.startFrame;
+  while (frame < region.endFrame) {
+    const int gapEnd = next == covered.end()
+                           ? region.endFrame
+                           : std::clamp(next->first, frame, region.endFrame);
+    if (gapEnd > frame)
+      silenceFrames(frame, gapEnd);
+    if (next == covered.end())
+      break;
+    frame = std::max(frame, next->second);
+    ++next;
+  }
 
-          if (samplesToReplace <= 0) {
-            isBusy = false;
-            if (onComplete)
-              juce::MessageManager::callAsync(
-                  [onComplete]() { onComplete(false); });
-            return;
-          }
+  // Equal-power splice: the core [startFrame, endFrame) is replaced, and
+  // crossfadeFrames on either side fade between old and new audio.
+  const int fadeSamples = crossfadeFrames * hopSize;
+  const int coreStart = region.startFrame * hopSize;
+  const int coreEnd = std::min(region.endFrame * hopSize, totalSamples);
+  const int fadeInStart = std::max(synthStartSample, coreStart - fadeSamples);
+  const int fadeOutEnd =
+      std::min({synthStartSample + expectedSamples, coreEnd + fadeSamples,
+                totalSamples});
+
+  auto fadeGains = [fadeSamples](int distanceIntoFade) {
+    const double t =
+        (static_cast<double>(distanceIntoFade) + 0.5) / fadeSamples;
+    const double angle = 0.5 * juce::MathConstants<double>::pi * t;
+    return std::make_pair(static_cast<float>(std::sin(angle)),
+                          static_cast<float>(std::cos(angle)));
+  };
 
-          // Direct replacement - no crossfade
-          for (int ch = 0; ch < numChannels; ++ch) {
-            float *dstCh = audioData.waveform.getWritePointer(ch);
-            for (int i = 0; i < samplesToReplace; ++i) {
-              dstCh[startSample + i] = synthesizedAudio[static_cast<size_t>(i)];
-            }
-          }
+  for (int ch = 0; ch < numChannels; ++ch) {
+    float *dst = audioData.waveform.getWritePointer(ch);
+    const float *src = synthesizedAudio.data() - synthStartSample;
 
-          // Silence regions outside note boundaries
-          // This ensures that when notes are shrunk, the silence is preserved
-          auto& notes = capturedProject->getNotes();
-          for (int ch = 0; ch < numChannels; ++ch) {
-            float *dstCh = audioData.waveform.getWritePointer(ch);
-            for (int frame = capturedStartFrame; frame < capturedEndFrame; ++frame) {
-              bool inNote = false;
-              for (const auto& note : notes) {
-                if (!note.isRest() && frame >= note.getStartFrame() && frame < note.getEndFrame()) {
-                  inNote = true;
-                  break;
-                }
-              }
-              if (!inNote) {
-                // This frame is not covered by any note - silence it
-                int sampleStart = frame * hopSize;
-                int sampleEnd = std::min(sampleStart + hopSize, totalSamples);
-                for (int i = sampleStart; i < sampleEnd; ++i) {
-                  dstCh[i] = 0.0f;
-                }
-              }
-            }
-          }
+    for (int i = fadeInStart; i < coreStart; ++i) {
+      const auto [gainNew, gainOld] =
+          fadeGains(i - (coreStart - fadeSamples));
+      dst[i] = gainOld * dst[i] + gainNew * src[i];
+    }
 
-          DBG("synthesizeRegion: replaced " << samplesToReplace
-                                            << " samples at " << startSample);
+    std::copy(src + coreStart, src + coreEnd, dst + coreStart);
 
-          // Clear dirty flags
-          capturedProject->clearAllDirty();
+    for (int i = coreEnd; i < fadeOutEnd; ++i) {
+      const auto [gainOld, gainNew] = fadeGains(i - coreEnd);
+      dst[i] = gainOld * dst[i] + gainNew * src[i];
+    }
+  }
 
-          isBusy = false;
-          if (onComplete)
-            juce::MessageManager::callAsync(
-                [onComplete]() { onComplete(true); });
-        }).detach();
-      });
+  splicedSamples = {fadeInStart, std::max(fadeInStart, fadeOutEnd)};
+  targetProject.invalidateWaveformPeaks(splicedSamples.getStart(),
+                                        splicedSamples.getLength());
+  DBG("synthesizeRegion: spliced " << (coreEnd - coreStart) << " samples at "
+                                   << coreStart);
+  return true;
 }
@@ -12,12 +12,15 @@
 /**
  * Handles audio synthesis for edited regions.
  * Uses vocoder to resynthesize dirty (modified) portions of audio.
- * Expands dirty region to nearest silence boundaries for clean cuts.
+ * Regions are cut at nearby silence when there is some and crossfaded in
+ * otherwise, so legato edits stay small.
  */
 class IncrementalSynthesizer {
 public:
   using ProgressCallback = std::function<void(const juce::String &message)>;
   using CompleteCallback = std::function<void(bool success)>;
+  using RegionCommittedCallback =
+      std::function<void(int startSample, int numSamples)>;
 
   IncrementalSynthesizer();
   ~IncrementalSynthesizer();
@@ -26,11 +29,24 @@ public:
   void setProject(Project *p) { project = p; }
 
   /**
-   * Synthesize the dirty region.
-   * - Finds dirty frame range from project
-   * - Expands to nearest silence boundaries
-   * - Synthesizes entire region (no padding, no crossfade)
-   * - Direct replacement of samples
+   * Called from a worker thread each time a region has been spliced into the
+   * project waveform, with the sample span it touched (crossfades included).
+   * Lets playback pick up edits without reloading the whole waveform.
+   */
+  void setRegionCommittedCallback(RegionCommittedCallback cb) {
+    onRegionCommitted = std::move(cb);
+  }
+
+  /**
+   * Synthesize the dirty regions.
+   * - Collects disjoint dirty frame ranges from project
+   * - Expands each to nearby silence, merging any that meet; where there
+   *   is no silence close by the region is cut at its dirty edges
+   * - Synthesizes the regions concurrently with a little extra context
+   * - Splices each region in with an equal-power crossfade as soon as it
+   *   finishes
+   * onComplete runs once, after the last region, with true only if every
+   * region was committed.
    */
   void synthesizeRegion(ProgressCallback onProgress,
                         CompleteCallback onComplete);
@@ -48,8 +64,39 @@ private:
    */
   std::pair<int, int> expandToSilenceBoundaries(int dirtyStart, int dirtyEnd);
 
+  // How far to look for a silence gap before cutting inside voiced audio
+  static constexpr int maxSilenceSearchFrames = 86; // ~1 s
+  // Extra frames synthesized on each side of a region as vocoder context
+  static constexpr int contextFrames = 8;
+  // Equal-power crossfade length on each side of a splice (<= contextFrames)
+  static constexpr int crossfadeFrames = 4;
+
+  struct SpliceRegion {
+    int startFrame;      // Core replaced outright
+    int endFrame;
+    int synthStartFrame; // Range sent to the vocoder (core plus context)
+    int synthEndFrame;
+  };
+
+  /**
+   * Splice synthesized audio for a region into the project waveform.
+   * Frames of the core not covered by a note are silenced first.
+   * splicedSamples receives the sample span that was written.
+   */
+  static bool commitRegion(Project &targetProject, const SpliceRegion &region,
+                           int hopSize, const FrameIntervalSet &noteCoverage,
+                           std::vector<float> &synthesizedAudio,
+                           juce::Range<int> &splicedSamples);
+
+  // Completion bookkeeping shared by the regions of one synthesis pass
+  struct PassState {
+    std::atomic<int> remaining{0};
+    std::atomic<bool> allCommitted{true};
+  };
+
   Vocoder *vocoder = nullptr;
   Project *project = nullptr;
+  RegionCommittedCallback onRegionCommitted;
 
   std::shared_ptr<std::atomic<bool>> cancelFlag;
   std::atomic<uint64_t> jobId{0};
@@ -1,5 +1,6 @@
 #include "Vocoder.h"
 #include "../Utils/AppLogger.h"
+#include "../Utils/ContentHash.h"
 #include "../Utils/Constants.h"
 #include "../Utils/PlatformPaths.h"
 #include <algorithm>
@@ -30,91 +31,22 @@ Vocoder::Vocoder() {
     onnxEnv =
         std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "HachiTune");
     allocator = std::make_unique<Ort::AllocatorWithDefaultOptions>();
+    prepackedWeights = std::make_unique<Ort::PrepackedWeightsContainer>();
     log("ONNX Runtime initialized successfully");
   } catch (const Ort::Exception &e) {
     log("Failed to initialize ONNX Runtime: " + std::string(e.what()));
   }
 #endif
-
-  // Start async worker thread for inferAsync()
-  asyncWorker = std::thread([this]() {
-    for (;;) {
-      AsyncTask task;
-      {
-        std::unique_lock<std::mutex> lock(asyncMutex);
-        asyncCondition.wait(lock, [this]() {
-          return isShuttingDown.load() || !asyncQueue.empty();
-        });
-
-        if (isShuttingDown.load() && asyncQueue.empty())
-          return;
-
-        task = std::move(asyncQueue.front());
-        asyncQueue.pop_front();
-      }
-
-      // Skip work if shutting down
-      if (isShuttingDown.load()) {
-        if (activeAsyncTasks.fetch_sub(1) == 1) {
-          std::lock_guard<std::mutex> lock(asyncMutex);
-          asyncCondition.notify_all();
-        }
-        continue;
-      }
-
-      // If canceled, still invoke callback (with empty result) so callers can
-      // clear state and potentially schedule a rerun.
-      if (task.cancelFlag && task.cancelFlag->load()) {
-        // Mark task done
-        if (activeAsyncTasks.fetch_sub(1) == 1) {
-          std::lock_guard<std::mutex> lock(asyncMutex);
-          asyncCondition.notify_all();
-        }
-
-        auto cb = std::move(task.callback);
-        juce::MessageManager::callAsync([cb]() mutable {
-          if (cb)
-            cb({});
-        });
-        continue;
-      }
-
-      auto result = infer(task.mel, task.f0);
-
-      // Mark task done
-      if (activeAsyncTasks.fetch_sub(1) == 1) {
-        std::lock_guard<std::mutex> lock(asyncMutex);
-        asyncCondition.notify_all();
-      }
-
-      // If shutting down, skip callback
-      if (isShuttingDown.load())
-        continue;
-
-      // Call callback on message thread
-      auto cb = std::move(task.callback);
-      juce::MessageManager::callAsync([cb, result]() mutable {
-        if (cb)
-          cb(result);
-      });
-    }
-  });
 }
 
 Vocoder::~Vocoder() {
-  // Signal shutdown
+  // Signal shutdown, drop queued async jobs and wait for running ones
   isShuttingDown.store(true);
-
-  // Wake worker and join
-  {
-    std::lock_guard<std::mutex> lock(asyncMutex);
-    asyncCondition.notify_all();
-  }
-  if (asyncWorker.joinable())
-    asyncWorker.join();
+  InferenceScheduler::getInstance().purge(this);
 
 #ifdef HAVE_ONNXRUNTIME
-  onnxSession.reset();
+  releaseSessionPool();
+  prepackedWeights.reset();
   onnxEnv.reset();
 #endif
   if (logFile && logFile->is_open()) {
@@ -125,6 +57,7 @@ Vocoder::~Vocoder() {
 
 void Vocoder::log(const std::string &message) {
   DBG(message);
+  std::lock_guard<std::mutex> lock(logMutex);
   if (logFile && logFile->is_open()) {
     auto now = std::chrono::system_clock::now();
     auto time = std::chrono::system_clock::to_time_t(now);
@@ -154,6 +87,13 @@ bool Vocoder::isOnnxRuntimeAvailable() {
 }
 
 bool Vocoder::loadModel(const juce::File &modelPath) {
+  // Exclusive lock: the session pool and I/O names are replaced below, so
+  // in-flight inference must finish first, as in reloadModel()
+  std::unique_lock<std::shared_mutex> lock(inferenceMutex);
+  return loadModelLocked(modelPath);
+}
+
+bool Vocoder::loadModelLocked(const juce::File &modelPath) {
 #ifdef HAVE_ONNXRUNTIME
   if (!onnxEnv) {
     log("ONNX Runtime not initialized");
@@ -175,7 +115,9 @@ bool Vocoder::loadModel(const juce::File &modelPath) {
 
     // Create session with current settings
     log("Creating session options...");
-    Ort::SessionOptions sessionOptions = createSessionOptions();
+    const int poolSize = resolveSessionPoolSize();
+    Ort::SessionOptions sessionOptions = createSessionOptions(poolSize);
+    std::vector<std::unique_ptr<Ort::Session>> sessions;
 
     // Create session
 #ifdef _WIN32
@@ -204,9 +146,12 @@ bool Vocoder::loadModel(const juce::File &modelPath) {
     log("Loading model from: " + pathStr.toStdString());
     log("Path length: " + std::to_string(modelPathW.length()) + " characters");
 
-    // Create the session - this is where the exception might occur
-    onnxSession = std::make_unique<Ort::Session>(*onnxEnv, modelPathW.c_str(),
-                                                 sessionOptions);
+    // Create the sessions - this is where the exception might occur.
+    // Pooled sessions share prepacked weights to avoid duplicating them.
+    for (int i = 0; i < poolSize; ++i)
+      sessions.push_back(std::make_unique<Ort::Session>(
+          *onnxEnv, modelPathW.c_str(), sessionOptions,
+          *prepackedWeights));
 #else
     std::string modelPathStr = modelPath.getFullPathName().toStdString();
     if (modelPathStr.empty()) {
@@ -214,17 +159,21 @@ bool Vocoder::loadModel(const juce::File &modelPath) {
       return false;
     }
     log("Loading model from: " + modelPathStr);
-    onnxSession = std::make_unique<Ort::Session>(*onnxEnv, modelPathStr.c_str(),
-                                                 sessionOptions);
+    for (int i = 0; i < poolSize; ++i)
+      sessions.push_back(std::make_unique<Ort::Session>(
+          *onnxEnv, modelPathStr.c_str(), sessionOptions,
+          *prepackedWeights));
 #endif
 
+    auto &primarySession = *sessions.front();
+
     // Get input names
-    size_t numInputs = onnxSession->GetInputCount();
+    size_t numInputs = primarySession.GetInputCount();
     inputNameStrings.clear();
     inputNames.clear();
 
     for (size_t i = 0; i < numInputs; ++i) {
-      auto namePtr = onnxSession->GetInputNameAllocated(i, *allocator);
+      auto namePtr = primarySession.GetInputNameAllocated(i, *allocator);
       inputNameStrings.push_back(namePtr.get());
     }
     for (auto &name : inputNameStrings) {
@@ -232,25 +181,36 @@ bool Vocoder::loadModel(const juce::File &modelPath) {
     }
 
     // Get output names
-    size_t numOutputs = onnxSession->GetOutputCount();
+    size_t numOutputs = primarySession.GetOutputCount();
     outputNameStrings.clear();
     outputNames.clear();
 
     for (size_t i = 0; i < numOutputs; ++i) {
-      auto namePtr = onnxSession->GetOutputNameAllocated(i, *allocator);
+      auto namePtr = primarySession.GetOutputNameAllocated(i, *allocator);
       outputNameStrings.push_back(namePtr.get());
     }
     for (auto &name : outputNameStrings) {
       outputNames.push_back(name.c_str());
     }
 
-    log("Vocoder: ONNX model loaded successfully");
+    {
+      std::lock_guard<std::mutex> lock(poolMutex);
+      sessionPool = std::move(sessions);
+      freeSessions.clear();
+      for (auto &session : sessionPool)
+        freeSessions.push_back(session.get());
+    }
+    poolCondition.notify_all();
+
+    log("Vocoder: ONNX model loaded successfully (" +
+        std::to_string(poolSize) + " session(s))");
     log("  Input names: " +
         std::string(inputNames.size() > 0 ? inputNames[0] : "none"));
     log("  Output names: " +
         std::string(outputNames.size() > 0 ? outputNames[0] : "none"));
 
     modelFile = modelPath;
+    updateModelIdentity();
     loaded = true;
     return true;
 
@@ -283,26 +243,216 @@ bool Vocoder::loadModel(const juce::File &modelPath) {
 #endif
 }
 
-std::vector<float> Vocoder::infer(const std::vector<std::vector<float>> &mel,
-                                  const std::vector<float> &f0) {
+std::vector<float> Vocoder::infer(MelView mel,
+                                  const std::vector<float> &f0,
+                                  InferencePriority priority) {
   if (!loaded || mel.empty() || f0.empty())
     return {};
 
-  // Lock to ensure thread-safe access to ONNX session
-  std::lock_guard<std::mutex> lock(inferenceMutex);
+  // Shared lock: concurrent Run() calls are fine, reload is exclusive
+  std::shared_lock<std::shared_mutex> lock(inferenceMutex);
 
   size_t numFrames = std::min(mel.size(), f0.size());
+  return runInference(mel, f0, 0, numFrames, priority);
+}
+
+std::vector<Vocoder::ChunkSpan>
+Vocoder::planChunks(const std::vector<float> &f0, int numFrames) const {
+  std::vector<ChunkSpan> chunks;
+  if (numFrames <= 0)
+    return chunks;
+
+  const int overlap = chunkOverlapFrames;
+  const int searchFrames = chunkFrames / 4;
+  const int minSilenceFrames = 5;
+
+  auto isVoiced = [&](int i) {
+    return i >= 0 && i < static_cast<int>(f0.size()) && f0[i] > 0.0f;
+  };
+
+  // Choose cut points. A cut in the middle of an unvoiced run hides any
+  // seam; otherwise the overlap crossfade takes care of it.
+  std::vector<int> cuts{0};
+  int prev = 0;
+  while (numFrames - prev > chunkFrames) {
+    const int target = prev + chunkFrames;
+    int cut = target;
+    int silenceEnd = -1;
+    int silenceCount = 0;
+    bool foundSilence = false;
+    for (int i = target; i > target - searchFrames && i > prev + overlap;
+         --i) {
+      if (!isVoiced(i)) {
+        if (silenceCount == 0)
+          silenceEnd = i;
+        ++silenceCount;
+      } else {
+        if (silenceCount >= minSilenceFrames) {
+          foundSilence = true;
+          break;
+        }
+        silenceCount = 0;
+      }
+    }
+    if (foundSilence || silenceCount >= minSilenceFrames)
+      cut = silenceEnd - silenceCount / 2;
+    cut = std::clamp(cut, prev + 1, numFrames);
+    cuts.push_back(cut);
+    prev = cut;
+  }
+  cuts.push_back(numFrames);
+
+  for (size_t i = 0; i + 1 < cuts.size(); ++i) {
+    ChunkSpan span;
+    span.keepStart = cuts[i];
+    span.keepEnd = cuts[i + 1];
+    span.start = std::max(0, span.keepStart - overlap);
+    span.end = std::min(numFrames, span.keepEnd + overlap);
+    chunks.push_back(span);
+  }
+  return chunks;
+}
+
+std::vector<float>
+Vocoder::inferChunked(MelView mel,
+                      const std::vector<float> &f0,
+                      const std::atomic<bool> *cancelFlag,
+                      InferencePriority priority) {
+  if (!loaded || mel.empty() || f0.empty())
+    return {};
+
+  const int numFrames = static_cast<int>(std::min(mel.size(), f0.size()));
+  if (numFrames <= chunkFrames + chunkOverlapFrames)
+    return infer(mel, f0, priority);
+
+  auto isCancelled = [cancelFlag]() {
+    return cancelFlag != nullptr && cancelFlag->load();
+  };
+
+  const auto chunks = planChunks(f0, numFrames);
+  std::vector<std::vector<float>> results(chunks.size());
+  std::atomic<bool> failed{false};
+
+  log("Chunked inference: " + std::to_string(numFrames) + " frames in " +
+      std::to_string(chunks.size()) + " chunks");
+
+  // Leave one pooled session free so preview resynthesis is not starved
+  // by a running export. Helper threads come from the shared budget, so an
+  // export job does not add a private pool on top of the scheduler's.
+  const int poolSize = getSessionPoolSize();
+  const int availableSessions = poolSize > 1 ? poolSize - 1 : 1;
+  InferenceScheduler::getInstance().forEachRun(
+      static_cast<int>(chunks.size()),
+      [&](size_t index) {
+        if (failed.load())
+          return;
+
+        const auto &span = chunks[index];
+        std::vector<float> audio;
+        {
+          std::shared_lock<std::shared_mutex> lock(inferenceMutex);
+          audio = runInference(mel, f0, static_cast<size_t>(span.start),
+                               static_cast<size_t>(span.end - span.start),
+                               priority);
+        }
+        if (audio.empty()) {
+          failed = true;
+          return;
+        }
+        audio.resize(static_cast<size_t>(span.end - span.start) * hopSize,
+                     0.0f);
+        results[index] = std::move(audio);
+      },
+      cancelFlag, std::min(maxParallelChunks, availableSessions));
 
+  if (failed.load() || isCancelled())
+    return {};
+
+  // Overlap-add: each chunk fades in/out (raised cosine, sums to 1) over a
+  // window of chunkOverlapFrames centred on the shared cut point.
+  std::vector<float> waveform(static_cast<size_t>(numFrames) * hopSize, 0.0f);
+  const int fadeSamples = chunkOverlapFrames * hopSize;
+  const int halfFade = fadeSamples / 2;
+
+  auto fadeWeight = [fadeSamples](int distanceFromFadeStart) {
+    const double t =
+        (static_cast<double>(distanceFromFadeStart) + 0.5) / fadeSamples;
+    const double s = std::sin(0.5 * juce::MathConstants<double>::pi * t);
+    return static_cast<float>(s * s);
+  };
+
+  for (size_t c = 0; c < chunks.size(); ++c) {
+    const auto &span = chunks[c];
+    const auto &audio = results[c];
+    const int chunkOffset = span.start * hopSize;
+    const bool hasPrev = c > 0 && fadeSamples > 0;
+    const bool hasNext = c + 1 < chunks.size() && fadeSamples > 0;
+
+    const int fadeInStart = span.keepStart * hopSize - halfFade;
+    const int fadeOutStart = span.keepEnd * hopSize - halfFade;
+    const int writeStart = hasPrev ? fadeInStart : span.keepStart * hopSize;
+    const int writeEnd = hasNext ? fadeOutStart + fadeSamples
+                                 : span.keepEnd * hopSize;
+
+    for (int s = std::max(writeStart, chunkOffset);
+         s < writeEnd && s - chunkOffset < static_cast<int>(audio.size());
+         ++s) {
+      float w = 1.0f;
+      if (hasPrev && s < fadeInStart + fadeSamples)
+        w = fadeWeight(s - fadeInStart);
+      else if (hasNext && s >= fadeOutStart)
+        w = 1.0f - fadeWeight(s - fadeOutStart);
+      waveform[static_cast<size_t>(s)] +=
+          w * audio[static_cast<size_t>(s - chunkOffset)];
+    }
+  }
+
+  return waveform;
+}
+
+std::vector<float>
+Vocoder::runInference(MelView mel,
+                      const std::vector<float> &f0, size_t startFrame,
+                      size_t numFrames, InferencePriority priority) {
   log("Starting inference with " + std::to_string(numFrames) + " frames");
 
   auto startTotal = std::chrono::high_resolution_clock::now();
 
+  auto fallback = [&]() {
+    return generateSineFallback(std::vector<float>(
+        f0.begin() + static_cast<std::ptrdiff_t>(startFrame),
+        f0.begin() + static_cast<std::ptrdiff_t>(startFrame + numFrames)));
+  };
+
 #ifdef HAVE_ONNXRUNTIME
-  if (!onnxSession) {
+  // Inputs rendered before (undo/redo, A/B) come from the output cache.
+  // Export chunks bypass it so a full render does not flush edit history.
+  const bool useCache = priority != InferencePriority::Export;
+  const auto cacheKey =
+      useCache ? VocoderCache::makeKey(modelIdentity.load(), mel, f0,
+                                       startFrame, numFrames)
+               : 0;
+  if (std::vector<float> cached;
+      useCache && outputCache.lookup(cacheKey, cached)) {
+    log("Output cache hit");
+    return cached;
+  }
+
+  // Take a scheduler slot before a session (consistent lock order)
+  auto runSlot = InferenceScheduler::getInstance().acquireRunSlot(priority);
+  Ort::Session *session = acquireSession();
+  if (session == nullptr) {
     log("ONNX session not available, using fallback");
-    return generateSineFallback(f0);
+    return fallback();
   }
 
+  // Return the session to the pool on every exit path
+  struct SessionReturn {
+    Vocoder &owner;
+    Ort::Session *session;
+    ~SessionReturn() { owner.releaseSession(session); }
+  } sessionReturn{*this, session};
+
   try {
     auto startPrep = std::chrono::high_resolution_clock::now();
 
@@ -312,11 +462,11 @@ std::vector<float> Vocoder::infer(const std::vector<std::vector<float>> &mel,
     std::vector<float> melData(numMels * numFrames);
 
     // Transpose mel from [T, num_mels] to [num_mels, T]
+    const int copyMels = std::min(numMels, mel.getNumMels());
     for (size_t frame = 0; frame < numFrames; ++frame) {
-      for (int m = 0; m < numMels && m < static_cast<int>(mel[frame].size());
-           ++m) {
-        melData[m * numFrames + frame] = mel[frame][m];
-      }
+      const float *melFrame = mel[startFrame + frame];
+      for (int m = 0; m < copyMels; ++m)
+        melData[m * numFrames + frame] = melFrame[m];
     }
 
     // Validate and normalize mel spectrogram values
@@ -341,7 +491,9 @@ std::vector<float> Vocoder::infer(const std::vector<std::vector<float>> &mel,
 
     // Prepare f0 input: [batch=1, frames]
     std::vector<int64_t> f0Shape = {1, static_cast<int64_t>(numFrames)};
-    std::vector<float> f0Data(f0.begin(), f0.begin() + numFrames);
+    std::vector<float> f0Data(
+        f0.begin() + static_cast<std::ptrdiff_t>(startFrame),
+        f0.begin() + static_cast<std::ptrdiff_t>(startFrame + numFrames));
 
     // Validate and clamp F0 values to reasonable range
     // Typical human voice range: 50 Hz to 1000 Hz
@@ -390,26 +542,26 @@ std::vector<float> Vocoder::infer(const std::vector<std::vector<float>> &mel,
     auto startInfer = std::chrono::high_resolution_clock::now();
 
     // Validate session and names before inference
-    if (!onnxSession || inputNames.empty() || outputNames.empty()) {
+    if (inputNames.empty() || outputNames.empty()) {
       log("ONNX session or input/output names invalid before inference");
-      return generateSineFallback(f0);
+      return fallback();
     }
 
     // Validate all name pointers are non-null
     for (const auto *name : inputNames) {
       if (name == nullptr) {
         log("Null pointer found in inputNames");
-        return generateSineFallback(f0);
+        return fallback();
       }
     }
     for (const auto *name : outputNames) {
       if (name == nullptr) {
         log("Null pointer found in outputNames");
-        return generateSineFallback(f0);
+        return fallback();
       }
     }
 
-    auto outputTensors = onnxSession->Run(
+    auto outputTensors = session->Run(
         Ort::RunOptions{nullptr}, inputNames.data(), inputTensors.data(),
         inputTensors.size(), outputNames.data(), outputNames.size());
 
@@ -423,7 +575,7 @@ std::vector<float> Vocoder::infer(const std::vector<std::vector<float>> &mel,
     // Get output
     if (outputTensors.empty()) {
       log("ONNX inference returned no output");
-      return generateSineFallback(f0);
+      return fallback();
     }
 
     // Get output tensor info
@@ -481,19 +633,21 @@ std::vector<float> Vocoder::infer(const std::vector<std::vector<float>> &mel,
                        .count();
     log("Total vocoder inference took " + std::to_string(totalMs) + " ms");
 
+    if (useCache)
+      outputCache.store(cacheKey, waveform);
     return waveform;
 
   } catch (const Ort::Exception &e) {
     log("ONNX inference failed: " + std::string(e.what()));
-    return generateSineFallback(f0);
+    return fallback();
   }
 #else
-  return generateSineFallback(f0);
+  return fallback();
 #endif
 }
 
 std::vector<float>
-Vocoder::inferWithPitchShift(const std::vector<std::vector<float>> &mel,
+Vocoder::inferWithPitchShift(MelView mel,
                              const std::vector<float> &f0,
                              float pitchShiftSemitones) {
   if (pitchShiftSemitones == 0.0f)
@@ -511,25 +665,79 @@ Vocoder::inferWithPitchShift(const std::vector<std::vector<float>> &mel,
   return infer(mel, shiftedF0);
 }
 
-void Vocoder::inferAsync(const std::vector<std::vector<float>> &mel,
+void Vocoder::inferAsync(MelView mel,
                          const std::vector<float> &f0,
                          std::function<void(std::vector<float>)> callback,
-                         std::shared_ptr<std::atomic<bool>> cancelFlag) {
+                         std::shared_ptr<std::atomic<bool>> cancelFlag,
+                         InferencePriority priority,
+                         const std::string &coalesceKey) {
   // Check if shutting down
   if (isShuttingDown.load()) {
     log("inferAsync: Vocoder is shutting down, skipping request");
     return;
   }
 
-  // Increment active task count
-  activeAsyncTasks.fetch_add(1);
-
-  {
-    std::lock_guard<std::mutex> lock(asyncMutex);
-    asyncQueue.push_back(
-        AsyncTask{mel, f0, std::move(callback), std::move(cancelFlag)});
-    asyncCondition.notify_one();
+  // If canceled or superseded, still invoke callback (with empty result) so
+  // callers can clear state and potentially schedule a rerun.
+  auto onCancelled = [callback]() {
+    juce::MessageManager::callAsync([callback]() {
+      if (callback)
+        callback({});
+    });
+  };
+
+  // A cached result needs no queue slot. Coalesced requests still go
+  // through the queue so they supersede older ones with the same key.
+#ifdef HAVE_ONNXRUNTIME
+  if (loaded && coalesceKey.empty() && !(cancelFlag && cancelFlag->load())) {
+    const size_t numFrames = std::min(mel.size(), f0.size());
+    std::vector<float> cached;
+    if (numFrames > 0 &&
+        outputCache.lookup(VocoderCache::makeKey(modelIdentity.load(), mel,
+                                                 f0, 0, numFrames),
+                           cached, false)) {
+      log("inferAsync: output cache hit");
+      juce::MessageManager::callAsync(
+          [callback, result = std::move(cached)]() mutable {
+            if (callback)
+              callback(std::move(result));
+          });
+      return;
+    }
   }
+#endif
+
+  InferenceScheduler::JobRequest request;
+  request.priority = priority;
+  request.owner = this;
+  request.coalesceKey = coalesceKey;
+  request.token = cancelFlag;
+  request.onCancelled = onCancelled;
+  request.run = [this, mel = MelMatrix(mel), f0, callback, cancelFlag,
+                 priority, onCancelled]() {
+    if (isShuttingDown.load())
+      return;
+
+    if (cancelFlag && cancelFlag->load()) {
+      onCancelled();
+      return;
+    }
+
+    auto result = infer(mel, f0, priority);
+
+    // If shutting down, skip callback
+    if (isShuttingDown.load())
+      return;
+
+    // Call callback on message thread
+    juce::MessageManager::callAsync(
+        [callback, result = std::move(result)]() mutable {
+          if (callback)
+            callback(std::move(result));
+        });
+  };
+
+  InferenceScheduler::getInstance().submit(std::move(request));
 }
 
 std::vector<float> Vocoder::generateSineFallback(const std::vector<float> &f0) {
@@ -578,20 +786,33 @@ void Vocoder::setExecutionDeviceId(int deviceId) {
   }
 }
 
+void Vocoder::updateModelIdentity() {
+  // Output depends on the weights and, numerically, on the provider
+  ContentHash identity;
+  identity.updateString(modelFile.getFullPathName().toStdString());
+  identity.updateValue(static_cast<std::int64_t>(modelFile.getSize()));
+  identity.updateValue(static_cast<std::int64_t>(
+      modelFile.getLastModificationTime().toMilliseconds()));
+  identity.updateString(executionDevice.toStdString());
+  identity.updateValue(executionDeviceId);
+  modelIdentity = identity.finish();
+  outputCache.clear();
+}
+
 bool Vocoder::reloadModel() {
   if (!modelFile.existsAsFile()) {
     log("Cannot reload: no model file set");
     return false;
   }
 
-  // Lock to prevent reload during inference
-  std::lock_guard<std::mutex> lock(inferenceMutex);
+  // Exclusive lock: waits for in-flight inference to finish
+  std::unique_lock<std::shared_mutex> lock(inferenceMutex);
 
   log("Reloading model with new settings...");
 
 #ifdef HAVE_ONNXRUNTIME
-  // Release existing session
-  onnxSession.reset();
+  // Release existing sessions
+  releaseSessionPool();
   inputNames.clear();
   outputNames.clear();
   inputNameStrings.clear();
@@ -599,14 +820,79 @@ bool Vocoder::reloadModel() {
   loaded = false;
 #endif
 
-  return loadModel(modelFile);
+  return loadModelLocked(modelFile);
+}
+
+int Vocoder::resolveSessionPoolSize() const {
+  // GPU providers keep one session: extra sessions only duplicate device
+  // memory and DirectML requires sequential execution anyway.
+  if (executionDevice != "CPU")
+    return 1;
+  if (sessionPoolSize > 0)
+    return sessionPoolSize;
+  const int cores =
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  return std::clamp(cores / 4, 2, 4);
 }
 
+int Vocoder::getSessionPoolSize() const {
 #ifdef HAVE_ONNXRUNTIME
-Ort::SessionOptions Vocoder::createSessionOptions() {
+  std::lock_guard<std::mutex> lock(poolMutex);
+  return std::max(1, static_cast<int>(sessionPool.size()));
+#else
+  return std::max(1, sessionPoolSize);
+#endif
+}
+
+#ifdef HAVE_ONNXRUNTIME
+Ort::Session *Vocoder::acquireSession() {
+  std::unique_lock<std::mutex> lock(poolMutex);
+  poolCondition.wait(lock, [this]() {
+    return !freeSessions.empty() || sessionPool.empty();
+  });
+  if (freeSessions.empty())
+    return nullptr;
+  auto *session = freeSessions.back();
+  freeSessions.pop_back();
+  return session;
+}
+
+void Vocoder::releaseSession(Ort::Session *session) {
+  if (session == nullptr)
+    return;
+  {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    freeSessions.push_back(session);
+  }
+  poolCondition.notify_one();
+}
+
+void Vocoder::releaseSessionPool() {
+  // Callers hold inferenceMutex exclusively, so no session is checked out.
+  {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    freeSessions.clear();
+    sessionPool.clear();
+  }
+  poolCondition.notify_all();
+}
+
+Ort::SessionOptions Vocoder::createSessionOptions(int poolSize) {
   Ort::SessionOptions sessionOptions;
 
-  // Let ONNX Runtime handle threading automatically
+  // Split the thread budget across pooled sessions so concurrent preview
+  // and export runs do not oversubscribe the CPU. Inter-op parallelism is
+  // not useful for this model (a single linear graph).
+  const int budget =
+      threadBudget > 0
+          ? threadBudget
+          : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  const int intraOpThreads = std::max(1, budget / std::max(1, poolSize));
+  sessionOptions.SetIntraOpNumThreads(intraOpThreads);
+  sessionOptions.SetInterOpNumThreads(1);
+  sessionOptions.SetExecutionMode(ORT_SEQUENTIAL);
+  log("Session threads: intra-op " + std::to_string(intraOpThreads) +
+      " x " + std::to_string(poolSize) + " session(s)");
 
   // Enable all optimizations
   sessionOptions.SetGraphOptimizationLevel(
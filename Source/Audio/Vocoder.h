@@ -1,13 +1,17 @@
 #pragma once
 
 #include "../JuceHeader.h"
+#include "../Utils/MelMatrix.h"
+#include "Inference/InferenceScheduler.h"
+#include "Inference/VocoderCache.h"
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
-#include <deque>
 #include <fstream>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <thread>
 #include <vector>
 
@@ -51,8 +55,27 @@ public:
    * @param f0 F0 values [T] (fundamental frequency per frame)
    * @return Synthesized waveform, or empty vector on failure
    */
-  std::vector<float> infer(const std::vector<std::vector<float>> &mel,
-                           const std::vector<float> &f0);
+  std::vector<float>
+  infer(MelView mel, const std::vector<float> &f0,
+        InferencePriority priority = InferencePriority::InteractivePreview);
+
+  /**
+   * Chunked synthesis for long inputs (full renders/exports).
+   * Splits the frame range into windows of about getChunkFrames() frames,
+   * preferring unvoiced frames as cut points, runs the windows on parallel
+   * workers and crossfades the overlapping edges. Peak tensor memory is
+   * bounded by the chunk length instead of the song length.
+   * @param mel Mel spectrogram [T, NUM_MELS]
+   * @param f0 F0 values [T]
+   * @param cancelFlag Optional flag polled between chunks
+   * @param priority Scheduler priority for each chunk run
+   * @return Synthesized waveform, or empty vector on failure/cancel
+   */
+  std::vector<float>
+  inferChunked(MelView mel,
+               const std::vector<float> &f0,
+               const std::atomic<bool> *cancelFlag = nullptr,
+               InferencePriority priority = InferencePriority::Export);
 
   /**
    * Synthesize with pitch shift.
@@ -62,19 +85,28 @@ public:
    * @return Synthesized waveform
    */
   std::vector<float>
-  inferWithPitchShift(const std::vector<std::vector<float>> &mel,
+  inferWithPitchShift(MelView mel,
                       const std::vector<float> &f0, float pitchShiftSemitones);
 
   /**
-   * Asynchronous inference with callback.
+   * Asynchronous inference with callback, run on the shared
+   * InferenceScheduler.
    * @param mel Mel spectrogram
    * @param f0 F0 values
-   * @param callback Called with result on completion
+   * @param callback Called on the message thread with the result (empty if
+   * cancelled or superseded)
+   * @param cancelFlag Optional cancel token
+   * @param priority Scheduler priority
+   * @param coalesceKey A newer request with the same key supersedes a queued
+   * one (empty = never coalesced)
    */
-  void inferAsync(const std::vector<std::vector<float>> &mel,
+  void inferAsync(MelView mel,
                   const std::vector<float> &f0,
                   std::function<void(std::vector<float>)> callback,
-                  std::shared_ptr<std::atomic<bool>> cancelFlag = nullptr);
+                  std::shared_ptr<std::atomic<bool>> cancelFlag = nullptr,
+                  InferencePriority priority =
+                      InferencePriority::InteractivePreview,
+                  const std::string &coalesceKey = {});
 
   // Model parameters
   int getSampleRate() const { return sampleRate; }
@@ -91,12 +123,38 @@ public:
   // Reload model with new settings (call after changing device)
   bool reloadModel();
 
+  // Chunked inference settings
+  void setChunkFrames(int frames) { chunkFrames = std::max(64, frames); }
+  int getChunkFrames() const { return chunkFrames; }
+  void setChunkOverlapFrames(int frames) {
+    chunkOverlapFrames = std::max(0, frames);
+  }
+  int getChunkOverlapFrames() const { return chunkOverlapFrames; }
+  void setMaxParallelChunks(int count) { maxParallelChunks = std::max(1, count); }
+  int getMaxParallelChunks() const { return maxParallelChunks; }
+
+  // Output cache: infer() and inferAsync() answer inputs rendered before
+  // without running a session (Export priority work is not cached).
+  // 0 bytes disables it.
+  void setCacheLimit(size_t bytes) { outputCache.setMaxBytes(bytes); }
+  size_t getCacheLimit() const { return outputCache.getMaxBytes(); }
+  void clearCache() { outputCache.clear(); }
+  VocoderCache::Stats getCacheStats() const { return outputCache.getStats(); }
+
+  // Session pool settings (applied on next load/reload).
+  // 0 = automatic: 2-4 sessions on CPU, always 1 on GPU providers.
+  void setSessionPoolSize(int size) { sessionPoolSize = std::max(0, size); }
+  int getSessionPoolSize() const;
+  // Total CPU threads shared by all pooled sessions (0 = all cores)
+  void setThreadBudget(int threads) { threadBudget = std::max(0, threads); }
+  int getThreadBudget() const { return threadBudget; }
+
 private:
-  struct AsyncTask {
-    std::vector<std::vector<float>> mel;
-    std::vector<float> f0;
-    std::function<void(std::vector<float>)> callback;
-    std::shared_ptr<std::atomic<bool>> cancelFlag;
+  struct ChunkSpan {
+    int start = 0;    // First frame sent to the model (includes overlap)
+    int end = 0;      // One past the last frame sent to the model
+    int keepStart = 0; // Cut point shared with the previous chunk
+    int keepEnd = 0;   // Cut point shared with the next chunk
   };
 
   bool loaded = false;
@@ -105,6 +163,15 @@ private:
   int numMels = 128;
   bool pitchControllable = true;
 
+  // Chunked inference: ~24 s windows with ~190 ms context on each side
+  int chunkFrames = 2048;
+  int chunkOverlapFrames = 16;
+  int maxParallelChunks =
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / 4);
+
+  int sessionPoolSize = 0;
+  int threadBudget = 0;
+
 #ifdef USE_DIRECTML
   juce::String executionDevice = "DirectML";
 #elif defined(USE_CUDA)
@@ -117,23 +184,57 @@ private:
   std::unique_ptr<std::ofstream> logFile;
   int executionDeviceId = 0;
 
-  // Thread safety for async operations
+  VocoderCache outputCache;
+  std::atomic<std::uint64_t> modelIdentity{0};
+
+  // Hash of the model file and device settings; clears the output cache
+  void updateModelIdentity();
+
+  // Set on destruction; async jobs bail out early
   std::atomic<bool> isShuttingDown{false};
-  std::atomic<int> activeAsyncTasks{0};
-  std::mutex asyncMutex;
-  std::condition_variable asyncCondition;
-  std::thread asyncWorker;
-  std::deque<AsyncTask> asyncQueue;
 
-  // Mutex to protect ONNX session access during inference
-  mutable std::mutex inferenceMutex;
+  // Guards the ONNX session: inference takes a shared lock (Run() is
+  // thread-safe), reloading takes an exclusive lock.
+  mutable std::shared_mutex inferenceMutex;
+  std::mutex logMutex;
 
   void log(const std::string &message);
 
+  // loadModel() body; caller holds inferenceMutex exclusively
+  bool loadModelLocked(const juce::File &modelPath);
+
+  /**
+   * Run the model over mel/f0 frames [startFrame, startFrame + numFrames).
+   * Caller must hold inferenceMutex (shared).
+   */
+  std::vector<float> runInference(MelView mel,
+                                  const std::vector<float> &f0,
+                                  size_t startFrame, size_t numFrames,
+                                  InferencePriority priority);
+
+  /**
+   * Split [0, numFrames) into overlapping chunks, moving each cut point to
+   * the middle of a nearby unvoiced run when one exists.
+   */
+  std::vector<ChunkSpan> planChunks(const std::vector<float> &f0,
+                                    int numFrames) const;
+
+  int resolveSessionPoolSize() const;
+
 #ifdef HAVE_ONNXRUNTIME
   std::unique_ptr<Ort::Env> onnxEnv;
-  std::unique_ptr<Ort::Session> onnxSession;
   std::unique_ptr<Ort::AllocatorWithDefaultOptions> allocator;
+  std::unique_ptr<Ort::PrepackedWeightsContainer> prepackedWeights;
+
+  // Session pool: each inference checks out one session for its Run()
+  std::vector<std::unique_ptr<Ort::Session>> sessionPool;
+  std::vector<Ort::Session *> freeSessions;
+  mutable std::mutex poolMutex;
+  std::condition_variable poolCondition;
+
+  Ort::Session *acquireSession();
+  void releaseSession(Ort::Session *session);
+  void releaseSessionPool();
 
   // Input/output names (cached)
   std::vector<const char *> inputNames;
@@ -142,7 +243,7 @@ private:
   std::vector<std::string> outputNameStrings;
 
   // Create session options based on current settings
-  Ort::SessionOptions createSessionOptions();
+  Ort::SessionOptions createSessionOptions(int poolSize);
 #endif
 
   /**
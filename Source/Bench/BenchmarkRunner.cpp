@@ -0,0 +1,152 @@
+#include "BenchmarkRunner.h"
+#include "../Utils/SystemMemory.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+
+BenchmarkRunner::BenchmarkRunner(Options optionsIn)
+    : options(std::move(optionsIn)) {
+  options.iterations = std::max(1, options.iterations);
+  options.warmupIterations = std::max(0, options.warmupIterations);
+}
+
+bool BenchmarkRunner::isEnabled(const juce::String &name) const {
+  return options.filter.isEmpty() || name.contains(options.filter);
+}
+
+void BenchmarkRunner::run(const juce::String &name, double audioSeconds,
+                          const std::function<bool()> &fn) {
+  if (!isEnabled(name))
+    return;
+
+  Result result;
+  result.name = name;
+  result.audioSeconds = audioSeconds;
+
+  std::cerr << name << "..." << std::endl;
+
+  for (int i = 0; i < options.warmupIterations + options.iterations; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    const bool ok = fn();
+    const auto end = std::chrono::steady_clock::now();
+    if (!ok) {
+      result.error = "failed on iteration " + juce::String(i);
+      break;
+    }
+    if (i >= options.warmupIterations)
+      result.milliseconds.push_back(
+          std::chrono::duration<double, std::milli>(end - start).count());
+  }
+
+  std::sort(result.milliseconds.begin(), result.milliseconds.end());
+  result.peakRssBytes = SystemMemory::getPeakResidentBytes();
+  results.push_back(std::move(result));
+}
+
+void BenchmarkRunner::addMetric(const juce::String &name,
+                                const juce::String &key, double value) {
+  for (auto it = results.rbegin(); it != results.rend(); ++it) {
+    if (it->name == name) {
+      if (!it->skipped)
+        it->metrics.emplace_back(key, value);
+      return;
+    }
+  }
+}
+
+void BenchmarkRunner::skip(const juce::String &name,
+                           const juce::String &reason) {
+  if (!isEnabled(name))
+    return;
+
+  std::cerr << name << ": skipped (" << reason << ")" << std::endl;
+
+  Result result;
+  result.name = name;
+  result.skipped = true;
+  result.error = reason;
+  results.push_back(std::move(result));
+}
+
+double BenchmarkRunner::percentile(const std::vector<double> &sorted,
+                                   double p) {
+  if (sorted.empty())
+    return 0.0;
+  // Linear interpolation between closest ranks
+  const double rank = p * static_cast<double>(sorted.size() - 1);
+  const size_t lower = static_cast<size_t>(rank);
+  const size_t upper = std::min(sorted.size() - 1, lower + 1);
+  const double t = rank - static_cast<double>(lower);
+  return sorted[lower] + (sorted[upper] - sorted[lower]) * t;
+}
+
+juce::var BenchmarkRunner::toJson() const {
+  juce::Array<juce::var> cases;
+  for (const auto &result : results) {
+    auto *entry = new juce::DynamicObject();
+    entry->setProperty("name", result.name);
+
+    if (result.skipped) {
+      entry->setProperty("skipped", true);
+      entry->setProperty("reason", result.error);
+      cases.add(juce::var(entry));
+      continue;
+    }
+    if (result.error.isNotEmpty())
+      entry->setProperty("error", result.error);
+
+    const auto &ms = result.milliseconds;
+    const double mean =
+        ms.empty() ? 0.0
+                   : std::accumulate(ms.begin(), ms.end(), 0.0) / ms.size();
+    const double median = percentile(ms, 0.5);
+
+    entry->setProperty("iterations", static_cast<int>(ms.size()));
+    entry->setProperty("audioSeconds", result.audioSeconds);
+
+    auto *latency = new juce::DynamicObject();
+    latency->setProperty("min", ms.empty() ? 0.0 : ms.front());
+    latency->setProperty("mean", mean);
+    latency->setProperty("p50", median);
+    latency->setProperty("p90", percentile(ms, 0.9));
+    latency->setProperty("p99", percentile(ms, 0.99));
+    latency->setProperty("max", ms.empty() ? 0.0 : ms.back());
+    entry->setProperty("latencyMs", juce::var(latency));
+
+    // Seconds of audio processed per second of wall time, at the median
+    if (result.audioSeconds > 0.0 && median > 0.0)
+      entry->setProperty("realtimeFactor",
+                         result.audioSeconds / (median / 1000.0));
+
+    entry->setProperty("peakRssBytes",
+                       static_cast<juce::int64>(result.peakRssBytes));
+
+    if (!result.metrics.empty()) {
+      auto *metrics = new juce::DynamicObject();
+      for (const auto &[key, value] : result.metrics)
+        metrics->setProperty(key, value);
+      entry->setProperty("metrics", juce::var(metrics));
+    }
+    cases.add(juce::var(entry));
+  }
+
+  auto *system = new juce::DynamicObject();
+  system->setProperty("os", juce::SystemStats::getOperatingSystemName());
+  system->setProperty("cpu", juce::SystemStats::getCpuModel());
+  system->setProperty("logicalCores", juce::SystemStats::getNumCpus());
+  system->setProperty("physicalCores",
+                      juce::SystemStats::getNumPhysicalCpus());
+  system->setProperty("memoryMB", juce::SystemStats::getMemorySizeInMegabytes());
+
+  auto *root = new juce::DynamicObject();
+  root->setProperty("timestamp",
+                    juce::Time::getCurrentTime().toISO8601(true));
+  root->setProperty("system", juce::var(system));
+  root->setProperty("warmupIterations", options.warmupIterations);
+  root->setProperty("peakRssBytes",
+                    static_cast<juce::int64>(
+                        SystemMemory::getPeakResidentBytes()));
+  root->setProperty("benchmarks", cases);
+  return juce::var(root);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../JuceHeader.h"
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * Times benchmark cases and collects the results for hachitune_bench.
+ *
+ * Each case runs a few untimed warm-up iterations, then the timed ones.
+ * Results carry latency percentiles, throughput as a multiple of real time
+ * for the audio the case processes, and the process peak RSS when the case
+ * finished (monotonic, so growth between cases is that case's high water).
+ */
+class BenchmarkRunner {
+public:
+  struct Options {
+    int iterations = 10;
+    int warmupIterations = 2;
+    juce::String filter; // Run only cases whose name contains this
+  };
+
+  explicit BenchmarkRunner(Options options);
+
+  bool isEnabled(const juce::String &name) const;
+
+  /**
+   * Time fn. audioSeconds is the audio covered by one call, for the
+   * real-time factor; pass 0 for cases with no audio duration. fn returns
+   * false on failure, which stops the case and records an error.
+   */
+  void run(const juce::String &name, double audioSeconds,
+           const std::function<bool()> &fn);
+
+  /**
+   * Attach an extra figure, such as an accuracy measure, to the result of
+   * the last case run as name. Ignored if that case did not run.
+   */
+  void addMetric(const juce::String &name, const juce::String &key,
+                 double value);
+
+  /** Record a case that could not run, e.g. because a model is missing. */
+  void skip(const juce::String &name, const juce::String &reason);
+
+  /** All results plus environment details, for writing as JSON. */
+  juce::var toJson() const;
+
+private:
+  struct Result {
+    juce::String name;
+    double audioSeconds = 0.0;
+    std::vector<double> milliseconds; // Sorted
+    std::int64_t peakRssBytes = 0;
+    std::vector<std::pair<juce::String, double>> metrics;
+    juce::String error;
+    bool skipped = false;
+  };
+
+  static double percentile(const std::vector<double> &sorted, double p);
+
+  Options options;
+  std::vector<Result> results;
+};
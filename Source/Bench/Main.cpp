@@ -0,0 +1,573 @@
+#include "../Audio/Analysis/AudioAnalyzer.h"
+#include "../Audio/FCPEPitchDetector.h"
+#include "../Audio/IO/AudioFileManager.h"
+#include "../Audio/RMVPEPitchDetector.h"
+#include "../Audio/SOMEDetector.h"
+#include "../Audio/Synthesis/IncrementalSynthesizer.h"
+#include "../Audio/Vocoder.h"
+#include "../JuceHeader.h"
+#include "../Models/ProjectSerializer.h"
+#include "../Utils/BasePitchCurve.h"
+#include "../Utils/CenteredMelSpectrogram.h"
+#include "../Utils/Constants.h"
+#include "../Utils/F0Smoother.h"
+#include "../Utils/MelSpectrogram.h"
+#include "../Utils/PitchCurveProcessor.h"
+#include "../Utils/WaveformPeaks.h"
+#include "BenchmarkRunner.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+namespace {
+struct Models {
+  std::unique_ptr<RMVPEPitchDetector> rmvpe;
+  std::unique_ptr<FCPEPitchDetector> fcpe;
+  std::unique_ptr<SOMEDetector> some;
+  std::unique_ptr<Vocoder> vocoder;
+};
+
+/** A named input with its audio and, once prepared, its analysis. */
+struct Input {
+  juce::String label;
+  Project project;
+};
+
+void printUsage() {
+  std::cout
+      << "Usage: hachitune-bench [options] [fixture audio files...]\n"
+         "\n"
+         "Times the analysis and synthesis hot paths on synthetic singing of\n"
+         "several lengths and on any fixture files given, and prints the\n"
+         "results as JSON.\n"
+         "\n"
+         "Options:\n"
+         "  -o, --output <file>     Write JSON here instead of stdout\n"
+         "      --models <dir>      Model directory (default: models/ next to\n"
+         "                          this executable); missing models skip\n"
+         "                          their cases\n"
+         "      --lengths <list>    Synthetic lengths in seconds (default "
+         "5,30,120)\n"
+         "  -n, --iterations <n>    Timed iterations per case (default 10)\n"
+         "      --warmup <n>        Untimed iterations per case (default 2)\n"
+         "      --filter <text>     Run only cases whose name contains text\n"
+         "  -h, --help              Show this help\n";
+}
+
+void loadModels(const juce::File &dir, Models &models) {
+  auto rmvpe = std::make_unique<RMVPEPitchDetector>();
+  if (rmvpe->loadModel(dir.getChildFile("rmvpe.onnx")))
+    models.rmvpe = std::move(rmvpe);
+
+  auto fcpe = std::make_unique<FCPEPitchDetector>();
+  if (fcpe->loadModel(dir.getChildFile("fcpe.onnx"),
+                      dir.getChildFile("mel_filterbank.bin"),
+                      dir.getChildFile("cent_table.bin")))
+    models.fcpe = std::move(fcpe);
+
+  auto some = std::make_unique<SOMEDetector>();
+  if (some->loadModel(dir.getChildFile("some.onnx")))
+    models.some = std::move(some);
+
+  auto vocoder = std::make_unique<Vocoder>();
+  if (vocoder->loadModel(dir.getChildFile("pc_nsf_hifigan.onnx"))) {
+    // Repeated runs on the same input would otherwise time the output
+    // cache; vocoder/inferCached measures that separately
+    vocoder->setCacheLimit(0);
+    models.vocoder = std::move(vocoder);
+  }
+}
+
+/**
+ * Deterministic stand-in for a vocal take: notes of 0.25-0.8 s separated by
+ * short rests, each a harmonic tone with vibrato and a little breath noise.
+ * The ground-truth F0, voicing and notes are filled in directly, so the
+ * model-free cases do not depend on a pitch detector.
+ */
+void makeSyntheticInput(double seconds, Input &input) {
+  juce::Random random(1234);
+  const int numSamples = static_cast<int>(seconds * SAMPLE_RATE);
+
+  auto &audioData = input.project.getAudioData();
+  audioData.sampleRate = SAMPLE_RATE;
+  audioData.waveform.setSize(1, numSamples);
+  audioData.waveform.clear();
+  auto *samples = audioData.waveform.getWritePointer(0);
+
+  MelSpectrogram mel(SAMPLE_RATE, N_FFT, HOP_SIZE, NUM_MELS, FMIN, FMAX);
+  const int numFrames = mel.getNumFrames(numSamples);
+  std::vector<float> f0(static_cast<size_t>(numFrames), 0.0f);
+  std::vector<bool> voiced(static_cast<size_t>(numFrames), false);
+
+  double phase = 0.0;
+  int position = static_cast<int>(0.2 * SAMPLE_RATE);
+  while (position < numSamples) {
+    const int length = static_cast<int>(
+        (0.25 + 0.55 * random.nextDouble()) * SAMPLE_RATE);
+    const int end = std::min(numSamples, position + length);
+    const float midi = 55.0f + static_cast<float>(random.nextInt(18));
+
+    for (int i = position; i < end; ++i) {
+      const double t = static_cast<double>(i - position) / SAMPLE_RATE;
+      const double twoPi = juce::MathConstants<double>::twoPi;
+      const double vibrato = 0.3 * std::sin(twoPi * 5.5 * t);
+      const double hz = midiToFreq(midi + static_cast<float>(vibrato));
+      phase += twoPi * hz / SAMPLE_RATE;
+
+      // 10 ms attack and release
+      const double fade =
+          std::min({1.0, t / 0.01,
+                    static_cast<double>(end - i) / (0.01 * SAMPLE_RATE)});
+      double sample = 0.0;
+      for (int k = 1; k <= 8; ++k)
+        sample += std::sin(phase * k) / k;
+      samples[i] = static_cast<float>(0.2 * fade * sample) +
+                   0.002f * (random.nextFloat() * 2.0f - 1.0f);
+
+      const int frame = i / HOP_SIZE;
+      if (frame < numFrames) {
+        f0[static_cast<size_t>(frame)] = static_cast<float>(hz);
+        voiced[static_cast<size_t>(frame)] = true;
+      }
+    }
+
+    const int startFrame = position / HOP_SIZE;
+    const int endFrame = std::min(numFrames, end / HOP_SIZE);
+    if (endFrame > startFrame)
+      input.project.addNote(Note(startFrame, endFrame, midi));
+
+    position = end + static_cast<int>((0.05 + 0.15 * random.nextDouble()) *
+                                      SAMPLE_RATE);
+  }
+
+  audioData.melSpectrogram = mel.compute(samples, numSamples);
+  audioData.f0 = f0;
+  audioData.voicedMask = std::move(voiced);
+  PitchCurveProcessor::rebuildBaseFromNotes(input.project);
+
+  // Delta from the ground truth so composeF0 works on realistic curves
+  audioData.deltaPitch =
+      BasePitchCurve::calculateDeltaPitch(f0, audioData.basePitch, 0);
+  PitchCurveProcessor::composeF0InPlace(input.project, false);
+
+  input.label = (seconds == std::floor(seconds)
+                     ? juce::String(static_cast<int>(seconds))
+                     : juce::String(seconds, 1)) +
+                "s";
+}
+
+/** Read a fixture and analyze it with whichever detectors loaded. */
+bool makeFixtureInput(const juce::File &file, Models &models, Input &input) {
+  juce::AudioBuffer<float> buffer;
+  if (!AudioFileManager::readAudioFile(file, buffer))
+    return false;
+
+  input.label = file.getFileName();
+  input.project.setFilePath(file);
+  auto &audioData = input.project.getAudioData();
+  audioData.waveform = std::move(buffer);
+  audioData.sampleRate = SAMPLE_RATE;
+
+  if (!models.rmvpe && !models.fcpe) {
+    // Mel only; the cases needing pitch data are skipped
+    MelSpectrogram mel(SAMPLE_RATE, N_FFT, HOP_SIZE, NUM_MELS, FMIN, FMAX);
+    audioData.melSpectrogram =
+        mel.compute(audioData.waveform.getReadPointer(0),
+                    audioData.waveform.getNumSamples());
+    return !audioData.melSpectrogram.empty();
+  }
+
+  AudioAnalyzer analyzer;
+  analyzer.setRMVPEDetector(models.rmvpe.get());
+  analyzer.setFCPEDetector(models.fcpe.get());
+  analyzer.setSOMEDetector(models.some.get());
+  analyzer.setPitchDetectorType(models.rmvpe ? PitchDetectorType::RMVPE
+                                             : PitchDetectorType::FCPE);
+  bool completed = false;
+  analyzer.analyze(
+      input.project, [](double, const juce::String &) {},
+      [&completed]() { completed = true; });
+  return completed;
+}
+
+void runInputCases(BenchmarkRunner &bench, Models &models, Input &input,
+                   const juce::File &tempDir) {
+  auto &project = input.project;
+  auto &audioData = project.getAudioData();
+  const float *audio = audioData.waveform.getReadPointer(0);
+  const int numSamples = audioData.waveform.getNumSamples();
+  const double seconds = static_cast<double>(numSamples) / SAMPLE_RATE;
+  const auto &label = input.label;
+  const bool hasPitch = !audioData.f0.empty() && !project.getNotes().empty();
+
+  {
+    MelSpectrogram mel(SAMPLE_RATE, N_FFT, HOP_SIZE, NUM_MELS, FMIN, FMAX);
+    bench.run("mel/compute/" + label, seconds,
+              [&] { return !mel.compute(audio, numSamples).empty(); });
+  }
+
+  {
+    bench.run("waveformPeaks/build/" + label, seconds, [&] {
+      WaveformPeaks peaks;
+      peaks.update(audio, numSamples);
+      return peaks.getNumSamples() == numSamples;
+    });
+
+    // One overview-width sweep of pixel columns across the whole file
+    WaveformPeaks peaks;
+    peaks.update(audio, numSamples);
+    constexpr int columns = 2048;
+    bench.run("waveformPeaks/query2048/" + label, 0.0, [&] {
+      float sum = 0.0f;
+      for (int px = 0; px < columns; ++px)
+        sum += peaks
+                   .query(static_cast<std::int64_t>(numSamples) * px / columns,
+                          static_cast<std::int64_t>(numSamples) * (px + 1) /
+                              columns)
+                   .getMagnitude();
+      return sum >= 0.0f;
+    });
+  }
+
+  if (!hasPitch) {
+    bench.skip("pitch/*/" + label, "no pitch data for this input");
+  } else {
+    bench.run("f0Smoother/smoothF0/" + label, seconds, [&] {
+      return !F0Smoother::smoothF0(audioData.f0, audioData.voicedMask).empty();
+    });
+
+    std::vector<BasePitchCurve::NoteSegment> segments;
+    for (const auto &note : project.getNotes())
+      if (!note.isRest())
+        segments.push_back(
+            {note.getStartFrame(), note.getEndFrame(), note.getMidiNote()});
+    bench.run("basePitch/generateForNotes/" + label, seconds, [&] {
+      return !BasePitchCurve::generateForNotes(segments,
+                                               audioData.getNumFrames())
+                  .empty();
+    });
+
+    bench.run("pitchCurve/composeF0/" + label, seconds, [&] {
+      return !PitchCurveProcessor::composeF0(project, true).empty();
+    });
+  }
+
+  // One-shot inference only for lengths the editor sends in one piece
+  const auto f0 = hasPitch ? PitchCurveProcessor::composeF0(project, true)
+                           : std::vector<float>{};
+  if (!models.rmvpe)
+    bench.skip("rmvpe/extractF0/" + label, "rmvpe.onnx not loaded");
+  else
+    bench.run("rmvpe/extractF0/" + label, seconds, [&] {
+      return !models.rmvpe->extractF0(audio, numSamples, SAMPLE_RATE).empty();
+    });
+
+  if (!models.fcpe)
+    bench.skip("fcpe/extractF0/" + label, "fcpe.onnx not loaded");
+  else
+    bench.run("fcpe/extractF0/" + label, seconds, [&] {
+      return !models.fcpe->extractF0(audio, numSamples, SAMPLE_RATE).empty();
+    });
+
+  if (!models.some)
+    bench.skip("some/detectNotes/" + label, "some.onnx not loaded");
+  else
+    bench.run("some/detectNotes/" + label, seconds, [&] {
+      models.some->detectNotes(audio, numSamples, SAMPLE_RATE);
+      return true;
+    });
+
+  if (!models.vocoder || !hasPitch) {
+    bench.skip("vocoder/*/" + label, models.vocoder
+                                         ? "no pitch data for this input"
+                                         : "pc_nsf_hifigan.onnx not loaded");
+  } else {
+    if (seconds <= 30.0)
+      bench.run("vocoder/infer/" + label, seconds, [&] {
+        return !models.vocoder->infer(audioData.melSpectrogram, f0).empty();
+      });
+    bench.run("vocoder/inferChunked/" + label, seconds, [&] {
+      return !models.vocoder->inferChunked(audioData.melSpectrogram, f0)
+                  .empty();
+    });
+
+    // Undo/redo path: the same input again, answered from the cache
+    if (seconds <= 30.0) {
+      auto &vocoder = *models.vocoder;
+      const auto cacheLimit = vocoder.getCacheLimit();
+      vocoder.setCacheLimit(256 * 1024 * 1024);
+      vocoder.infer(audioData.melSpectrogram, f0);
+      bench.run("vocoder/inferCached/" + label, seconds, [&] {
+        return !vocoder.infer(audioData.melSpectrogram, f0).empty();
+      });
+      vocoder.clearCache();
+      vocoder.setCacheLimit(cacheLimit);
+    }
+  }
+
+  const auto projectFile =
+      tempDir.getChildFile("bench_" + label).withFileExtension("htpx");
+  bench.run("serializer/save/" + label, seconds, [&] {
+    return ProjectSerializer::saveToFile(project, projectFile);
+  });
+  bench.run("serializer/load/" + label, seconds, [&] {
+    Project loaded;
+    return ProjectSerializer::loadFromFile(loaded, projectFile);
+  });
+
+  // Edit one note near the middle and wait for it to be spliced back in,
+  // as the editor does after a drag
+  if (!models.vocoder || !hasPitch) {
+    bench.skip("incremental/roundTrip/" + label,
+               models.vocoder ? "no pitch data for this input"
+                              : "pc_nsf_hifigan.onnx not loaded");
+  } else {
+    IncrementalSynthesizer synth;
+    synth.setProject(&project);
+    synth.setVocoder(models.vocoder.get());
+
+    auto &notes = project.getNotes();
+    auto &note = notes[notes.size() / 2];
+    const double noteSeconds = framesToSeconds(note.getDurationFrames());
+    float step = 1.0f;
+
+    bench.run("incremental/roundTrip/" + label, noteSeconds, [&] {
+      note.setMidiNote(note.getMidiNote() + step);
+      step = -step;
+      note.markDirty();
+      PitchCurveProcessor::rebuildBaseFromNotesInRange(
+          project, note.getStartFrame(), note.getEndFrame());
+
+      std::promise<bool> done;
+      auto result = done.get_future();
+      synth.synthesizeRegion(nullptr, [&done](bool success) {
+        done.set_value(success);
+      });
+      return result.get();
+    });
+  }
+}
+
+/**
+ * Compare batched F0 against extractF0 on the same clips: the largest pitch
+ * difference in cents over frames both call voiced, and the share of frames
+ * whose voicing (or presence, if lengths differ) disagrees.
+ */
+void addBatchDeviation(BenchmarkRunner &bench, const juce::String &name,
+                       const std::vector<std::vector<float>> &batched,
+                       const std::vector<std::vector<float>> &single) {
+  double maxCents = 0.0;
+  size_t mismatched = 0;
+  size_t total = 0;
+  for (size_t i = 0; i < batched.size() && i < single.size(); ++i) {
+    const auto &a = batched[i];
+    const auto &b = single[i];
+    const size_t common = std::min(a.size(), b.size());
+    for (size_t t = 0; t < common; ++t) {
+      if ((a[t] > 0.0f) != (b[t] > 0.0f))
+        ++mismatched;
+      else if (a[t] > 0.0f)
+        maxCents = std::max(maxCents,
+                            std::abs(1200.0 * std::log2(a[t] / b[t])));
+    }
+    mismatched += std::max(a.size(), b.size()) - common;
+    total += std::max(a.size(), b.size());
+  }
+  bench.addMetric(name, "maxCentsVsExtractF0", maxCents);
+  bench.addMetric(name, "voicingMismatchVsExtractF0",
+                  total > 0 ? static_cast<double>(mismatched) / total : 0.0);
+}
+
+/**
+ * A folder of short takes as the CLI pre-analyzes them: one extractF0Batch
+ * call against extractF0 clip by clip, plus how far the padded batch rows
+ * drift from the single runs.
+ */
+template <typename Detector>
+void runBatchCase(BenchmarkRunner &bench, Detector *detector,
+                  const juce::String &prefix, const juce::String &modelFile,
+                  const std::vector<Input> &inputs, const juce::String &label,
+                  double totalSeconds) {
+  if (detector == nullptr) {
+    bench.skip(prefix + "/extractF0Batch/" + label, modelFile + " not loaded");
+    return;
+  }
+
+  std::vector<typename Detector::Clip> clips;
+  for (const auto &input : inputs) {
+    const auto &waveform = input.project.getAudioData().waveform;
+    clips.push_back(
+        {waveform.getReadPointer(0), waveform.getNumSamples(), SAMPLE_RATE});
+  }
+
+  auto runSingly = [&] {
+    std::vector<std::vector<float>> f0;
+    for (const auto &clip : clips)
+      f0.push_back(
+          detector->extractF0(clip.audio, clip.numSamples, clip.sampleRate));
+    return f0;
+  };
+
+  const auto batchName = prefix + "/extractF0Batch/" + label;
+  bench.run(batchName, totalSeconds, [&] {
+    return detector->extractF0Batch(clips).size() == clips.size();
+  });
+  bench.run(prefix + "/extractF0Sequential/" + label, totalSeconds,
+            [&] { return runSingly().size() == clips.size(); });
+
+  if (bench.isEnabled(batchName))
+    addBatchDeviation(bench, batchName, detector->extractF0Batch(clips),
+                      runSingly());
+}
+
+void runBatchCases(BenchmarkRunner &bench, Models &models) {
+  // Sixteen phrases of 3-3.75 s, so the padding ratio keeps them in one
+  // batch and every row but the longest is padded
+  constexpr int numClips = 16;
+  std::vector<Input> inputs(numClips);
+  double totalSeconds = 0.0;
+  for (int i = 0; i < numClips; ++i) {
+    const double seconds = 3.0 + 0.05 * i;
+    makeSyntheticInput(seconds, inputs[static_cast<size_t>(i)]);
+    totalSeconds += seconds;
+  }
+  const juce::String label = juce::String(numClips) + "x3s";
+
+  runBatchCase(bench, models.rmvpe.get(), "rmvpe", "rmvpe.onnx", inputs,
+               label, totalSeconds);
+  runBatchCase(bench, models.fcpe.get(), "fcpe", "fcpe.onnx", inputs, label,
+               totalSeconds);
+}
+
+void runCases(BenchmarkRunner &bench, Models &models,
+              const std::vector<double> &lengths,
+              const juce::Array<juce::File> &fixtures) {
+  const auto tempDir =
+      juce::File::getSpecialLocation(juce::File::tempDirectory)
+          .getChildFile("hachitune_bench");
+  tempDir.createDirectory();
+
+  {
+    // A 2 s note stretched to 1.5x, the typical drag-to-lengthen edit
+    Input input;
+    makeSyntheticInput(3.0, input);
+    const auto &audioData = input.project.getAudioData();
+    const int startFrame = secondsToFrames(0.5f);
+    const int endFrame = secondsToFrames(2.5f);
+    CenteredMelSpectrogram centered(SAMPLE_RATE, N_FFT, N_FFT, NUM_MELS, FMIN,
+                                    FMAX);
+    MelMatrix stretched;
+    bench.run("centeredMel/computeTimeStretched/2s_x1.5", 2.0, [&] {
+      centered.computeTimeStretched(audioData.waveform.getReadPointer(0),
+                                    audioData.waveform.getNumSamples(),
+                                    startFrame, endFrame,
+                                    (endFrame - startFrame) * 3 / 2, stretched);
+      return !stretched.empty();
+    });
+  }
+
+  runBatchCases(bench, models);
+
+  for (double seconds : lengths) {
+    Input input;
+    makeSyntheticInput(seconds, input);
+    runInputCases(bench, models, input, tempDir);
+  }
+
+  for (const auto &file : fixtures) {
+    Input input;
+    if (!makeFixtureInput(file, models, input)) {
+      bench.skip("fixture/" + file.getFileName(), "could not load or analyze");
+      continue;
+    }
+    runInputCases(bench, models, input, tempDir);
+  }
+
+  tempDir.deleteRecursively();
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+  BenchmarkRunner::Options options;
+  juce::File modelsDirectory =
+      juce::File::getSpecialLocation(juce::File::currentExecutableFile)
+          .getParentDirectory()
+          .getChildFile("models");
+  juce::File outputFile;
+  std::vector<double> lengths{5.0, 30.0, 120.0};
+  juce::Array<juce::File> fixtures;
+
+  const juce::StringArray args(argv + 1, argc - 1);
+  for (int i = 0; i < args.size(); ++i) {
+    const auto &arg = args[i];
+    auto nextValue = [&]() -> juce::String {
+      if (i + 1 >= args.size()) {
+        std::cerr << "Missing value for " << arg << std::endl;
+        std::exit(2);
+      }
+      return args[++i];
+    };
+    const auto cwd = juce::File::getCurrentWorkingDirectory();
+
+    if (arg == "-h" || arg == "--help") {
+      printUsage();
+      return 0;
+    } else if (arg == "-o" || arg == "--output") {
+      outputFile = cwd.getChildFile(nextValue());
+    } else if (arg == "--models") {
+      modelsDirectory = cwd.getChildFile(nextValue());
+    } else if (arg == "--lengths") {
+      lengths.clear();
+      for (const auto &token :
+           juce::StringArray::fromTokens(nextValue(), ",", ""))
+        if (token.getDoubleValue() > 0.0)
+          lengths.push_back(token.getDoubleValue());
+    } else if (arg == "-n" || arg == "--iterations") {
+      options.iterations = nextValue().getIntValue();
+    } else if (arg == "--warmup") {
+      options.warmupIterations = nextValue().getIntValue();
+    } else if (arg == "--filter") {
+      options.filter = nextValue();
+    } else if (arg.startsWith("-")) {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      printUsage();
+      return 2;
+    } else {
+      const auto file = cwd.getChildFile(arg);
+      if (!file.existsAsFile()) {
+        std::cerr << "Fixture not found: " << file.getFullPathName()
+                  << std::endl;
+        return 2;
+      }
+      fixtures.add(file);
+    }
+  }
+
+  Models models;
+  loadModels(modelsDirectory, models);
+  BenchmarkRunner bench(options);
+
+  // Incremental synthesis reports back on the message thread, so the cases
+  // run on a worker while this thread dispatches messages
+  std::thread worker([&] {
+    runCases(bench, models, lengths, fixtures);
+    juce::MessageManager::getInstance()->stopDispatchLoop();
+  });
+  juce::MessageManager::getInstance()->runDispatchLoop();
+  worker.join();
+
+  const auto json = juce::JSON::toString(bench.toJson());
+  if (outputFile == juce::File{}) {
+    std::cout << json << std::endl;
+  } else if (!outputFile.replaceWithText(json)) {
+    std::cerr << "Cannot write " << outputFile.getFullPathName() << std::endl;
+    return 1;
+  }
+  return 0;
+}
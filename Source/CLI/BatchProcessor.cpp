@@ -0,0 +1,457 @@
+#include "BatchProcessor.h"
+#include "../Audio/Analysis/AnalysisCache.h"
+#include "../Audio/Analysis/AudioAnalyzer.h"
+#include "../Audio/IO/AudioFileManager.h"
+#include "../Audio/IO/MidiExporter.h"
+#include "../Models/ProjectCache.h"
+#include "../Models/ProjectSerializer.h"
+#include "../Utils/Constants.h"
+#include "../Utils/MelSpectrogram.h"
+#include "../Utils/PitchCurveProcessor.h"
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+std::mutex consoleMutex;
+
+// Inputs decoded and pitch-tracked together; the detectors' batch cap
+constexpr int preAnalysisGroupSize = 32;
+
+// Longest input pitch-tracked in a batch: one detector chunk. Longer files
+// already run as parallel chunks through extractF0
+constexpr double maxBatchedSeconds = 30.0;
+
+void report(const juce::String &line, bool isError = false) {
+  std::lock_guard<std::mutex> lock(consoleMutex);
+  (isError ? std::cerr : std::cout) << line << std::endl;
+}
+} // namespace
+
+bool BatchProcessor::Preset::loadFromFile(const juce::File &file) {
+  const auto json = juce::JSON::parse(file);
+  auto *object = json.getDynamicObject();
+  if (object == nullptr)
+    return false;
+
+  if (object->hasProperty("globalPitchOffset"))
+    globalPitchOffset =
+        static_cast<float>(object->getProperty("globalPitchOffset"));
+  if (object->hasProperty("snapToSemitone"))
+    snapToSemitone = static_cast<bool>(object->getProperty("snapToSemitone"));
+  if (object->hasProperty("pitchDetector")) {
+    const auto name =
+        object->getProperty("pitchDetector").toString().toUpperCase();
+    if (!isPitchDetectorTypeName(name))
+      return false;
+    detector = stringToPitchDetectorType(name);
+  }
+  return true;
+}
+
+BatchProcessor::BatchProcessor(Options optionsIn)
+    : options(std::move(optionsIn)) {}
+
+BatchProcessor::~BatchProcessor() { cancelFlag = true; }
+
+bool BatchProcessor::loadModels() {
+  const auto &dir = options.modelsDirectory;
+  auto require = [&dir](const char *name) {
+    auto file = dir.getChildFile(name);
+    if (!file.existsAsFile())
+      report("Model not found: " + file.getFullPathName(), true);
+    return file;
+  };
+
+  // Only the selected detector is required; the other is a fallback
+  if (options.preset.detector == PitchDetectorType::FCPE) {
+    fcpeDetector = std::make_unique<FCPEPitchDetector>();
+    if (!fcpeDetector->loadModel(require("fcpe.onnx"),
+                                 dir.getChildFile("mel_filterbank.bin"),
+                                 dir.getChildFile("cent_table.bin"))) {
+      report("Failed to load FCPE model", true);
+      return false;
+    }
+  } else {
+    rmvpeDetector = std::make_unique<RMVPEPitchDetector>();
+    if (!rmvpeDetector->loadModel(require("rmvpe.onnx"))) {
+      report("Failed to load RMVPE model", true);
+      return false;
+    }
+  }
+
+  // Without SOME, notes fall back to F0-based segmentation
+  auto someModel = dir.getChildFile("some.onnx");
+  if (someModel.existsAsFile()) {
+    someDetector = std::make_unique<SOMEDetector>();
+    if (!someDetector->loadModel(someModel))
+      someDetector.reset();
+  }
+
+  if (options.exportWav) {
+    vocoder = std::make_unique<Vocoder>();
+    if (!vocoder->loadModel(require("pc_nsf_hifigan.onnx"))) {
+      report("Failed to load vocoder model", true);
+      return false;
+    }
+  }
+  return true;
+}
+
+int BatchProcessor::run(const std::vector<Input> &inputs) {
+  const auto outputStems = getOutputStems(inputs);
+  const int numInputs = static_cast<int>(inputs.size());
+  int failures = 0;
+  int started = 0;
+
+  while (started < numInputs && !cancelFlag.load()) {
+    const int groupSize = std::min(preAnalysisGroupSize, numInputs - started);
+    std::vector<Job> jobs(static_cast<size_t>(groupSize));
+    for (int k = 0; k < groupSize; ++k) {
+      const auto index = static_cast<size_t>(started + k);
+      jobs[static_cast<size_t>(k)].input = inputs[index].file;
+      jobs[static_cast<size_t>(k)].outputStem = outputStems[index];
+    }
+
+    forEachJob(jobs, [this](Job &job) { decodeShortInput(job); });
+    preAnalyze(jobs);
+
+    std::atomic<int> groupFailures{0};
+    started += forEachJob(jobs, [&](Job &job) {
+      if (!processFile(job))
+        ++groupFailures;
+    });
+    failures += groupFailures.load();
+  }
+
+  // Inputs never started because of cancel count as failed
+  return failures + (numInputs - started);
+}
+
+int BatchProcessor::forEachJob(std::vector<Job> &jobs,
+                               const std::function<void(Job &)> &fn) {
+  std::atomic<size_t> nextJob{0};
+  std::atomic<int> started{0};
+
+  auto worker = [&]() {
+    while (!cancelFlag.load()) {
+      const size_t index = nextJob.fetch_add(1);
+      if (index >= jobs.size())
+        return;
+      ++started;
+      fn(jobs[index]);
+    }
+  };
+
+  const int numWorkers = juce::jlimit(
+      1, std::max(1, static_cast<int>(jobs.size())), options.jobs);
+  std::vector<std::thread> workers;
+  for (int i = 1; i < numWorkers; ++i)
+    workers.emplace_back(worker);
+  worker();
+  for (auto &t : workers)
+    t.join();
+  return started.load();
+}
+
+void BatchProcessor::decodeShortInput(Job &job) {
+  // A .htpx input may restore its analysis, so it is loaded in processFile
+  if (job.input.hasFileExtension("htpx"))
+    return;
+
+  {
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    std::unique_ptr<juce::AudioFormatReader> reader(
+        formatManager.createReaderFor(job.input));
+    if (reader == nullptr || reader->sampleRate <= 0.0 ||
+        reader->lengthInSamples > reader->sampleRate * maxBatchedSeconds)
+      return;
+  }
+
+  auto project = std::make_unique<Project>();
+  if (decodeAudio(job.input, *project))
+    job.project = std::move(project);
+}
+
+void BatchProcessor::preAnalyze(std::vector<Job> &jobs) {
+  const auto detectorType = options.preset.detector;
+  const bool useFCPE = detectorType == PitchDetectorType::FCPE;
+  if (useFCPE ? fcpeDetector == nullptr : rmvpeDetector == nullptr)
+    return;
+  const auto modelFile = useFCPE ? fcpeDetector->getModelFile()
+                                 : rmvpeDetector->getModelFile();
+
+  // Inputs whose F0 is already cached skip the detector in analyze()
+  auto &analysisCache = AnalysisCache::getInstance();
+  std::vector<Job *> batched;
+  for (auto &job : jobs) {
+    if (!job.project)
+      continue;
+    std::vector<float> cachedF0;
+    const auto key = AnalysisCache::f0Key(
+        AnalysisCache::hashAudio(job.project->getAudioData()), detectorType,
+        modelFile);
+    if (!analysisCache.loadF0(key, cachedF0))
+      batched.push_back(&job);
+  }
+  if (batched.size() < 2)
+    return;
+
+  std::vector<std::vector<float>> f0;
+  if (useFCPE) {
+    std::vector<FCPEPitchDetector::Clip> clips;
+    for (auto *job : batched) {
+      const auto &waveform = job->project->getAudioData().waveform;
+      clips.push_back(
+          {waveform.getReadPointer(0), waveform.getNumSamples(), SAMPLE_RATE});
+    }
+    f0 = fcpeDetector->extractF0Batch(clips, 0.05f, &cancelFlag);
+  } else {
+    std::vector<RMVPEPitchDetector::Clip> clips;
+    for (auto *job : batched) {
+      const auto &waveform = job->project->getAudioData().waveform;
+      clips.push_back(
+          {waveform.getReadPointer(0), waveform.getNumSamples(), SAMPLE_RATE});
+    }
+    f0 = rmvpeDetector->extractF0Batch(
+        clips, RMVPEPitchDetector::DEFAULT_THRESHOLD, &cancelFlag);
+  }
+
+  // Cancelled or failed: analyze() runs the detector per file instead
+  if (f0.size() != batched.size())
+    return;
+  for (size_t i = 0; i < batched.size(); ++i)
+    batched[i]->f0 = std::move(f0[i]);
+}
+
+bool BatchProcessor::processFile(Job &job) {
+  const auto startTime = juce::Time::getMillisecondCounterHiRes();
+  const auto &input = job.input;
+  const auto name = input.getFileName();
+
+  // Taken from the job so the project is freed as soon as this input is done
+  const auto ownedProject =
+      job.project ? std::move(job.project) : std::make_unique<Project>();
+  auto &project = *ownedProject;
+  if (!loadProject(input, project, std::move(job.f0))) {
+    report(name + ": failed to load or analyze", true);
+    return false;
+  }
+
+  applyPreset(project);
+
+  if (!job.outputStem.getParentDirectory().createDirectory()) {
+    report(name + ": cannot create " +
+               job.outputStem.getParentDirectory().getFullPathName(),
+           true);
+    return false;
+  }
+
+  if (options.exportWav) {
+    juce::AudioBuffer<float> rendered;
+    const auto file = getOutputFile(job, "wav");
+    if (!render(project, rendered) ||
+        !AudioFileManager::writeWavFile(file, rendered,
+                                        vocoder->getSampleRate())) {
+      report(name + ": render failed", true);
+      return false;
+    }
+  }
+
+  if (options.exportMidi) {
+    MidiExporter::ExportOptions midiOptions;
+    midiOptions.tempo = options.midiTempo;
+    if (!MidiExporter::exportToFile(project.getNotes(),
+                                    getOutputFile(job, "mid"),
+                                    midiOptions)) {
+      report(name + ": MIDI export failed", true);
+      return false;
+    }
+  }
+
+  if (options.exportProject) {
+    const auto file = getOutputFile(job, "htpx");
+    project.setProjectFilePath(file);
+    if (!ProjectSerializer::saveToFile(project, file)) {
+      report(name + ": project save failed", true);
+      return false;
+    }
+  }
+
+  const auto seconds =
+      (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+  report(name + ": " + juce::String(project.getNotes().size()) +
+         " notes, done in " + juce::String(seconds, 1) + " s");
+  return true;
+}
+
+bool BatchProcessor::decodeAudio(const juce::File &audioFile,
+                                 Project &project) {
+  juce::AudioBuffer<float> buffer;
+  if (!AudioFileManager::readAudioFile(audioFile, buffer, &cancelFlag))
+    return false;
+
+  project.setFilePath(audioFile);
+  auto &audioData = project.getAudioData();
+  audioData.waveform = std::move(buffer);
+  audioData.sampleRate = SAMPLE_RATE;
+  return true;
+}
+
+bool BatchProcessor::loadProject(const juce::File &input, Project &project,
+                                 std::vector<float> precomputedF0) {
+  auto &audioData = project.getAudioData();
+
+  // Short audio inputs arrive already decoded by run()
+  if (audioData.waveform.getNumSamples() == 0) {
+    // A .htpx input keeps its notes and pitch edits
+    juce::File audioFile = input;
+    if (input.hasFileExtension("htpx")) {
+      if (!ProjectSerializer::loadFromFile(project, input))
+        return false;
+      audioFile = project.getFilePath();
+    }
+
+    if (!decodeAudio(audioFile, project))
+      return false;
+
+    if (audioFile != input) {
+      project.setProjectFilePath(input);
+      if (restoreAnalysis(project, input))
+        return true;
+    }
+  }
+
+  AudioAnalyzer analyzer;
+  analyzer.setRMVPEDetector(rmvpeDetector.get());
+  analyzer.setFCPEDetector(fcpeDetector.get());
+  analyzer.setSOMEDetector(someDetector.get());
+  analyzer.setPitchDetectorType(options.preset.detector);
+  if (!precomputedF0.empty())
+    analyzer.setPrecomputedF0(options.preset.detector,
+                              std::move(precomputedF0));
+
+  bool completed = false;
+  analyzer.analyze(
+      project, [](double, const juce::String &) {},
+      [&completed]() { completed = true; });
+  return completed && !audioData.f0.empty();
+}
+
+bool BatchProcessor::restoreAnalysis(Project &project,
+                                     const juce::File &projectFile) {
+  auto &audioData = project.getAudioData();
+  const auto key = ProjectCache::computeKey(audioData);
+  if (ProjectCache::load(project, key,
+                         ProjectCache::getCacheFileFor(projectFile)))
+    return true;
+
+  // Pitch data from the JSON is still valid; only the mel is missing
+  if (audioData.f0.empty())
+    return false;
+
+  MelSpectrogram melComputer(audioData.sampleRate, N_FFT, HOP_SIZE, NUM_MELS,
+                             FMIN, FMAX);
+  const int numSamples = audioData.waveform.getNumSamples();
+  if (static_cast<int>(audioData.f0.size()) !=
+      melComputer.getNumFrames(numSamples))
+    return false;
+
+  audioData.melSpectrogram = melComputer.compute(
+      audioData.waveform.getReadPointer(0), numSamples, &cancelFlag);
+  return !audioData.melSpectrogram.empty();
+}
+
+void BatchProcessor::applyPreset(Project &project) const {
+  const auto &preset = options.preset;
+  if (preset.globalPitchOffset)
+    project.setGlobalPitchOffset(*preset.globalPitchOffset);
+
+  if (!preset.snapToSemitone)
+    return;
+
+  for (auto &note : project.getNotes()) {
+    if (note.isRest())
+      continue;
+    note.setMidiNote(std::round(note.getAdjustedMidiNote()));
+    note.setPitchOffset(0.0f);
+    note.markDirty();
+  }
+  PitchCurveProcessor::rebuildBaseFromNotes(project);
+}
+
+bool BatchProcessor::render(const Project &project,
+                            juce::AudioBuffer<float> &output) {
+  const auto &audioData = project.getAudioData();
+  if (!vocoder || audioData.melSpectrogram.empty() || audioData.f0.empty())
+    return false;
+
+  // Same curve the editor renders: notes, pitch edits, vibrato and offset
+  const auto f0 = project.getAdjustedF0();
+  if (f0.empty())
+    return false;
+  const auto samples =
+      vocoder->inferChunked(audioData.melSpectrogram, f0, &cancelFlag);
+  if (samples.empty())
+    return false;
+
+  output.setSize(1, static_cast<int>(samples.size()));
+  output.copyFrom(0, 0, samples.data(), static_cast<int>(samples.size()));
+  return true;
+}
+
+std::vector<juce::File>
+BatchProcessor::getOutputStems(const std::vector<Input> &inputs) const {
+  auto stemFor = [this](const Input &input, const juce::String &suffix) {
+    const auto dir =
+        options.outputDirectory != juce::File{}
+            ? options.outputDirectory.getChildFile(input.relativeDirectory)
+            : input.file.getParentDirectory();
+    return dir.getChildFile(input.file.getFileNameWithoutExtension() +
+                            suffix);
+  };
+
+  auto key = [](const juce::File &file) {
+    return file.getFullPathName().toLowerCase();
+  };
+
+  // Workers write their outputs concurrently, so two inputs must never
+  // share a stem. Compare case-insensitively to stay safe on macOS and
+  // Windows file systems.
+  std::map<juce::String, int> counts;
+  for (const auto &input : inputs)
+    ++counts[key(stemFor(input, {}))];
+
+  std::vector<juce::File> stems;
+  stems.reserve(inputs.size());
+  std::set<juce::String> taken;
+  for (const auto &input : inputs) {
+    auto stem = stemFor(input, {});
+    if (counts[key(stem)] > 1) {
+      const auto base =
+          "_" + input.file.getFileExtension().trimCharactersAtStart(".");
+      stem = stemFor(input, base);
+      for (int n = 2; taken.count(key(stem)) > 0 || counts.count(key(stem)) > 0;
+           ++n)
+        stem = stemFor(input, base + "_" + juce::String(n));
+    }
+    taken.insert(key(stem));
+    stems.push_back(stem);
+  }
+  return stems;
+}
+
+juce::File BatchProcessor::getOutputFile(const Job &job,
+                                         const juce::String &extension) {
+  auto file = job.outputStem.withFileExtension(extension);
+  // Never overwrite the input itself
+  if (file == job.input)
+    file = job.outputStem.getSiblingFile(job.outputStem.getFileName() + "_out")
+               .withFileExtension(extension);
+  return file;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "../Audio/FCPEPitchDetector.h"
+#include "../Audio/PitchDetectorType.h"
+#include "../Audio/RMVPEPitchDetector.h"
+#include "../Audio/SOMEDetector.h"
+#include "../Audio/Vocoder.h"
+#include "../JuceHeader.h"
+#include "../Models/Project.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+/**
+ * Headless analyze / edit / render pipeline behind the hachitune-cli tool.
+ *
+ * Each input (an audio file, or a .htpx project whose edits are kept) is
+ * loaded, analyzed unless a saved analysis can be restored, optionally has
+ * the preset applied, and is exported as any of WAV, MIDI and .htpx. Up to
+ * Options::jobs inputs are processed at once. The models are loaded once
+ * and shared by every worker; ONNX Runtime sessions allow concurrent runs.
+ *
+ * Inputs go through in groups. Short audio files in a group are decoded
+ * first and pitch-tracked together with one extractF0Batch call, so a
+ * folder of sliced phrases runs the detector as a few batched tensors
+ * instead of one small run per file.
+ */
+class BatchProcessor {
+public:
+  struct Preset {
+    // Semitones; replaces the project's own offset when set
+    std::optional<float> globalPitchOffset;
+    bool snapToSemitone = false; // Round every note to the nearest semitone
+    PitchDetectorType detector = PitchDetectorType::RMVPE;
+
+    /**
+     * Read "globalPitchOffset", "snapToSemitone" and "pitchDetector"
+     * ("RMVPE" or "FCPE") from a JSON file; missing keys keep their value.
+     * Returns false if the file is not a JSON object or names an unknown
+     * detector.
+     */
+    bool loadFromFile(const juce::File &file);
+  };
+
+  /** An input file and, when it was found inside an input directory, its
+   *  folder relative to that directory (mirrored under outputDirectory). */
+  struct Input {
+    juce::File file;
+    juce::String relativeDirectory;
+  };
+
+  struct Options {
+    juce::File modelsDirectory;
+    juce::File outputDirectory; // Next to each input if unset
+    int jobs = 1;
+    bool exportWav = true;
+    bool exportMidi = true;
+    bool exportProject = true;
+    float midiTempo = 120.0f;
+    Preset preset;
+  };
+
+  explicit BatchProcessor(Options options);
+  ~BatchProcessor();
+
+  /** Load the models; false (with a message on stderr) if one is missing. */
+  bool loadModels();
+
+  /**
+   * Process every input; returns the number that failed. Inputs whose
+   * outputs would share a name (x.wav and x.flac, or x.wav from two input
+   * directories) get the source extension, then a number, appended.
+   */
+  int run(const std::vector<Input> &inputs);
+
+  /** Stop after the files currently in progress. Safe from any thread. */
+  void cancel() { cancelFlag = true; }
+
+private:
+  /** One input on its way through run(). */
+  struct Job {
+    juce::File input;
+    juce::File outputStem;            // Output path without extension
+    std::unique_ptr<Project> project; // Set if decoded ahead for batching
+    std::vector<float> f0;            // Raw batched F0 for the analyzer
+  };
+
+  /** Run fn on each job with up to Options::jobs threads until cancelled;
+   *  returns how many jobs were started. */
+  int forEachJob(std::vector<Job> &jobs, const std::function<void(Job &)> &fn);
+  void decodeShortInput(Job &job);
+  void preAnalyze(std::vector<Job> &jobs);
+  bool processFile(Job &job);
+  bool decodeAudio(const juce::File &audioFile, Project &project);
+  bool loadProject(const juce::File &input, Project &project,
+                   std::vector<float> precomputedF0);
+  bool restoreAnalysis(Project &project, const juce::File &projectFile);
+  void applyPreset(Project &project) const;
+  bool render(const Project &project, juce::AudioBuffer<float> &output);
+  std::vector<juce::File> getOutputStems(const std::vector<Input> &inputs) const;
+  static juce::File getOutputFile(const Job &job, const juce::String &extension);
+
+  Options options;
+  std::unique_ptr<RMVPEPitchDetector> rmvpeDetector;
+  std::unique_ptr<FCPEPitchDetector> fcpeDetector;
+  std::unique_ptr<SOMEDetector> someDetector;
+  std::unique_ptr<Vocoder> vocoder;
+  std::atomic<bool> cancelFlag{false};
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BatchProcessor)
+};
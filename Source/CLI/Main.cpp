@@ -0,0 +1,196 @@
+#include "../JuceHeader.h"
+#include "BatchProcessor.h"
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace {
+BatchProcessor *activeProcessor = nullptr;
+
+void handleInterrupt(int) {
+  if (activeProcessor != nullptr)
+    activeProcessor->cancel();
+}
+
+void printUsage() {
+  std::cout
+      << "Usage: hachitune-cli [options] <input>...\n"
+         "\n"
+         "Inputs are audio files, .htpx projects (edits are kept) or\n"
+         "directories of either.\n"
+         "\n"
+         "Options:\n"
+         "  -o, --output <dir>      Output directory (default: next to input);\n"
+         "                          subfolders of input directories are kept\n"
+         "  -j, --jobs <n>          Files processed at once\n"
+         "      --models <dir>      Model directory (default: models/ next to\n"
+         "                          this executable)\n"
+         "      --detector <name>   Pitch detector: rmvpe or fcpe\n"
+         "      --preset <file>     JSON preset (globalPitchOffset,\n"
+         "                          snapToSemitone, pitchDetector)\n"
+         "      --pitch-offset <st> Global pitch offset in semitones\n"
+         "      --snap              Snap notes to the nearest semitone\n"
+         "      --export <list>     Comma-separated: wav,midi,htpx (default "
+         "all)\n"
+         "      --tempo <bpm>       Tempo written to MIDI files (default 120)\n"
+         "  -r, --recursive         Search input directories recursively\n"
+         "  -h, --help              Show this help\n";
+}
+
+bool isSupportedInput(const juce::File &file) {
+  return file.hasFileExtension("wav;mp3;flac;aiff;aif;ogg;htpx");
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+  BatchProcessor::Options options;
+  options.modelsDirectory =
+      juce::File::getSpecialLocation(juce::File::currentExecutableFile)
+          .getParentDirectory()
+          .getChildFile("models");
+  options.jobs = std::max(1, juce::SystemStats::getNumCpus() / 4);
+
+  juce::StringArray paths;
+  bool recursive = false;
+  std::optional<float> pitchOffset;
+  std::optional<PitchDetectorType> detector;
+  bool snap = false;
+
+  const juce::StringArray args(argv + 1, argc - 1);
+  for (int i = 0; i < args.size(); ++i) {
+    const auto &arg = args[i];
+    auto nextValue = [&]() -> juce::String {
+      if (i + 1 >= args.size()) {
+        std::cerr << "Missing value for " << arg << std::endl;
+        std::exit(2);
+      }
+      return args[++i];
+    };
+
+    if (arg == "-h" || arg == "--help") {
+      printUsage();
+      return 0;
+    } else if (arg == "-o" || arg == "--output") {
+      options.outputDirectory = juce::File::getCurrentWorkingDirectory()
+                                    .getChildFile(nextValue());
+    } else if (arg == "-j" || arg == "--jobs") {
+      options.jobs = std::max(1, nextValue().getIntValue());
+    } else if (arg == "--models") {
+      options.modelsDirectory = juce::File::getCurrentWorkingDirectory()
+                                    .getChildFile(nextValue());
+    } else if (arg == "--detector") {
+      const auto name = nextValue().toUpperCase();
+      if (!isPitchDetectorTypeName(name)) {
+        std::cerr << "Unknown pitch detector: " << name.toLowerCase()
+                  << std::endl;
+        printUsage();
+        return 2;
+      }
+      detector = stringToPitchDetectorType(name);
+    } else if (arg == "--preset") {
+      const auto file =
+          juce::File::getCurrentWorkingDirectory().getChildFile(nextValue());
+      if (!options.preset.loadFromFile(file)) {
+        std::cerr << "Cannot read preset: " << file.getFullPathName()
+                  << std::endl;
+        return 2;
+      }
+    } else if (arg == "--pitch-offset") {
+      pitchOffset = nextValue().getFloatValue();
+    } else if (arg == "--snap") {
+      snap = true;
+    } else if (arg == "--export") {
+      auto formats =
+          juce::StringArray::fromTokens(nextValue().toLowerCase(), ",", "");
+      formats.trim();
+      formats.removeEmptyStrings();
+      for (const auto &format : formats) {
+        if (format != "wav" && format != "midi" && format != "mid" &&
+            format != "htpx") {
+          std::cerr << "Unknown export format: " << format << std::endl;
+          printUsage();
+          return 2;
+        }
+      }
+      options.exportWav = formats.contains("wav");
+      options.exportMidi = formats.contains("midi") || formats.contains("mid");
+      options.exportProject = formats.contains("htpx");
+    } else if (arg == "--tempo") {
+      options.midiTempo = juce::jmax(1.0f, nextValue().getFloatValue());
+    } else if (arg == "-r" || arg == "--recursive") {
+      recursive = true;
+    } else if (arg.startsWith("-")) {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      printUsage();
+      return 2;
+    } else {
+      paths.add(arg);
+    }
+  }
+
+  // Command-line flags override the preset file
+  if (pitchOffset)
+    options.preset.globalPitchOffset = pitchOffset;
+  if (snap)
+    options.preset.snapToSemitone = true;
+  if (detector)
+    options.preset.detector = *detector;
+
+  if (!options.exportWav && !options.exportMidi && !options.exportProject) {
+    std::cerr << "Nothing to export" << std::endl;
+    return 2;
+  }
+
+  std::vector<BatchProcessor::Input> inputs;
+  for (const auto &path : paths) {
+    const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(path);
+    if (file.isDirectory()) {
+      auto children = file.findChildFiles(juce::File::findFiles, recursive);
+      children.sort();
+      for (const auto &child : children) {
+        if (!isSupportedInput(child))
+          continue;
+        // Kept under --output so same-named files in subfolders don't clash
+        const auto folder = child.getParentDirectory();
+        inputs.push_back(
+            {child, folder == file ? juce::String{}
+                                   : folder.getRelativePathFrom(file)});
+      }
+    } else if (file.existsAsFile()) {
+      inputs.push_back({file, {}});
+    } else {
+      std::cerr << "Input not found: " << file.getFullPathName() << std::endl;
+      return 2;
+    }
+  }
+
+  if (inputs.empty()) {
+    printUsage();
+    return 2;
+  }
+
+  if (options.outputDirectory != juce::File{} &&
+      !options.outputDirectory.createDirectory()) {
+    std::cerr << "Cannot create output directory: "
+              << options.outputDirectory.getFullPathName() << std::endl;
+    return 2;
+  }
+
+  BatchProcessor processor(options);
+  if (!processor.loadModels())
+    return 2;
+
+  activeProcessor = &processor;
+  std::signal(SIGINT, handleInterrupt);
+  const int failures = processor.run(inputs);
+  std::signal(SIGINT, SIG_DFL);
+  activeProcessor = nullptr;
+
+  const int numInputs = static_cast<int>(inputs.size());
+  std::cout << (numInputs - failures) << " of " << numInputs
+            << " files processed" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
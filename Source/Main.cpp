@@ -1,6 +1,7 @@
 // Main.cpp - Cross-platform entry point (macOS uses native menu inside
 // MainComponent)
 
+#include "Audio/Inference/InferenceScheduler.h"
 #include "JuceHeader.h"
 #include "UI/MainComponent.h"
 #include "UI/StyledComponents.h"
@@ -103,6 +104,7 @@ public:
   void initialise(const juce::String &commandLine) override {
     juce::ignoreUnused(commandLine);
     AppLogger::init();
+    inferenceUser = std::make_unique<InferenceScheduler::ScopedUser>();
     LOG("========== APP STARTING ==========");
     LOG("Initializing fonts...");
     AppFont::initialize();
@@ -123,6 +125,8 @@ public:
 
   void shutdown() override {
     mainWindow = nullptr;
+    // Join the inference workers now that nothing can submit to them
+    inferenceUser = nullptr;
     TimecodeFont::shutdown();
     AppFont::shutdown(); // Release font resources before JUCE shuts down
   }
@@ -220,6 +224,7 @@ public:
   };
 
 private:
+  std::unique_ptr<InferenceScheduler::ScopedUser> inferenceUser;
   std::unique_ptr<MainWindow> mainWindow;
 #if JUCE_STANDALONE_APPLICATION
   std::unique_ptr<SplashWindow> splashWindow;
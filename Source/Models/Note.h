@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../JuceHeader.h"
+#include "../Utils/MelMatrix.h"
 #include <vector>
 
 /**
@@ -94,8 +95,8 @@ public:
     bool hasClipWaveform() const { return !clipWaveform.empty(); }
 
     // Mel spectrogram clip (original mel frames for this note)
-    const std::vector<std::vector<float>>& getClipMel() const { return clipMel; }
-    void setClipMel(std::vector<std::vector<float>> mel) { clipMel = std::move(mel); }
+    const MelMatrix& getClipMel() const { return clipMel; }
+    void setClipMel(MelMatrix mel) { clipMel = std::move(mel); }
     bool hasClipMel() const { return !clipMel.empty(); }
 
     // Selection
@@ -146,7 +147,7 @@ private:
 
     std::vector<float> f0Values;
     std::vector<float> clipWaveform;
-    std::vector<std::vector<float>> clipMel;  // Mel spectrogram clip [T, numMels]
+    MelMatrix clipMel;  // Mel spectrogram clip [T, numMels]
     bool selected = false;
     bool dirty = false;  // For incremental synthesis
     bool rest = false;   // Rest note (silence placeholder)
@@ -0,0 +1,111 @@
+#include "NoteIndex.h"
+#include <algorithm>
+#include <limits>
+
+NoteIndex& NoteIndex::operator=(const NoteIndex& other)
+{
+    if (this != &other)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        built = false;
+    }
+    return *this;
+}
+
+std::vector<size_t> NoteIndex::findOverlapping(const std::vector<Note>& notes, std::uint64_t revision,
+                                               int startFrame, int endFrame)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    updateIfNeeded(notes, revision);
+
+    std::vector<size_t> result;
+
+    const auto last = firstStartingAtOrAfter(endFrame);
+    for (auto i = firstReaching(startFrame); i < last; ++i)
+    {
+        const auto& entry = entries[i];
+        if (entry.endFrame > startFrame)
+            result.push_back(entry.noteIndex);
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+int NoteIndex::findContaining(const std::vector<Note>& notes, std::uint64_t revision, int frame)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    updateIfNeeded(notes, revision);
+
+    // Lowest vector index among the overlapping entries, so the answer
+    // matches a linear scan without collecting and sorting them
+    int result = -1;
+    const auto last = firstStartingAtOrAfter(frame + 1);
+    for (auto i = firstReaching(frame); i < last; ++i)
+    {
+        const auto& entry = entries[i];
+        if (entry.endFrame > frame && (result < 0 || entry.noteIndex < static_cast<size_t>(result)))
+            result = static_cast<int>(entry.noteIndex);
+    }
+    return result;
+}
+
+int NoteIndex::findStartingAt(const std::vector<Note>& notes, std::uint64_t revision, int startFrame)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    updateIfNeeded(notes, revision);
+
+    auto it = std::lower_bound(entries.begin(), entries.end(), startFrame,
+                               [](const Entry& e, int frame) { return e.startFrame < frame; });
+
+    int result = -1;
+    for (; it != entries.end() && it->startFrame == startFrame; ++it)
+    {
+        if (result < 0 || it->noteIndex < static_cast<size_t>(result))
+            result = static_cast<int>(it->noteIndex);
+    }
+    return result;
+}
+
+size_t NoteIndex::firstReaching(int startFrame) const
+{
+    // Entries before it all end at or before startFrame
+    return static_cast<size_t>(std::partition_point(maxEndFrames.begin(), maxEndFrames.end(),
+                                                    [startFrame](int end) { return end <= startFrame; })
+                               - maxEndFrames.begin());
+}
+
+size_t NoteIndex::firstStartingAtOrAfter(int endFrame) const
+{
+    return static_cast<size_t>(std::partition_point(entries.begin(), entries.end(),
+                                                    [endFrame](const Entry& e) { return e.startFrame < endFrame; })
+                               - entries.begin());
+}
+
+void NoteIndex::updateIfNeeded(const std::vector<Note>& notes, std::uint64_t revision)
+{
+    if (built && builtData == notes.data() && builtSize == notes.size() && builtRevision == revision)
+        return;
+
+    entries.clear();
+    entries.reserve(notes.size());
+    for (size_t i = 0; i < notes.size(); ++i)
+        entries.push_back({notes[i].getStartFrame(), notes[i].getEndFrame(), i});
+
+    // Stable so equal starts keep vector order
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const Entry& a, const Entry& b) { return a.startFrame < b.startFrame; });
+
+    maxEndFrames.resize(entries.size());
+    int maxEnd = std::numeric_limits<int>::min();
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        maxEnd = std::max(maxEnd, entries[i].endFrame);
+        maxEndFrames[i] = maxEnd;
+    }
+
+    builtData = notes.data();
+    builtSize = notes.size();
+    builtRevision = revision;
+    built = true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Note.h"
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * Interval index over a vector of notes by output frame range.
+ *
+ * Entries are sorted by start frame alongside a running maximum of end
+ * frames, so a query binary-searches to the first entry that can reach the
+ * range and stops at the first one starting past it: O(log n + k) for notes
+ * that do not overlap each other, as detected notes do not.
+ *
+ * The index rebuilds itself on the next query after the vector is resized
+ * or reallocated or the owner's layout revision changes; Project raises its
+ * revision whenever notes are added, removed, split or moved. Results are
+ * indices into the vector in vector order, the order a linear scan would
+ * find them in.
+ */
+class NoteIndex
+{
+public:
+    NoteIndex() = default;
+
+    // A copy starts unbuilt and indexes its owner's notes on first query
+    NoteIndex(const NoteIndex&) {}
+    NoteIndex& operator=(const NoteIndex&);
+
+    /** Notes starting before endFrame and ending after startFrame. */
+    std::vector<size_t> findOverlapping(const std::vector<Note>& notes, std::uint64_t revision,
+                                        int startFrame, int endFrame);
+
+    /** First note containing frame, or -1. */
+    int findContaining(const std::vector<Note>& notes, std::uint64_t revision, int frame);
+
+    /** First note starting exactly at startFrame, or -1. */
+    int findStartingAt(const std::vector<Note>& notes, std::uint64_t revision, int startFrame);
+
+private:
+    struct Entry
+    {
+        int startFrame;
+        int endFrame;
+        size_t noteIndex;
+    };
+
+    void updateIfNeeded(const std::vector<Note>& notes, std::uint64_t revision);
+    size_t firstReaching(int startFrame) const;
+    size_t firstStartingAtOrAfter(int endFrame) const;
+
+    std::vector<Entry> entries;      // By start frame
+    std::vector<int> maxEndFrames;   // Max end frame of entries[0..i]
+
+    const Note* builtData = nullptr;
+    size_t builtSize = 0;
+    std::uint64_t builtRevision = 0;
+    bool built = false;
+
+    std::mutex mutex;
+};
@@ -13,25 +13,67 @@ Project::Project()
 {
 }
 
+const WaveformPeaks& Project::getWaveformPeaks()
+{
+    const auto& waveform = audioData.waveform;
+    waveformPeaks.update(waveform.getNumSamples() > 0 ? waveform.getReadPointer(0) : nullptr,
+                         waveform.getNumSamples());
+    return waveformPeaks;
+}
+
+void Project::invalidateWaveformPeaks(int startSample, int numSamples)
+{
+    waveformPeaks.invalidate(startSample, numSamples);
+}
+
 Note* Project::getNoteAtFrame(int frame)
 {
-    for (auto& note : notes)
-    {
-        if (note.containsFrame(frame))
-            return &note;
-    }
-    return nullptr;
+    const int index = noteIndex.findContaining(notes, noteLayoutRevision, frame);
+    return index >= 0 ? &notes[static_cast<size_t>(index)] : nullptr;
 }
 
 std::vector<Note*> Project::getNotesInRange(int startFrame, int endFrame)
 {
     std::vector<Note*> result;
-    for (auto& note : notes)
+    for (size_t index : noteIndex.findOverlapping(notes, noteLayoutRevision, startFrame, endFrame))
+        result.push_back(&notes[index]);
+    return result;
+}
+
+const Project::BasePitchOrder& Project::getBasePitchOrder()
+{
+    if (basePitchOrderBuilt && basePitchOrderData == notes.data() &&
+        basePitchOrderSize == notes.size() && basePitchOrderRevision == noteLayoutRevision)
+        return basePitchOrder;
+
+    auto& indices = basePitchOrder.noteIndices;
+    indices.clear();
+    for (size_t i = 0; i < notes.size(); ++i)
     {
-        if (note.getStartFrame() < endFrame && note.getEndFrame() > startFrame)
-            result.push_back(&note);
+        if (!notes[i].isRest())
+            indices.push_back(i);
     }
-    return result;
+
+    // Stable, matching the sort PitchCurveProcessor gives a full rebuild
+    std::stable_sort(indices.begin(), indices.end(), [this](size_t a, size_t b) {
+        const auto& na = notes[a];
+        const auto& nb = notes[b];
+        if (na.getStartFrame() != nb.getStartFrame())
+            return na.getStartFrame() < nb.getStartFrame();
+        return na.getEndFrame() < nb.getEndFrame();
+    });
+
+    std::vector<BasePitchCurve::NoteSegment> segments;
+    segments.reserve(indices.size());
+    for (size_t index : indices)
+        segments.push_back({notes[index].getStartFrame(), notes[index].getEndFrame(), 0.0f});
+    basePitchOrder.spans = BasePitchCurve::buildSortedSpans(segments);
+
+    basePitchOrderData = notes.data();
+    basePitchOrderSize = notes.size();
+    basePitchOrderRevision = noteLayoutRevision;
+    basePitchOrderBuilt = true;
+    return basePitchOrder;
 }
 
 std::vector<Note*> Project::getSelectedNotes()
@@ -47,15 +89,12 @@ std::vector<Note*> Project::getSelectedNotes()
 
 bool Project::removeNoteByStartFrame(int startFrame)
 {
-    for (auto it = notes.begin(); it != notes.end(); ++it)
-    {
-        if (it->getStartFrame() == startFrame)
-        {
-            notes.erase(it);
-            return true;
-        }
-    }
-    return false;
+    const int index = noteIndex.findStartingAt(notes, noteLayoutRevision, startFrame);
+    if (index < 0)
+        return false;
+    notes.erase(notes.begin() + index);
+    notifyNoteLayoutChanged();
+    return true;
 }
 
 void Project::deselectAllNotes()
@@ -89,9 +128,8 @@ void Project::clearAllDirty()
 {
     for (auto& note : notes)
         note.clearDirty();
-    // Also clear F0 dirty range
-    f0DirtyStart = -1;
-    f0DirtyEnd = -1;
+    // Also clear F0 dirty ranges
+    f0DirtyRanges.clear();
 }
 
 bool Project::hasDirtyNotes() const
@@ -106,58 +144,38 @@ bool Project::hasDirtyNotes() const
 
 void Project::setF0DirtyRange(int startFrame, int endFrame)
 {
-    if (f0DirtyStart < 0 || startFrame < f0DirtyStart)
-        f0DirtyStart = startFrame;
-    if (f0DirtyEnd < 0 || endFrame > f0DirtyEnd)
-        f0DirtyEnd = endFrame;
+    f0DirtyRanges.add(startFrame, endFrame);
 }
 
 void Project::clearF0DirtyRange()
 {
-    f0DirtyStart = -1;
-    f0DirtyEnd = -1;
+    f0DirtyRanges.clear();
 }
 
 bool Project::hasF0DirtyRange() const
 {
-    return f0DirtyStart >= 0 && f0DirtyEnd >= 0;
+    return !f0DirtyRanges.empty();
 }
 
 std::pair<int, int> Project::getF0DirtyRange() const
 {
-    return {f0DirtyStart, f0DirtyEnd};
+    return f0DirtyRanges.getHull();
 }
 
 std::pair<int, int> Project::getDirtyFrameRange() const
 {
-    int minStart = -1;
-    int maxEnd = -1;
-    
-    // Check dirty notes
+    return getDirtyFrameRanges().getHull();
+}
+
+FrameIntervalSet Project::getDirtyFrameRanges() const
+{
+    FrameIntervalSet ranges = f0DirtyRanges;
     for (const auto& note : notes)
     {
         if (note.isDirty())
-        {
-            if (minStart < 0 || note.getStartFrame() < minStart)
-                minStart = note.getStartFrame();
-            if (maxEnd < 0 || note.getEndFrame() > maxEnd)
-                maxEnd = note.getEndFrame();
-        }
-    }
-    
-    // Also include F0 dirty range from Draw mode edits
-    if (f0DirtyStart >= 0)
-    {
-        if (minStart < 0 || f0DirtyStart < minStart)
-            minStart = f0DirtyStart;
-    }
-    if (f0DirtyEnd >= 0)
-    {
-        if (maxEnd < 0 || f0DirtyEnd > maxEnd)
-            maxEnd = f0DirtyEnd;
+            ranges.add(note.getStartFrame(), note.getEndFrame());
     }
-    
-    return {minStart, maxEnd};
+    return ranges;
 }
 
 std::vector<float> Project::getAdjustedF0() const
@@ -2,6 +2,11 @@
 
 #include "../JuceHeader.h"
 #include "Note.h"
+#include "NoteIndex.h"
+#include "../Utils/BasePitchCurve.h"
+#include "../Utils/FrameIntervalSet.h"
+#include "../Utils/WaveformPeaks.h"
+#include <cstdint>
 #include <vector>
 #include <memory>
 
@@ -14,7 +19,7 @@ struct AudioData
     int sampleRate = 44100;
     
     // Extracted features
-    std::vector<std::vector<float>> melSpectrogram;  // [T, NUM_MELS]
+    MelMatrix melSpectrogram;                         // [T, NUM_MELS]
     std::vector<float> f0;                            // [T] (composed: base + delta, dense)
     std::vector<float> baseF0;                        // [T] (cached base pitch in Hz)
     std::vector<float> basePitch;                     // [T] base pitch in MIDI (dense)
@@ -65,15 +70,39 @@ public:
     // Audio data
     AudioData& getAudioData() { return audioData; }
     const AudioData& getAudioData() const { return audioData; }
+
+    // Peak pyramid of the waveform for drawing, brought up to date on each
+    // call. Call from the thread that draws; writers that change waveform
+    // samples in place report them with invalidateWaveformPeaks().
+    const WaveformPeaks& getWaveformPeaks();
+    void invalidateWaveformPeaks(int startSample, int numSamples);
     
     // Notes
     std::vector<Note>& getNotes() { return notes; }
     const std::vector<Note>& getNotes() const { return notes; }
-    void addNote(Note note) { notes.push_back(std::move(note)); }
-    void clearNotes() { notes.clear(); }
+    void addNote(Note note) { notes.push_back(std::move(note)); notifyNoteLayoutChanged(); }
+    void clearNotes() { notes.clear(); notifyNoteLayoutChanged(); }
+
+    // Call after changing which notes exist or their frame ranges through
+    // getNotes() (splits, stretches, undo); the note index rebuilds on the
+    // next lookup
+    void notifyNoteLayoutChanged() { ++noteLayoutRevision; }
 
+    // Frame lookups go through an interval index, rebuilt after edits
     Note* getNoteAtFrame(int frame);
     std::vector<Note*> getNotesInRange(int startFrame, int endFrame);
+
+    // Non-rest notes in the order the base pitch curve sorts them, with
+    // their step-function spans, so ranged base pitch rebuilds read only
+    // the notes they reach. Rebuilt on the first call after a layout
+    // change; call from the editing thread.
+    struct BasePitchOrder
+    {
+        std::vector<size_t> noteIndices;
+        BasePitchCurve::SortedSpans spans;
+    };
+    const BasePitchOrder& getBasePitchOrder();
+
     std::vector<Note*> getSelectedNotes();
     bool removeNoteByStartFrame(int startFrame);
     std::vector<Note*> getDirtyNotes();
@@ -100,11 +129,16 @@ public:
     // Get frame range that needs resynthesis (based on dirty notes)
     // Returns {-1, -1} if no dirty notes
     std::pair<int, int> getDirtyFrameRange() const;
+
+    // Disjoint frame regions that need resynthesis: dirty notes plus F0
+    // dirty ranges, merged where they overlap or touch
+    FrameIntervalSet getDirtyFrameRanges() const;
     
     // Check if any notes are dirty
     bool hasDirtyNotes() const;
     
-    // F0 direct edit dirty tracking (for Draw mode)
+    // F0 direct edit dirty tracking (for Draw mode). Ranges accumulate
+    // until cleared; getF0DirtyRange returns their hull.
     void setF0DirtyRange(int startFrame, int endFrame);
     void clearF0DirtyRange();
     bool hasF0DirtyRange() const;
@@ -126,15 +160,23 @@ private:
     juce::File projectFilePath;
     
     AudioData audioData;
+    WaveformPeaks waveformPeaks;
     std::vector<Note> notes;
+    NoteIndex noteIndex;
+    std::uint64_t noteLayoutRevision = 0;
+
+    BasePitchOrder basePitchOrder;
+    const Note* basePitchOrderData = nullptr;
+    size_t basePitchOrderSize = 0;
+    std::uint64_t basePitchOrderRevision = 0;
+    bool basePitchOrderBuilt = false;
     
     float globalPitchOffset = 0.0f;
     float formantShift = 0.0f;
     float volume = 0.0f;  // dB
     
-    // F0 direct edit dirty range
-    int f0DirtyStart = -1;
-    int f0DirtyEnd = -1;
+    // F0 direct edit dirty ranges
+    FrameIntervalSet f0DirtyRanges;
     
     bool modified = false;
 
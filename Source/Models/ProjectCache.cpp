@@ -0,0 +1,546 @@
+#include "ProjectCache.h"
+#include "../Utils/Constants.h"
+#include "../Utils/ContentHash.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    constexpr char magic[4] = {'H', 'T', 'P', 'C'};
+    constexpr size_t headerSize = 40;
+    constexpr size_t tableEntrySize = 32;
+    constexpr size_t payloadAlignment = 16;
+    constexpr std::uint32_t chunkCompressed = 1u << 0;
+
+    constexpr std::uint32_t makeTag(char a, char b, char c, char d) {
+        return static_cast<std::uint32_t>(static_cast<unsigned char>(a)) |
+               (static_cast<std::uint32_t>(static_cast<unsigned char>(b)) << 8) |
+               (static_cast<std::uint32_t>(static_cast<unsigned char>(c)) << 16) |
+               (static_cast<std::uint32_t>(static_cast<unsigned char>(d)) << 24);
+    }
+
+    constexpr std::uint32_t tagMel = makeTag('M', 'E', 'L', ' ');
+    constexpr std::uint32_t tagF0 = makeTag('F', '0', ' ', ' ');
+    constexpr std::uint32_t tagBaseF0 = makeTag('B', 'F', '0', ' ');
+    constexpr std::uint32_t tagBasePitch = makeTag('B', 'P', 'I', 'T');
+    constexpr std::uint32_t tagDeltaPitch = makeTag('D', 'P', 'I', 'T');
+    constexpr std::uint32_t tagVoicedMask = makeTag('V', 'M', 'S', 'K');
+    constexpr std::uint32_t tagNotes = makeTag('N', 'O', 'T', 'E');
+
+    // How a note clip is stored
+    enum ClipMode : std::uint32_t {
+        clipNone = 0,
+        clipSlice = 1,   // Identical to a range of the global data; store the range
+        clipStored = 2   // Store the values
+    };
+
+    size_t alignUp(size_t value) {
+        return (value + payloadAlignment - 1) & ~(payloadAlignment - 1);
+    }
+
+    /** Appends native-order values to a MemoryBlock. */
+    struct Writer {
+        juce::MemoryOutputStream stream;
+
+        template <typename T>
+        void value(T v) { stream.write(&v, sizeof(T)); }
+
+        void floats(const float* data, size_t count) {
+            value(static_cast<std::uint32_t>(count));
+            if (count > 0)
+                stream.write(data, count * sizeof(float));
+        }
+
+        void floats(const std::vector<float>& values) { floats(values.data(), values.size()); }
+    };
+
+    /** Bounds-checked reader over a chunk payload. */
+    struct Reader {
+        const char* data = nullptr;
+        size_t size = 0;
+        size_t pos = 0;
+        bool ok = true;
+
+        template <typename T>
+        T value() {
+            T v{};
+            if (!ok || pos + sizeof(T) > size) {
+                ok = false;
+                return v;
+            }
+            std::memcpy(&v, data + pos, sizeof(T));
+            pos += sizeof(T);
+            return v;
+        }
+
+        bool floats(std::vector<float>& out) {
+            const auto count = static_cast<size_t>(value<std::uint32_t>());
+            if (!ok || pos + count * sizeof(float) > size)
+                return ok = false;
+            out.resize(count);
+            if (count > 0)
+                std::memcpy(out.data(), data + pos, count * sizeof(float));
+            pos += count * sizeof(float);
+            return true;
+        }
+
+        bool raw(void* dst, size_t numBytes) {
+            if (!ok || pos + numBytes > size)
+                return ok = false;
+            if (numBytes > 0)
+                std::memcpy(dst, data + pos, numBytes);
+            pos += numBytes;
+            return true;
+        }
+    };
+
+    struct PendingChunk {
+        std::uint32_t tag = 0;
+        std::uint32_t flags = 0;
+        juce::MemoryBlock prefix;   // Small header written before body
+        const void* body = nullptr; // Borrowed bulk data (not copied)
+        size_t bodySize = 0;
+        juce::MemoryBlock stored;   // Compressed payload, if compressed
+        size_t rawSize = 0;
+
+        size_t storedSize() const {
+            return (flags & chunkCompressed) ? stored.getSize() : rawSize;
+        }
+    };
+
+    PendingChunk makeChunk(std::uint32_t tag, juce::MemoryBlock prefix,
+                           const void* body = nullptr, size_t bodySize = 0) {
+        PendingChunk chunk;
+        chunk.tag = tag;
+        chunk.prefix = std::move(prefix);
+        chunk.body = body;
+        chunk.bodySize = bodySize;
+        chunk.rawSize = chunk.prefix.getSize() + bodySize;
+        return chunk;
+    }
+
+    PendingChunk makeFloatChunk(std::uint32_t tag, const std::vector<float>& values) {
+        Writer w;
+        w.value(static_cast<std::uint32_t>(values.size()));
+        return makeChunk(tag, w.stream.getMemoryBlock(), values.data(),
+                         values.size() * sizeof(float));
+    }
+
+    void compressChunk(PendingChunk& chunk) {
+        juce::MemoryOutputStream out(chunk.stored, false);
+        {
+            juce::GZIPCompressorOutputStream gzip(out, 1);
+            gzip.write(chunk.prefix.getData(), chunk.prefix.getSize());
+            if (chunk.bodySize > 0)
+                gzip.write(chunk.body, chunk.bodySize);
+            gzip.flush();
+        }
+        chunk.stored.setSize(out.getDataSize());
+        chunk.flags |= chunkCompressed;
+    }
+
+    bool writeChunkPayload(juce::OutputStream& out, const PendingChunk& chunk) {
+        if (chunk.flags & chunkCompressed)
+            return out.write(chunk.stored.getData(), chunk.stored.getSize());
+        if (chunk.prefix.getSize() > 0 && !out.write(chunk.prefix.getData(), chunk.prefix.getSize()))
+            return false;
+        return chunk.bodySize == 0 || out.write(chunk.body, chunk.bodySize);
+    }
+
+    bool writePadding(juce::OutputStream& out, size_t count) {
+        static const char zeros[payloadAlignment] = {};
+        return count == 0 || out.write(zeros, count);
+    }
+
+    // Clip data is usually an unmodified slice of the global arrays; store a
+    // range instead of a copy when it is.
+    int findMelSlice(const MelMatrix& clip, const MelMatrix& mel, const Note& note) {
+        if (clip.empty() || clip.getNumMels() != mel.getNumMels())
+            return -1;
+        const size_t bytes = clip.size() * static_cast<size_t>(clip.getNumMels()) * sizeof(float);
+        for (int start : {note.getStartFrame(), note.getSrcStartFrame()}) {
+            if (start >= 0 && static_cast<size_t>(start) + clip.size() <= mel.size() &&
+                std::memcmp(mel[static_cast<size_t>(start)], clip.data(), bytes) == 0)
+                return start;
+        }
+        return -1;
+    }
+
+    int findWaveformSlice(const std::vector<float>& clip,
+                          const juce::AudioBuffer<float>& waveform, const Note& note) {
+        if (clip.empty() || waveform.getNumChannels() == 0)
+            return -1;
+        const float* samples = waveform.getReadPointer(0);
+        const auto numSamples = static_cast<size_t>(waveform.getNumSamples());
+        for (int frame : {note.getStartFrame(), note.getSrcStartFrame()}) {
+            const int start = frame * HOP_SIZE;
+            if (start >= 0 && static_cast<size_t>(start) + clip.size() <= numSamples &&
+                std::memcmp(samples + start, clip.data(), clip.size() * sizeof(float)) == 0)
+                return start;
+        }
+        return -1;
+    }
+
+    struct NoteClipData {
+        int startFrame = 0;
+        int endFrame = 0;
+        int srcStartFrame = 0;
+        int srcEndFrame = 0;
+        std::vector<float> f0Values;
+        std::vector<float> deltaPitch;
+        MelMatrix clipMel;
+        std::vector<float> clipWaveform;
+    };
+}
+
+juce::String ProjectCache::Key::toString() const {
+    return juce::String::toHexString(static_cast<juce::int64>(audioHash)).paddedLeft('0', 16) +
+           juce::String::toHexString(static_cast<juce::int64>(settingsHash)).paddedLeft('0', 16);
+}
+
+ProjectCache::Key ProjectCache::computeKey(const AudioData& audioData,
+                                           const juce::String& analysisSettings) {
+    Key key;
+
+    const auto& waveform = audioData.waveform;
+    ContentHash audio;
+    audio.updateValue(static_cast<std::int32_t>(waveform.getNumChannels()));
+    audio.updateValue(static_cast<std::int32_t>(waveform.getNumSamples()));
+    audio.updateValue(static_cast<std::int32_t>(audioData.sampleRate));
+    for (int ch = 0; ch < waveform.getNumChannels(); ++ch)
+        audio.update(waveform.getReadPointer(ch),
+                     static_cast<size_t>(waveform.getNumSamples()) * sizeof(float));
+    key.audioHash = audio.finish();
+
+    ContentHash settings;
+    settings.updateValue(static_cast<std::int32_t>(FORMAT_VERSION));
+    settings.updateValue(static_cast<std::int32_t>(HOP_SIZE));
+    settings.updateValue(static_cast<std::int32_t>(N_FFT));
+    settings.updateValue(static_cast<std::int32_t>(WIN_SIZE));
+    settings.updateValue(static_cast<std::int32_t>(NUM_MELS));
+    settings.updateValue(FMIN);
+    settings.updateValue(FMAX);
+    settings.updateString(analysisSettings.toStdString());
+    key.settingsHash = settings.finish();
+
+    return key;
+}
+
+juce::File ProjectCache::getCacheFileFor(const juce::File& projectFile) {
+    return projectFile.withFileExtension("htpc");
+}
+
+bool ProjectCache::save(const Project& project, const Key& key, const juce::File& file,
+                        bool compress) {
+    if (juce::ByteOrder::isBigEndian())
+        return false;
+
+    const auto& audioData = project.getAudioData();
+    std::vector<PendingChunk> chunks;
+
+    if (!audioData.melSpectrogram.empty()) {
+        const auto& mel = audioData.melSpectrogram;
+        Writer w;
+        w.value(static_cast<std::uint32_t>(mel.getNumFrames()));
+        w.value(static_cast<std::uint32_t>(mel.getNumMels()));
+        chunks.push_back(makeChunk(tagMel, w.stream.getMemoryBlock(), mel.data(),
+                                   mel.size() * static_cast<size_t>(mel.getNumMels()) * sizeof(float)));
+    }
+
+    chunks.push_back(makeFloatChunk(tagF0, audioData.f0));
+    chunks.push_back(makeFloatChunk(tagBaseF0, audioData.baseF0));
+    chunks.push_back(makeFloatChunk(tagBasePitch, audioData.basePitch));
+    chunks.push_back(makeFloatChunk(tagDeltaPitch, audioData.deltaPitch));
+
+    {
+        Writer w;
+        const auto& mask = audioData.voicedMask;
+        w.value(static_cast<std::uint32_t>(mask.size()));
+        std::vector<std::uint8_t> packed((mask.size() + 7) / 8, 0);
+        for (size_t i = 0; i < mask.size(); ++i)
+            if (mask[i])
+                packed[i / 8] |= static_cast<std::uint8_t>(1u << (i % 8));
+        w.stream.write(packed.data(), packed.size());
+        chunks.push_back(makeChunk(tagVoicedMask, w.stream.getMemoryBlock()));
+    }
+
+    {
+        Writer w;
+        const auto& notes = project.getNotes();
+        w.value(static_cast<std::uint32_t>(notes.size()));
+        for (const auto& note : notes) {
+            w.value(static_cast<std::int32_t>(note.getStartFrame()));
+            w.value(static_cast<std::int32_t>(note.getEndFrame()));
+            w.value(static_cast<std::int32_t>(note.getSrcStartFrame()));
+            w.value(static_cast<std::int32_t>(note.getSrcEndFrame()));
+            w.floats(note.getF0Values());
+            w.floats(note.getDeltaPitch());
+
+            const auto& clipMel = note.getClipMel();
+            const int melSlice = findMelSlice(clipMel, audioData.melSpectrogram, note);
+            if (clipMel.empty()) {
+                w.value(static_cast<std::uint32_t>(clipNone));
+            } else if (melSlice >= 0) {
+                w.value(static_cast<std::uint32_t>(clipSlice));
+                w.value(static_cast<std::int32_t>(melSlice));
+                w.value(static_cast<std::int32_t>(clipMel.getNumFrames()));
+            } else {
+                w.value(static_cast<std::uint32_t>(clipStored));
+                w.value(static_cast<std::uint32_t>(clipMel.getNumFrames()));
+                w.value(static_cast<std::uint32_t>(clipMel.getNumMels()));
+                w.stream.write(clipMel.data(),
+                               clipMel.size() * static_cast<size_t>(clipMel.getNumMels()) * sizeof(float));
+            }
+
+            const auto& clipWaveform = note.getClipWaveform();
+            const int waveSlice = findWaveformSlice(clipWaveform, audioData.waveform, note);
+            if (clipWaveform.empty()) {
+                w.value(static_cast<std::uint32_t>(clipNone));
+            } else if (waveSlice >= 0) {
+                w.value(static_cast<std::uint32_t>(clipSlice));
+                w.value(static_cast<std::int32_t>(waveSlice));
+                w.value(static_cast<std::int32_t>(clipWaveform.size()));
+            } else {
+                w.value(static_cast<std::uint32_t>(clipStored));
+                w.floats(clipWaveform);
+            }
+        }
+        chunks.push_back(makeChunk(tagNotes, w.stream.getMemoryBlock()));
+    }
+
+    if (compress)
+        for (auto& chunk : chunks)
+            compressChunk(chunk);
+
+    // Lay out payloads after the header and table
+    std::vector<size_t> offsets(chunks.size());
+    size_t offset = alignUp(headerSize + tableEntrySize * chunks.size());
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        offsets[i] = offset;
+        offset = alignUp(offset + chunks[i].storedSize());
+    }
+
+    juce::TemporaryFile temp(file);
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (!out.openedOk())
+            return false;
+
+        Writer header;
+        header.stream.write(magic, sizeof(magic));
+        header.value(static_cast<std::uint32_t>(FORMAT_VERSION));
+        header.value(key.audioHash);
+        header.value(key.settingsHash);
+        header.value(static_cast<std::uint32_t>(chunks.size()));
+        header.value(static_cast<std::uint32_t>(0));
+        header.value(static_cast<std::uint64_t>(0));
+
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            header.value(chunks[i].tag);
+            header.value(chunks[i].flags);
+            header.value(static_cast<std::uint64_t>(offsets[i]));
+            header.value(static_cast<std::uint64_t>(chunks[i].storedSize()));
+            header.value(static_cast<std::uint64_t>(chunks[i].rawSize));
+        }
+
+        if (!out.write(header.stream.getData(), header.stream.getDataSize()))
+            return false;
+
+        size_t written = header.stream.getDataSize();
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            if (!writePadding(out, offsets[i] - written) || !writeChunkPayload(out, chunks[i]))
+                return false;
+            written = offsets[i] + chunks[i].storedSize();
+        }
+
+        out.flush();
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+bool ProjectCache::readKey(const juce::File& file, Key& key) {
+    juce::FileInputStream in(file);
+    if (!in.openedOk())
+        return false;
+
+    char header[headerSize];
+    if (in.read(header, static_cast<int>(headerSize)) != static_cast<int>(headerSize))
+        return false;
+
+    Reader r{header, headerSize};
+    char fileMagic[4];
+    r.raw(fileMagic, sizeof(fileMagic));
+    const auto version = r.value<std::uint32_t>();
+    key.audioHash = r.value<std::uint64_t>();
+    key.settingsHash = r.value<std::uint64_t>();
+    return r.ok && std::memcmp(fileMagic, magic, sizeof(magic)) == 0 &&
+           version == static_cast<std::uint32_t>(FORMAT_VERSION);
+}
+
+bool ProjectCache::load(Project& project, const Key& expectedKey, const juce::File& file) {
+    if (juce::ByteOrder::isBigEndian() || !file.existsAsFile())
+        return false;
+
+    Key fileKey;
+    if (!readKey(file, fileKey) || fileKey != expectedKey)
+        return false;
+
+    juce::MemoryMappedFile mapped(file, juce::MemoryMappedFile::readOnly);
+    juce::MemoryBlock fallback;
+    const char* base = static_cast<const char*>(mapped.getData());
+    size_t fileSize = mapped.getSize();
+    if (base == nullptr) {
+        if (!file.loadFileAsData(fallback))
+            return false;
+        base = static_cast<const char*>(fallback.getData());
+        fileSize = fallback.getSize();
+    }
+
+    Reader header{base, fileSize};
+    header.pos = 4 + 4 + 8 + 8;
+    const auto numChunks = header.value<std::uint32_t>();
+    header.pos = headerSize;
+
+    AudioData restored;
+    std::vector<NoteClipData> noteClips;
+    bool hasNotes = false;
+
+    for (std::uint32_t i = 0; i < numChunks; ++i) {
+        const auto tag = header.value<std::uint32_t>();
+        const auto flags = header.value<std::uint32_t>();
+        const auto offset = header.value<std::uint64_t>();
+        const auto storedSize = header.value<std::uint64_t>();
+        const auto rawSize = header.value<std::uint64_t>();
+        if (!header.ok || offset > fileSize || storedSize > fileSize - offset)
+            return false;
+
+        Reader r{base + offset, static_cast<size_t>(storedSize)};
+        juce::MemoryBlock inflated;
+        if (flags & chunkCompressed) {
+            juce::MemoryInputStream compressed(base + offset, static_cast<size_t>(storedSize), false);
+            juce::GZIPDecompressorInputStream gzip(compressed);
+            inflated.setSize(static_cast<size_t>(rawSize));
+            auto* dst = static_cast<char*>(inflated.getData());
+            size_t filled = 0;
+            while (filled < rawSize) {
+                const int toRead = static_cast<int>(std::min<size_t>(rawSize - filled, 1 << 24));
+                const int got = gzip.read(dst + filled, toRead);
+                if (got <= 0)
+                    return false;
+                filled += static_cast<size_t>(got);
+            }
+            r = Reader{static_cast<const char*>(inflated.getData()), static_cast<size_t>(rawSize)};
+        }
+
+        if (tag == tagMel) {
+            const auto frames = static_cast<int>(r.value<std::uint32_t>());
+            const auto mels = static_cast<int>(r.value<std::uint32_t>());
+            if (!r.ok || static_cast<size_t>(frames) * static_cast<size_t>(mels) * sizeof(float) > r.size - r.pos)
+                return false;
+            MelMatrix mel(frames, mels);
+            if (!r.raw(mel.data(), mel.size() * static_cast<size_t>(mels) * sizeof(float)))
+                return false;
+            restored.melSpectrogram = std::move(mel);
+        } else if (tag == tagF0) {
+            r.floats(restored.f0);
+        } else if (tag == tagBaseF0) {
+            r.floats(restored.baseF0);
+        } else if (tag == tagBasePitch) {
+            r.floats(restored.basePitch);
+        } else if (tag == tagDeltaPitch) {
+            r.floats(restored.deltaPitch);
+        } else if (tag == tagVoicedMask) {
+            const auto count = static_cast<size_t>(r.value<std::uint32_t>());
+            std::vector<std::uint8_t> packed((count + 7) / 8);
+            if (!r.raw(packed.data(), packed.size()))
+                return false;
+            restored.voicedMask.resize(count);
+            for (size_t j = 0; j < count; ++j)
+                restored.voicedMask[j] = (packed[j / 8] >> (j % 8)) & 1u;
+        } else if (tag == tagNotes) {
+            const auto count = r.value<std::uint32_t>();
+            if (!r.ok || count > r.size)
+                return false;
+            noteClips.resize(count);
+            for (auto& clip : noteClips) {
+                clip.startFrame = r.value<std::int32_t>();
+                clip.endFrame = r.value<std::int32_t>();
+                clip.srcStartFrame = r.value<std::int32_t>();
+                clip.srcEndFrame = r.value<std::int32_t>();
+                r.floats(clip.f0Values);
+                r.floats(clip.deltaPitch);
+
+                const auto melMode = r.value<std::uint32_t>();
+                if (melMode == clipSlice) {
+                    const int start = r.value<std::int32_t>();
+                    const int frames = r.value<std::int32_t>();
+                    clip.clipMel = MelMatrix(restored.melSpectrogram.view(start, start + frames));
+                } else if (melMode == clipStored) {
+                    const auto frames = static_cast<int>(r.value<std::uint32_t>());
+                    const auto mels = static_cast<int>(r.value<std::uint32_t>());
+                    if (!r.ok || static_cast<size_t>(frames) * static_cast<size_t>(mels) > r.size)
+                        return false;
+                    clip.clipMel = MelMatrix(frames, mels);
+                    r.raw(clip.clipMel.data(), clip.clipMel.size() * static_cast<size_t>(mels) * sizeof(float));
+                }
+
+                const auto waveMode = r.value<std::uint32_t>();
+                if (waveMode == clipSlice) {
+                    const int start = r.value<std::int32_t>();
+                    const int count = r.value<std::int32_t>();
+                    const auto& waveform = project.getAudioData().waveform;
+                    if (start >= 0 && count > 0 && waveform.getNumChannels() > 0 &&
+                        start + count <= waveform.getNumSamples()) {
+                        const float* samples = waveform.getReadPointer(0) + start;
+                        clip.clipWaveform.assign(samples, samples + count);
+                    }
+                } else if (waveMode == clipStored) {
+                    r.floats(clip.clipWaveform);
+                }
+
+                if (!r.ok)
+                    return false;
+            }
+            hasNotes = true;
+        }
+
+        if (!r.ok)
+            return false;
+    }
+
+    if (!header.ok)
+        return false;
+
+    auto& audioData = project.getAudioData();
+    audioData.melSpectrogram = std::move(restored.melSpectrogram);
+    audioData.f0 = std::move(restored.f0);
+    audioData.baseF0 = std::move(restored.baseF0);
+    audioData.basePitch = std::move(restored.basePitch);
+    audioData.deltaPitch = std::move(restored.deltaPitch);
+    audioData.voicedMask = std::move(restored.voicedMask);
+
+    // Attach clip data to the notes loaded from JSON, if they still line up
+    auto& notes = project.getNotes();
+    if (hasNotes && noteClips.size() == notes.size()) {
+        bool matches = true;
+        for (size_t i = 0; i < notes.size() && matches; ++i)
+            matches = notes[i].getStartFrame() == noteClips[i].startFrame &&
+                      notes[i].getEndFrame() == noteClips[i].endFrame;
+
+        if (matches) {
+            for (size_t i = 0; i < notes.size(); ++i) {
+                auto& clip = noteClips[i];
+                notes[i].setSrcStartFrame(clip.srcStartFrame);
+                notes[i].setSrcEndFrame(clip.srcEndFrame);
+                notes[i].setF0Values(std::move(clip.f0Values));
+                notes[i].setDeltaPitch(std::move(clip.deltaPitch));
+                notes[i].setClipMel(std::move(clip.clipMel));
+                notes[i].setClipWaveform(std::move(clip.clipWaveform));
+            }
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "../JuceHeader.h"
+#include "Project.h"
+#include <cstdint>
+
+/**
+ * Binary sidecar for a project's analysis results (.htpc next to the .htpx).
+ *
+ * Holds what the JSON project either stores as text or not at all: the mel
+ * spectrogram, f0/baseF0/basePitch/deltaPitch, the voiced mask and per-note
+ * clip data. Reopening a project with a matching cache skips mel, F0 and
+ * note analysis entirely.
+ *
+ * Layout (little-endian, native float):
+ * - 40-byte header: magic "HTPC", version, key, chunk count
+ * - chunk table: tag, flags, offset, stored size, raw size
+ * - chunk payloads, each 16-byte aligned
+ *
+ * Uncompressed chunks are read straight out of a memory-mapped file;
+ * compressed chunks (gzip) are inflated on load.
+ */
+class ProjectCache {
+public:
+    static constexpr int FORMAT_VERSION = 1;
+
+    /**
+     * Identifies the audio and analysis settings a cache was built from.
+     */
+    struct Key {
+        std::uint64_t audioHash = 0;
+        std::uint64_t settingsHash = 0;
+
+        bool operator==(const Key& other) const {
+            return audioHash == other.audioHash && settingsHash == other.settingsHash;
+        }
+        bool operator!=(const Key& other) const { return !(*this == other); }
+        juce::String toString() const;
+    };
+
+    /**
+     * Hash the waveform and the mel/frame settings. analysisSettings lets
+     * callers fold in anything else the cached data depends on.
+     */
+    static Key computeKey(const AudioData& audioData,
+                          const juce::String& analysisSettings = {});
+
+    /** Sidecar path for a project file (same name, .htpc). */
+    static juce::File getCacheFileFor(const juce::File& projectFile);
+
+    /**
+     * Write the project's analysis data. Compression trades save time and
+     * memory-mapped loading for a smaller file.
+     */
+    static bool save(const Project& project, const Key& key, const juce::File& file,
+                     bool compress = false);
+
+    /** Read only the key from a cache file. */
+    static bool readKey(const juce::File& file, Key& key);
+
+    /**
+     * Restore analysis data into project if the file's key matches
+     * expectedKey. Notes already in the project (from the JSON) receive their
+     * clip data only when count and frame ranges match. The project is left
+     * untouched on any failure.
+     */
+    static bool load(Project& project, const Key& expectedKey, const juce::File& file);
+
+private:
+    ProjectCache() = delete;
+};
@@ -1,11 +1,24 @@
 #include "ProjectSerializer.h"
+#include "ProjectCache.h"
 #include "../Utils/PitchCurveProcessor.h"
 
 bool ProjectSerializer::saveToFile(const Project& project, const juce::File& file) {
     auto json = toJson(project);
     auto jsonString = juce::JSON::toString(json, true); // Pretty print
 
-    return file.replaceWithText(jsonString);
+    if (!file.replaceWithText(jsonString))
+        return false;
+
+    // Analysis results go to a binary sidecar so reopening skips re-analysis.
+    // A failed cache write only costs load time, so it doesn't fail the save.
+    const auto& audioData = project.getAudioData();
+    if (!audioData.melSpectrogram.empty() && audioData.waveform.getNumSamples() > 0) {
+        const auto key = ProjectCache::computeKey(audioData);
+        if (!ProjectCache::save(project, key, ProjectCache::getCacheFileFor(file)))
+            DBG("ProjectSerializer: failed to write analysis cache for " << file.getFullPathName());
+    }
+
+    return true;
 }
 
 bool ProjectSerializer::loadFromFile(Project& project, const juce::File& file) {
@@ -16,7 +16,8 @@ public:
     static constexpr int FORMAT_VERSION = 1;
 
     /**
-     * Save project to JSON file.
+     * Save project to JSON file, plus its analysis data to the binary
+     * ProjectCache sidecar when available.
      */
     static bool saveToFile(const Project& project, const juce::File& file);
 
@@ -3,6 +3,7 @@
 #if JucePlugin_Enable_ARA
 
 #include "../UI/IMainView.h"
+#include "../Utils/RealtimeCheck.h"
 
 #include <limits>
 
@@ -18,6 +19,11 @@ HachiTunePlaybackRenderer::getDocController() const {
           docController);
 }
 
+IMainView *HachiTunePlaybackRenderer::getMainView() const {
+  auto *docCtrl = getDocController();
+  return docCtrl ? docCtrl->getMainComponent() : nullptr;
+}
+
 void HachiTunePlaybackRenderer::prepareToPlay(
     double sampleRateIn, int maxBlockSize, int numChannelsIn,
     juce::AudioProcessor::ProcessingPrecision,
@@ -26,6 +32,7 @@ void HachiTunePlaybackRenderer::prepareToPlay(
   numChannels = numChannelsIn;
   tempBuffer =
       std::make_unique<juce::AudioBuffer<float>>(numChannels, maxBlockSize);
+  inputScratch.setSize(numChannels, maxBlockSize);
 
   bool useBuffered = (alwaysNonRealtime == AlwaysNonRealtime::no);
   juce::ignoreUnused(useBuffered);
@@ -42,6 +49,7 @@ void HachiTunePlaybackRenderer::prepareToPlay(
 void HachiTunePlaybackRenderer::releaseResources() {
   readers.clear();
   tempBuffer.reset();
+  inputScratch.setSize(0, 0);
 }
 
 bool HachiTunePlaybackRenderer::readFromARARegions(
@@ -108,6 +116,7 @@ bool HachiTunePlaybackRenderer::readFromARARegions(
 bool HachiTunePlaybackRenderer::processBlock(
     juce::AudioBuffer<float> &buffer, juce::AudioProcessor::Realtime realtime,
     const juce::AudioPlayHead::PositionInfo &posInfo) noexcept {
+  const RealtimeCheck::ScopedAudioThread audioThreadScope;
   auto timeInSamples = posInfo.getTimeInSamples().orFallback(0);
   bool isPlaying = posInfo.getIsPlaying();
   int numSamples = buffer.getNumSamples();
@@ -118,32 +127,10 @@ bool HachiTunePlaybackRenderer::processBlock(
 
   // Update UI cursor position from host playback position
   if (shouldSyncUi && docCtrl && docCtrl->getMainComponent()) {
-    if (isPlaying) {
-      double timeInSeconds = static_cast<double>(timeInSamples) / sampleRate;
-      auto state = hostUiSyncState;
-      state->latestSeconds.store(timeInSeconds);
-
-      if (!state->posPending.exchange(true)) {
-        juce::Component::SafePointer<juce::Component> safeMain(
-            docCtrl->getMainComponent()->getComponent());
-        juce::MessageManager::callAsync([safeMain, state]() {
-          state->posPending.store(false);
-          if (auto *view = dynamic_cast<IMainView *>(safeMain.getComponent()))
-            view->updatePlaybackPosition(state->latestSeconds.load());
-        });
-      }
-    } else {
-      auto state = hostUiSyncState;
-      if (!state->stoppedPending.exchange(true)) {
-        juce::Component::SafePointer<juce::Component> safeMain(
-            docCtrl->getMainComponent()->getComponent());
-        juce::MessageManager::callAsync([safeMain, state]() {
-          state->stoppedPending.store(false);
-          if (auto *view = dynamic_cast<IMainView *>(safeMain.getComponent()))
-            view->notifyHostStopped();
-        });
-      }
-    }
+    if (isPlaying)
+      uiNotifier.postPosition(static_cast<double>(timeInSamples) / sampleRate);
+    else
+      uiNotifier.postStopped();
   }
 
   if (!isPlaying) {
@@ -151,8 +138,11 @@ bool HachiTunePlaybackRenderer::processBlock(
     return true;
   }
 
-  // Read from ARA regions
-  juce::AudioBuffer<float> inputBuffer(buffer.getNumChannels(), numSamples);
+  // Read from ARA regions. The scratch only grows if the host exceeds the
+  // block size it announced in prepareToPlay.
+  inputScratch.setSize(buffer.getNumChannels(), numSamples, false, false,
+                       true);
+  auto &inputBuffer = inputScratch;
   bool didRender = readFromARARegions(inputBuffer, timeInSamples, numSamples);
 
   if (!didRender) {
@@ -191,23 +181,13 @@ bool HachiTunePlaybackRenderer::processBlock(
           *t + (static_cast<double>(modOffsetSamples) / sampleRate));
 
     if (realtimeProcessor->processBlock(inputBuffer, buffer,
-                                        &adjustedPosInfo)) {
+                                        &adjustedPosInfo))
       return true;
-    } else {
-      DBG("ARA processBlock: realtimeProcessor->processBlock returned false "
-          "(passthrough)");
-    }
-  } else {
-    // Log why we're not using the processor
-    if (!realtimeProcessor) {
-      DBG("ARA processBlock: realtimeProcessor is null");
-    } else if (!realtimeProcessor->isReady()) {
-      DBG("ARA processBlock: realtimeProcessor not ready");
-    }
   }
 
-  // Fallback: copy input to output
-  buffer.makeCopyOf(inputBuffer);
+  // Fallback (no processor, not ready, or outside the processed audio): copy
+  // input to output. No logging here; it would allocate on every block.
+  buffer.makeCopyOf(inputBuffer, true);
   return true;
 }
 
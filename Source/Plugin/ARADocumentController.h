@@ -2,6 +2,7 @@
 
 #include "../Audio/RealtimePitchProcessor.h"
 #include "../JuceHeader.h"
+#include "HostUiNotifier.h"
 
 #include <atomic>
 #include <cstdint>
@@ -29,21 +30,17 @@ public:
       const juce::AudioPlayHead::PositionInfo &positionInfo) noexcept override;
 
 private:
-  struct HostUiSyncState {
-    std::atomic<double> latestSeconds{0.0};
-    std::atomic<bool> posPending{false};
-    std::atomic<bool> stoppedPending{false};
-  };
-
   bool readFromARARegions(juce::AudioBuffer<float> &buffer,
                           juce::int64 timeInSamples, int numSamples);
   HachiTuneDocumentController *getDocController() const;
+  IMainView *getMainView() const;
 
   std::map<juce::ARAAudioSource *, std::unique_ptr<juce::ARAAudioSourceReader>>
       readers;
   std::unique_ptr<juce::AudioBuffer<float>> tempBuffer;
-  std::shared_ptr<HostUiSyncState> hostUiSyncState =
-      std::make_shared<HostUiSyncState>();
+  // Region audio read ahead of pitch correction, sized in prepareToPlay
+  juce::AudioBuffer<float> inputScratch;
+  HostUiNotifier uiNotifier{[this] { return getMainView(); }};
   double sampleRate = 44100.0;
   int numChannels = 2;
 };
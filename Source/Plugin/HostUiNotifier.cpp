@@ -0,0 +1,46 @@
+#include "HostUiNotifier.h"
+#include "../UI/IMainView.h"
+#include "../Utils/Localization.h"
+
+HostUiNotifier::HostUiNotifier(ViewProvider provider)
+    : viewProvider(std::move(provider)) {}
+
+HostUiNotifier::~HostUiNotifier() { cancelPendingUpdate(); }
+
+void HostUiNotifier::postPosition(double seconds) {
+  latestSeconds.store(seconds);
+  post(Position);
+}
+
+void HostUiNotifier::postStopped() { post(Stopped); }
+
+void HostUiNotifier::postRecording() { post(Recording); }
+
+void HostUiNotifier::postCaptureReady(int numSamples, double sampleRate) {
+  capturedSamples.store(numSamples);
+  captureSampleRate.store(sampleRate);
+  post(CaptureReady);
+}
+
+void HostUiNotifier::post(Event event) {
+  // Already pending events ride on the update that is on its way
+  if ((pendingEvents.fetch_or(event) & event) == 0)
+    triggerAsyncUpdate();
+}
+
+void HostUiNotifier::handleAsyncUpdate() {
+  const auto events = pendingEvents.exchange(0);
+  auto *view = viewProvider ? viewProvider() : nullptr;
+  if (!view)
+    return;
+
+  if (events & Position)
+    view->updatePlaybackPosition(latestSeconds.load());
+  if (events & Stopped)
+    view->notifyHostStopped();
+  if (events & Recording)
+    view->setStatusMessage(TR("progress.recording"));
+  if ((events & CaptureReady) && captureReadyHandler)
+    captureReadyHandler(*view, capturedSamples.load(),
+                        captureSampleRate.load());
+}
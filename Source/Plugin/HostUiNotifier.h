@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../JuceHeader.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+class IMainView;
+
+/**
+ * Carries audio-thread events to the plugin UI without allocating.
+ *
+ * The audio thread records what happened in atomics and triggers the
+ * AsyncUpdater, whose message is allocated up front and posted at most once
+ * until it is delivered. The message thread then drains every pending event
+ * into the current view. This replaces per-event MessageManager::callAsync
+ * lambdas, which allocate on each post.
+ */
+class HostUiNotifier : private juce::AsyncUpdater {
+public:
+  using ViewProvider = std::function<IMainView *()>;
+  using CaptureReadyHandler =
+      std::function<void(IMainView &view, int numSamples, double sampleRate)>;
+
+  explicit HostUiNotifier(ViewProvider provider);
+  ~HostUiNotifier() override;
+
+  // Message thread, before processing starts
+  void setCaptureReadyHandler(CaptureReadyHandler handler) {
+    captureReadyHandler = std::move(handler);
+  }
+
+  // Audio thread
+  void postPosition(double seconds);
+  void postStopped();
+  void postRecording();
+  void postCaptureReady(int numSamples, double sampleRate);
+
+private:
+  enum Event : std::uint32_t {
+    Position = 1 << 0,
+    Stopped = 1 << 1,
+    Recording = 1 << 2,
+    CaptureReady = 1 << 3
+  };
+
+  void post(Event event);
+  void handleAsyncUpdate() override;
+
+  ViewProvider viewProvider;
+  CaptureReadyHandler captureReadyHandler;
+
+  std::atomic<std::uint32_t> pendingEvents{0};
+  std::atomic<double> latestSeconds{0.0};
+  std::atomic<int> capturedSamples{0};
+  std::atomic<double> captureSampleRate{44100.0};
+
+  JUCE_DECLARE_NON_COPYABLE(HostUiNotifier)
+};
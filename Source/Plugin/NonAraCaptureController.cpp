@@ -5,18 +5,14 @@
 
 void NonAraCaptureController::prepare(double sampleRate, int numChannels,
                                       int maxCaptureSeconds) {
-  juce::ignoreUnused(sampleRate);
-
   const int maxSamples = static_cast<int>(sampleRate * maxCaptureSeconds);
 
-  {
-    const juce::SpinLock::ScopedLockType lock(bufferLock);
-    captureBuffer.setSize(numChannels, maxSamples);
-    captureBuffer.clear();
-    capturePosition = 0;
-    finalLength = 0;
-    stopDebounceBlocks = 0;
-  }
+  // prepareToPlay is never concurrent with processBlock, so this is the one
+  // place the buffer may be (re)allocated
+  captureBuffer.setSize(numChannels, maxSamples);
+  captureBuffer.clear();
+  capturePosition = 0;
+  stopDebounceBlocks = 0;
 
   analysisPending.store(false);
   shouldFinalizeFlag.store(false);
@@ -24,10 +20,7 @@ void NonAraCaptureController::prepare(double sampleRate, int numChannels,
 }
 
 void NonAraCaptureController::resetToWaiting() {
-  const juce::SpinLock::ScopedLockType lock(bufferLock);
-  captureBuffer.clear();
   capturePosition = 0;
-  finalLength = 0;
   stopDebounceBlocks = 0;
   analysisPending.store(false);
   shouldFinalizeFlag.store(false);
@@ -44,18 +37,15 @@ void NonAraCaptureController::processBlock(
   // Wait for audio
   if (currentState == State::WaitingForAudio && hostIsPlaying) {
     float maxLevel = 0.0f;
-    for (int ch = 0; ch < input.getNumChannels(); ++ch) {
-      const float *data = input.getReadPointer(ch);
-      for (int i = 0; i < input.getNumSamples(); ++i)
-        maxLevel = std::max(maxLevel, std::abs(data[i]));
-    }
+    for (int ch = 0; ch < input.getNumChannels(); ++ch)
+      maxLevel = std::max(
+          maxLevel, input.getMagnitude(ch, 0, input.getNumSamples()));
 
     if (maxLevel > audioThreshold) {
-      const juce::SpinLock::ScopedLockType lock(bufferLock);
       capturePosition = 0;
       stopDebounceBlocks = 0;
-      state.store(State::Capturing);
       shouldFinalizeFlag.store(false);
+      state.store(State::Capturing);
       return;
     }
   }
@@ -68,24 +58,24 @@ void NonAraCaptureController::processBlock(
   if (hostIsPlaying) {
     stopDebounceBlocks = 0;
 
-    const juce::SpinLock::ScopedLockType lock(bufferLock);
-    int spaceLeft = captureBuffer.getNumSamples() - capturePosition;
+    int position = capturePosition.load();
+    int spaceLeft = captureBuffer.getNumSamples() - position;
     int toCopy = std::min(input.getNumSamples(), spaceLeft);
 
     if (toCopy > 0) {
       int channelsToCopy =
           std::min(input.getNumChannels(), captureBuffer.getNumChannels());
       for (int ch = 0; ch < channelsToCopy; ++ch)
-        captureBuffer.copyFrom(ch, capturePosition, input, ch, 0, toCopy);
-      capturePosition += toCopy;
+        captureBuffer.copyFrom(ch, position, input, ch, 0, toCopy);
+      position += toCopy;
+      capturePosition.store(position);
     }
 
-    if (capturePosition >= captureBuffer.getNumSamples()) {
+    if (position >= captureBuffer.getNumSamples()) {
       shouldFinalizeFlag.store(true);
     }
   } else {
-    ++stopDebounceBlocks;
-    if (stopDebounceBlocks >= kStopDebounceBlocks)
+    if (++stopDebounceBlocks >= kStopDebounceBlocks)
       shouldFinalizeFlag.store(true);
   }
 }
@@ -96,32 +86,21 @@ bool NonAraCaptureController::finalizeCapture(double hostSampleRate,
     return false;
 
   const int minSamples = static_cast<int>(hostSampleRate * minCaptureSeconds);
-
-  int captured = 0;
-  int channels = 0;
-  {
-    const juce::SpinLock::ScopedLockType lock(bufferLock);
-    captured = capturePosition;
-    channels = captureBuffer.getNumChannels();
-  }
+  const int captured = capturePosition.load();
 
   if (captured < minSamples) {
     resetToWaiting();
     return false;
   }
 
-  {
-    const juce::SpinLock::ScopedLockType lock(bufferLock);
-    finalLength = capturePosition;
-  }
+  out.numChannels = captureBuffer.getNumChannels();
+  out.numSamples = captured;
+  out.sampleRate = hostSampleRate;
 
+  // Hands the buffer to the message thread; processBlock stops writing
   analysisPending.store(true);
   shouldFinalizeFlag.store(false);
   state.store(State::Complete);
-
-  out.numChannels = channels;
-  out.numSamples = finalLength;
-  out.sampleRate = hostSampleRate;
   return true;
 }
 
@@ -129,7 +108,6 @@ juce::AudioBuffer<float>
 NonAraCaptureController::copyCapturedAudio(int numSamples) const {
   juce::AudioBuffer<float> trimmed;
 
-  const juce::SpinLock::ScopedLockType lock(bufferLock);
   int length = std::min(numSamples, captureBuffer.getNumSamples());
   trimmed.setSize(captureBuffer.getNumChannels(), length);
   for (int ch = 0; ch < captureBuffer.getNumChannels(); ++ch)
@@ -139,20 +117,16 @@ NonAraCaptureController::copyCapturedAudio(int numSamples) const {
 }
 
 void NonAraCaptureController::onAnalysisDispatched() {
-  analysisPending.store(false);
-  shouldFinalizeFlag.store(false);
   stopDebounceBlocks = 0;
+  shouldFinalizeFlag.store(false);
   state.store(State::WaitingForAudio);
+  // Last: hands the buffer back to the audio thread
+  analysisPending.store(false);
 }
 
 void NonAraCaptureController::stop() {
-  {
-    const juce::SpinLock::ScopedLockType lock(bufferLock);
-    captureBuffer.clear();
-    capturePosition = 0;
-    finalLength = 0;
-    stopDebounceBlocks = 0;
-  }
+  capturePosition = 0;
+  stopDebounceBlocks = 0;
   analysisPending.store(false);
   shouldFinalizeFlag.store(false);
   state.store(State::Idle);
@@ -3,6 +3,15 @@
 #include "../JuceHeader.h"
 #include <atomic>
 
+/**
+ * Captures host audio for analysis in non-ARA hosts.
+ *
+ * No locks: ownership of the capture buffer follows the state. The audio
+ * thread owns it while waiting or capturing; once finalizeCapture() moves
+ * to Complete it belongs to the message thread until onAnalysisDispatched().
+ * The buffer is only allocated in prepare(), and is never cleared on the
+ * audio thread, since only the first capturePosition samples are read.
+ */
 class NonAraCaptureController {
 public:
   enum class State { Idle, WaitingForAudio, Capturing, Complete };
@@ -27,7 +36,7 @@ public:
   // Called from audio thread
   bool finalizeCapture(double hostSampleRate, FinalizeResult &out);
 
-  // Called from message thread
+  // Called from message thread, while the state is Complete
   juce::AudioBuffer<float> copyCapturedAudio(int numSamples) const;
 
   // Called from message thread after the captured audio has been copied out and
@@ -46,12 +55,9 @@ public:
 private:
   std::atomic<State> state{State::Idle};
 
-  mutable juce::SpinLock bufferLock;
-
   juce::AudioBuffer<float> captureBuffer;
-  int capturePosition = 0;
-  int stopDebounceBlocks = 0;
-  int finalLength = 0;
+  std::atomic<int> capturePosition{0};
+  std::atomic<int> stopDebounceBlocks{0};
 
   std::atomic<bool> analysisPending{false};
   std::atomic<bool> shouldFinalizeFlag{false};
@@ -1,6 +1,7 @@
 #include "PluginProcessor.h"
 #include "../UI/IMainView.h"
 #include "../Utils/Localization.h"
+#include "../Utils/RealtimeCheck.h"
 #include "PluginEditor.h"
 
 HachiTuneAudioProcessor::HachiTuneAudioProcessor()
@@ -11,6 +12,13 @@ HachiTuneAudioProcessor::HachiTuneAudioProcessor()
               .withOutput("Output", juce::AudioChannelSet::stereo(), true))
 #endif
 {
+  uiNotifier.setCaptureReadyHandler(
+      [this](IMainView &view, int numSamples, double sampleRate) {
+        auto trimmed = captureController->copyCapturedAudio(numSamples);
+        captureController->onAnalysisDispatched();
+        view.setStatusMessage(TR("progress.analyzing"));
+        view.setHostAudio(trimmed, sampleRate);
+      });
 }
 
 HachiTuneAudioProcessor::~HachiTuneAudioProcessor() = default;
@@ -47,6 +55,7 @@ void HachiTuneAudioProcessor::prepareToPlay(double sampleRate,
                                             int samplesPerBlock) {
   hostSampleRate = sampleRate;
   realtimeProcessor.prepareToPlay(sampleRate, samplesPerBlock);
+  processedScratch.setSize(getTotalNumOutputChannels(), samplesPerBlock);
 
 #if JucePlugin_Enable_ARA
   prepareToPlayForARA(sampleRate, samplesPerBlock,
@@ -63,6 +72,13 @@ void HachiTuneAudioProcessor::releaseResources() {
 #if JucePlugin_Enable_ARA
   releaseResourcesForARA();
 #endif
+
+#if HACHITUNE_RT_CHECKS
+  if (RealtimeCheck::getViolationCount() > 0)
+    DBG("Real-time violations on the audio thread: "
+        << RealtimeCheck::getViolationCount() << " (last: "
+        << RealtimeCheck::getLastViolation() << ")");
+#endif
 }
 
 #if !JucePlugin_PreferredChannelConfigurations
@@ -113,6 +129,7 @@ void HachiTuneAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
                                            juce::MidiBuffer &midiMessages) {
   juce::ignoreUnused(midiMessages);
   juce::ScopedNoDenormals noDenormals;
+  const RealtimeCheck::ScopedAudioThread audioThreadScope;
 
   // Process transport control requests and update sync state
   transportController.processBlock(getPlayHead(), hostSampleRate);
@@ -156,32 +173,10 @@ void HachiTuneAudioProcessor::processNonARAMode(
       else if (auto time = posInfo.getTimeInSeconds())
         timeInSeconds = *time;
 
-      auto state = hostUiSyncState;
-      state->latestSeconds.store(timeInSeconds);
-
       // Never touch UI on the audio thread: coalesce to a single async update
-      if (!state->posPending.exchange(true)) {
-        juce::Component::SafePointer<juce::Component> safeMain(
-            mainComponent->getComponent());
-        juce::MessageManager::callAsync([safeMain, state]() {
-          state->posPending.store(false);
-          if (auto *view =
-                  dynamic_cast<IMainView *>(safeMain.getComponent()))
-            view->updatePlaybackPosition(state->latestSeconds.load());
-        });
-      }
+      uiNotifier.postPosition(timeInSeconds);
     } else if (!hostIsPlaying && hasProject) {
-      auto state = hostUiSyncState;
-      if (!state->stoppedPending.exchange(true)) {
-        juce::Component::SafePointer<juce::Component> safeMain(
-            mainComponent->getComponent());
-        juce::MessageManager::callAsync([safeMain, state]() {
-          state->stoppedPending.store(false);
-          if (auto *view =
-                  dynamic_cast<IMainView *>(safeMain.getComponent()))
-            view->notifyHostStopped();
-        });
-      }
+      uiNotifier.postStopped();
     }
   }
 
@@ -193,24 +188,8 @@ void HachiTuneAudioProcessor::processNonARAMode(
     if (captureController->shouldFinalize()) {
       NonAraCaptureController::FinalizeResult result;
       if (captureController->finalizeCapture(hostSampleRate, result) &&
-          mainComponent) {
-        juce::Component::SafePointer<juce::Component> safeMain(
-            mainComponent->getComponent());
-        auto controller = captureController;
-        juce::MessageManager::callAsync([safeMain, controller,
-                                         samples = result.numSamples,
-                                         sr = result.sampleRate]() mutable {
-          auto *view = dynamic_cast<IMainView *>(safeMain.getComponent());
-          if (!view)
-            return;
-          if (!controller)
-            return;
-          auto trimmed = controller->copyCapturedAudio(samples);
-          controller->onAnalysisDispatched();
-          view->setStatusMessage(TR("progress.analyzing"));
-          view->setHostAudio(trimmed, sr);
-        });
-      }
+          mainComponent)
+        uiNotifier.postCaptureReady(result.numSamples, result.sampleRate);
     }
 
     buffer.clear();
@@ -218,11 +197,12 @@ void HachiTuneAudioProcessor::processNonARAMode(
   }
 
   if (hasProject && realtimeProcessor.isReady()) {
-    // Real-time pitch correction mode
-    juce::AudioBuffer<float> outputBuffer(numChannels, numSamples);
-    if (realtimeProcessor.processBlock(buffer, outputBuffer, &posInfo)) {
+    // Real-time pitch correction mode. The scratch only grows if the host
+    // exceeds the block size it announced in prepareToPlay.
+    processedScratch.setSize(numChannels, numSamples, false, false, true);
+    if (realtimeProcessor.processBlock(buffer, processedScratch, &posInfo)) {
       for (int ch = 0; ch < numChannels; ++ch)
-        buffer.copyFrom(ch, 0, outputBuffer, ch, 0, numSamples);
+        buffer.copyFrom(ch, 0, processedScratch, ch, 0, numSamples);
     }
     return;
   }
@@ -234,38 +214,16 @@ void HachiTuneAudioProcessor::processNonARAMode(
   auto currentState = captureController->getState();
   if (currentState != lastCaptureUiState) {
     if (currentState == NonAraCaptureController::State::Capturing &&
-        mainComponent) {
-      juce::Component::SafePointer<juce::Component> safeMain(
-          mainComponent->getComponent());
-      juce::MessageManager::callAsync([safeMain]() {
-        if (auto *view = dynamic_cast<IMainView *>(safeMain.getComponent()))
-          view->setStatusMessage(TR("progress.recording"));
-      });
-    }
+        mainComponent)
+      uiNotifier.postRecording();
     lastCaptureUiState = currentState;
   }
 
   if (captureController->shouldFinalize()) {
     NonAraCaptureController::FinalizeResult result;
     if (captureController->finalizeCapture(hostSampleRate, result) &&
-        mainComponent) {
-      juce::Component::SafePointer<juce::Component> safeMain(
-          mainComponent->getComponent());
-      auto controller = captureController;
-      juce::MessageManager::callAsync([safeMain, controller,
-                                       samples = result.numSamples,
-                                       sr = result.sampleRate]() mutable {
-        auto *view = dynamic_cast<IMainView *>(safeMain.getComponent());
-        if (!view)
-          return;
-        if (!controller)
-          return;
-        auto trimmed = controller->copyCapturedAudio(samples);
-        controller->onAnalysisDispatched();
-        view->setStatusMessage(TR("progress.analyzing"));
-        view->setHostAudio(trimmed, sr);
-      });
-    }
+        mainComponent)
+      uiNotifier.postCaptureReady(result.numSamples, result.sampleRate);
   }
 
   // Passthrough during capture
@@ -278,6 +236,8 @@ void HachiTuneAudioProcessor::startCapture() {
 void HachiTuneAudioProcessor::stopCapture() { captureController->stop(); }
 
 void HachiTuneAudioProcessor::setMainComponent(IMainView *mc) {
+  if (mainComponent != nullptr && mainComponent != mc)
+    mainComponent->unbindRealtimeProcessor();
   mainComponent = mc;
   if (mc) {
     mc->bindRealtimeProcessor(realtimeProcessor);
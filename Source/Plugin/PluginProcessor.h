@@ -1,9 +1,11 @@
 #pragma once
 
 #include "../Audio/Engine/PluginTransportController.h"
+#include "../Audio/Inference/InferenceScheduler.h"
 #include "../Audio/RealtimePitchProcessor.h"
 #include "../JuceHeader.h"
 #include "HostCompatibility.h"
+#include "HostUiNotifier.h"
 #include "NonAraCaptureController.h"
 #include <atomic>
 #include <memory>
@@ -122,23 +124,23 @@ public:
   }
 
 private:
-  struct HostUiSyncState {
-    std::atomic<double> latestSeconds{0.0};
-    std::atomic<bool> posPending{false};
-    std::atomic<bool> stoppedPending{false};
-  };
-
   void processNonARAMode(juce::AudioBuffer<float> &buffer,
                          const juce::AudioPlayHead::PositionInfo &posInfo,
                          bool isRealtime);
 
+  // First member, so the scheduler's workers are joined after everything
+  // else here is gone and before the host can unload the plugin
+  InferenceScheduler::ScopedUser inferenceUser;
+
   PluginTransportController transportController;
   RealtimePitchProcessor realtimeProcessor;
   IMainView *mainComponent = nullptr;
-  std::shared_ptr<HostUiSyncState> hostUiSyncState =
-      std::make_shared<HostUiSyncState>();
+  HostUiNotifier uiNotifier{[this] { return mainComponent; }};
   double hostSampleRate = 44100.0;
 
+  // Output scratch for the realtime processor, sized in prepareToPlay
+  juce::AudioBuffer<float> processedScratch;
+
   juce::String pendingStateJson;
 
   // Non-ARA capture (Stage 2A): decoupled controller
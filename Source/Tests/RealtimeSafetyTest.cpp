@@ -0,0 +1,175 @@
+#include "../Audio/RealtimePitchProcessor.h"
+#include "../JuceHeader.h"
+#include "../Models/Project.h"
+#include "../Plugin/PluginProcessor.h"
+#include "../UI/IMainView.h"
+#include "../Utils/RealtimeCheck.h"
+#include <cmath>
+#include <iostream>
+
+/**
+ * Offline real-time safety test.
+ *
+ * Drives the plugin's processBlock through host-like sessions and fails
+ * (exit code 1) if RealtimeCheck recorded any allocation or blocking call
+ * on the audio thread. Built only with HACHITUNE_RT_CHECKS; without the
+ * detector it reports itself as skipped (exit code 77).
+ *
+ * In an ARA build processBlock asks processBlockForARA first; the processor
+ * here is not bound to an ARA document, so that dispatch is exercised and
+ * falls through to the non-ARA path. The ARA playback renderer itself needs
+ * a host-side ARA document and cannot be created offline, so its per-block
+ * work (scratch input, modification-time offset, RealtimePitchProcessor)
+ * is replayed directly inside an audio-thread scope.
+ */
+namespace {
+constexpr double sampleRate = 44100.0;
+constexpr int blockSize = 512;
+constexpr int numChannels = 2;
+
+/** Reports a playing or stopped transport advancing one block per call. */
+class TestPlayHead : public juce::AudioPlayHead {
+public:
+  juce::Optional<PositionInfo> getPosition() const override {
+    PositionInfo info;
+    info.setIsPlaying(playing);
+    info.setTimeInSamples(timeInSamples);
+    info.setTimeInSeconds(static_cast<double>(timeInSamples) / sampleRate);
+    return info;
+  }
+
+  bool playing = false;
+  juce::int64 timeInSamples = 0;
+};
+
+/** Editor stand-in that hands a ready project to the realtime processor. */
+class TestView : public IMainView {
+public:
+  explicit TestView(Project &p) : project(p) {}
+
+  juce::Component *getComponent() override { return nullptr; }
+  Project *getProject() const override { return &project; }
+  Vocoder *getVocoder() const override { return nullptr; }
+  bool hasAnalyzedProject() const override { return true; }
+  void bindRealtimeProcessor(RealtimePitchProcessor &processor) override {
+    processor.setProject(&project);
+  }
+  void unbindRealtimeProcessor() override {}
+  juce::String serializeProjectJson() const override { return {}; }
+  bool restoreProjectJson(const juce::String &) override { return false; }
+  void setStatusMessage(const juce::String &) override {}
+  void setARAMode(bool) override {}
+  void setOnReanalyzeRequested(std::function<void()>) override {}
+  void setOnProjectDataChanged(std::function<void()>) override {}
+  void setOnPitchEditFinished(std::function<void()>) override {}
+  void setOnRequestHostPlayState(std::function<void(bool)>) override {}
+  void setOnRequestHostStop(std::function<void()>) override {}
+  void setOnRequestHostSeek(std::function<void(double)>) override {}
+  void setHostAudio(const juce::AudioBuffer<float> &, double) override {}
+  void updatePlaybackPosition(double) override {}
+  void notifyHostStopped() override {}
+
+private:
+  Project &project;
+};
+
+void fillSine(juce::AudioBuffer<float> &buffer, juce::int64 startSample) {
+  for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+    auto *data = buffer.getWritePointer(ch);
+    for (int i = 0; i < buffer.getNumSamples(); ++i)
+      data[i] = 0.25f * std::sin(2.0 * juce::MathConstants<double>::pi *
+                                 220.0 *
+                                 static_cast<double>(startSample + i) /
+                                 sampleRate);
+  }
+}
+
+void runBlocks(HachiTuneAudioProcessor &processor, TestPlayHead &playHead,
+               juce::AudioBuffer<float> &buffer, juce::MidiBuffer &midi,
+               bool playing, double seconds) {
+  playHead.playing = playing;
+  const int numBlocks = static_cast<int>(seconds * sampleRate / blockSize);
+  for (int i = 0; i < numBlocks; ++i) {
+    fillSine(buffer, playHead.timeInSamples);
+    processor.processBlock(buffer, midi);
+    if (playing)
+      playHead.timeInSamples += blockSize;
+  }
+}
+
+bool report(const char *stage) {
+  const int violations = RealtimeCheck::getViolationCount();
+  if (violations == 0) {
+    std::cout << stage << ": ok\n";
+    return true;
+  }
+  std::cout << stage << ": " << violations
+            << " real-time violation(s), last: "
+            << RealtimeCheck::getLastViolation() << "\n";
+  RealtimeCheck::resetViolations();
+  return false;
+}
+} // namespace
+
+int main() {
+#if !HACHITUNE_RT_CHECKS
+  std::cout << "Real-time checks are not compiled in; configure a Debug "
+               "build with -DHACHITUNE_RT_CHECKS=ON\n";
+  return 77;
+#else
+  juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+  // Two seconds of audio standing in for an analyzed, resynthesized take
+  Project project;
+  auto &audioData = project.getAudioData();
+  audioData.sampleRate = static_cast<int>(sampleRate);
+  audioData.waveform.setSize(numChannels, static_cast<int>(2.0 * sampleRate));
+  fillSine(audioData.waveform, 0);
+
+  HachiTuneAudioProcessor processor;
+  TestPlayHead playHead;
+  processor.setPlayConfigDetails(numChannels, numChannels, sampleRate,
+                                 blockSize);
+  processor.setPlayHead(&playHead);
+  processor.prepareToPlay(sampleRate, blockSize);
+
+  juce::AudioBuffer<float> buffer(numChannels, blockSize);
+  juce::MidiBuffer midi;
+  bool passed = true;
+  RealtimeCheck::resetViolations();
+
+  // Non-ARA capture: wait for audio, record while playing, finalize on stop
+  runBlocks(processor, playHead, buffer, midi, true, 1.5);
+  runBlocks(processor, playHead, buffer, midi, false, 0.1);
+  passed &= report("non-ARA capture");
+
+  // Non-ARA playback of the corrected audio, with UI position updates
+  TestView view(project);
+  processor.setMainComponent(&view);
+  playHead.timeInSamples = 0;
+  runBlocks(processor, playHead, buffer, midi, true, 1.5);
+  runBlocks(processor, playHead, buffer, midi, false, 0.1);
+  passed &= report("non-ARA playback");
+
+  // ARA renderer block: region audio into a prepared scratch, then pitch
+  // correction at audio-modification time
+  auto &realtimeProcessor = processor.getRealtimeProcessor();
+  juce::AudioBuffer<float> inputScratch(numChannels, blockSize);
+  constexpr juce::int64 modificationOffset = blockSize * 3;
+  for (juce::int64 time = 0; time < static_cast<juce::int64>(sampleRate);
+       time += blockSize) {
+    fillSine(inputScratch, time);
+    const RealtimeCheck::ScopedAudioThread audioThreadScope;
+    juce::AudioPlayHead::PositionInfo posInfo;
+    posInfo.setIsPlaying(true);
+    posInfo.setTimeInSamples(time + modificationOffset);
+    if (!realtimeProcessor.processBlock(inputScratch, buffer, &posInfo))
+      buffer.makeCopyOf(inputScratch, true);
+  }
+  passed &= report("ARA renderer block");
+
+  processor.setMainComponent(nullptr);
+  processor.releaseResources();
+  return passed ? 0 : 1;
+#endif
+}
@@ -16,6 +16,7 @@ public:
   virtual Vocoder *getVocoder() const = 0;
   virtual bool hasAnalyzedProject() const = 0;
   virtual void bindRealtimeProcessor(RealtimePitchProcessor &processor) = 0;
+  virtual void unbindRealtimeProcessor() = 0;
   virtual juce::String serializeProjectJson() const = 0;
   virtual bool restoreProjectJson(const juce::String &json) = 0;
   virtual void setStatusMessage(const juce::String &message) = 0;
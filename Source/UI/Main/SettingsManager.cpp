@@ -49,6 +49,8 @@ void SettingsManager::applySettings() {
   if (vocoder) {
     vocoder->setExecutionDevice(device);
     vocoder->setExecutionDeviceId(gpuDeviceId);
+    vocoder->setThreadBudget(threads);
+    vocoder->setSessionPoolSize(vocoderSessions);
     if (vocoder->isLoaded())
       vocoder->reloadModel();
   }
@@ -73,6 +75,10 @@ void SettingsManager::loadConfig() {
         if (configObj->hasProperty("threads"))
           threads = static_cast<int>(configObj->getProperty("threads"));
 
+        if (configObj->hasProperty("vocoderSessions"))
+          vocoderSessions =
+              static_cast<int>(configObj->getProperty("vocoderSessions"));
+
         if (configObj->hasProperty("pitchDetector")) {
           auto pitchDetectorStr =
               configObj->getProperty("pitchDetector").toString();
@@ -112,6 +118,7 @@ void SettingsManager::saveConfig() {
 
   config->setProperty("device", device);
   config->setProperty("threads", threads);
+  config->setProperty("vocoderSessions", vocoderSessions);
   config->setProperty("pitchDetector",
                       pitchDetectorTypeToString(pitchDetectorType));
   config->setProperty("gpuDeviceId", gpuDeviceId);
@@ -22,6 +22,8 @@ public:
   void setDevice(const juce::String &d) { device = d; }
   int getThreads() const { return threads; }
   void setThreads(int t) { threads = t; }
+  int getVocoderSessions() const { return vocoderSessions; }
+  void setVocoderSessions(int n) { vocoderSessions = n; }
   PitchDetectorType getPitchDetectorType() const { return pitchDetectorType; }
   void setPitchDetectorType(PitchDetectorType t) { pitchDetectorType = t; }
   int getGPUDeviceId() const { return gpuDeviceId; }
@@ -59,6 +61,7 @@ private:
   // Settings
   juce::String device = "CPU";
   int threads = 0;
+  int vocoderSessions = 0; // 0 = automatic
   PitchDetectorType pitchDetectorType = PitchDetectorType::RMVPE;
   int gpuDeviceId = 0;
   juce::String language = "auto";
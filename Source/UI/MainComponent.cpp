@@ -21,7 +21,7 @@ MainComponent::MainComponent(bool enableAudioDevice)
   LOG("MainComponent: creating core components...");
   // Initialize components
   editorController = std::make_unique<EditorController>(enableAudioDeviceFlag);
-  undoManager = std::make_unique<PitchUndoManager>(100);
+  undoManager = std::make_unique<PitchUndoManager>();
   commandManager = std::make_unique<juce::ApplicationCommandManager>();
   undoManager->onHistoryChanged = [this]() {
     if (commandManager)
@@ -90,6 +90,27 @@ MainComponent::MainComponent(bool enableAudioDevice)
   // Set undo manager for piano roll
   pianoRoll.setUndoManager(undoManager.get());
 
+  // Show notes in the piano roll as analysis finds them
+  {
+    juce::Component::SafePointer<MainComponent> safeThis(this);
+    editorController->setOnAnalysisPreview(
+        [safeThis](const std::vector<SOMEDetector::NoteEvent> &events) {
+          std::vector<PianoRollComponent::PreviewNote> notes;
+          notes.reserve(events.size());
+          for (const auto &event : events) {
+            if (!event.isRest)
+              notes.push_back({event.startFrame, event.endFrame,
+                               event.midiNote});
+          }
+          if (notes.empty())
+            return;
+          juce::MessageManager::callAsync([safeThis, notes]() {
+            if (safeThis != nullptr)
+              safeThis->pianoRoll.addPreviewNotes(notes);
+          });
+        });
+  }
+
   // Setup toolbar callbacks
   toolbar.onPlay = [this]() { play(); };
   toolbar.onPause = [this]() { pause(); };
@@ -260,7 +281,7 @@ MainComponent::~MainComponent() {
 #endif
   removeKeyListener(commandManager->getKeyMappings());
   stopTimer();
-
+  unbindRealtimeProcessor();
 
   if (auto *audioEngine = editorController->getAudioEngine()) {
     audioEngine->clearCallbacks();
@@ -491,7 +512,8 @@ void MainComponent::openFile() {
     return;
 
   fileChooser = std::make_unique<juce::FileChooser>(
-      TR("dialog.select_audio"), juce::File{}, "*.wav;*.mp3;*.flac;*.aiff");
+      TR("dialog.select_audio"), juce::File{},
+      "*.wav;*.mp3;*.flac;*.aiff;*.htpx");
 
   auto chooserFlags = juce::FileBrowserComponent::openMode |
                       juce::FileBrowserComponent::canSelectFiles;
@@ -522,6 +544,7 @@ void MainComponent::loadAudioFile(const juce::File &file) {
   }
   toolbar.showProgress(TR("progress.loading_audio"));
   toolbar.setProgress(0.0f);
+  pianoRoll.clearPreviewNotes();
 
   juce::Component::SafePointer<MainComponent> safeThis(this);
   if (!editorController) {
@@ -638,6 +661,7 @@ void MainComponent::analyzeAudio() {
   if (!project || !editorController)
     return;
 
+  pianoRoll.clearPreviewNotes();
   juce::Component::SafePointer<MainComponent> safeThis(this);
   editorController->analyzeAudioAsync(
       [safeThis](Project &projectRef) {
@@ -1177,9 +1201,9 @@ void MainComponent::resynthesizeIncremental() {
           return;
         }
 
+        // In plugin mode the realtime processor has already been patched
+        // region by region through onWaveformPatched
         safeThis->pianoRoll.repaint();
-        if (safeThis->isPluginMode())
-          safeThis->notifyProjectDataChanged();
       },
       pendingIncrementalResynth,
       isPluginMode());
@@ -1334,7 +1358,8 @@ bool MainComponent::isInterestedInFileDrag(const juce::StringArray &files) {
   for (const auto &file : files) {
     if (file.endsWithIgnoreCase(".wav") || file.endsWithIgnoreCase(".mp3") ||
         file.endsWithIgnoreCase(".flac") || file.endsWithIgnoreCase(".aiff") ||
-        file.endsWithIgnoreCase(".ogg") || file.endsWithIgnoreCase(".m4a"))
+        file.endsWithIgnoreCase(".ogg") || file.endsWithIgnoreCase(".m4a") ||
+        file.endsWithIgnoreCase(".htpx"))
       return true;
   }
   return false;
@@ -1362,6 +1387,7 @@ void MainComponent::setHostAudio(const juce::AudioBuffer<float> &buffer,
 
   // Show analyzing progress
   toolbar.showProgress(TR("progress.analyzing"));
+  pianoRoll.clearPreviewNotes();
 
   juce::Component::SafePointer<MainComponent> safeThis(this);
   editorController->setHostAudioAsync(
@@ -1479,6 +1505,19 @@ void MainComponent::bindRealtimeProcessor(RealtimePitchProcessor &processor) {
   processor.setProject(getProject());
   processor.setVocoder(editorController ? editorController->getVocoder()
                                         : nullptr);
+
+  // Incremental edits refresh only the spans they rewrote
+  if (editorController)
+    editorController->setOnWaveformPatched(
+        [&processor](int startSample, int numSamples) {
+          processor.invalidateRange(startSample, numSamples);
+        });
+}
+
+void MainComponent::unbindRealtimeProcessor() {
+  // The callback above holds a reference to the processor
+  if (editorController)
+    editorController->setOnWaveformPatched(nullptr);
 }
 
 juce::String MainComponent::serializeProjectJson() const {
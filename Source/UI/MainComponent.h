@@ -67,6 +67,7 @@ public:
   }
   bool hasAnalyzedProject() const override;
   void bindRealtimeProcessor(RealtimePitchProcessor &processor) override;
+  void unbindRealtimeProcessor() override;
   juce::String serializeProjectJson() const override;
   bool restoreProjectJson(const juce::String &json) override;
   void setStatusMessage(const juce::String &message) override {
@@ -31,19 +31,24 @@ std::vector<Note*> BoxSelector::getNotesInRect(Project* project, CoordinateMappe
 
     auto rect = getSelectionRect();
 
-    for (auto& note : project->getNotes()) {
-        if (note.isRest())
+    // Candidates from the frames under the rect; the exact test is in pixels
+    const float pps = mapper->getPixelsPerSecond();
+    const int startFrame = secondsToFrames(rect.getX() / pps) - 1;
+    const int endFrame = secondsToFrames(rect.getRight() / pps) + 2;
+
+    for (auto* note : project->getNotesInRange(startFrame, endFrame)) {
+        if (note->isRest())
             continue;
 
-        float noteX = framesToSeconds(note.getStartFrame()) * mapper->getPixelsPerSecond();
-        float noteW = framesToSeconds(note.getDurationFrames()) * mapper->getPixelsPerSecond();
-        float noteY = mapper->midiToY(note.getAdjustedMidiNote());
+        float noteX = framesToSeconds(note->getStartFrame()) * pps;
+        float noteW = framesToSeconds(note->getDurationFrames()) * pps;
+        float noteY = mapper->midiToY(note->getAdjustedMidiNote());
         float noteH = mapper->getPixelsPerSemitone();
 
         juce::Rectangle<float> noteRect(noteX, noteY, noteW, noteH);
 
         if (rect.intersects(noteRect)) {
-            result.push_back(&note);
+            result.push_back(note);
         }
     }
 
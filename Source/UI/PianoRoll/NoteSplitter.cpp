@@ -65,10 +65,7 @@ bool NoteSplitter::splitNoteAtFrame(Note* note, int splitFrame) {
             int melStart = std::max(0, std::min(startFrame, melSize));
             int melEnd = std::max(melStart, std::min(endFrame, melSize));
             if (melEnd > melStart) {
-                std::vector<std::vector<float>> melClip(
-                    audioData.melSpectrogram.begin() + melStart,
-                    audioData.melSpectrogram.begin() + melEnd);
-                note->setClipMel(std::move(melClip));
+                note->setClipMel(MelMatrix(audioData.melSpectrogram.view(melStart, melEnd)));
             }
         }
     }
@@ -97,8 +94,8 @@ bool NoteSplitter::splitNoteAtFrame(Note* note, int splitFrame) {
         const auto& mel = note->getClipMel();
         int splitOffset = splitFrame - startFrame;
         splitOffset = std::max(0, std::min(splitOffset, static_cast<int>(mel.size())));
-        std::vector<std::vector<float>> leftMel(mel.begin(), mel.begin() + splitOffset);
-        std::vector<std::vector<float>> rightMel(mel.begin() + splitOffset, mel.end());
+        MelMatrix leftMel(mel.view(0, splitOffset));
+        MelMatrix rightMel(mel.view(splitOffset, static_cast<int>(mel.size())));
         note->setClipMel(std::move(leftMel));
         secondNote.setClipMel(std::move(rightMel));
     }
@@ -38,7 +38,7 @@ void OverviewPanel::paint(juce::Graphics &g) {
   if (numSamples <= 0 || audioData.sampleRate <= 0)
     return;
 
-  const float *samples = audioData.waveform.getReadPointer(0);
+  const auto &peaks = project->getWaveformPeaks();
   const int width = static_cast<int>(content.getWidth());
   const int height = static_cast<int>(content.getHeight());
 
@@ -60,10 +60,7 @@ void OverviewPanel::paint(juce::Graphics &g) {
     startSample = juce::jlimit(0, numSamples - 1, startSample);
     endSample = juce::jlimit(startSample + 1, numSamples, endSample);
 
-    float maxVal = 0.0f;
-    for (int i = startSample; i < endSample; ++i) {
-      maxVal = std::max(maxVal, std::abs(samples[i]));
-    }
+    float maxVal = peaks.query(startSample, endSample).getMagnitude();
     maxVal = std::sqrt(maxVal);
 
     float x = content.getX() + static_cast<float>(px);
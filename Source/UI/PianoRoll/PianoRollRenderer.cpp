@@ -32,8 +32,8 @@ void PianoRollRenderer::drawBackgroundWaveform(
   if (!project || !coordMapper)
     return;
 
-  const auto &audioData = project->getAudioData();
-  if (audioData.waveform.getNumSamples() == 0)
+  const auto &peaks = project->getWaveformPeaks();
+  if (peaks.getNumSamples() == 0)
     return;
 
   double scrollX = coordMapper->getScrollX();
@@ -43,7 +43,8 @@ void PianoRollRenderer::drawBackgroundWaveform(
   bool cacheValid =
       waveformCache.isValid() && std::abs(cachedScrollX - scrollX) < 1.0 &&
       std::abs(cachedPixelsPerSecond - pixelsPerSecond) < 0.01f &&
-      cachedWidth == area.getWidth() && cachedHeight == area.getHeight();
+      cachedWidth == area.getWidth() && cachedHeight == area.getHeight() &&
+      cachedPeaksRevision == peaks.getRevision();
 
   if (cacheValid) {
     g.drawImageAt(waveformCache, area.getX(), area.getY());
@@ -55,9 +56,6 @@ void PianoRollRenderer::drawBackgroundWaveform(
       juce::Image(juce::Image::ARGB, area.getWidth(), area.getHeight(), true);
   juce::Graphics cacheGraphics(waveformCache);
 
-  const float *samples = audioData.waveform.getReadPointer(0);
-  int numSamples = audioData.waveform.getNumSamples();
-
   float visibleHeight = static_cast<float>(area.getHeight());
   float centerY = visibleHeight * 0.5f;
   float waveformHeight = visibleHeight * 0.8f;
@@ -65,21 +63,20 @@ void PianoRollRenderer::drawBackgroundWaveform(
   juce::Path waveformPath;
   int visibleWidth = area.getWidth();
 
-  waveformPath.startNewSubPath(0.0f, centerY);
-
-  // Top half
+  // One peak query per pixel column, shared by both halves
+  std::vector<float> columnPeaks(static_cast<size_t>(visibleWidth));
   for (int px = 0; px < visibleWidth; ++px) {
     double time = (scrollX + px) / pixelsPerSecond;
-    int startSample = static_cast<int>(time * SAMPLE_RATE);
-    int endSample =
-        static_cast<int>((time + 1.0 / pixelsPerSecond) * SAMPLE_RATE);
+    columnPeaks[static_cast<size_t>(px)] =
+        peaks.queryTime(time, time + 1.0 / pixelsPerSecond, SAMPLE_RATE)
+            .getMagnitude();
+  }
 
-    startSample = std::max(0, std::min(startSample, numSamples - 1));
-    endSample = std::max(startSample + 1, std::min(endSample, numSamples));
+  waveformPath.startNewSubPath(0.0f, centerY);
 
-    float maxVal = 0.0f;
-    for (int i = startSample; i < endSample; ++i)
-      maxVal = std::max(maxVal, std::abs(samples[i]));
+  // Top half
+  for (int px = 0; px < visibleWidth; ++px) {
+    float maxVal = columnPeaks[static_cast<size_t>(px)];
 
     float y = centerY - maxVal * waveformHeight * 0.5f;
     waveformPath.lineTo(static_cast<float>(px), y);
@@ -87,17 +84,7 @@ void PianoRollRenderer::drawBackgroundWaveform(
 
   // Bottom half (reverse)
   for (int px = visibleWidth - 1; px >= 0; --px) {
-    double time = (scrollX + px) / pixelsPerSecond;
-    int startSample = static_cast<int>(time * SAMPLE_RATE);
-    int endSample =
-        static_cast<int>((time + 1.0 / pixelsPerSecond) * SAMPLE_RATE);
-
-    startSample = std::max(0, std::min(startSample, numSamples - 1));
-    endSample = std::max(startSample + 1, std::min(endSample, numSamples));
-
-    float maxVal = 0.0f;
-    for (int i = startSample; i < endSample; ++i)
-      maxVal = std::max(maxVal, std::abs(samples[i]));
+    float maxVal = columnPeaks[static_cast<size_t>(px)];
 
     float y = centerY + maxVal * waveformHeight * 0.5f;
     waveformPath.lineTo(static_cast<float>(px), y);
@@ -113,6 +100,7 @@ void PianoRollRenderer::drawBackgroundWaveform(
   cachedPixelsPerSecond = pixelsPerSecond;
   cachedWidth = area.getWidth();
   cachedHeight = area.getHeight();
+  cachedPeaksRevision = peaks.getRevision();
 
   g.drawImageAt(waveformCache, area.getX(), area.getY());
 }
@@ -247,10 +235,7 @@ void PianoRollRenderer::drawNotes(juce::Graphics &g, double visibleStartTime,
     return;
 
   const auto &audioData = project->getAudioData();
-  const float *samples = audioData.waveform.getNumSamples() > 0
-                             ? audioData.waveform.getReadPointer(0)
-                             : nullptr;
-  int totalSamples = audioData.waveform.getNumSamples();
+  const auto &peaks = project->getWaveformPeaks();
 
   for (auto &note : project->getNotes()) {
     if (note.isRest())
@@ -276,9 +261,8 @@ void PianoRollRenderer::drawNotes(juce::Graphics &g, double visibleStartTime,
                                  ? APP_COLOR_NOTE_SELECTED
                                  : APP_COLOR_NOTE_NORMAL;
 
-    if (samples && totalSamples > 0 && w > 2.0f) {
-      drawNoteWaveform(g, note, x, y, w, h, samples, totalSamples,
-                       audioData.sampleRate);
+    if (peaks.getNumSamples() > 0 && w > 2.0f) {
+      drawNoteWaveform(g, note, x, y, w, h, peaks, audioData.sampleRate);
     } else {
       g.setColour(noteColor.withAlpha(0.85f));
       g.fillRoundedRectangle(x, y, std::max(w, 4.0f), h, 2.0f);
@@ -288,8 +272,9 @@ void PianoRollRenderer::drawNotes(juce::Graphics &g, double visibleStartTime,
 
 void PianoRollRenderer::drawNoteWaveform(juce::Graphics &g, const Note &note,
                                          float x, float y, float w, float h,
-                                         const float *samples, int totalSamples,
+                                         const WaveformPeaks &peaks,
                                          int sampleRate) {
+  const int totalSamples = peaks.getNumSamples();
   juce::Colour noteColor = note.isSelected() ? APP_COLOR_NOTE_SELECTED
                                              : APP_COLOR_NOTE_NORMAL;
 
@@ -313,9 +298,7 @@ void PianoRollRenderer::drawNoteWaveform(juce::Graphics &g, const Note &note,
     int sampleIdx = startSample + static_cast<int>((px / w) * numNoteSamples);
     int sampleEnd = std::min(sampleIdx + samplesPerPixel, endSample);
 
-    float maxVal = 0.0f;
-    for (int i = sampleIdx; i < sampleEnd; ++i)
-      maxVal = std::max(maxVal, std::abs(samples[i]));
+    float maxVal = peaks.query(sampleIdx, sampleEnd).getMagnitude();
 
     waveValues.push_back(maxVal);
   }
@@ -50,8 +50,8 @@ private:
 
   // Draw note waveform with smooth curves
   void drawNoteWaveform(juce::Graphics &g, const Note &note, float x, float y,
-                        float w, float h, const float *samples,
-                        int totalSamples, int sampleRate);
+                        float w, float h, const WaveformPeaks &peaks,
+                        int sampleRate);
 
   CoordinateMapper *coordMapper = nullptr;
   Project *project = nullptr;
@@ -62,6 +62,7 @@ private:
   float cachedPixelsPerSecond = -1.0f;
   int cachedWidth = 0;
   int cachedHeight = 0;
+  std::uint32_t cachedPeaksRevision = 0; // WaveformPeaks::getRevision()
 
   // Base pitch cache
   std::vector<float> cachedBasePitch;
@@ -0,0 +1,92 @@
+#include "PianoRollTileCache.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+bool PianoRollTileCache::Key::operator==(const Key &other) const {
+  return layer == other.layer && tileX == other.tileX &&
+         tileY == other.tileY && pixelsPerSecond == other.pixelsPerSecond &&
+         pixelsPerSemitone == other.pixelsPerSemitone &&
+         height == other.height && scale == other.scale;
+}
+
+size_t PianoRollTileCache::KeyHash::operator()(const Key &key) const {
+  size_t h = std::hash<int>()(static_cast<int>(key.layer));
+  auto mix = [&h](size_t value) {
+    h ^= value + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+  };
+  mix(std::hash<int>()(key.tileX));
+  mix(std::hash<int>()(key.tileY));
+  mix(std::hash<float>()(key.pixelsPerSecond));
+  mix(std::hash<float>()(key.pixelsPerSemitone));
+  mix(std::hash<int>()(key.height));
+  mix(std::hash<float>()(key.scale));
+  return h;
+}
+
+PianoRollTileCache::PianoRollTileCache(size_t maxBytesIn)
+    : maxBytes(maxBytesIn) {}
+
+void PianoRollTileCache::drawTile(juce::Graphics &g, const Key &key,
+                                  std::uint64_t fingerprint,
+                                  juce::Rectangle<float> destination,
+                                  const RenderFunction &render) {
+  auto &tile = tiles[key];
+  if (!tile.image.isValid() || tile.fingerprint != fingerprint) {
+    const int width =
+        std::max(1, static_cast<int>(std::ceil(destination.getWidth() *
+                                               key.scale)));
+    const int height = std::max(
+        1, static_cast<int>(std::ceil(destination.getHeight() * key.scale)));
+
+    if (tile.image.isValid() && tile.image.getWidth() == width &&
+        tile.image.getHeight() == height) {
+      tile.image.clear(tile.image.getBounds());
+    } else {
+      bytesUsed -= getImageBytes(tile.image);
+      tile.image = juce::Image(juce::Image::ARGB, width, height, true);
+      bytesUsed += getImageBytes(tile.image);
+    }
+
+    juce::Graphics tileGraphics(tile.image);
+    tileGraphics.addTransform(juce::AffineTransform::scale(key.scale));
+    render(tileGraphics);
+    tile.fingerprint = fingerprint;
+  }
+
+  tile.lastUsed = paintCounter;
+  g.drawImage(tile.image, destination);
+}
+
+void PianoRollTileCache::trim() {
+  if (bytesUsed > maxBytes) {
+    std::vector<std::pair<std::uint64_t, Key>> byAge;
+    byAge.reserve(tiles.size());
+    for (const auto &[key, tile] : tiles)
+      if (tile.lastUsed < paintCounter)
+        byAge.emplace_back(tile.lastUsed, key);
+    std::sort(byAge.begin(), byAge.end(),
+              [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    for (const auto &entry : byAge) {
+      if (bytesUsed <= maxBytes)
+        break;
+      auto it = tiles.find(entry.second);
+      bytesUsed -= getImageBytes(it->second.image);
+      tiles.erase(it);
+    }
+  }
+  ++paintCounter;
+}
+
+void PianoRollTileCache::clear() {
+  tiles.clear();
+  bytesUsed = 0;
+}
+
+size_t PianoRollTileCache::getImageBytes(const juce::Image &image) {
+  if (!image.isValid())
+    return 0;
+  return static_cast<size_t>(image.getWidth()) *
+         static_cast<size_t>(image.getHeight()) * 4;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "../../JuceHeader.h"
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+/**
+ * Fixed-size image tiles of piano roll content, kept per zoom level.
+ *
+ * Tiles cover tileWidth x tileHeight logical pixels of world space (or of a
+ * layer's own space) and are rendered at the display scale. Each carries a
+ * fingerprint of the data it was drawn from; a tile whose fingerprint no
+ * longer matches is redrawn, so an edit only costs the tiles over the frames
+ * it changed and scrolling only draws newly exposed tiles. Memory stays under
+ * a byte budget by dropping the least recently drawn tiles between paints.
+ */
+class PianoRollTileCache {
+public:
+  static constexpr int tileWidth = 512;
+  static constexpr int tileHeight = 256;
+
+  enum class Layer { BackgroundWaveform, Notes };
+
+  struct Key {
+    Layer layer = Layer::Notes;
+    int tileX = 0;
+    int tileY = 0;
+    float pixelsPerSecond = 0.0f;
+    float pixelsPerSemitone = 0.0f;
+    int height = tileHeight; // Background tiles span the view height
+    float scale = 1.0f;      // Physical pixels per logical pixel
+
+    bool operator==(const Key &other) const;
+  };
+
+  using RenderFunction = std::function<void(juce::Graphics &)>;
+
+  explicit PianoRollTileCache(size_t maxBytes = 128 * 1024 * 1024);
+
+  /**
+   * Draw the tile for key into g at destination (logical pixels), rendering
+   * it first if it is missing or was drawn from data with a different
+   * fingerprint. render draws in the tile's logical coordinates, with the
+   * tile's top-left corner at the origin.
+   */
+  void drawTile(juce::Graphics &g, const Key &key, std::uint64_t fingerprint,
+                juce::Rectangle<float> destination,
+                const RenderFunction &render);
+
+  /** Evict least recently drawn tiles until under budget; tiles drawn
+   *  since the last call are kept. Call once at the end of a paint. */
+  void trim();
+
+  void clear();
+
+  size_t getMemoryUsage() const { return bytesUsed; }
+
+private:
+  struct KeyHash {
+    size_t operator()(const Key &key) const;
+  };
+
+  struct Tile {
+    juce::Image image;
+    std::uint64_t fingerprint = 0;
+    std::uint64_t lastUsed = 0;
+  };
+
+  static size_t getImageBytes(const juce::Image &image);
+
+  size_t maxBytes;
+  size_t bytesUsed = 0;
+  std::uint64_t paintCounter = 1;
+  std::unordered_map<Key, Tile, KeyHash> tiles;
+};
@@ -119,8 +119,8 @@ void PitchEditor::endNoteDrag() {
     }
 
     // Rebuild pitch curves
-    PitchCurveProcessor::rebuildBaseFromNotes(*project);
-    PitchCurveProcessor::composeF0InPlace(*project, false);
+    PitchCurveProcessor::rebuildBaseFromNotesInRange(*project, startFrame,
+                                                     endFrame);
 
     if (onBasePitchCacheInvalidated)
       onBasePitchCacheInvalidated();
@@ -153,8 +153,8 @@ void PitchEditor::endNoteDrag() {
           [this, capturedExpandedStart, capturedExpandedEnd,
            capturedF0Size](Note *n) {
             if (project) {
-              PitchCurveProcessor::rebuildBaseFromNotes(*project);
-              PitchCurveProcessor::composeF0InPlace(*project, false);
+              PitchCurveProcessor::rebuildBaseFromNotesInRange(
+                  *project, capturedExpandedStart, capturedExpandedEnd);
               if (onBasePitchCacheInvalidated)
                 onBasePitchCacheInvalidated();
               int smoothStart = std::max(0, capturedExpandedStart - 60);
@@ -540,8 +540,8 @@ void PitchEditor::endMultiNoteDrag() {
     }
 
     // Rebuild pitch curves
-    PitchCurveProcessor::rebuildBaseFromNotes(*project);
-    PitchCurveProcessor::composeF0InPlace(*project, false);
+    PitchCurveProcessor::rebuildBaseFromNotesInRange(*project, expandedStart,
+                                                     expandedEnd);
 
     if (onBasePitchCacheInvalidated)
       onBasePitchCacheInvalidated();
@@ -584,8 +584,8 @@ void PitchEditor::endMultiNoteDrag() {
           [this, capturedExpandedStart, capturedExpandedEnd,
            capturedF0Size](const std::vector<Note *> &) {
             if (project) {
-              PitchCurveProcessor::rebuildBaseFromNotes(*project);
-              PitchCurveProcessor::composeF0InPlace(*project, false);
+              PitchCurveProcessor::rebuildBaseFromNotesInRange(
+                  *project, capturedExpandedStart, capturedExpandedEnd);
               if (onBasePitchCacheInvalidated)
                 onBasePitchCacheInvalidated();
               int smoothStart = std::max(0, capturedExpandedStart - 60);
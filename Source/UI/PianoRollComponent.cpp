@@ -3,6 +3,7 @@
 #include "../Utils/CenteredMelSpectrogram.h"
 #include "../Utils/CurveResampler.h"
 #include "../Utils/Constants.h"
+#include "../Utils/ContentHash.h"
 #include "../Utils/UI/TimecodeFont.h"
 #include "../Utils/UI/Theme.h"
 #include "../Utils/PitchCurveProcessor.h"
@@ -144,9 +145,20 @@ void PianoRollComponent::paint(juce::Graphics &g) {
 
     drawGrid(g);
     drawLoopOverlay(g);
-    drawNotes(g);
-    drawStretchGuides(g);
-    drawPitchCurves(g);
+    if (!previewNotes.empty()) {
+      drawPreviewNotes(g);
+    } else if (isEditingInteractively()) {
+      // Content changes on every drag step, so skip the tiles
+      drawNotes(g);
+      drawStretchGuides(g);
+      drawPitchCurves(g);
+    } else {
+      drawContentTiles(g, mainArea);
+      drawSplitGuide(g);
+      drawStretchGuides(g);
+      if (showBasePitch && project && !project->getAudioData().f0.empty())
+        drawBasePitchCurve(g);
+    }
     drawSelectionRect(g);
   }
 
@@ -181,6 +193,8 @@ void PianoRollComponent::paint(juce::Graphics &g) {
 
   // Draw piano keys
   drawPianoKeys(g);
+
+  tileCache.trim();
 }
 
 void PianoRollComponent::resized() {
@@ -203,89 +217,217 @@ void PianoRollComponent::drawBackgroundWaveform(
   if (!project)
     return;
 
-  const auto &audioData = project->getAudioData();
-  if (audioData.waveform.getNumSamples() == 0)
+  const auto &peaks = project->getWaveformPeaks();
+  if (peaks.getNumSamples() == 0 || visibleArea.isEmpty())
     return;
 
-  // Check if we can use cached waveform
-  bool cacheValid = waveformCache.isValid() &&
-                    std::abs(cachedScrollX - scrollX) < 1.0 &&
-                    std::abs(cachedPixelsPerSecond - pixelsPerSecond) < 0.01f &&
-                    cachedWidth == visibleArea.getWidth() &&
-                    cachedHeight == visibleArea.getHeight();
+  // Strips of tileWidth columns spanning the view height, so scrolling only
+  // renders the strips it exposes
+  constexpr int tileWidth = PianoRollTileCache::tileWidth;
+  const int scrollPixels = static_cast<int>(scrollX);
+  const int firstTile = scrollPixels / tileWidth;
+  const int lastTile = (scrollPixels + visibleArea.getWidth() - 1) / tileWidth;
+
+  PianoRollTileCache::Key key;
+  key.layer = PianoRollTileCache::Layer::BackgroundWaveform;
+  key.pixelsPerSecond = pixelsPerSecond;
+  key.height = visibleArea.getHeight();
+  key.scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+  const float visibleHeight = static_cast<float>(visibleArea.getHeight());
+  const float centerY = visibleHeight * 0.5f;
+  const float waveformHeight = visibleHeight * 0.8f;
+
+  for (int tile = firstTile; tile <= lastTile; ++tile) {
+    key.tileX = tile;
+    const double startTime =
+        static_cast<double>(tile * tileWidth) / pixelsPerSecond;
+    // One column past the strip so neighbouring strips join up
+    const double endTime =
+        static_cast<double>((tile + 1) * tileWidth + 1) / pixelsPerSecond;
+    const auto peak = peaks.queryTime(startTime, endTime, SAMPLE_RATE);
+
+    ContentHash fingerprint;
+    fingerprint.updateValue(peaks.getNumSamples());
+    fingerprint.updateValue(peak.min);
+    fingerprint.updateValue(peak.max);
+    fingerprint.updateValue(peak.rms);
+
+    const juce::Rectangle<float> destination(
+        static_cast<float>(visibleArea.getX() + tile * tileWidth -
+                           scrollPixels),
+        static_cast<float>(visibleArea.getY()), static_cast<float>(tileWidth),
+        visibleHeight);
+
+    tileCache.drawTile(
+        g, key, fingerprint.finish(), destination, [&](juce::Graphics &tg) {
+          std::vector<float> columnPeaks(tileWidth + 1);
+          for (int px = 0; px <= tileWidth; ++px) {
+            double time = static_cast<double>(tile * tileWidth + px) /
+                          pixelsPerSecond;
+            columnPeaks[static_cast<size_t>(px)] =
+                peaks
+                    .queryTime(time, time + 1.0 / pixelsPerSecond,
+                               SAMPLE_RATE)
+                    .getMagnitude();
+          }
 
-  if (cacheValid) {
-    g.drawImageAt(waveformCache, visibleArea.getX(), visibleArea.getY());
-    return;
+          auto edgeY = [&](int px, float direction) {
+            return centerY + direction *
+                                 columnPeaks[static_cast<size_t>(px)] *
+                                 waveformHeight * 0.5f;
+          };
+
+          juce::Path waveformPath;
+          waveformPath.startNewSubPath(0.0f, edgeY(0, -1.0f));
+          for (int px = 1; px <= tileWidth; ++px)
+            waveformPath.lineTo(static_cast<float>(px), edgeY(px, -1.0f));
+          // Bottom half (reverse)
+          for (int px = tileWidth; px >= 0; --px)
+            waveformPath.lineTo(static_cast<float>(px), edgeY(px, 1.0f));
+          waveformPath.closeSubPath();
+
+          tg.setColour(APP_COLOR_WAVEFORM);
+          tg.fillPath(waveformPath);
+        });
   }
+}
 
-  // Render waveform to cache
-  waveformCache = juce::Image(juce::Image::ARGB, visibleArea.getWidth(),
-                              visibleArea.getHeight(), true);
-  juce::Graphics cacheGraphics(waveformCache);
-
-  const float *samples = audioData.waveform.getReadPointer(0);
-  int numSamples = audioData.waveform.getNumSamples();
-
-  // Draw waveform filling the visible area height
-  float visibleHeight = static_cast<float>(visibleArea.getHeight());
-  float centerY = visibleHeight * 0.5f;
-  float waveformHeight = visibleHeight * 0.8f;
-
-  juce::Path waveformPath;
-  int visibleWidth = visibleArea.getWidth();
-
-  waveformPath.startNewSubPath(0.0f, centerY);
-
-  // Draw only the visible portion
-  for (int px = 0; px < visibleWidth; ++px) {
-    double time = (scrollX + px) / pixelsPerSecond;
-    int startSample = static_cast<int>(time * SAMPLE_RATE);
-    int endSample =
-        static_cast<int>((time + 1.0 / pixelsPerSecond) * SAMPLE_RATE);
-
-    startSample = std::max(0, std::min(startSample, numSamples - 1));
-    endSample = std::max(startSample + 1, std::min(endSample, numSamples));
-
-    float maxVal = 0.0f;
-    for (int i = startSample; i < endSample; ++i)
-      maxVal = std::max(maxVal, std::abs(samples[i]));
-
-    float y = centerY - maxVal * waveformHeight * 0.5f;
-    waveformPath.lineTo(static_cast<float>(px), y);
-  }
+bool PianoRollComponent::isEditingInteractively() const {
+  return isDragging || isDrawing || stretchDrag.active ||
+         pitchEditor->isDraggingMultiNotes();
+}
 
-  // Bottom half (reverse)
-  for (int px = visibleWidth - 1; px >= 0; --px) {
-    double time = (scrollX + px) / pixelsPerSecond;
-    int startSample = static_cast<int>(time * SAMPLE_RATE);
-    int endSample =
-        static_cast<int>((time + 1.0 / pixelsPerSecond) * SAMPLE_RATE);
+void PianoRollComponent::drawContentTiles(
+    juce::Graphics &g, const juce::Rectangle<int> &visibleArea) {
+  if (!project)
+    return;
 
-    startSample = std::max(0, std::min(startSample, numSamples - 1));
-    endSample = std::max(startSample + 1, std::min(endSample, numSamples));
+  constexpr int tileWidth = PianoRollTileCache::tileWidth;
+  constexpr int tileHeight = PianoRollTileCache::tileHeight;
+  const auto &audioData = project->getAudioData();
+  const auto &peaks = project->getWaveformPeaks();
+  const bool drawCurves = showDeltaPitch && !audioData.f0.empty();
+  const float globalOffset = project->getGlobalPitchOffset();
+
+  const int scrollPixelsX = static_cast<int>(scrollX);
+  const int scrollPixelsY = static_cast<int>(scrollY);
+  const int firstColumn = scrollPixelsX / tileWidth;
+  const int lastColumn =
+      (scrollPixelsX + visibleArea.getWidth() - 1) / tileWidth;
+  const int firstRow = scrollPixelsY / tileHeight;
+  const int lastRow =
+      (scrollPixelsY + visibleArea.getHeight() - 1) / tileHeight;
+
+  const double framesPerPixel =
+      audioData.sampleRate /
+      (HOP_SIZE * static_cast<double>(pixelsPerSecond));
+  // Note outlines and the short-note minimum width reach a few pixels past
+  // the note; curves need a frame either side to run across tile edges
+  const int marginFrames =
+      static_cast<int>(std::ceil(6.0 * framesPerPixel)) + 2;
+
+  PianoRollTileCache::Key key;
+  key.layer = PianoRollTileCache::Layer::Notes;
+  key.pixelsPerSecond = pixelsPerSecond;
+  key.pixelsPerSemitone = pixelsPerSemitone;
+  key.scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+  std::vector<const Note *> columnNotes;
+  for (int column = firstColumn; column <= lastColumn; ++column) {
+    const int columnStartFrame =
+        static_cast<int>(column * tileWidth * framesPerPixel) - marginFrames;
+    const int columnEndFrame =
+        static_cast<int>((column + 1) * tileWidth * framesPerPixel) +
+        marginFrames;
+
+    // Everything a tile in this column is drawn from goes into its
+    // fingerprint, so edits redraw only the columns over changed frames
+    ContentHash fingerprint;
+    fingerprint.updateValue(drawCurves);
+    fingerprint.updateValue(globalOffset);
+
+    columnNotes.clear();
+    for (const auto *note :
+         project->getNotesInRange(columnStartFrame, columnEndFrame)) {
+      if (note->isRest())
+        continue;
+      columnNotes.push_back(note);
+
+      fingerprint.updateValue(note->getStartFrame());
+      fingerprint.updateValue(note->getEndFrame());
+      fingerprint.updateValue(note->getMidiNote());
+      fingerprint.updateValue(note->getPitchOffset());
+      fingerprint.updateValue(note->isSelected());
+      const auto &clip = note->getClipWaveform();
+      fingerprint.updateValue(clip.data());
+      fingerprint.updateValue(clip.size());
+      if (!clip.empty()) {
+        fingerprint.updateValue(clip.front());
+        fingerprint.updateValue(clip[clip.size() / 2]);
+        fingerprint.updateValue(clip.back());
+      }
+    }
 
-    float maxVal = 0.0f;
-    for (int i = startSample; i < endSample; ++i)
-      maxVal = std::max(maxVal, std::abs(samples[i]));
+    const auto peak =
+        peaks.query(static_cast<std::int64_t>(columnStartFrame) * HOP_SIZE,
+                    static_cast<std::int64_t>(columnEndFrame) * HOP_SIZE);
+    fingerprint.updateValue(peaks.getNumSamples());
+    fingerprint.updateValue(peak.min);
+    fingerprint.updateValue(peak.max);
+    fingerprint.updateValue(peak.rms);
+
+    if (drawCurves) {
+      auto hashRange = [&](const auto &values) {
+        fingerprint.updateValue(values.size());
+        const int begin = juce::jlimit(0, static_cast<int>(values.size()),
+                                       columnStartFrame);
+        const int end = juce::jlimit(begin, static_cast<int>(values.size()),
+                                     columnEndFrame);
+        if (end > begin)
+          fingerprint.update(values.data() + begin,
+                             static_cast<size_t>(end - begin) *
+                                 sizeof(values[0]));
+      };
+      hashRange(audioData.f0);
+      hashRange(audioData.basePitch);
+      hashRange(audioData.deltaPitch);
+    }
+
+    key.tileX = column;
+    const auto columnFingerprint = fingerprint.finish();
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+      key.tileY = row;
+      const juce::Rectangle<float> destination(
+          static_cast<float>(column * tileWidth),
+          static_cast<float>(row * tileHeight), static_cast<float>(tileWidth),
+          static_cast<float>(tileHeight));
+
+      tileCache.drawTile(
+          g, key, columnFingerprint, destination, [&](juce::Graphics &tg) {
+            tg.addTransform(juce::AffineTransform::translation(
+                -destination.getX(), -destination.getY()));
+
+            for (const auto *note : columnNotes) {
+              // A note's waveform reaches one note height above and below
+              // its row
+              const float h = pixelsPerSemitone;
+              const float y = midiToY(note->getMidiNote()) -
+                              note->getPitchOffset() * pixelsPerSemitone;
+              if (y + 2.0f * h < destination.getY() ||
+                  y - h > destination.getBottom())
+                continue;
+              drawNote(tg, *note, peaks);
+            }
 
-    float y = centerY + maxVal * waveformHeight * 0.5f;
-    waveformPath.lineTo(static_cast<float>(px), y);
+            if (drawCurves)
+              for (const auto *note : columnNotes)
+                drawNotePitchCurve(tg, *note, columnStartFrame,
+                                   columnEndFrame);
+          });
+    }
   }
-
-  waveformPath.closeSubPath();
-
-  cacheGraphics.setColour(APP_COLOR_WAVEFORM);
-  cacheGraphics.fillPath(waveformPath);
-
-  // Update cache metadata
-  cachedScrollX = scrollX;
-  cachedPixelsPerSecond = pixelsPerSecond;
-  cachedWidth = visibleArea.getWidth();
-  cachedHeight = visibleArea.getHeight();
-
-  // Draw cached image
-  g.drawImageAt(waveformCache, visibleArea.getX(), visibleArea.getY());
 }
 
 void PianoRollComponent::drawGrid(juce::Graphics &g) {
@@ -522,271 +664,310 @@ void PianoRollComponent::drawLoopTimeline(juce::Graphics &g) {
   g.fillPath(endFlag);
 }
 
+void PianoRollComponent::drawPreviewNotes(juce::Graphics &g) {
+  const double visibleStartTime = scrollX / pixelsPerSecond;
+  const double visibleEndTime = (scrollX + getWidth()) / pixelsPerSecond;
+
+  for (const auto &note : previewNotes) {
+    const double noteStartTime = framesToSeconds(note.startFrame);
+    const double noteEndTime = framesToSeconds(note.endFrame);
+    if (noteEndTime < visibleStartTime || noteStartTime > visibleEndTime)
+      continue;
+
+    const float x = static_cast<float>(noteStartTime * pixelsPerSecond);
+    const float w = std::max(
+        2.0f, static_cast<float>((noteEndTime - noteStartTime) * pixelsPerSecond));
+    const float y = midiToY(note.midiNote);
+    const float h = pixelsPerSemitone;
+
+    g.setColour(APP_COLOR_NOTE_NORMAL.withAlpha(0.25f));
+    g.fillRoundedRectangle(x, y, w, h, 2.0f);
+    g.setColour(APP_COLOR_NOTE_NORMAL.withAlpha(0.7f));
+    g.drawRoundedRectangle(x, y, w, h, 2.0f, 1.0f);
+  }
+}
+
 void PianoRollComponent::drawNotes(juce::Graphics &g) {
   if (!project)
     return;
 
-  const auto &audioData = project->getAudioData();
-  const float *globalSamples = audioData.waveform.getNumSamples() > 0
-                                   ? audioData.waveform.getReadPointer(0)
-                                   : nullptr;
-  int globalTotalSamples = audioData.waveform.getNumSamples();
+  const auto &globalPeaks = project->getWaveformPeaks();
 
-  // Calculate visible time range for culling
-  double visibleStartTime = scrollX / pixelsPerSecond;
-  double visibleEndTime = (scrollX + getWidth()) / pixelsPerSecond;
+  // Viewport culling: only notes over the visible frames, with a frame of
+  // margin either side
+  const int visibleStartFrame =
+      secondsToFrames(static_cast<float>(scrollX / pixelsPerSecond)) - 1;
+  const int visibleEndFrame =
+      secondsToFrames(
+          static_cast<float>((scrollX + getWidth()) / pixelsPerSecond)) +
+      2;
 
-  for (auto &note : project->getNotes()) {
+  for (const auto *note :
+       project->getNotesInRange(visibleStartFrame, visibleEndFrame)) {
     // Skip rest notes (they have no pitch)
-    if (note.isRest())
+    if (note->isRest())
       continue;
 
-    // Viewport culling: skip notes outside visible area
-    double noteStartTime = framesToSeconds(note.getStartFrame());
-    double noteEndTime = framesToSeconds(note.getEndFrame());
-    if (noteEndTime < visibleStartTime || noteStartTime > visibleEndTime)
-      continue;
+    drawNote(g, *note, globalPeaks);
+  }
 
-    float x = static_cast<float>(noteStartTime * pixelsPerSecond);
-    float w = framesToSeconds(note.getDurationFrames()) * pixelsPerSecond;
-    float h = pixelsPerSemitone;
-
-    // Position at grid cell center for MIDI note, then offset by pitch
-    // adjustment
-    float baseGridCenterY =
-        midiToY(note.getMidiNote()) + pixelsPerSemitone * 0.5f;
-    float pitchOffsetPixels = -note.getPitchOffset() * pixelsPerSemitone;
-    float y = baseGridCenterY + pitchOffsetPixels - h * 0.5f;
-
-    // Note color based on pitch
-    juce::Colour noteColor = note.isSelected()
-                                 ? APP_COLOR_NOTE_SELECTED
-                                 : APP_COLOR_NOTE_NORMAL;
-
-    const float *samples = globalSamples;
-    int totalSamples = globalTotalSamples;
-    int startSample = 0;
-    int endSample = 0;
-    const auto &clipWaveform = note.getClipWaveform();
-    if (!clipWaveform.empty()) {
-      samples = clipWaveform.data();
-      totalSamples = static_cast<int>(clipWaveform.size());
-      startSample = 0;
-      endSample = totalSamples;
-    } else if (samples && totalSamples > 0) {
-      startSample = static_cast<int>(framesToSeconds(note.getStartFrame()) *
-                                     audioData.sampleRate);
-      endSample = static_cast<int>(framesToSeconds(note.getEndFrame()) *
+  drawSplitGuide(g);
+}
+
+void PianoRollComponent::drawNote(juce::Graphics &g, const Note &note,
+                                  const WaveformPeaks &globalPeaks) {
+  const auto &audioData = project->getAudioData();
+  const float *globalSamples = audioData.waveform.getNumSamples() > 0
+                                   ? audioData.waveform.getReadPointer(0)
+                                   : nullptr;
+  int globalTotalSamples = audioData.waveform.getNumSamples();
+
+  double noteStartTime = framesToSeconds(note.getStartFrame());
+  float x = static_cast<float>(noteStartTime * pixelsPerSecond);
+  float w = framesToSeconds(note.getDurationFrames()) * pixelsPerSecond;
+  float h = pixelsPerSemitone;
+
+  // Position at grid cell center for MIDI note, then offset by pitch
+  // adjustment
+  float baseGridCenterY =
+      midiToY(note.getMidiNote()) + pixelsPerSemitone * 0.5f;
+  float pitchOffsetPixels = -note.getPitchOffset() * pixelsPerSemitone;
+  float y = baseGridCenterY + pitchOffsetPixels - h * 0.5f;
+
+  // Note color based on pitch
+  juce::Colour noteColor =
+      note.isSelected() ? APP_COLOR_NOTE_SELECTED : APP_COLOR_NOTE_NORMAL;
+
+  const float *samples = globalSamples;
+  int totalSamples = globalTotalSamples;
+  int startSample = 0;
+  int endSample = 0;
+  // Clips are short and private to the note, so they are scanned
+  // directly; the global waveform goes through its peak pyramid
+  const WaveformPeaks *peaks = &globalPeaks;
+  const auto &clipWaveform = note.getClipWaveform();
+  if (!clipWaveform.empty()) {
+    peaks = nullptr;
+    samples = clipWaveform.data();
+    totalSamples = static_cast<int>(clipWaveform.size());
+    startSample = 0;
+    endSample = totalSamples;
+  } else if (samples && totalSamples > 0) {
+    startSample = static_cast<int>(framesToSeconds(note.getStartFrame()) *
                                    audioData.sampleRate);
-      startSample = std::max(0, std::min(startSample, totalSamples - 1));
-      endSample = std::max(startSample + 1,
-                           std::min(endSample, totalSamples));
-    }
+    endSample = static_cast<int>(framesToSeconds(note.getEndFrame()) *
+                                 audioData.sampleRate);
+    startSample = std::max(0, std::min(startSample, totalSamples - 1));
+    endSample = std::max(startSample + 1, std::min(endSample, totalSamples));
+  }
 
-    if (samples && totalSamples > 0 && w > 2.0f &&
-        endSample > startSample) {
-      // Draw waveform slice inside note
-      int numNoteSamples = endSample - startSample;
-      int samplesPerPixel = std::max(1, static_cast<int>(numNoteSamples / w));
+  if (samples && totalSamples > 0 && w > 2.0f && endSample > startSample) {
+    // Draw waveform slice inside note
+    int numNoteSamples = endSample - startSample;
+    int samplesPerPixel = std::max(1, static_cast<int>(numNoteSamples / w));
 
-      float centerY = y + h * 0.5f;
-      float waveHeight = h * 3.0f;
+    float centerY = y + h * 0.5f;
+    float waveHeight = h * 3.0f;
 
-      // Build waveform data with increased resolution for smoother curves
-      std::vector<float> waveValues;
-      // Increase point density for smoother curves (up to 800 points)
-      float step = std::max(0.5f, w / 1024.0f);
+    // Build waveform data with increased resolution for smoother curves
+    std::vector<float> waveValues;
+    // Increase point density for smoother curves (up to 800 points)
+    float step = std::max(0.5f, w / 1024.0f);
 
-      for (float px = 0; px <= w; px += step) {
-        int sampleIdx =
-            startSample + static_cast<int>((px / w) * numNoteSamples);
-        int sampleEnd = std::min(sampleIdx + samplesPerPixel, endSample);
+    for (float px = 0; px <= w; px += step) {
+      int sampleIdx =
+          startSample + static_cast<int>((px / w) * numNoteSamples);
+      int sampleEnd = std::min(sampleIdx + samplesPerPixel, endSample);
 
-        float maxVal = 0.0f;
+      float maxVal = 0.0f;
+      if (peaks)
+        maxVal = peaks->query(sampleIdx, sampleEnd).getMagnitude();
+      else
         for (int i = sampleIdx; i < sampleEnd; ++i)
           maxVal = std::max(maxVal, std::abs(samples[i]));
 
-        waveValues.push_back(maxVal);
-      }
+      waveValues.push_back(maxVal);
+    }
 
-      // Apply smoothing filter to reduce aliasing artifacts
-      if (waveValues.size() > 2) {
-        std::vector<float> smoothed(waveValues.size());
-        smoothed[0] = waveValues[0];
-        for (size_t i = 1; i + 1 < waveValues.size(); ++i) {
-          // Simple 3-point moving average for gentle smoothing
-          smoothed[i] = (waveValues[i - 1] * 0.25f + waveValues[i] * 0.5f +
-                         waveValues[i + 1] * 0.25f);
-        }
-        smoothed[waveValues.size() - 1] = waveValues[waveValues.size() - 1];
-        waveValues = std::move(smoothed);
+    // Apply smoothing filter to reduce aliasing artifacts
+    if (waveValues.size() > 2) {
+      std::vector<float> smoothed(waveValues.size());
+      smoothed[0] = waveValues[0];
+      for (size_t i = 1; i + 1 < waveValues.size(); ++i) {
+        // Simple 3-point moving average for gentle smoothing
+        smoothed[i] = (waveValues[i - 1] * 0.25f + waveValues[i] * 0.5f +
+                       waveValues[i + 1] * 0.25f);
       }
+      smoothed[waveValues.size() - 1] = waveValues[waveValues.size() - 1];
+      waveValues = std::move(smoothed);
+    }
 
-      size_t numPoints = waveValues.size();
-      if (numPoints < 2) {
-        // Fallback for very short notes
-        g.setColour(noteColor.withAlpha(0.85f));
-        g.fillRoundedRectangle(x, y, std::max(w, 4.0f), h, 2.0f);
-      } else {
-        // Helper function for Catmull-Rom spline interpolation
-        auto catmullRom = [](float t, float p0, float p1, float p2,
-                             float p3) -> float {
-          // Catmull-Rom spline: smooth interpolation between p1 and p2
-          float t2 = t * t;
-          float t3 = t2 * t;
-          return 0.5f * ((2.0f * p1) + (-p0 + p2) * t +
-                         (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
-                         (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * t3);
-        };
-
-        // Draw filled waveform using smooth curves
-        g.setColour(noteColor.withAlpha(0.85f));
-        juce::Path waveformPath;
-
-        // Build top curve with Catmull-Rom spline
-        waveformPath.startNewSubPath(x, centerY -
-                                            waveValues[0] * waveHeight * 0.5f);
-
-        // Use cubic curves for smooth interpolation
-        const int curveSegments = 4; // Interpolate 4 points between each pair
-        for (size_t i = 0; i + 1 < numPoints; ++i) {
-          float px1 =
-              (static_cast<float>(i) / static_cast<float>(numPoints - 1)) * w;
-          float px2 =
-              (static_cast<float>(i + 1) / static_cast<float>(numPoints - 1)) *
-              w;
-
-          // Get control points for spline
-          size_t idx0 = (i > 0) ? i - 1 : i;
-          size_t idx1 = i;
-          size_t idx2 = i + 1;
-          size_t idx3 = (i + 2 < numPoints) ? i + 2 : i + 1;
-
-          float val0 = waveValues[idx0];
-          float val1 = waveValues[idx1];
-          float val2 = waveValues[idx2];
-          float val3 = waveValues[idx3];
-
-          // Draw smooth curve segment
-          for (int seg = 1; seg <= curveSegments; ++seg) {
-            float t =
-                static_cast<float>(seg) / static_cast<float>(curveSegments);
-            float px = px1 + (px2 - px1) * t;
-            float val = catmullRom(t, val0, val1, val2, val3);
-            float yPos = centerY - val * waveHeight * 0.5f;
-            waveformPath.lineTo(x + px, yPos);
-          }
+    size_t numPoints = waveValues.size();
+    if (numPoints < 2) {
+      // Fallback for very short notes
+      g.setColour(noteColor.withAlpha(0.85f));
+      g.fillRoundedRectangle(x, y, std::max(w, 4.0f), h, 2.0f);
+    } else {
+      // Helper function for Catmull-Rom spline interpolation
+      auto catmullRom = [](float t, float p0, float p1, float p2,
+                           float p3) -> float {
+        // Catmull-Rom spline: smooth interpolation between p1 and p2
+        float t2 = t * t;
+        float t3 = t2 * t;
+        return 0.5f * ((2.0f * p1) + (-p0 + p2) * t +
+                       (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+                       (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * t3);
+      };
+
+      // Draw filled waveform using smooth curves
+      g.setColour(noteColor.withAlpha(0.85f));
+      juce::Path waveformPath;
+
+      // Build top curve with Catmull-Rom spline
+      waveformPath.startNewSubPath(x, centerY -
+                                          waveValues[0] * waveHeight * 0.5f);
+
+      // Use cubic curves for smooth interpolation
+      const int curveSegments = 4; // Interpolate 4 points between each pair
+      for (size_t i = 0; i + 1 < numPoints; ++i) {
+        float px1 =
+            (static_cast<float>(i) / static_cast<float>(numPoints - 1)) * w;
+        float px2 =
+            (static_cast<float>(i + 1) / static_cast<float>(numPoints - 1)) *
+            w;
+
+        // Get control points for spline
+        size_t idx0 = (i > 0) ? i - 1 : i;
+        size_t idx1 = i;
+        size_t idx2 = i + 1;
+        size_t idx3 = (i + 2 < numPoints) ? i + 2 : i + 1;
+
+        float val0 = waveValues[idx0];
+        float val1 = waveValues[idx1];
+        float val2 = waveValues[idx2];
+        float val3 = waveValues[idx3];
+
+        // Draw smooth curve segment
+        for (int seg = 1; seg <= curveSegments; ++seg) {
+          float t =
+              static_cast<float>(seg) / static_cast<float>(curveSegments);
+          float px = px1 + (px2 - px1) * t;
+          float val = catmullRom(t, val0, val1, val2, val3);
+          float yPos = centerY - val * waveHeight * 0.5f;
+          waveformPath.lineTo(x + px, yPos);
         }
+      }
 
-        // Build bottom curve (mirror of top)
-        waveformPath.lineTo(x + w, centerY + waveValues[numPoints - 1] *
-                                                 waveHeight * 0.5f);
-
-        for (int i = static_cast<int>(numPoints) - 2; i >= 0; --i) {
-          float px1 =
-              (static_cast<float>(i + 1) / static_cast<float>(numPoints - 1)) *
-              w;
-          float px2 =
-              (static_cast<float>(i) / static_cast<float>(numPoints - 1)) * w;
-
-          size_t idx0 = (i + 2 < numPoints) ? i + 2 : i + 1;
-          size_t idx1 = i + 1;
-          size_t idx2 = i;
-          size_t idx3 = (i > 0) ? i - 1 : i;
-
-          float val0 = waveValues[idx0];
-          float val1 = waveValues[idx1];
-          float val2 = waveValues[idx2];
-          float val3 = waveValues[idx3];
-
-          for (int seg = 1; seg <= curveSegments; ++seg) {
-            float t =
-                static_cast<float>(seg) / static_cast<float>(curveSegments);
-            float px = px1 + (px2 - px1) * t;
-            float val = catmullRom(t, val0, val1, val2, val3);
-            float yPos = centerY + val * waveHeight * 0.5f;
-            waveformPath.lineTo(x + px, yPos);
-          }
+      // Build bottom curve (mirror of top)
+      waveformPath.lineTo(x + w, centerY + waveValues[numPoints - 1] *
+                                               waveHeight * 0.5f);
+
+      for (int i = static_cast<int>(numPoints) - 2; i >= 0; --i) {
+        float px1 =
+            (static_cast<float>(i + 1) / static_cast<float>(numPoints - 1)) *
+            w;
+        float px2 =
+            (static_cast<float>(i) / static_cast<float>(numPoints - 1)) * w;
+
+        size_t idx0 = (i + 2 < numPoints) ? i + 2 : i + 1;
+        size_t idx1 = i + 1;
+        size_t idx2 = i;
+        size_t idx3 = (i > 0) ? i - 1 : i;
+
+        float val0 = waveValues[idx0];
+        float val1 = waveValues[idx1];
+        float val2 = waveValues[idx2];
+        float val3 = waveValues[idx3];
+
+        for (int seg = 1; seg <= curveSegments; ++seg) {
+          float t =
+              static_cast<float>(seg) / static_cast<float>(curveSegments);
+          float px = px1 + (px2 - px1) * t;
+          float val = catmullRom(t, val0, val1, val2, val3);
+          float yPos = centerY + val * waveHeight * 0.5f;
+          waveformPath.lineTo(x + px, yPos);
         }
+      }
 
-        waveformPath.closeSubPath();
-        g.fillPath(waveformPath);
-
-        // Draw smooth outline with anti-aliasing
-        juce::Path outline;
-        outline.startNewSubPath(x, centerY - waveValues[0] * waveHeight * 0.5f);
-
-        // Top curve
-        for (size_t i = 0; i + 1 < numPoints; ++i) {
-          float px1 =
-              (static_cast<float>(i) / static_cast<float>(numPoints - 1)) * w;
-          float px2 =
-              (static_cast<float>(i + 1) / static_cast<float>(numPoints - 1)) *
-              w;
-
-          size_t idx0 = (i > 0) ? i - 1 : i;
-          size_t idx1 = i;
-          size_t idx2 = i + 1;
-          size_t idx3 = (i + 2 < numPoints) ? i + 2 : i + 1;
-
-          float val0 = waveValues[idx0];
-          float val1 = waveValues[idx1];
-          float val2 = waveValues[idx2];
-          float val3 = waveValues[idx3];
-
-          for (int seg = 1; seg <= curveSegments; ++seg) {
-            float t =
-                static_cast<float>(seg) / static_cast<float>(curveSegments);
-            float px = px1 + (px2 - px1) * t;
-            float val = catmullRom(t, val0, val1, val2, val3);
-            float yPos = centerY - val * waveHeight * 0.5f;
-            outline.lineTo(x + px, yPos);
-          }
+      waveformPath.closeSubPath();
+      g.fillPath(waveformPath);
+
+      // Draw smooth outline with anti-aliasing
+      juce::Path outline;
+      outline.startNewSubPath(x, centerY - waveValues[0] * waveHeight * 0.5f);
+
+      // Top curve
+      for (size_t i = 0; i + 1 < numPoints; ++i) {
+        float px1 =
+            (static_cast<float>(i) / static_cast<float>(numPoints - 1)) * w;
+        float px2 =
+            (static_cast<float>(i + 1) / static_cast<float>(numPoints - 1)) *
+            w;
+
+        size_t idx0 = (i > 0) ? i - 1 : i;
+        size_t idx1 = i;
+        size_t idx2 = i + 1;
+        size_t idx3 = (i + 2 < numPoints) ? i + 2 : i + 1;
+
+        float val0 = waveValues[idx0];
+        float val1 = waveValues[idx1];
+        float val2 = waveValues[idx2];
+        float val3 = waveValues[idx3];
+
+        for (int seg = 1; seg <= curveSegments; ++seg) {
+          float t =
+              static_cast<float>(seg) / static_cast<float>(curveSegments);
+          float px = px1 + (px2 - px1) * t;
+          float val = catmullRom(t, val0, val1, val2, val3);
+          float yPos = centerY - val * waveHeight * 0.5f;
+          outline.lineTo(x + px, yPos);
         }
+      }
 
-        // Bottom curve
-        for (int i = static_cast<int>(numPoints) - 2; i >= 0; --i) {
-          float px1 =
-              (static_cast<float>(i + 1) / static_cast<float>(numPoints - 1)) *
-              w;
-          float px2 =
-              (static_cast<float>(i) / static_cast<float>(numPoints - 1)) * w;
-
-          size_t idx0 = (i + 2 < numPoints) ? i + 2 : i + 1;
-          size_t idx1 = i + 1;
-          size_t idx2 = i;
-          size_t idx3 = (i > 0) ? i - 1 : i;
-
-          float val0 = waveValues[idx0];
-          float val1 = waveValues[idx1];
-          float val2 = waveValues[idx2];
-          float val3 = waveValues[idx3];
-
-          for (int seg = 1; seg <= curveSegments; ++seg) {
-            float t =
-                static_cast<float>(seg) / static_cast<float>(curveSegments);
-            float px = px1 + (px2 - px1) * t;
-            float val = catmullRom(t, val0, val1, val2, val3);
-            float yPos = centerY + val * waveHeight * 0.5f;
-            outline.lineTo(x + px, yPos);
-          }
+      // Bottom curve
+      for (int i = static_cast<int>(numPoints) - 2; i >= 0; --i) {
+        float px1 =
+            (static_cast<float>(i + 1) / static_cast<float>(numPoints - 1)) *
+            w;
+        float px2 =
+            (static_cast<float>(i) / static_cast<float>(numPoints - 1)) * w;
+
+        size_t idx0 = (i + 2 < numPoints) ? i + 2 : i + 1;
+        size_t idx1 = i + 1;
+        size_t idx2 = i;
+        size_t idx3 = (i > 0) ? i - 1 : i;
+
+        float val0 = waveValues[idx0];
+        float val1 = waveValues[idx1];
+        float val2 = waveValues[idx2];
+        float val3 = waveValues[idx3];
+
+        for (int seg = 1; seg <= curveSegments; ++seg) {
+          float t =
+              static_cast<float>(seg) / static_cast<float>(curveSegments);
+          float px = px1 + (px2 - px1) * t;
+          float val = catmullRom(t, val0, val1, val2, val3);
+          float yPos = centerY + val * waveHeight * 0.5f;
+          outline.lineTo(x + px, yPos);
         }
-
-        outline.closeSubPath();
-        g.setColour(noteColor.brighter(0.2f));
-        // Use slightly thicker stroke with anti-aliasing for smoother
-        // appearance
-        g.strokePath(outline,
-                     juce::PathStrokeType(1.2f, juce::PathStrokeType::curved,
-                                          juce::PathStrokeType::rounded));
       }
-    } else {
-      // Fallback: simple rectangle for very short notes
-      g.setColour(noteColor.withAlpha(0.85f));
-      g.fillRoundedRectangle(x, y, std::max(w, 4.0f), h, 2.0f);
+
+      outline.closeSubPath();
+      g.setColour(noteColor.brighter(0.2f));
+      // Use slightly thicker stroke with anti-aliasing for smoother
+      // appearance
+      g.strokePath(outline,
+                   juce::PathStrokeType(1.2f, juce::PathStrokeType::curved,
+                                        juce::PathStrokeType::rounded));
     }
+  } else {
+    // Fallback: simple rectangle for very short notes
+    g.setColour(noteColor.withAlpha(0.85f));
+    g.fillRoundedRectangle(x, y, std::max(w, 4.0f), h, 2.0f);
   }
+}
 
+void PianoRollComponent::drawSplitGuide(juce::Graphics &g) {
   // Draw split guide line when in split mode and hovering over a note
   if (editMode == EditMode::Split && splitGuideNote && splitGuideX >= 0) {
     float noteStartTime = framesToSeconds(splitGuideNote->getStartFrame());
@@ -849,138 +1030,157 @@ void PianoRollComponent::drawPitchCurves(juce::Graphics &g) {
   if (audioData.f0.empty())
     return;
 
-  // Get global pitch offset (applied to display only)
-  float globalOffset = project->getGlobalPitchOffset();
-
   // Draw pitch curves per note with their pitch offsets applied (delta pitch)
   if (showDeltaPitch) {
-    g.setColour(APP_COLOR_PITCH_CURVE);
+    // One frame of margin so curves run in from outside the view
+    const double framesPerPixel =
+        audioData.sampleRate /
+        (HOP_SIZE * static_cast<double>(pixelsPerSecond));
+    const int visStartFrame =
+        std::max(0, static_cast<int>(scrollX * framesPerPixel) - 1);
+    const int visEndFrame =
+        static_cast<int>((scrollX + getWidth()) * framesPerPixel) + 2;
 
-    const bool useLiveBasePreview =
-        (isDragging || pitchEditor->isDraggingMultiNotes());
-    const auto &draggedNotes = pitchEditor->getDraggedNotes();
+    for (const auto *note :
+         project->getNotesInRange(visStartFrame, visEndFrame)) {
+      if (!note->isRest())
+        drawNotePitchCurve(g, *note, visStartFrame, visEndFrame);
+    }
+  }
 
-    for (const auto &note : project->getNotes()) {
-      if (note.isRest())
-        continue;
+  // Draw base pitch curve as dashed line
+  if (showBasePitch)
+    drawBasePitchCurve(g);
+}
 
-      const bool isDraggedNote =
-          (isDragging && draggedNote == &note) ||
-          (pitchEditor->isDraggingMultiNotes() &&
-           std::find(draggedNotes.begin(), draggedNotes.end(), &note) !=
-               draggedNotes.end());
-      const bool applyNoteOffset = !(useLiveBasePreview && isDraggedNote);
-
-      juce::Path path;
-      bool pathStarted = false;
-
-      int startFrame = note.getStartFrame();
-      int endFrame =
-          std::min(note.getEndFrame(), static_cast<int>(audioData.f0.size()));
-
-      for (int i = startFrame; i < endFrame; ++i) {
-        // Base pitch: during drag, add pitchOffset to simulate the new base
-        // pitch This gives real-time preview of how the curve will look after
-        // drag completes
-        float baseMidi =
-            (i < static_cast<int>(audioData.basePitch.size()))
-                ? audioData.basePitch[static_cast<size_t>(i)]
-                : ((i < static_cast<int>(audioData.f0.size()) &&
-                    audioData.f0[static_cast<size_t>(i)] > 0.0f)
-                       ? freqToMidi(audioData.f0[static_cast<size_t>(i)])
-                       : 0.0f);
-        if (applyNoteOffset)
-          baseMidi += note.getPitchOffset();
-        float deltaMidi = (i < static_cast<int>(audioData.deltaPitch.size()))
-                              ? audioData.deltaPitch[static_cast<size_t>(i)]
-                              : 0.0f;
-        // Final = base (with drag offset) + delta + global offset only
-        float finalMidi = baseMidi + deltaMidi + globalOffset;
-
-        if (finalMidi > 0.0f) {
-          float x = framesToSeconds(i) * pixelsPerSecond;
-          float y = midiToY(finalMidi) + pixelsPerSemitone * 0.5f;
+void PianoRollComponent::drawNotePitchCurve(juce::Graphics &g,
+                                            const Note &note, int startFrame,
+                                            int endFrame) {
+  const auto &audioData = project->getAudioData();
 
-          if (!pathStarted) {
-            path.startNewSubPath(x, y);
-            pathStarted = true;
-          } else {
-            path.lineTo(x, y);
-          }
-        }
-      }
+  // Get global pitch offset (applied to display only)
+  float globalOffset = project->getGlobalPitchOffset();
 
-      if (pathStarted) {
-        g.strokePath(path, juce::PathStrokeType(2.0f));
+  const bool useLiveBasePreview =
+      (isDragging || pitchEditor->isDraggingMultiNotes());
+  const auto &draggedNotes = pitchEditor->getDraggedNotes();
+  const bool isDraggedNote =
+      (isDragging && draggedNote == &note) ||
+      (pitchEditor->isDraggingMultiNotes() &&
+       std::find(draggedNotes.begin(), draggedNotes.end(), &note) !=
+           draggedNotes.end());
+  const bool applyNoteOffset = !(useLiveBasePreview && isDraggedNote);
+
+  juce::Path path;
+  bool pathStarted = false;
+
+  startFrame = std::max(startFrame, note.getStartFrame());
+  endFrame = std::min({endFrame, note.getEndFrame(),
+                       static_cast<int>(audioData.f0.size())});
+
+  for (int i = startFrame; i < endFrame; ++i) {
+    // Base pitch: during drag, add pitchOffset to simulate the new base
+    // pitch This gives real-time preview of how the curve will look after
+    // drag completes
+    float baseMidi =
+        (i < static_cast<int>(audioData.basePitch.size()))
+            ? audioData.basePitch[static_cast<size_t>(i)]
+            : ((i < static_cast<int>(audioData.f0.size()) &&
+                audioData.f0[static_cast<size_t>(i)] > 0.0f)
+                   ? freqToMidi(audioData.f0[static_cast<size_t>(i)])
+                   : 0.0f);
+    if (applyNoteOffset)
+      baseMidi += note.getPitchOffset();
+    float deltaMidi = (i < static_cast<int>(audioData.deltaPitch.size()))
+                          ? audioData.deltaPitch[static_cast<size_t>(i)]
+                          : 0.0f;
+    // Final = base (with drag offset) + delta + global offset only
+    float finalMidi = baseMidi + deltaMidi + globalOffset;
+
+    if (finalMidi > 0.0f) {
+      float x = framesToSeconds(i) * pixelsPerSecond;
+      float y = midiToY(finalMidi) + pixelsPerSemitone * 0.5f;
+
+      if (!pathStarted) {
+        path.startNewSubPath(x, y);
+        pathStarted = true;
+      } else {
+        path.lineTo(x, y);
       }
     }
   }
 
-  // Draw base pitch curve as dashed line
+  if (pathStarted) {
+    g.setColour(APP_COLOR_PITCH_CURVE);
+    g.strokePath(path, juce::PathStrokeType(2.0f));
+  }
+}
+
+void PianoRollComponent::drawBasePitchCurve(juce::Graphics &g) {
+  const auto &audioData = project->getAudioData();
+
   // Use cached base pitch to avoid expensive recalculation on every repaint
-  if (showBasePitch) {
-    const bool useLiveBasePreview =
-        (isDragging || pitchEditor->isDraggingMultiNotes());
-    if (!useLiveBasePreview) {
-      updateBasePitchCacheIfNeeded();
-    }
-
-    const auto &basePitchCurve =
-        useLiveBasePreview ? audioData.basePitch : cachedBasePitch;
-    if (!basePitchCurve.empty()) {
-      // Calculate visible frame range
-      double visibleStartTime = scrollX / pixelsPerSecond;
-      double visibleEndTime = (scrollX + getWidth()) / pixelsPerSecond;
-      int visStartFrame =
-          std::max(0, static_cast<int>(visibleStartTime * audioData.sampleRate /
-                                       HOP_SIZE));
-      int visEndFrame = std::min(
-          static_cast<int>(basePitchCurve.size()),
-          static_cast<int>(visibleEndTime * audioData.sampleRate / HOP_SIZE) +
-              1);
-
-      // Draw base pitch curve with dashed line
-      g.setColour(
-          APP_COLOR_SECONDARY.withAlpha(0.6f));
-      juce::Path basePath;
-      bool basePathStarted = false;
-
-      for (int i = visStartFrame; i < visEndFrame; ++i) {
-        if (i >= 0 && i < static_cast<int>(basePitchCurve.size())) {
-          float baseMidi = basePitchCurve[static_cast<size_t>(i)];
-          if (baseMidi > 0.0f) {
-            float x = framesToSeconds(i) * pixelsPerSecond;
-            float y = midiToY(baseMidi) +
-                      pixelsPerSemitone * 0.5f; // Center in grid cell
-
-            if (!basePathStarted) {
-              basePath.startNewSubPath(x, y);
-              basePathStarted = true;
-            } else {
-              basePath.lineTo(x, y);
-            }
-          } else if (basePathStarted) {
-            // Break path at unvoiced regions - draw current segment before
-            // breaking
-            juce::Path dashedPath;
-            juce::PathStrokeType stroke(1.5f);
-            const float dashLengths[] = {4.0f, 4.0f}; // 4px dash, 4px gap
-            stroke.createDashedStroke(dashedPath, basePath, dashLengths, 2);
-            g.strokePath(dashedPath, juce::PathStrokeType(1.5f));
-            basePath.clear();
-            basePathStarted = false;
+  const bool useLiveBasePreview =
+      (isDragging || pitchEditor->isDraggingMultiNotes());
+  if (!useLiveBasePreview) {
+    updateBasePitchCacheIfNeeded();
+  }
+
+  const auto &basePitchCurve =
+      useLiveBasePreview ? audioData.basePitch : cachedBasePitch;
+  if (!basePitchCurve.empty()) {
+    // Calculate visible frame range
+    double visibleStartTime = scrollX / pixelsPerSecond;
+    double visibleEndTime = (scrollX + getWidth()) / pixelsPerSecond;
+    int visStartFrame =
+        std::max(0, static_cast<int>(visibleStartTime * audioData.sampleRate /
+                                     HOP_SIZE));
+    int visEndFrame = std::min(
+        static_cast<int>(basePitchCurve.size()),
+        static_cast<int>(visibleEndTime * audioData.sampleRate / HOP_SIZE) +
+            1);
+
+    // Draw base pitch curve with dashed line
+    g.setColour(
+        APP_COLOR_SECONDARY.withAlpha(0.6f));
+    juce::Path basePath;
+    bool basePathStarted = false;
+
+    for (int i = visStartFrame; i < visEndFrame; ++i) {
+      if (i >= 0 && i < static_cast<int>(basePitchCurve.size())) {
+        float baseMidi = basePitchCurve[static_cast<size_t>(i)];
+        if (baseMidi > 0.0f) {
+          float x = framesToSeconds(i) * pixelsPerSecond;
+          float y = midiToY(baseMidi) +
+                    pixelsPerSemitone * 0.5f; // Center in grid cell
+
+          if (!basePathStarted) {
+            basePath.startNewSubPath(x, y);
+            basePathStarted = true;
+          } else {
+            basePath.lineTo(x, y);
           }
+        } else if (basePathStarted) {
+          // Break path at unvoiced regions - draw current segment before
+          // breaking
+          juce::Path dashedPath;
+          juce::PathStrokeType stroke(1.5f);
+          const float dashLengths[] = {4.0f, 4.0f}; // 4px dash, 4px gap
+          stroke.createDashedStroke(dashedPath, basePath, dashLengths, 2);
+          g.strokePath(dashedPath, juce::PathStrokeType(1.5f));
+          basePath.clear();
+          basePathStarted = false;
         }
       }
+    }
 
-      if (basePathStarted) {
-        // Use dashed stroke for base pitch curve
-        juce::Path dashedPath;
-        juce::PathStrokeType stroke(1.5f);
-        const float dashLengths[] = {4.0f, 4.0f}; // 4px dash, 4px gap
-        stroke.createDashedStroke(dashedPath, basePath, dashLengths, 2);
-        g.strokePath(dashedPath, juce::PathStrokeType(1.5f));
-      }
+    if (basePathStarted) {
+      // Use dashed stroke for base pitch curve
+      juce::Path dashedPath;
+      juce::PathStrokeType stroke(1.5f);
+      const float dashLengths[] = {4.0f, 4.0f}; // 4px dash, 4px gap
+      stroke.createDashedStroke(dashedPath, basePath, dashLengths, 2);
+      g.strokePath(dashedPath, juce::PathStrokeType(1.5f));
     }
   }
 }
@@ -1470,9 +1670,9 @@ void PianoRollComponent::mouseUp(const juce::MouseEvent &e) {
         }
       }
 
-      // Rebuild base pitch curve and F0 with final note position
-      PitchCurveProcessor::rebuildBaseFromNotes(*project);
-      PitchCurveProcessor::composeF0InPlace(*project, /*applyUvMask=*/false);
+      // Rebuild base pitch curve and F0 around the edited note
+      PitchCurveProcessor::rebuildBaseFromNotesInRange(*project, startFrame,
+                                                       endFrame);
 
       // Invalidate base pitch cache so it gets regenerated on next paint
       invalidateBasePitchCache();
@@ -1505,9 +1705,8 @@ void PianoRollComponent::mouseUp(const juce::MouseEvent &e) {
             [this, capturedExpandedStart, capturedExpandedEnd,
              capturedF0Size](Note *n) {
               if (project) {
-                PitchCurveProcessor::rebuildBaseFromNotes(*project);
-                PitchCurveProcessor::composeF0InPlace(*project,
-                                                      /*applyUvMask=*/false);
+                PitchCurveProcessor::rebuildBaseFromNotesInRange(
+                    *project, capturedExpandedStart, capturedExpandedEnd);
                 // Invalidate base pitch cache
                 invalidateBasePitchCache();
                 // Set dirty range for synthesis (use expanded range)
@@ -1630,9 +1829,9 @@ void PianoRollComponent::mouseDoubleClick(const juce::MouseEvent &e) {
   Note *note = findNoteAt(adjustedX, adjustedY);
 
   if (note) {
-    auto rebuildAndNotify = [this]() {
-      PitchCurveProcessor::rebuildBaseFromNotes(*project);
-      PitchCurveProcessor::composeF0InPlace(*project, false);
+    auto rebuildAndNotify = [this](int startFrame, int endFrame) {
+      PitchCurveProcessor::rebuildBaseFromNotesInRange(*project, startFrame,
+                                                       endFrame);
       if (onPitchEdited)
         onPitchEdited();
       if (onPitchEditFinished)
@@ -1672,11 +1871,19 @@ void PianoRollComponent::mouseDoubleClick(const juce::MouseEvent &e) {
         }
 
         if (!notesToSnap.empty()) {
+          int snapStart = notesToSnap.front()->getStartFrame();
+          int snapEnd = notesToSnap.front()->getEndFrame();
+          for (auto *snapped : notesToSnap) {
+            snapStart = std::min(snapStart, snapped->getStartFrame());
+            snapEnd = std::max(snapEnd, snapped->getEndFrame());
+          }
+
           if (undoManager) {
             auto action = std::make_unique<MultiNoteSnapToSemitoneAction>(
                 notesToSnap, oldMidis, oldOffsets, newMidis,
-                [this, rebuildAndNotify](const std::vector<Note *> &) {
-                  rebuildAndNotify();
+                [rebuildAndNotify, snapStart,
+                 snapEnd](const std::vector<Note *> &) {
+                  rebuildAndNotify(snapStart, snapEnd);
                 });
             undoManager->addAction(std::move(action));
           }
@@ -1687,7 +1894,7 @@ void PianoRollComponent::mouseDoubleClick(const juce::MouseEvent &e) {
             notesToSnap[i]->markDirty();
           }
 
-          rebuildAndNotify();
+          rebuildAndNotify(snapStart, snapEnd);
         }
         return;
       }
@@ -1703,14 +1910,16 @@ void PianoRollComponent::mouseDoubleClick(const juce::MouseEvent &e) {
       if (undoManager) {
         auto action = std::make_unique<NoteSnapToSemitoneAction>(
             note, oldMidi, oldOffset, snappedMidi,
-            [this, rebuildAndNotify](Note *n) { rebuildAndNotify(); });
+            [rebuildAndNotify](Note *n) {
+              rebuildAndNotify(n->getStartFrame(), n->getEndFrame());
+            });
         undoManager->addAction(std::move(action));
       }
 
       note->setMidiNote(snappedMidi);
       note->setPitchOffset(0.0f);
       note->markDirty();
-      rebuildAndNotify();
+      rebuildAndNotify(note->getStartFrame(), note->getEndFrame());
     }
   }
 }
@@ -1914,6 +2123,7 @@ void PianoRollComponent::scrollBarMoved(juce::ScrollBar *scrollBar,
 
 void PianoRollComponent::setProject(Project *proj) {
   project = proj;
+  previewNotes.clear();
 
   // Update modular components
   renderer->setProject(proj);
@@ -1923,16 +2133,26 @@ void PianoRollComponent::setProject(Project *proj) {
 
   // Clear all caches when project changes to free memory
   invalidateBasePitchCache();
-  waveformCache = juce::Image(); // Clear waveform cache
-  cachedScrollX = -1.0;
-  cachedPixelsPerSecond = -1.0f;
-  cachedWidth = 0;
-  cachedHeight = 0;
+  tileCache.clear();
 
   updateScrollBars();
   repaint();
 }
 
+void PianoRollComponent::addPreviewNotes(
+    const std::vector<PreviewNote> &notes) {
+  previewNotes.insert(previewNotes.end(), notes.begin(), notes.end());
+  repaint();
+}
+
+void PianoRollComponent::clearPreviewNotes() {
+  if (previewNotes.empty())
+    return;
+  previewNotes.clear();
+  previewNotes.shrink_to_fit();
+  repaint();
+}
+
 void PianoRollComponent::setUndoManager(PitchUndoManager *manager) {
   undoManager = manager;
   pitchEditor->setUndoManager(manager);
@@ -2349,9 +2569,8 @@ void PianoRollComponent::startStretchDrag(const StretchBoundary &boundary) {
           static_cast<int>(audioData.melSpectrogram.size())) {
     int melEnd = std::min(stretchDrag.rangeEndFull,
                           static_cast<int>(audioData.melSpectrogram.size()));
-    stretchDrag.originalMelRangeFull.assign(
-        audioData.melSpectrogram.begin() + stretchDrag.rangeStartFull,
-        audioData.melSpectrogram.begin() + melEnd);
+    stretchDrag.originalMelRangeFull = MelMatrix(
+        audioData.melSpectrogram.view(stretchDrag.rangeStartFull, melEnd));
   }
 }
 
@@ -2419,9 +2638,8 @@ void PianoRollComponent::updateStretchDrag(int targetFrame) {
       audioData.melSpectrogram.size() >=
           static_cast<size_t>(stretchDrag.rangeStartFull +
                               stretchDrag.originalMelRangeFull.size())) {
-    for (size_t i = 0; i < stretchDrag.originalMelRangeFull.size(); ++i)
-      audioData.melSpectrogram[static_cast<size_t>(stretchDrag.rangeStartFull) +
-                               i] = stretchDrag.originalMelRangeFull[i];
+    audioData.melSpectrogram.copyFrames(stretchDrag.rangeStartFull,
+                                        stretchDrag.originalMelRangeFull);
   }
 
   // Update left note if exists
@@ -2476,6 +2694,8 @@ void PianoRollComponent::updateStretchDrag(int targetFrame) {
     stretchDrag.boundary.right->markDirty();
   }
 
+  project->notifyNoteLayoutChanged();
+
   // Update mel spectrogram using fast nearest neighbor during drag
   // (High-quality centered STFT is computed in finishStretchDrag)
   if (!audioData.melSpectrogram.empty() &&
@@ -2495,42 +2715,39 @@ void PianoRollComponent::updateStretchDrag(int targetFrame) {
     rangeStart = std::clamp(rangeStart, 0, melSize);
     rangeEnd = std::clamp(rangeEnd, 0, melSize);
 
-    std::vector<std::vector<float>> newMel;
+    MelMatrix newMel;
     if (rangeEnd > rangeStart) {
       // Use fast nearest neighbor resampling for drag preview
-      std::vector<std::vector<float>> newLeftMel;
+      MelMatrix newLeftMel;
       if (stretchDrag.boundary.left && newLeftLength > 0) {
         const int leftOffset = stretchDrag.originalLeftStart - stretchDrag.rangeStartFull;
         if (leftOffset >= 0 &&
             leftOffset + (stretchDrag.originalLeftEnd - stretchDrag.originalLeftStart) <=
                 static_cast<int>(stretchDrag.originalMelRangeFull.size())) {
-          std::vector<std::vector<float>> leftMel(
-              stretchDrag.originalMelRangeFull.begin() + leftOffset,
-              stretchDrag.originalMelRangeFull.begin() + leftOffset +
-                  (stretchDrag.originalLeftEnd - stretchDrag.originalLeftStart));
+          const MelView leftMel = stretchDrag.originalMelRangeFull.view(
+              leftOffset, leftOffset + (stretchDrag.originalLeftEnd -
+                                        stretchDrag.originalLeftStart));
           newLeftMel = CurveResampler::resampleNearest2D(leftMel, newLeftLength);
         }
       }
 
-      std::vector<std::vector<float>> newRightMel;
+      MelMatrix newRightMel;
       if (stretchDrag.boundary.right && newRightLength > 0) {
         const int rightOffset = stretchDrag.originalRightStart - stretchDrag.rangeStartFull;
         if (rightOffset >= 0 &&
             rightOffset + (stretchDrag.originalRightEnd - stretchDrag.originalRightStart) <=
                 static_cast<int>(stretchDrag.originalMelRangeFull.size())) {
-          std::vector<std::vector<float>> rightMel(
-              stretchDrag.originalMelRangeFull.begin() + rightOffset,
-              stretchDrag.originalMelRangeFull.begin() + rightOffset +
-                  (stretchDrag.originalRightEnd - stretchDrag.originalRightStart));
+          const MelView rightMel = stretchDrag.originalMelRangeFull.view(
+              rightOffset, rightOffset + (stretchDrag.originalRightEnd -
+                                          stretchDrag.originalRightStart));
           newRightMel = CurveResampler::resampleNearest2D(rightMel, newRightLength);
         }
       }
 
       // Combine mel spectrograms
       if (stretchDrag.boundary.left && stretchDrag.boundary.right) {
-        newMel.reserve(static_cast<size_t>(newLeftLength + newRightLength));
-        newMel.insert(newMel.end(), newLeftMel.begin(), newLeftMel.end());
-        newMel.insert(newMel.end(), newRightMel.begin(), newRightMel.end());
+        newMel = std::move(newLeftMel);
+        newMel.append(newRightMel);
       } else if (stretchDrag.boundary.left) {
         newMel = std::move(newLeftMel);
       } else {
@@ -2540,16 +2757,14 @@ void PianoRollComponent::updateStretchDrag(int targetFrame) {
 
     if (!newMel.empty() &&
         static_cast<int>(newMel.size()) == (rangeEnd - rangeStart)) {
-      for (int i = rangeStart; i < rangeEnd; ++i)
-        audioData.melSpectrogram[static_cast<size_t>(i)] =
-            newMel[static_cast<size_t>(i - rangeStart)];
+      audioData.melSpectrogram.copyFrames(rangeStart, newMel);
       previewRangeStart = rangeStart;
       previewRangeEnd = rangeEnd;
     }
   }
 
-  PitchCurveProcessor::rebuildBaseFromNotes(*project);
-  PitchCurveProcessor::composeF0InPlace(*project, /*applyUvMask=*/false);
+  PitchCurveProcessor::rebuildBaseFromNotesInRange(
+      *project, stretchDrag.rangeStartFull, stretchDrag.rangeEndFull);
   invalidateBasePitchCache();
 
   if (onPitchEdited)
@@ -2593,7 +2808,7 @@ void PianoRollComponent::finishStretchDrag() {
   std::vector<bool> newVoiced(
       audioData.voicedMask.begin() + rangeStart,
       audioData.voicedMask.begin() + rangeEnd);
-  std::vector<std::vector<float>> newMel;
+  MelMatrix newMel;
   if (!audioData.melSpectrogram.empty() &&
       rangeEnd <= static_cast<int>(audioData.melSpectrogram.size()) &&
       audioData.waveform.getNumSamples() > 0 && centeredMelComputer) {
@@ -2610,8 +2825,8 @@ void PianoRollComponent::finishStretchDrag() {
     const float* globalAudio = audioData.waveform.getReadPointer(0);
     const int numSamples = audioData.waveform.getNumSamples();
 
-    std::vector<std::vector<float>> newLeftMel;
-    std::vector<std::vector<float>> newRightMel;
+    MelMatrix newLeftMel;
+    MelMatrix newRightMel;
 
     if (leftLen > 0) {
       centeredMelComputer->computeTimeStretched(
@@ -2637,16 +2852,15 @@ void PianoRollComponent::finishStretchDrag() {
     if (newLeftMel.empty() && leftLen > 0) {
       const int leftOffset =
           stretchDrag.originalLeftStart - stretchDrag.rangeStartFull;
-      std::vector<std::vector<float>> leftMel;
+      MelView leftMel;
       if (leftOffset >= 0 &&
           leftOffset +
                   (stretchDrag.originalLeftEnd -
                    stretchDrag.originalLeftStart) <=
               static_cast<int>(stretchDrag.originalMelRangeFull.size())) {
-        leftMel.assign(
-            stretchDrag.originalMelRangeFull.begin() + leftOffset,
-            stretchDrag.originalMelRangeFull.begin() + leftOffset +
-                (stretchDrag.originalLeftEnd - stretchDrag.originalLeftStart));
+        leftMel = stretchDrag.originalMelRangeFull.view(
+            leftOffset, leftOffset + (stretchDrag.originalLeftEnd -
+                                      stretchDrag.originalLeftStart));
       }
       newLeftMel = CurveResampler::resampleNearest2D(leftMel, leftLen);
     }
@@ -2654,29 +2868,25 @@ void PianoRollComponent::finishStretchDrag() {
     if (newRightMel.empty() && rightLen > 0) {
       const int rightOffset =
           stretchDrag.originalRightStart - stretchDrag.rangeStartFull;
-      std::vector<std::vector<float>> rightMel;
+      MelView rightMel;
       if (rightOffset >= 0 &&
           rightOffset +
                   (stretchDrag.originalRightEnd -
                    stretchDrag.originalRightStart) <=
               static_cast<int>(stretchDrag.originalMelRangeFull.size())) {
-        rightMel.assign(
-            stretchDrag.originalMelRangeFull.begin() + rightOffset,
-            stretchDrag.originalMelRangeFull.begin() + rightOffset +
-                (stretchDrag.originalRightEnd - stretchDrag.originalRightStart));
+        rightMel = stretchDrag.originalMelRangeFull.view(
+            rightOffset, rightOffset + (stretchDrag.originalRightEnd -
+                                        stretchDrag.originalRightStart));
       }
       newRightMel = CurveResampler::resampleNearest2D(rightMel, rightLen);
     }
 
-    newMel.reserve(static_cast<size_t>(leftLen + rightLen));
-    newMel.insert(newMel.end(), newLeftMel.begin(), newLeftMel.end());
-    newMel.insert(newMel.end(), newRightMel.begin(), newRightMel.end());
+    newMel = std::move(newLeftMel);
+    newMel.append(newRightMel);
 
     if (!newMel.empty() &&
         static_cast<int>(newMel.size()) == (rangeEnd - rangeStart)) {
-      for (int i = rangeStart; i < rangeEnd; ++i)
-        audioData.melSpectrogram[static_cast<size_t>(i)] =
-            newMel[static_cast<size_t>(i - rangeStart)];
+      audioData.melSpectrogram.copyFrames(rangeStart, newMel);
     } else {
       newMel.clear();
     }
@@ -2696,7 +2906,7 @@ void PianoRollComponent::finishStretchDrag() {
     int capturedRangeEnd = rangeEnd;
     std::vector<float> oldDelta;
     std::vector<bool> oldVoiced;
-    std::vector<std::vector<float>> oldMel;
+    MelMatrix oldMel;
     if (!stretchDrag.originalDeltaRangeFull.empty() &&
         !stretchDrag.originalVoicedRangeFull.empty()) {
       int offset = rangeStart - stretchDrag.rangeStartFull;
@@ -2718,13 +2928,13 @@ void PianoRollComponent::finishStretchDrag() {
       if (offset >= 0 &&
           offset + count <=
               static_cast<int>(stretchDrag.originalMelRangeFull.size())) {
-        oldMel.assign(stretchDrag.originalMelRangeFull.begin() + offset,
-                      stretchDrag.originalMelRangeFull.begin() + offset + count);
+        oldMel = MelMatrix(
+            stretchDrag.originalMelRangeFull.view(offset, offset + count));
       }
     }
 
     auto action = std::make_unique<NoteTimingStretchAction>(
-        stretchDrag.boundary.left,
+        project, stretchDrag.boundary.left,
         stretchDrag.boundary.right,
         &audioData.deltaPitch, &audioData.voicedMask, &audioData.melSpectrogram,
         capturedRangeStart, capturedRangeEnd, stretchDrag.originalLeftStart,
@@ -2739,9 +2949,8 @@ void PianoRollComponent::finishStretchDrag() {
         [this](int startFrame, int endFrame) {
           if (!project)
             return;
-          PitchCurveProcessor::rebuildBaseFromNotes(*project);
-          PitchCurveProcessor::composeF0InPlace(*project,
-                                                /*applyUvMask=*/false);
+          PitchCurveProcessor::rebuildBaseFromNotesInRange(*project, startFrame,
+                                                           endFrame);
           invalidateBasePitchCache();
           const int f0Size =
               static_cast<int>(project->getAudioData().f0.size());
@@ -2798,6 +3007,9 @@ void PianoRollComponent::finishStretchDrag() {
         }
       }
     }
+
+    project->invalidateWaveformPeaks(rangeStartSample,
+                                     rangeEndSample - rangeStartSample);
   }
 
   const int f0Size = static_cast<int>(audioData.f0.size());
@@ -2844,9 +3056,8 @@ void PianoRollComponent::cancelStretchDrag() {
       rangeStart < rangeEnd &&
       audioData.melSpectrogram.size() >=
           static_cast<size_t>(rangeStart + stretchDrag.originalMelRangeFull.size())) {
-    for (size_t i = 0; i < stretchDrag.originalMelRangeFull.size(); ++i)
-      audioData.melSpectrogram[static_cast<size_t>(rangeStart) + i] =
-          stretchDrag.originalMelRangeFull[i];
+    audioData.melSpectrogram.copyFrames(rangeStart,
+                                        stretchDrag.originalMelRangeFull);
   }
 
   // Note: waveform is not modified during drag, so no need to restore it here
@@ -2866,9 +3077,10 @@ void PianoRollComponent::cancelStretchDrag() {
     if (!stretchDrag.originalRightClip.empty())
       stretchDrag.boundary.right->setClipWaveform(stretchDrag.originalRightClip);
   }
+  project->notifyNoteLayoutChanged();
 
-  PitchCurveProcessor::rebuildBaseFromNotes(*project);
-  PitchCurveProcessor::composeF0InPlace(*project, /*applyUvMask=*/false);
+  PitchCurveProcessor::rebuildBaseFromNotesInRange(
+      *project, stretchDrag.rangeStartFull, stretchDrag.rangeEndFull);
   invalidateBasePitchCache();
 
   if (onPitchEdited)
@@ -2881,18 +3093,20 @@ Note *PianoRollComponent::findNoteAt(float x, float y) {
   if (!project)
     return nullptr;
 
-  for (auto &note : project->getNotes()) {
+  // Candidates from the frames around x; the exact test is in pixels
+  const int frame = secondsToFrames(x / pixelsPerSecond);
+  for (auto *note : project->getNotesInRange(frame - 1, frame + 2)) {
     // Skip rest notes
-    if (note.isRest())
+    if (note->isRest())
       continue;
 
-    float noteX = framesToSeconds(note.getStartFrame()) * pixelsPerSecond;
-    float noteW = framesToSeconds(note.getDurationFrames()) * pixelsPerSecond;
-    float noteY = midiToY(note.getAdjustedMidiNote());
+    float noteX = framesToSeconds(note->getStartFrame()) * pixelsPerSecond;
+    float noteW = framesToSeconds(note->getDurationFrames()) * pixelsPerSecond;
+    float noteY = midiToY(note->getAdjustedMidiNote());
     float noteH = pixelsPerSemitone;
 
     if (x >= noteX && x < noteX + noteW && y >= noteY && y < noteY + noteH) {
-      return &note;
+      return note;
     }
   }
 
@@ -12,6 +12,7 @@
 #include "PianoRoll/CoordinateMapper.h"
 #include "PianoRoll/NoteSplitter.h"
 #include "PianoRoll/PianoRollRenderer.h"
+#include "PianoRoll/PianoRollTileCache.h"
 #include "PianoRoll/PitchEditor.h"
 #include "PianoRoll/ScrollZoomController.h"
 
@@ -70,6 +71,17 @@ public:
   void setProject(Project *proj);
   Project *getProject() const { return project; }
 
+  // Notes found so far by an analysis still in progress. They are drawn as
+  // outlines in place of the current project's notes until setProject() or
+  // clearPreviewNotes() is called.
+  struct PreviewNote {
+    int startFrame;
+    int endFrame;
+    float midiNote;
+  };
+  void addPreviewNotes(const std::vector<PreviewNote> &notes);
+  void clearPreviewNotes();
+
   // Undo Manager
   void setUndoManager(PitchUndoManager *manager);
   PitchUndoManager *getUndoManager() const { return undoManager; }
@@ -129,7 +141,18 @@ private:
   void drawTimeline(juce::Graphics &g);
   void drawLoopTimeline(juce::Graphics &g);
   void drawNotes(juce::Graphics &g);
+  void drawNote(juce::Graphics &g, const Note &note,
+                const WaveformPeaks &globalPeaks);
+  void drawSplitGuide(juce::Graphics &g);
+  void drawPreviewNotes(juce::Graphics &g);
   void drawPitchCurves(juce::Graphics &g);
+  void drawNotePitchCurve(juce::Graphics &g, const Note &note, int startFrame,
+                          int endFrame);
+  void drawBasePitchCurve(juce::Graphics &g);
+  // Notes and delta pitch curves from the tile cache
+  void drawContentTiles(juce::Graphics &g,
+                        const juce::Rectangle<int> &visibleArea);
+  bool isEditingInteractively() const;
   void drawCursor(juce::Graphics &g);
   void drawPianoKeys(juce::Graphics &g);
   void drawDrawingCursor(juce::Graphics &g); // Draw mode indicator
@@ -178,7 +201,7 @@ private:
     std::vector<bool> rightVoiced;
     std::vector<float> originalLeftClip;
     std::vector<float> originalRightClip;
-    std::vector<std::vector<float>> originalMelRangeFull;
+    MelMatrix originalMelRangeFull;
     std::vector<float> originalDeltaRangeFull;
     std::vector<bool> originalVoicedRangeFull;
   };
@@ -211,6 +234,7 @@ private:
   float pixelsPerSemitone = DEFAULT_PIXELS_PER_SEMITONE;
 
   double cursorTime = 0.0;
+  std::vector<PreviewNote> previewNotes;
   double scrollX = 0.0;
   double scrollY = 0.0;
 
@@ -286,12 +310,8 @@ private:
   juce::ScrollBar horizontalScrollBar{false};
   juce::ScrollBar verticalScrollBar{true};
 
-  // Waveform cache for performance
-  juce::Image waveformCache;
-  double cachedScrollX = -1.0;
-  float cachedPixelsPerSecond = -1.0f;
-  int cachedWidth = 0;
-  int cachedHeight = 0;
+  // Background waveform, notes and pitch curves rendered in tiles
+  PianoRollTileCache tileCache;
 
   // Base pitch curve cache for performance
   // Only recalculates when notes change, not on every repaint
@@ -45,7 +45,7 @@ void WaveformComponent::drawWaveform(juce::Graphics& g)
     float centerY = static_cast<float>(bounds.getCentreY());
     float amplitude = bounds.getHeight() * 0.4f;
     
-    const float* samples = audioData.waveform.getReadPointer(0);
+    const auto& peaks = project->getWaveformPeaks();
     int numSamples = audioData.waveform.getNumSamples();
     
     // Calculate visible range
@@ -74,13 +74,9 @@ void WaveformComponent::drawWaveform(juce::Graphics& g)
         if (sampleStart >= numSamples || sampleEnd < 0) continue;
         
         // Find min/max in this range
-        float minVal = 0.0f, maxVal = 0.0f;
-        for (int i = sampleStart; i <= sampleEnd; ++i)
-        {
-            float s = samples[i];
-            if (s < minVal) minVal = s;
-            if (s > maxVal) maxVal = s;
-        }
+        const auto peak = peaks.query(sampleStart, sampleEnd + 1);
+        float minVal = juce::jmin(0.0f, peak.min);
+        float maxVal = juce::jmax(0.0f, peak.max);
         
         float yMin = centerY - maxVal * amplitude;
         float yMax = centerY - minVal * amplitude;
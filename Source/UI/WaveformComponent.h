@@ -36,7 +36,6 @@ private:
     void drawWaveform(juce::Graphics& g);
     void drawCursor(juce::Graphics& g);
     void updateScrollBar();
-    void rebuildWaveformCache();
     
     float timeToX(double time) const;
     double xToTime(float x) const;
@@ -47,10 +46,6 @@ private:
     float pixelsPerSecond = 100.0f;
     double cursorTime = 0.0;
     
-    // Waveform cache
-    juce::AudioBuffer<float> waveformCache;
-    int cacheResolution = 512;  // Samples per pixel at base zoom
-    
     juce::ScrollBar horizontalScrollBar { false };
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformComponent)
@@ -1,6 +1,7 @@
 #include "BasePitchCurve.h"
 #include <algorithm>
 #include <cmath>
+#include <limits>
 
 // Local constants (to avoid JUCE dependency from Constants.h)
 namespace {
@@ -13,11 +14,21 @@ inline float midiToFreq(float midi) {
   return FREQ_A4 * std::pow(2.0f, (midi - MIDI_A4) / 12.0f);
 }
 
+constexpr double MS_PER_FRAME = 1000.0 * HOP_SIZE / SAMPLE_RATE;
+
 inline float freqToMidi(float freq) {
   if (freq <= 0.0f)
     return 0.0f;
   return 12.0f * std::log2(freq / FREQ_A4) + MIDI_A4;
 }
+
+// Time (s) where the step function switches from a note ending at endFrame
+// to the next one starting at nextStartFrame
+inline double switchMidpoint(int endFrame, int nextStartFrame) {
+  const double endSec = endFrame * MS_PER_FRAME / 1000.0;
+  const double nextStartSec = nextStartFrame * MS_PER_FRAME / 1000.0;
+  return 0.5 * (endSec + nextStartSec);
+}
 } // namespace
 
 std::vector<double> BasePitchCurve::createCosineKernel() {
@@ -55,93 +66,191 @@ BasePitchCurve::generateForNotes(const std::vector<NoteSegment> &notes,
   if (notes.empty() || totalFrames <= 0)
     return {};
 
+  // Stable, so notes with equal spans keep their order and a ranged
+  // rebuild over the same input picks the same one
   auto sortedNotes = notes;
-  std::sort(sortedNotes.begin(), sortedNotes.end(),
-            [](const NoteSegment &a, const NoteSegment &b) {
-              if (a.startFrame != b.startFrame)
-                return a.startFrame < b.startFrame;
-              return a.endFrame < b.endFrame;
-            });
-
-  // Convert frames to milliseconds (at ~86 fps, each frame is ~11.6ms)
-  // We'll work at 1ms resolution for smoothing, then resample
-  double msPerFrame = 1000.0 * HOP_SIZE / SAMPLE_RATE; // ~11.6ms
-
-  // Calculate total duration in seconds, add padding for convolution kernel
+  std::stable_sort(sortedNotes.begin(), sortedNotes.end(),
+                   [](const NoteSegment &a, const NoteSegment &b) {
+                     if (a.startFrame != b.startFrame)
+                       return a.startFrame < b.startFrame;
+                     return a.endFrame < b.endFrame;
+                   });
+
   int lastEndFrame = 0;
   for (const auto &n : sortedNotes)
     lastEndFrame = std::max(lastEndFrame, n.endFrame);
-  double lastNoteEndSec = lastEndFrame * msPerFrame / 1000.0;
-  int totalMs =
+
+  std::vector<float> result(totalFrames);
+  std::vector<double> scratch;
+  generateRangeImpl(sortedNotes, -std::numeric_limits<double>::infinity(),
+                    lastEndFrame, 0, totalFrames, result.data(), scratch);
+  return result;
+}
+
+BasePitchCurve::SortedSpans
+BasePitchCurve::buildSortedSpans(const std::vector<NoteSegment> &sortedNotes) {
+  SortedSpans spans;
+  spans.startFrames.reserve(sortedNotes.size());
+  for (const auto &n : sortedNotes) {
+    spans.startFrames.push_back(n.startFrame);
+    spans.lastEndFrame = std::max(spans.lastEndFrame, n.endFrame);
+  }
+
+  if (sortedNotes.size() > 1) {
+    spans.switchSeconds.reserve(sortedNotes.size() - 1);
+    double boundary = -std::numeric_limits<double>::infinity();
+    for (size_t k = 0; k + 1 < sortedNotes.size(); ++k) {
+      boundary = std::max(boundary,
+                          switchMidpoint(sortedNotes[k].endFrame,
+                                         sortedNotes[k + 1].startFrame));
+      spans.switchSeconds.push_back(boundary);
+    }
+  }
+  return spans;
+}
+
+BasePitchCurve::Window BasePitchCurve::findWindow(const SortedSpans &spans,
+                                                  int startFrame,
+                                                  int endFrame) {
+  Window window;
+  window.lastEndFrame = spans.lastEndFrame;
+  window.switchBefore = -std::numeric_limits<double>::infinity();
+  const int numNotes = static_cast<int>(spans.startFrames.size());
+  if (numNotes == 0 || endFrame <= startFrame)
+    return window;
+
+  // Millisecond i takes note #{switches < 0.001 * (i - 1)}; switchSeconds
+  // is non-decreasing, so that count is a binary search
+  const auto noteAt = [&](int ms) {
+    const double time = 0.001 * (ms - 1);
+    return static_cast<int>(
+        std::partition_point(spans.switchSeconds.begin(),
+                             spans.switchSeconds.end(),
+                             [time](double s) { return s < time; }) -
+        spans.switchSeconds.begin());
+  };
+
+  const auto range = msRangeFor(startFrame, endFrame, spans.lastEndFrame);
+  window.first = noteAt(range.lo);
+  // One note past the last one read, for the switch point after it
+  window.last = std::min(numNotes, noteAt(range.hi) + 2);
+  if (window.first > 0)
+    window.switchBefore =
+        spans.switchSeconds[static_cast<size_t>(window.first - 1)];
+  return window;
+}
+
+void BasePitchCurve::generateRange(const std::vector<NoteSegment> &windowNotes,
+                                   const Window &window, int startFrame,
+                                   int endFrame, float *out) {
+  thread_local std::vector<double> scratch;
+  generateRangeImpl(windowNotes, window.switchBefore, window.lastEndFrame,
+                    startFrame, endFrame, out, scratch);
+}
+
+int BasePitchCurve::kernelRadiusFrames() {
+  // +1 for the linear interpolation between neighbouring milliseconds
+  return static_cast<int>(std::ceil((KERNEL_SIZE / 2 + 1) / MS_PER_FRAME));
+}
+
+BasePitchCurve::MsRange BasePitchCurve::msRangeFor(int startFrame,
+                                                   int endFrame,
+                                                   int lastEndFrame) {
+  // Total duration in ms, padded for the convolution kernel
+  const double lastNoteEndSec = lastEndFrame * MS_PER_FRAME / 1000.0;
+  MsRange range;
+  range.totalMs =
       static_cast<int>(std::round(1000.0 * (lastNoteEndSec + SMOOTH_WINDOW))) +
       1;
 
-  // Create initial step function values at 1ms resolution
-  // This matches ds-editor-lite's BasePitchCurve::Convolve algorithm
-  std::vector<double> initValues(totalMs, 0.0);
+  // Milliseconds whose smoothed value the requested frames read
+  const int halfKernel = KERNEL_SIZE / 2;
+  const int firstMs =
+      std::min(static_cast<int>(startFrame * MS_PER_FRAME), range.totalMs - 1);
+  const int lastMs = std::min(
+      static_cast<int>((endFrame - 1) * MS_PER_FRAME) + 1, range.totalMs - 1);
+  range.lo = std::max(0, firstMs - halfKernel);
+  range.hi = std::min(range.totalMs - 1, lastMs + halfKernel);
+  return range;
+}
 
-  // Convert note segments from frames to seconds for step function
-  struct NoteInSeconds {
-    double start;
-    double end;
-    float midiNote;
-  };
-  std::vector<NoteInSeconds> noteArray;
-  for (const auto &note : sortedNotes) {
-    double startSec = note.startFrame * msPerFrame / 1000.0;
-    double endSec = note.endFrame * msPerFrame / 1000.0;
-    noteArray.push_back({startSec, endSec, note.midiNote});
+void BasePitchCurve::generateRangeImpl(
+    const std::vector<NoteSegment> &sortedNotes, double switchBefore,
+    int lastEndFrame, int startFrame, int endFrame, float *out,
+    std::vector<double> &scratch) {
+  if (endFrame <= startFrame)
+    return;
+  if (sortedNotes.empty()) {
+    std::fill(out, out + (endFrame - startFrame), 0.0f);
+    return;
   }
 
-  if (noteArray.empty())
-    return {};
+  // Work at 1ms resolution for smoothing, then resample to frames
+  // (at ~86 fps each frame is ~11.6ms)
+  const auto range = msRangeFor(startFrame, endFrame, lastEndFrame);
+  const int totalMs = range.totalMs;
+  const int lo = range.lo;
+  const int hi = range.hi;
+  const int halfKernel = KERNEL_SIZE / 2;
+
+  // Step function (matching ds-editor-lite's BasePitchCurve::Convolve): each
+  // millisecond takes the semitone of its note, switching at the midpoint
+  // between one note's end and the next note's start. Midpoints are taken
+  // as a running maximum so overlapping notes still advance monotonically;
+  // switchBefore carries that maximum in from notes before sortedNotes.
+  const int numNotes = static_cast<int>(sortedNotes.size());
+  auto midpointAfter = [&](int k) {
+    return switchMidpoint(sortedNotes[k].endFrame,
+                          sortedNotes[k + 1].startFrame);
+  };
 
-  // Create step function: each millisecond gets the semitone value of its note
-  // At note boundaries, switch at the midpoint (matching ds-editor-lite)
+  // The note index advances after the first millisecond past its midpoint,
+  // so millisecond i takes note k = #{midpoints < 0.001 * (i - 1)}
   int noteIndex = 0;
-  for (int i = 0; i < totalMs; ++i) {
-    const double time = 0.001 * i; // Time in seconds
-
-    // Assign current note's semitone value
-    initValues[i] = noteArray[noteIndex].midiNote;
-
-    // Check if we should advance to next note at midpoint
-    // Switch at: 0.5 * (current_note_end + next_note_start)
-    if (noteIndex < static_cast<int>(noteArray.size()) - 1 &&
-        time >
-            0.5 * (noteArray[noteIndex].end + noteArray[noteIndex + 1].start)) {
-      noteIndex++;
+  double boundary =
+      numNotes > 1 ? std::max(switchBefore, midpointAfter(0)) : switchBefore;
+  auto advanceTo = [&](int ms) {
+    const double time = 0.001 * (ms - 1);
+    while (noteIndex < numNotes - 1 && time > boundary) {
+      ++noteIndex;
+      if (noteIndex < numNotes - 1)
+        boundary = std::max(boundary, midpointAfter(noteIndex));
     }
-  }
+  };
 
-  // Apply cosine kernel convolution
-  auto kernel = createCosineKernel();
-  std::vector<double> smoothedMs(totalMs, 0.0);
+  scratch.resize(static_cast<size_t>(hi - lo + 1));
+  for (int i = lo; i <= hi; ++i) {
+    advanceTo(i);
+    scratch[static_cast<size_t>(i - lo)] = sortedNotes[noteIndex].midiNote;
+  }
 
-  for (int i = 0; i < totalMs; ++i) {
+  // Cosine kernel convolution, clamped at the curve edges
+  const auto &kernel = getCosineKernel();
+  auto smoothedAt = [&](int ms) {
+    double sum = 0.0;
     for (int j = 0; j < KERNEL_SIZE; ++j) {
-      int srcIdx = std::max(0, std::min(i - KERNEL_SIZE / 2 + j, totalMs - 1));
-      smoothedMs[i] += initValues[srcIdx] * kernel[j];
+      const int srcIdx =
+          std::max(0, std::min(ms - halfKernel + j, totalMs - 1));
+      sum += scratch[static_cast<size_t>(srcIdx - lo)] * kernel[j];
     }
-  }
+    return sum;
+  };
 
-  // Resample back to frame resolution
-  std::vector<float> result(totalFrames);
-  for (int frame = 0; frame < totalFrames; ++frame) {
-    double ms = frame * msPerFrame;
-    int msIdx = static_cast<int>(ms);
-    double frac = ms - msIdx;
+  for (int frame = startFrame; frame < endFrame; ++frame) {
+    const double ms = frame * MS_PER_FRAME;
+    const int msIdx = static_cast<int>(ms);
+    const double frac = ms - msIdx;
 
+    float value;
     if (msIdx + 1 < totalMs)
-      result[frame] = static_cast<float>(smoothedMs[msIdx] * (1.0 - frac) +
-                                         smoothedMs[msIdx + 1] * frac);
+      value = static_cast<float>(smoothedAt(msIdx) * (1.0 - frac) +
+                                 smoothedAt(msIdx + 1) * frac);
     else if (msIdx < totalMs)
-      result[frame] = static_cast<float>(smoothedMs[msIdx]);
+      value = static_cast<float>(smoothedAt(msIdx));
     else
-      result[frame] = static_cast<float>(smoothedMs.back());
+      value = static_cast<float>(smoothedAt(totalMs - 1));
+    out[frame - startFrame] = value;
   }
-
-  return result;
 }
 
 std::vector<float>
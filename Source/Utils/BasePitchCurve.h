@@ -40,6 +40,41 @@ public:
     // Generate smoothed base pitch for multiple notes
     static std::vector<float> generateForNotes(const std::vector<NoteSegment>& notes, int totalFrames);
 
+    // Step-function layout of notes sorted as generateForNotes sorts them:
+    // start frames, the running maximum of the midpoints where the step
+    // switches to the next note, and the last end frame. Build it once per
+    // note layout; ranged rebuilds then find their notes by binary search.
+    struct SortedSpans {
+        std::vector<int> startFrames;
+        std::vector<double> switchSeconds;  // [i]: max midpoint after notes 0..i
+        int lastEndFrame = 0;
+    };
+
+    // Sorted notes [first, last) that a frame range reads, with the step
+    // state carried in from the notes before first
+    struct Window {
+        int first = 0;
+        int last = 0;
+        double switchBefore = 0.0;
+        int lastEndFrame = 0;
+    };
+
+    static SortedSpans buildSortedSpans(const std::vector<NoteSegment>& sortedNotes);
+    static Window findWindow(const SortedSpans& spans, int startFrame, int endFrame);
+
+    // Write base pitch for frames [startFrame, endFrame) into out, matching
+    // generateForNotes for those frames. windowNotes are the sorted notes
+    // [window.first, window.last) from findWindow, so the cost scales with
+    // the range and the notes it reaches, not the project; does not
+    // allocate once the per-thread scratch buffer has grown to the range.
+    static void generateRange(const std::vector<NoteSegment>& windowNotes,
+                              const Window& window,
+                              int startFrame, int endFrame, float* out);
+
+    // Frames on each side of a frame whose step value changed that the
+    // smoothing kernel can reach
+    static int kernelRadiusFrames();
+
     // Calculate delta pitch (actual F0 in MIDI - base pitch)
     static std::vector<float> calculateDeltaPitch(const std::vector<float>& f0Values,
                                                    const std::vector<float>& basePitch,
@@ -56,4 +91,15 @@ private:
                 static constexpr double SMOOTH_WINDOW = 0.08;  // 80ms total window for faster transitions
 
     static std::vector<double> createCosineKernel();
+    struct MsRange {
+        int totalMs;
+        int lo;
+        int hi;
+    };
+
+    static MsRange msRangeFor(int startFrame, int endFrame, int lastEndFrame);
+    static void generateRangeImpl(const std::vector<NoteSegment>& sortedNotes,
+                                  double switchBefore, int lastEndFrame,
+                                  int startFrame, int endFrame, float* out,
+                                  std::vector<double>& scratch);
 };
@@ -8,10 +8,10 @@ CenteredMelSpectrogram::CenteredMelSpectrogram(int sampleRate, int nFft, int win
                                                int numMels, float fMin, float fMax)
     : sampleRate(sampleRate), nFft(nFft), winSize(winSize),
       numMels(numMels), fMin(fMin), fMax(fMax),
+      melFilterbank(sampleRate, nFft, numMels, fMin, fMax),
       fft(static_cast<int>(std::log2(nFft)))
 {
     createWindow();
-    createMelFilterbank();
 }
 
 void CenteredMelSpectrogram::createWindow()
@@ -24,161 +24,77 @@ void CenteredMelSpectrogram::createWindow()
     }
 }
 
-void CenteredMelSpectrogram::createMelFilterbank()
+void CenteredMelSpectrogram::computeFrameAtCenter(
+    const float* audio, int numSamples, double center, float* fftBuffer, float* magnitude)
 {
-    // Slaney-style mel scale (matches librosa default with htk=False)
-    const float f_min_mel = 0.0f;
-    const float f_sp = 200.0f / 3.0f;  // ~66.67 Hz per mel below 1000 Hz
-    const float min_log_hz = 1000.0f;
-    const float min_log_mel = (min_log_hz - f_min_mel) / f_sp;  // = 15.0
-    const float logstep = std::log(6.4f) / 27.0f;  // ~0.0687
-
-    auto hzToMel = [=](float hz) -> float {
-        if (hz < min_log_hz)
-            return (hz - f_min_mel) / f_sp;
-        else
-            return min_log_mel + std::log(hz / min_log_hz) / logstep;
-    };
-
-    auto melToHz = [=](float mel) -> float {
-        if (mel < min_log_mel)
-            return f_min_mel + f_sp * mel;
-        else
-            return min_log_hz * std::exp(logstep * (mel - min_log_mel));
-    };
-
-    float melMin = hzToMel(fMin);
-    float melMax = hzToMel(fMax);
+    // Compute single STFT frame centered at given position
+    // Uses reflect padding for boundary handling (matches librosa/torch)
 
-    std::vector<float> melPoints(numMels + 2);
-    for (int i = 0; i <= numMels + 1; ++i)
-    {
-        melPoints[i] = melMin + (melMax - melMin) * i / (numMels + 1);
-    }
+    const int halfWin = winSize / 2;
+    const int startIdx = static_cast<int>(std::round(center)) - halfWin;
+    std::fill(fftBuffer, fftBuffer + nFft * 2, 0.0f);
 
-    std::vector<float> hzPoints(numMels + 2);
-    for (int i = 0; i <= numMels + 1; ++i)
+    if (startIdx >= 0 && startIdx + winSize <= numSamples)
     {
-        hzPoints[i] = melToHz(melPoints[i]);
+        // Interior frame: no padding needed
+        juce::FloatVectorOperations::multiply(fftBuffer, audio + startIdx, window.data(),
+                                              winSize);
     }
-
-    int numBins = nFft / 2 + 1;
-
-    melFilterbank.resize(numMels);
-    for (int m = 0; m < numMels; ++m)
+    else
     {
-        melFilterbank[m].resize(numBins, 0.0f);
-
-        float fLow = hzPoints[m];
-        float fCenter = hzPoints[m + 1];
-        float fHigh = hzPoints[m + 2];
-
-        // Slaney normalization
-        float enorm = 2.0f / (fHigh - fLow);
-
-        for (int k = 0; k < numBins; ++k)
+        for (int j = 0; j < winSize; ++j)
         {
-            float freq = static_cast<float>(k) * sampleRate / nFft;
+            // Calculate source index relative to center
+            int srcIdx = startIdx + j;
 
-            if (freq >= fLow && freq < fCenter)
+            float sample = 0.0f;
+            if (srcIdx < 0)
             {
-                melFilterbank[m][k] = enorm * (freq - fLow) / (fCenter - fLow);
+                // Left boundary: reflect
+                int reflectIdx = std::min(-srcIdx - 1, numSamples - 1);
+                reflectIdx = std::max(0, reflectIdx);
+                sample = audio[reflectIdx];
             }
-            else if (freq >= fCenter && freq <= fHigh)
+            else if (srcIdx >= numSamples)
             {
-                melFilterbank[m][k] = enorm * (fHigh - freq) / (fHigh - fCenter);
+                // Right boundary: reflect
+                int reflectIdx = numSamples - 1 - (srcIdx - numSamples);
+                reflectIdx = std::max(0, reflectIdx);
+                sample = audio[reflectIdx];
+            }
+            else
+            {
+                sample = audio[srcIdx];
             }
-        }
-    }
-}
-
-std::vector<float> CenteredMelSpectrogram::computeFrameAtCenter(
-    const float* audio, int numSamples, double center)
-{
-    // Compute single STFT frame centered at given position
-    // Uses reflect padding for boundary handling (matches librosa/torch)
-
-    const int halfWin = winSize / 2;
-    std::vector<float> frame(nFft * 2, 0.0f);  // Complex FFT buffer
-
-    for (int j = 0; j < winSize; ++j)
-    {
-        // Calculate source index relative to center
-        int srcIdx = static_cast<int>(std::round(center)) - halfWin + j;
 
-        float sample = 0.0f;
-        if (srcIdx < 0)
-        {
-            // Left boundary: reflect
-            int reflectIdx = std::min(-srcIdx - 1, numSamples - 1);
-            reflectIdx = std::max(0, reflectIdx);
-            sample = audio[reflectIdx];
+            fftBuffer[j] = sample * window[j];
         }
-        else if (srcIdx >= numSamples)
-        {
-            // Right boundary: reflect
-            int reflectIdx = numSamples - 1 - (srcIdx - numSamples);
-            reflectIdx = std::max(0, reflectIdx);
-            sample = audio[reflectIdx];
-        }
-        else
-        {
-            sample = audio[srcIdx];
-        }
-
-        frame[j] = sample * window[j];
     }
 
     // Perform FFT
-    fft.performRealOnlyForwardTransform(frame.data());
+    fft.performRealOnlyForwardTransform(fftBuffer);
 
     // Compute magnitude spectrum
-    int numBins = nFft / 2 + 1;
-    std::vector<float> magnitude(numBins);
-    for (int k = 0; k < numBins; ++k)
-    {
-        float real = frame[k * 2];
-        float imag = frame[k * 2 + 1];
-        magnitude[k] = std::sqrt(real * real + imag * imag + 1e-9f);
-    }
-
-    return magnitude;
+    MelFilterbank::computeMagnitude(fftBuffer, magnitude, nFft / 2 + 1);
 }
 
-std::vector<float> CenteredMelSpectrogram::applyMelFilterbank(const std::vector<float>& magnitude)
-{
-    std::vector<float> mel(numMels);
-    int numBins = nFft / 2 + 1;
-
-    for (int m = 0; m < numMels; ++m)
-    {
-        float sum = 0.0f;
-        for (int k = 0; k < numBins; ++k)
-        {
-            sum += magnitude[k] * melFilterbank[m][k];
-        }
-        // Log scale (natural log for vocoder compatibility)
-        // Use clamp value matching Python: 1e-9
-        mel[m] = std::log(std::max(sum, 1e-9f));
-    }
-
-    return mel;
-}
-
-std::vector<std::vector<float>> CenteredMelSpectrogram::computeAtCenters(
+MelMatrix CenteredMelSpectrogram::computeAtCenters(
     const float* audio, int numSamples, const std::vector<double>& centers)
 {
     if (numSamples == 0 || centers.empty())
         return {};
 
-    std::vector<std::vector<float>> result;
-    result.reserve(centers.size());
+    MelMatrix result(static_cast<int>(centers.size()), numMels);
+    std::vector<float> fftBuffer(static_cast<size_t>(nFft) * 2);
+    std::vector<float> magnitude(static_cast<size_t>(nFft / 2 + 1));
 
-    for (double center : centers)
+    for (size_t i = 0; i < centers.size(); ++i)
     {
-        auto magnitude = computeFrameAtCenter(audio, numSamples, center);
-        auto mel = applyMelFilterbank(magnitude);
-        result.push_back(std::move(mel));
+        computeFrameAtCenter(audio, numSamples, centers[i], fftBuffer.data(),
+                             magnitude.data());
+        // Log scale (natural log for vocoder compatibility)
+        // Use clamp value matching Python: 1e-9
+        melFilterbank.applyLog(magnitude.data(), result[i], 1e-9f);
     }
 
     return result;
@@ -187,7 +103,7 @@ std::vector<std::vector<float>> CenteredMelSpectrogram::computeAtCenters(
 void CenteredMelSpectrogram::computeTimeStretched(
     const float* globalAudio, int numSamples,
     int startFrame, int endFrame, int newLength,
-    std::vector<std::vector<float>>& stretchedMel)
+    MelMatrix& stretchedMel)
 {
     // This function computes time-stretched mel spectrogram using centered STFT
     // Key insight from Python implementation:
@@ -237,7 +153,7 @@ void CenteredMelSpectrogram::computeTimeStretched(
     stretchedMel = computeAtCenters(globalAudio, numSamples, newCenters);
 }
 
-std::vector<std::vector<float>> CenteredMelSpectrogram::computeWithSpeedCurve(
+MelMatrix CenteredMelSpectrogram::computeWithSpeedCurve(
     const float* audio, int numSamples,
     int startSample, int endSample,
     const std::vector<float>& speeds, int hopSize)
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../JuceHeader.h"
+#include "MelFilterbank.h"
+#include "MelMatrix.h"
 #include <vector>
 
 /**
@@ -37,8 +39,8 @@ public:
      * @param centers Center positions (in samples) for each frame
      * @return Mel spectrogram [T, numMels] in log scale
      */
-    std::vector<std::vector<float>> computeAtCenters(const float* audio, int numSamples,
-                                                      const std::vector<double>& centers);
+    MelMatrix computeAtCenters(const float* audio, int numSamples,
+                               const std::vector<double>& centers);
 
     /**
      * Compute time-stretched mel spectrogram for a note region.
@@ -53,7 +55,7 @@ public:
      */
     void computeTimeStretched(const float* globalAudio, int numSamples,
                               int startFrame, int endFrame, int newLength,
-                              std::vector<std::vector<float>>& stretchedMel);
+                              MelMatrix& stretchedMel);
 
     /**
      * Compute time-stretched mel spectrogram with non-uniform speed.
@@ -65,7 +67,7 @@ public:
      * @param hopSize Hop size for output frames
      * @return Mel spectrogram [T_new, numMels] in log scale
      */
-    std::vector<std::vector<float>> computeWithSpeedCurve(
+    MelMatrix computeWithSpeedCurve(
         const float* audio, int numSamples,
         int startSample, int endSample,
         const std::vector<float>& speeds, int hopSize);
@@ -75,19 +77,16 @@ public:
     int getWinSize() const { return winSize; }
 
 private:
-    void createMelFilterbank();
     void createWindow();
 
     /**
-     * Compute single STFT frame centered at given position.
-     * Uses reflect padding for boundary handling.
+     * Compute the magnitude spectrum of a single STFT frame centered at the
+     * given position. Uses reflect padding for boundary handling.
+     * fftBuffer is scratch of nFft * 2 floats; magnitude receives
+     * nFft / 2 + 1 values.
      */
-    std::vector<float> computeFrameAtCenter(const float* audio, int numSamples, double center);
-
-    /**
-     * Apply mel filterbank and log compression to magnitude spectrum.
-     */
-    std::vector<float> applyMelFilterbank(const std::vector<float>& magnitude);
+    void computeFrameAtCenter(const float* audio, int numSamples, double center,
+                              float* fftBuffer, float* magnitude);
 
     int sampleRate;
     int nFft;
@@ -97,7 +96,7 @@ private:
     float fMax;
 
     std::vector<float> window;  // Hann window
-    std::vector<std::vector<float>> melFilterbank;
+    MelFilterbank melFilterbank;
 
     juce::dsp::FFT fft;
 };
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+/**
+ * Streaming 64-bit content hash (XXH64 algorithm).
+ *
+ * Used to key cached analysis data by the audio it was computed from.
+ * Not cryptographic; fast enough to hash a long session's PCM on load.
+ */
+class ContentHash
+{
+public:
+    explicit ContentHash(std::uint64_t seed = 0)
+    {
+        lanes[0] = seed + prime1 + prime2;
+        lanes[1] = seed + prime2;
+        lanes[2] = seed;
+        lanes[3] = seed - prime1;
+        this->seed = seed;
+    }
+
+    void update(const void* data, size_t numBytes)
+    {
+        auto* p = static_cast<const unsigned char*>(data);
+        totalBytes += numBytes;
+
+        if (pendingBytes > 0)
+        {
+            const size_t take = std::min(numBytes, sizeof(pending) - pendingBytes);
+            std::memcpy(pending + pendingBytes, p, take);
+            pendingBytes += take;
+            p += take;
+            numBytes -= take;
+            if (pendingBytes < sizeof(pending))
+                return;
+            consumeBlock(pending);
+            pendingBytes = 0;
+        }
+
+        while (numBytes >= sizeof(pending))
+        {
+            consumeBlock(p);
+            p += sizeof(pending);
+            numBytes -= sizeof(pending);
+        }
+
+        if (numBytes > 0)
+        {
+            std::memcpy(pending, p, numBytes);
+            pendingBytes = numBytes;
+        }
+    }
+
+    template <typename T>
+    void updateValue(const T& value)
+    {
+        update(&value, sizeof(T));
+    }
+
+    void updateString(const std::string& text)
+    {
+        updateValue(static_cast<std::uint64_t>(text.size()));
+        update(text.data(), text.size());
+    }
+
+    std::uint64_t finish() const
+    {
+        std::uint64_t h;
+        if (totalBytes >= sizeof(pending))
+        {
+            h = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+            for (auto lane : lanes)
+                h = (h ^ round(0, lane)) * prime1 + prime4;
+        }
+        else
+        {
+            h = seed + prime5;
+        }
+
+        h += totalBytes;
+
+        const unsigned char* p = pending;
+        size_t remaining = pendingBytes;
+        while (remaining >= 8)
+        {
+            h ^= round(0, read64(p));
+            h = rotl(h, 27) * prime1 + prime4;
+            p += 8;
+            remaining -= 8;
+        }
+        if (remaining >= 4)
+        {
+            h ^= static_cast<std::uint64_t>(read32(p)) * prime1;
+            h = rotl(h, 23) * prime2 + prime3;
+            p += 4;
+            remaining -= 4;
+        }
+        while (remaining > 0)
+        {
+            h ^= (*p) * prime5;
+            h = rotl(h, 11) * prime1;
+            ++p;
+            --remaining;
+        }
+
+        h ^= h >> 33;
+        h *= prime2;
+        h ^= h >> 29;
+        h *= prime3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    static std::uint64_t of(const void* data, size_t numBytes, std::uint64_t seed = 0)
+    {
+        ContentHash hash(seed);
+        hash.update(data, numBytes);
+        return hash.finish();
+    }
+
+private:
+    static constexpr std::uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+    static constexpr std::uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr std::uint64_t prime3 = 0x165667B19E3779F9ULL;
+    static constexpr std::uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr std::uint64_t prime5 = 0x27D4EB2F165667C5ULL;
+
+    static std::uint64_t rotl(std::uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    static std::uint64_t round(std::uint64_t acc, std::uint64_t input)
+    {
+        acc += input * prime2;
+        acc = rotl(acc, 31);
+        return acc * prime1;
+    }
+
+    static std::uint64_t read64(const unsigned char* p)
+    {
+        std::uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static std::uint32_t read32(const unsigned char* p)
+    {
+        std::uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    void consumeBlock(const unsigned char* p)
+    {
+        lanes[0] = round(lanes[0], read64(p));
+        lanes[1] = round(lanes[1], read64(p + 8));
+        lanes[2] = round(lanes[2], read64(p + 16));
+        lanes[3] = round(lanes[3], read64(p + 24));
+    }
+
+    std::uint64_t lanes[4];
+    std::uint64_t seed = 0;
+    std::uint64_t totalBytes = 0;
+    unsigned char pending[32] = {};
+    size_t pendingBytes = 0;
+};
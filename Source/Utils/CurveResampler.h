@@ -1,5 +1,6 @@
 #pragma once
 
+#include "MelMatrix.h"
 #include <vector>
 
 namespace CurveResampler {
@@ -14,12 +15,8 @@ namespace CurveResampler {
                                     int targetLength);
 
   // Resample a 2D curve [T, C] to a target length using linear interpolation.
-  std::vector<std::vector<float>> resampleLinear2D(
-      const std::vector<std::vector<float>>& points,
-      int targetLength);
+  MelMatrix resampleLinear2D(MelView points, int targetLength);
 
   // Resample a 2D curve [T, C] to a target length using nearest-neighbor.
-  std::vector<std::vector<float>> resampleNearest2D(
-      const std::vector<std::vector<float>>& points,
-      int targetLength);
+  MelMatrix resampleNearest2D(MelView points, int targetLength);
 } // namespace CurveResampler
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+/**
+ * Set of half-open frame intervals [start, end), kept sorted and disjoint.
+ * Overlapping or touching intervals are merged on insertion.
+ */
+class FrameIntervalSet
+{
+public:
+    using Interval = std::pair<int, int>;
+
+    void add(int startFrame, int endFrame)
+    {
+        if (endFrame <= startFrame)
+            return;
+
+        // First interval that could touch [startFrame, endFrame)
+        auto first = std::lower_bound(intervals.begin(), intervals.end(), startFrame,
+                                      [](const Interval& iv, int frame) { return iv.second < frame; });
+        auto last = first;
+        while (last != intervals.end() && last->first <= endFrame)
+        {
+            startFrame = std::min(startFrame, last->first);
+            endFrame = std::max(endFrame, last->second);
+            ++last;
+        }
+
+        if (first == last)
+        {
+            intervals.insert(first, {startFrame, endFrame});
+        }
+        else
+        {
+            *first = {startFrame, endFrame};
+            intervals.erase(first + 1, last);
+        }
+    }
+
+    void add(const FrameIntervalSet& other)
+    {
+        for (const auto& iv : other.intervals)
+            add(iv.first, iv.second);
+    }
+
+    void clear() { intervals.clear(); }
+    bool empty() const { return intervals.empty(); }
+    size_t size() const { return intervals.size(); }
+
+    const std::vector<Interval>& getIntervals() const { return intervals; }
+
+    /** Smallest interval covering every member, or {-1, -1} when empty. */
+    Interval getHull() const
+    {
+        if (intervals.empty())
+            return {-1, -1};
+        return {intervals.front().first, intervals.back().second};
+    }
+
+    bool intersects(int startFrame, int endFrame) const
+    {
+        auto it = std::upper_bound(intervals.begin(), intervals.end(), startFrame,
+                                   [](int frame, const Interval& iv) { return frame < iv.second; });
+        return it != intervals.end() && it->first < endFrame;
+    }
+
+private:
+    std::vector<Interval> intervals;
+};
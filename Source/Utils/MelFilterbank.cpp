@@ -0,0 +1,136 @@
+#include "MelFilterbank.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Slaney-style mel scale: linear below 1 kHz, log above
+    constexpr float slaneyFSp = 200.0f / 3.0f;  // ~66.67 Hz per mel below 1000 Hz
+    constexpr float slaneyMinLogHz = 1000.0f;
+    constexpr float slaneyMinLogMel = slaneyMinLogHz / slaneyFSp;  // = 15.0
+
+    float hzToMel(float hz, MelFilterbank::Scale scale)
+    {
+        if (scale == MelFilterbank::Scale::Htk)
+            return 2595.0f * std::log10(1.0f + hz / 700.0f);
+
+        const float logstep = std::log(6.4f) / 27.0f;
+        if (hz < slaneyMinLogHz)
+            return hz / slaneyFSp;
+        return slaneyMinLogMel + std::log(hz / slaneyMinLogHz) / logstep;
+    }
+
+    float melToHz(float mel, MelFilterbank::Scale scale)
+    {
+        if (scale == MelFilterbank::Scale::Htk)
+            return 700.0f * (std::pow(10.0f, mel / 2595.0f) - 1.0f);
+
+        const float logstep = std::log(6.4f) / 27.0f;
+        if (mel < slaneyMinLogMel)
+            return slaneyFSp * mel;
+        return slaneyMinLogHz * std::exp(logstep * (mel - slaneyMinLogMel));
+    }
+}
+
+MelFilterbank::MelFilterbank(int sampleRate, int nFft, int numMels, float fMin, float fMax,
+                             Scale scale)
+    : numBins(nFft / 2 + 1)
+{
+    const float melMin = hzToMel(fMin, scale);
+    const float melMax = hzToMel(fMax, scale);
+
+    // numMels + 2 points delimit the triangular filters
+    std::vector<float> hzPoints(numMels + 2);
+    for (int i = 0; i <= numMels + 1; ++i)
+        hzPoints[i] = melToHz(melMin + (melMax - melMin) * i / (numMels + 1), scale);
+
+    std::vector<float> row(numBins);
+    bands.reserve(numMels);
+    for (int m = 0; m < numMels; ++m)
+    {
+        const float fLow = hzPoints[m];
+        const float fCenter = hzPoints[m + 1];
+        const float fHigh = hzPoints[m + 2];
+
+        // Slaney normalization: divide by the width of the mel band
+        const float enorm = 2.0f / (fHigh - fLow);
+
+        std::fill(row.begin(), row.end(), 0.0f);
+        for (int k = 0; k < numBins; ++k)
+        {
+            const float freq = static_cast<float>(k) * sampleRate / nFft;
+            if (freq >= fLow && freq < fCenter)
+                row[k] = enorm * (freq - fLow) / (fCenter - fLow);
+            else if (freq >= fCenter && freq <= fHigh)
+                row[k] = enorm * (fHigh - freq) / (fHigh - fCenter);
+        }
+        addBand(row.data());
+    }
+}
+
+MelFilterbank MelFilterbank::fromDense(const float* denseWeights, int numMels, int numBins)
+{
+    MelFilterbank filterbank;
+    filterbank.numBins = numBins;
+    filterbank.bands.reserve(numMels);
+    for (int m = 0; m < numMels; ++m)
+        filterbank.addBand(denseWeights + static_cast<size_t>(m) * numBins);
+    return filterbank;
+}
+
+void MelFilterbank::addBand(const float* denseRow)
+{
+    int first = 0;
+    while (first < numBins && denseRow[first] == 0.0f)
+        ++first;
+    int last = numBins;
+    while (last > first && denseRow[last - 1] == 0.0f)
+        --last;
+
+    Band band;
+    band.firstBin = first;
+    band.numBins = last - first;
+    band.offset = static_cast<int>(weights.size());
+    weights.insert(weights.end(), denseRow + first, denseRow + last);
+    bands.push_back(band);
+}
+
+void MelFilterbank::computeMagnitude(const float* fftInterleaved, float* magnitude, int numBins)
+{
+    // Branch-free so the compiler can vectorise it
+    for (int k = 0; k < numBins; ++k)
+    {
+        const float re = fftInterleaved[2 * k];
+        const float im = fftInterleaved[2 * k + 1];
+        magnitude[k] = std::sqrt(re * re + im * im + 1e-9f);
+    }
+}
+
+void MelFilterbank::applyLog(const float* magnitude, float* out, float clipValue) const
+{
+    const int numMels = getNumMels();
+    for (int m = 0; m < numMels; ++m)
+    {
+        const Band& band = bands[static_cast<size_t>(m)];
+        const float* w = weights.data() + band.offset;
+        const float* x = magnitude + band.firstBin;
+
+        // Four independent partial sums keep the multiply-adds pipelined
+        float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+        int k = 0;
+        for (; k + 4 <= band.numBins; k += 4)
+        {
+            s0 += w[k] * x[k];
+            s1 += w[k + 1] * x[k + 1];
+            s2 += w[k + 2] * x[k + 2];
+            s3 += w[k + 3] * x[k + 3];
+        }
+        for (; k < band.numBins; ++k)
+            s0 += w[k] * x[k];
+
+        out[m] = (s0 + s1) + (s2 + s3);
+    }
+
+    for (int m = 0; m < numMels; ++m)
+        out[m] = std::log(std::max(out[m], clipValue));
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+
+/**
+ * Sparse triangular mel filterbank shared by the mel front ends.
+ *
+ * Each filter is nonzero over only a few dozen FFT bins, so filters are
+ * stored as (first bin, bin count, weights) instead of a dense
+ * [numMels][nFft/2+1] matrix. Applying it costs about two multiply-adds per
+ * bin rather than numMels.
+ */
+class MelFilterbank
+{
+public:
+    enum class Scale
+    {
+        Slaney, // librosa default (htk=False)
+        Htk
+    };
+
+    MelFilterbank() = default;
+
+    /**
+     * Triangular filters with Slaney area normalisation, spaced evenly on
+     * the given mel scale between fMin and fMax.
+     */
+    MelFilterbank(int sampleRate, int nFft, int numMels, float fMin, float fMax,
+                  Scale scale = Scale::Slaney);
+
+    /** Sparse copy of a dense row-major [numMels][numBins] matrix. */
+    static MelFilterbank fromDense(const float* weights, int numMels, int numBins);
+
+    int getNumMels() const { return static_cast<int>(bands.size()); }
+    int getNumBins() const { return numBins; }
+    bool empty() const { return bands.empty(); }
+
+    /**
+     * magnitude[k] = sqrt(re^2 + im^2 + 1e-9) for the first numBins bins of
+     * juce::dsp::FFT::performRealOnlyForwardTransform output (interleaved).
+     */
+    static void computeMagnitude(const float* fftInterleaved, float* magnitude, int numBins);
+
+    /** out[m] = log(max(sum_k weight[m][k] * magnitude[k], clipValue)). */
+    void applyLog(const float* magnitude, float* out, float clipValue) const;
+
+private:
+    struct Band
+    {
+        int firstBin = 0;
+        int numBins = 0;
+        int offset = 0; // into weights
+    };
+
+    void addBand(const float* denseRow);
+
+    std::vector<Band> bands;
+    std::vector<float> weights;
+    int numBins = 0;
+};
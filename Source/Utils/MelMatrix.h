@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+/**
+ * Non-owning view over a contiguous [T, numMels] mel range.
+ * Valid only while the underlying storage is neither resized nor destroyed.
+ */
+class MelView
+{
+public:
+    MelView() = default;
+    MelView(const float* data, int numFrames, int numMels)
+        : ptr(data), frames(std::max(0, numFrames)), mels(std::max(0, numMels))
+    {
+    }
+
+    const float* operator[](size_t frame) const { return ptr + frame * static_cast<size_t>(mels); }
+
+    const float* data() const { return ptr; }
+    size_t size() const { return static_cast<size_t>(frames); }
+    bool empty() const { return frames == 0 || mels == 0; }
+    int getNumFrames() const { return frames; }
+    int getNumMels() const { return mels; }
+
+    /** Sub-range [startFrame, endFrame), clamped to this view. */
+    MelView slice(int startFrame, int endFrame) const
+    {
+        startFrame = std::clamp(startFrame, 0, frames);
+        endFrame = std::clamp(endFrame, startFrame, frames);
+        return MelView(ptr + static_cast<size_t>(startFrame) * static_cast<size_t>(mels),
+                       endFrame - startFrame, mels);
+    }
+
+private:
+    const float* ptr = nullptr;
+    int frames = 0;
+    int mels = 0;
+};
+
+/**
+ * Mel spectrogram [T, numMels] stored as one row-major float buffer.
+ *
+ * Row access (mel[t][m]) and size()/empty() match the previous
+ * vector-of-vectors layout, so most call sites read the same, but a
+ * whole range can be handed to the vocoder or copied with a single memcpy.
+ */
+class MelMatrix
+{
+public:
+    MelMatrix() = default;
+    MelMatrix(int numFrames, int numMels, float value = 0.0f)
+        : frames(std::max(0, numFrames)), mels(std::max(0, numMels)),
+          values(static_cast<size_t>(frames) * static_cast<size_t>(mels), value)
+    {
+    }
+
+    /** Deep copy of a view. */
+    explicit MelMatrix(MelView view)
+        : frames(view.getNumFrames()), mels(view.getNumMels()),
+          values(view.data(), view.data() + view.size() * static_cast<size_t>(view.getNumMels()))
+    {
+    }
+
+    float* operator[](size_t frame) { return values.data() + frame * static_cast<size_t>(mels); }
+    const float* operator[](size_t frame) const { return values.data() + frame * static_cast<size_t>(mels); }
+
+    float* data() { return values.data(); }
+    const float* data() const { return values.data(); }
+    size_t size() const { return static_cast<size_t>(frames); }
+    bool empty() const { return frames == 0 || mels == 0; }
+    int getNumFrames() const { return frames; }
+    int getNumMels() const { return mels; }
+
+    MelView view() const { return MelView(values.data(), frames, mels); }
+    MelView view(int startFrame, int endFrame) const { return view().slice(startFrame, endFrame); }
+    operator MelView() const { return view(); }
+
+    void clear()
+    {
+        values.clear();
+        frames = 0;
+    }
+
+    /**
+     * Resize to numFrames x numMels. Leading frames are kept when the
+     * mel count is unchanged; new values are zero.
+     */
+    void resize(int numFrames, int numMels)
+    {
+        numFrames = std::max(0, numFrames);
+        numMels = std::max(0, numMels);
+        if (numMels != mels)
+            values.clear();
+        frames = numFrames;
+        mels = numMels;
+        values.resize(static_cast<size_t>(frames) * static_cast<size_t>(mels), 0.0f);
+    }
+
+    void reserveFrames(int numFrames)
+    {
+        values.reserve(static_cast<size_t>(std::max(0, numFrames)) * static_cast<size_t>(mels));
+    }
+
+    /** Append frames; the mel count is taken from src if this matrix is empty. */
+    void append(MelView src)
+    {
+        if (src.empty())
+            return;
+        if (frames == 0)
+            mels = src.getNumMels();
+        if (src.getNumMels() != mels)
+            return;
+        values.insert(values.end(), src.data(),
+                      src.data() + src.size() * static_cast<size_t>(mels));
+        frames += src.getNumFrames();
+    }
+
+    /**
+     * Overwrite frames starting at dstFrame with src. Frames that would
+     * fall outside this matrix are ignored.
+     */
+    void copyFrames(int dstFrame, MelView src)
+    {
+        if (src.empty() || src.getNumMels() != mels || dstFrame >= frames)
+            return;
+        int srcStart = 0;
+        if (dstFrame < 0)
+        {
+            srcStart = -dstFrame;
+            dstFrame = 0;
+        }
+        const int count = std::min(src.getNumFrames() - srcStart, frames - dstFrame);
+        if (count <= 0)
+            return;
+        // memmove: src may be a view into this matrix
+        std::memmove((*this)[static_cast<size_t>(dstFrame)], src[static_cast<size_t>(srcStart)],
+                     static_cast<size_t>(count) * static_cast<size_t>(mels) * sizeof(float));
+    }
+
+    bool operator==(const MelMatrix& other) const
+    {
+        return frames == other.frames && mels == other.mels && values == other.values;
+    }
+    bool operator!=(const MelMatrix& other) const { return !(*this == other); }
+
+private:
+    int frames = 0;
+    int mels = 0;
+    std::vector<float> values;
+};
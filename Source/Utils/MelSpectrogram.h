@@ -1,10 +1,18 @@
 #pragma once
 
 #include "../JuceHeader.h"
+#include "MelFilterbank.h"
+#include "MelMatrix.h"
+#include "ParallelFor.h"
+#include <atomic>
 #include <vector>
 
 /**
  * Mel spectrogram computation.
+ *
+ * Frames are independent, so compute() splits them into blocks across
+ * worker threads, each with its own FFT and scratch. Every frame is written
+ * to its own row, so the output does not depend on the thread count.
  */
 class MelSpectrogram
 {
@@ -17,15 +25,45 @@ public:
      * Compute mel spectrogram from audio.
      * @param audio Audio samples
      * @param numSamples Number of samples
-     * @return Mel spectrogram [T, numMels] in log scale
+     * @param cancelFlag Checked between blocks of frames; may be null
+     * @param onProgress Completed fraction; see ParallelFor::forEachBlock
+     * @return Mel spectrogram [T, numMels] in log scale, or an empty matrix
+     *         if cancelled
      */
-    std::vector<std::vector<float>> compute(const float* audio, int numSamples);
+    MelMatrix compute(const float* audio, int numSamples,
+                      const std::atomic<bool>* cancelFlag = nullptr,
+                      const ParallelFor::ProgressCallback& onProgress = nullptr);
+
+    /** Number of frames compute() returns for numSamples of audio. */
+    int getNumFrames(int numSamples) const;
+
+    /**
+     * Number of leading frames of a numSamples-long signal that depend only
+     * on its first availableSamples samples, for computing frames while the
+     * audio is still being decoded.
+     */
+    int getNumFramesAvailable(int availableSamples, int numSamples) const;
+
+    /**
+     * Compute frames [startFrame, endFrame) of compute()'s result into mel,
+     * which must already have getNumFrames(numSamples) frames. Only audio
+     * covered by getNumFramesAvailable(endFrame) has to be valid yet.
+     * @return false if cancelled before every frame was computed
+     */
+    bool computeRange(const float* audio, int numSamples, int startFrame, int endFrame,
+                      MelMatrix& mel, const std::atomic<bool>* cancelFlag = nullptr,
+                      const ParallelFor::ProgressCallback& onProgress = nullptr);
+
+    /** Limit the worker threads used by compute(); 0 uses every core the
+     *  ParallelFor budget has free. */
+    void setMaxThreads(int threads) { maxThreads = std::max(0, threads); }
     
 private:
-    void createMelFilterbank();
-    void applyWindow(std::vector<float>& frame);
-    std::vector<float> computeFFT(const std::vector<float>& frame);
-    
+    // Frames per work item; ~3 s of audio at the default hop
+    static constexpr int framesPerBlock = 256;
+
+    void computeFrame(const float* audio, int numSamples, int frameIndex,
+                      juce::dsp::FFT& fft, float* frame, float* mag, float* melOut) const;
     int sampleRate;
     int nFft;
     int hopSize;
@@ -34,7 +72,8 @@ private:
     float fMax;
     
     std::vector<float> window;  // Hann window
-    std::vector<std::vector<float>> melFilterbank;
+    MelFilterbank melFilterbank;
     
-    juce::dsp::FFT fft;
+    int fftOrder;
+    int maxThreads = 0;
 };
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Block-parallel loop for frame-wise DSP such as STFT and mel extraction.
+ *
+ * [0, numItems) is split into blocks of blockSize and handed out to worker
+ * threads in order; the calling thread is one of the workers. makeWorker()
+ * is called once per thread and returns a callable taking (begin, end), so
+ * per-thread state such as an FFT instance and scratch buffers lives in the
+ * returned closure. Workers write to disjoint output ranges, which keeps the
+ * result independent of the thread count.
+ *
+ * Helper threads come from one process-wide budget of
+ * getDefaultThreadCount() - 1, so loops running at the same time (the mel
+ * stages of concurrent analyses, CLI jobs, waveform peaks) share the cores
+ * instead of each starting one thread per core. A loop that finds the
+ * budget spent runs on its calling thread alone.
+ */
+namespace ParallelFor
+{
+    using ProgressCallback = std::function<void(double)>;
+
+    inline int getDefaultThreadCount()
+    {
+        return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    namespace detail
+    {
+        inline std::atomic<int>& spareHelperThreads()
+        {
+            static std::atomic<int> spare{getDefaultThreadCount() - 1};
+            return spare;
+        }
+
+        /** Takes up to wanted helper threads from the shared budget. */
+        inline int acquireHelperThreads(int wanted)
+        {
+            auto& spare = spareHelperThreads();
+            int available = spare.load();
+            int granted = 0;
+            do
+            {
+                granted = std::min(wanted, std::max(0, available));
+            } while (granted > 0 && !spare.compare_exchange_weak(available, available - granted));
+            return granted;
+        }
+
+        inline void releaseHelperThreads(int count)
+        {
+            if (count > 0)
+                spareHelperThreads().fetch_add(count);
+        }
+    }
+
+    /**
+     * @param maxThreads Upper bound on threads, including the caller; 0 picks
+     *                   getDefaultThreadCount(). Helpers beyond the caller
+     *                   are further limited by the shared budget.
+     * @param cancelFlag Checked between blocks; may be null
+     * @param onProgress Called with the completed fraction as blocks finish,
+     *                   from whichever worker finished one but never from two
+     *                   at once, and with 1.0 on the calling thread once every
+     *                   block is done; may be empty
+     * @return false if cancelled before every block was processed
+     * @throws Whatever a worker threw first, rethrown on the calling thread
+     *         after every worker has stopped
+     */
+    template <typename MakeWorker>
+    bool forEachBlock(int numItems, int blockSize, int maxThreads, MakeWorker&& makeWorker,
+                      const std::atomic<bool>* cancelFlag = nullptr,
+                      const ProgressCallback& onProgress = nullptr)
+    {
+        if (numItems <= 0)
+            return true;
+
+        blockSize = std::max(1, blockSize);
+        const int numBlocks = (numItems + blockSize - 1) / blockSize;
+        const int wantedThreads = std::min(maxThreads > 0 ? maxThreads : getDefaultThreadCount(),
+                                           numBlocks);
+
+        std::atomic<int> nextBlock{0};
+        std::atomic<int> completedItems{0};
+        std::atomic<bool> cancelled{false};
+        std::mutex progressMutex;
+        int reportedItems = 0;
+        std::mutex errorMutex;
+        std::exception_ptr error;
+
+        auto isCancelled = [&]()
+        {
+            if (cancelFlag != nullptr && cancelFlag->load())
+                cancelled = true;
+            return cancelled.load();
+        };
+
+        auto reportProgress = [&](int done)
+        {
+            // Skip rather than wait if another worker is reporting
+            std::unique_lock<std::mutex> lock(progressMutex, std::try_to_lock);
+            if (!lock.owns_lock() || done <= reportedItems)
+                return;
+            reportedItems = done;
+            onProgress(static_cast<double>(done) / numItems);
+        };
+
+        auto run = [&]()
+        {
+            // An exception escaping a std::thread would terminate; keep the
+            // first one and stop the other workers instead
+            try
+            {
+                auto process = makeWorker();
+                for (;;)
+                {
+                    const int block = nextBlock.fetch_add(1);
+                    if (block >= numBlocks || isCancelled())
+                        return;
+
+                    const int begin = block * blockSize;
+                    const int end = std::min(numItems, begin + blockSize);
+                    process(begin, end);
+
+                    const int done = completedItems.fetch_add(end - begin) + (end - begin);
+                    if (onProgress && done < numItems)
+                        reportProgress(done);
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error)
+                    error = std::current_exception();
+                cancelled = true;
+            }
+        };
+
+        const int numHelpers = detail::acquireHelperThreads(wantedThreads - 1);
+        std::vector<std::thread> workers;
+        workers.reserve(static_cast<size_t>(numHelpers));
+        try
+        {
+            for (int i = 0; i < numHelpers; ++i)
+                workers.emplace_back(run);
+        }
+        catch (...)
+        {
+            // Could not start a thread; the caller picks up its share
+        }
+        detail::releaseHelperThreads(numHelpers - static_cast<int>(workers.size()));
+        run();
+        for (auto& t : workers)
+            t.join();
+        detail::releaseHelperThreads(static_cast<int>(workers.size()));
+
+        if (error)
+            std::rethrow_exception(error);
+        if (cancelled.load() || completedItems.load() != numItems)
+            return false;
+        if (onProgress)
+            onProgress(1.0);
+        return true;
+    }
+}
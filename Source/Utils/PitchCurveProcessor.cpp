@@ -3,6 +3,8 @@
 #include "../Utils/Constants.h"
 #include <algorithm>
 #include <cmath>
+#include <iterator>
+#include <utility>
 
 namespace
 {
@@ -29,9 +31,10 @@ namespace
             audioData.deltaPitch.assign(static_cast<size_t>(totalFrames), 0.0f);
     }
 
-    std::vector<BasePitchCurve::NoteSegment> collectNoteSegments(const std::vector<Note>& notes)
+    void collectNoteSegments(const std::vector<Note>& notes,
+                             std::vector<BasePitchCurve::NoteSegment>& segments)
     {
-        std::vector<BasePitchCurve::NoteSegment> segments;
+        segments.clear();
         segments.reserve(notes.size());
 
         for (const auto& note : notes)
@@ -47,11 +50,48 @@ namespace
             segments.push_back(seg);
         }
 
-        // Ensure segments are sorted by start frame for stable generation
-        std::sort(segments.begin(), segments.end(),
-                  [](const auto& a, const auto& b) { return a.startFrame < b.startFrame; });
+        // Same order BasePitchCurve::generateForNotes and
+        // Project::getBasePitchOrder use, so a ranged rebuild reproduces the
+        // full one exactly
+        std::stable_sort(segments.begin(), segments.end(),
+                         [](const auto& a, const auto& b) {
+                             if (a.startFrame != b.startFrame)
+                                 return a.startFrame < b.startFrame;
+                             return a.endFrame < b.endFrame;
+                         });
+    }
+
+    std::vector<BasePitchCurve::NoteSegment> collectNoteSegments(const std::vector<Note>& notes)
+    {
+        std::vector<BasePitchCurve::NoteSegment> segments;
+        collectNoteSegments(notes, segments);
         return segments;
     }
+
+    /**
+     * Frames whose base pitch can change when notes inside [dirtyStart,
+     * dirtyEnd) change. The step function only switches at midpoints between
+     * neighbouring notes, which lie between the previous note's start and the
+     * next note's start; the smoothing kernel then reaches a few frames
+     * further.
+     */
+    std::pair<int, int> baseInfluenceRange(const BasePitchCurve::SortedSpans& spans,
+                                           int dirtyStart, int dirtyEnd,
+                                           int totalFrames)
+    {
+        // Last note starting before the dirty range, first starting in or
+        // after its end
+        const auto& starts = spans.startFrames;
+        const auto before = std::lower_bound(starts.begin(), starts.end(), dirtyStart);
+        const auto after = std::lower_bound(before, starts.end(), dirtyEnd);
+        const int lo = before != starts.begin() ? *std::prev(before) : 0;
+        const int hi = after != starts.end() ? std::min(*after, totalFrames) : totalFrames;
+
+        const int radius = BasePitchCurve::kernelRadiusFrames();
+        const int rangeStart = std::clamp(std::min(lo, dirtyStart) - radius, 0, totalFrames);
+        const int rangeEnd = std::clamp(std::max(hi, dirtyEnd) + radius, rangeStart, totalFrames);
+        return {rangeStart, rangeEnd};
+    }
 } // namespace
 
 namespace PitchCurveProcessor
@@ -192,6 +232,49 @@ namespace PitchCurveProcessor
         composeF0InPlace(project, /*applyUvMask=*/false);
     }
 
+    void rebuildBaseFromNotesInRange(Project& project, int dirtyStart, int dirtyEnd)
+    {
+        auto& audioData = project.getAudioData();
+        const int totalFrames = audioData.getNumFrames();
+        const auto expected = static_cast<size_t>(totalFrames);
+        if (totalFrames <= 0 || audioData.basePitch.size() != expected ||
+            audioData.deltaPitch.size() != expected ||
+            audioData.baseF0.size() != expected || audioData.f0.size() != expected)
+        {
+            rebuildBaseFromNotes(project);
+            return;
+        }
+
+        const auto& order = project.getBasePitchOrder();
+        const auto [startFrame, endFrame] =
+            baseInfluenceRange(order.spans, dirtyStart, dirtyEnd, totalFrames);
+        if (endFrame <= startFrame)
+            return;
+
+        if (!order.noteIndices.empty())
+        {
+            // Only the sorted notes the range reaches, with current pitches;
+            // reused across calls so dragging does not allocate
+            const auto window = BasePitchCurve::findWindow(order.spans, startFrame, endFrame);
+            const auto& notes = project.getNotes();
+            thread_local std::vector<BasePitchCurve::NoteSegment> segments;
+            segments.clear();
+            for (int k = window.first; k < window.last; ++k)
+            {
+                const auto& note = notes[order.noteIndices[static_cast<size_t>(k)]];
+                segments.push_back({note.getStartFrame(), note.getEndFrame(),
+                                    note.getMidiNote() + note.getPitchOffset()});
+            }
+            BasePitchCurve::generateRange(segments, window, startFrame, endFrame,
+                                          audioData.basePitch.data() + startFrame);
+        }
+
+        for (int i = startFrame; i < endFrame; ++i)
+            audioData.baseF0[static_cast<size_t>(i)] = safeMidiToFreq(audioData.basePitch[static_cast<size_t>(i)]);
+
+        composeF0InRange(project, startFrame, endFrame, /*applyUvMask=*/false);
+    }
+
     std::vector<float> composeF0(const Project& project,
                                  bool applyUvMask,
                                  float globalPitchOffset)
@@ -221,10 +304,40 @@ namespace PitchCurveProcessor
                           bool applyUvMask,
                           float globalPitchOffset)
     {
-        auto composed = composeF0(project, applyUvMask, globalPitchOffset);
         auto& audioData = project.getAudioData();
-        audioData.f0 = std::move(composed);
+        audioData.f0.resize(audioData.basePitch.size());
+        composeF0InRange(project, 0, static_cast<int>(audioData.f0.size()),
+                         applyUvMask, globalPitchOffset);
     }
-} // namespace PitchCurveProcessor
 
+    void composeF0InRange(Project& project,
+                          int startFrame,
+                          int endFrame,
+                          bool applyUvMask,
+                          float globalPitchOffset)
+    {
+        auto& audioData = project.getAudioData();
+        const int totalFrames = static_cast<int>(audioData.basePitch.size());
+        if (audioData.f0.size() != static_cast<size_t>(totalFrames))
+            audioData.f0.resize(static_cast<size_t>(totalFrames), 0.0f);
+
+        startFrame = std::max(0, startFrame);
+        endFrame = std::min(endFrame, totalFrames);
+        const int voicedSize = static_cast<int>(audioData.voicedMask.size());
+        const int deltaSize = static_cast<int>(audioData.deltaPitch.size());
 
+        for (int i = startFrame; i < endFrame; ++i)
+        {
+            const bool isVoiced = i < voicedSize ? audioData.voicedMask[static_cast<size_t>(i)] : true;
+            if (applyUvMask && !isVoiced)
+            {
+                audioData.f0[static_cast<size_t>(i)] = 0.0f;
+                continue;
+            }
+
+            const float base = audioData.basePitch[static_cast<size_t>(i)];
+            const float delta = i < deltaSize ? audioData.deltaPitch[static_cast<size_t>(i)] : 0.0f;
+            audioData.f0[static_cast<size_t>(i)] = safeMidiToFreq(base + delta + globalPitchOffset);
+        }
+    }
+} // namespace PitchCurveProcessor
@@ -19,6 +19,17 @@ namespace PitchCurveProcessor
      */
     void rebuildBaseFromNotes(Project& project);
 
+    /**
+     * Incremental rebuildBaseFromNotes for note edits. Pass the frames the
+     * edited notes covered before and after the change; basePitch, baseF0
+     * and f0 are recomputed in place only where the smoothed base can differ
+     * (out to the neighbouring notes plus the kernel radius), reading only
+     * the notes that range reaches through Project::getBasePitchOrder().
+     * Falls back to a full rebuild if the curves are not yet sized to the
+     * project.
+     */
+    void rebuildBaseFromNotesInRange(Project& project, int dirtyStart, int dirtyEnd);
+
     /**
      * Rebuild base and delta from a source pitch (Hz). This is used after
      * detection/segmentation or when we need to recompute delta from edited
@@ -42,6 +53,15 @@ namespace PitchCurveProcessor
     void composeF0InPlace(Project& project,
                           bool applyUvMask,
                           float globalPitchOffset = 0.0f);
+
+    /**
+     * composeF0InPlace restricted to frames [startFrame, endFrame).
+     */
+    void composeF0InRange(Project& project,
+                          int startFrame,
+                          int endFrame,
+                          bool applyUvMask,
+                          float globalPitchOffset = 0.0f);
 } // namespace PitchCurveProcessor
 
 
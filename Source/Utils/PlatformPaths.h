@@ -9,16 +9,19 @@
  *   - Models: App.app/Contents/Resources/models/
  *   - Logs: ~/Library/Logs/HachiTune/
  *   - Config: ~/Library/Application Support/HachiTune/
+ *   - Cache: ~/Library/Caches/HachiTune/
  *
  * Windows:
  *   - Models: <exe_dir>/models/
  *   - Logs: %APPDATA%/HachiTune/Logs/
  *   - Config: %APPDATA%/HachiTune/
+ *   - Cache: %APPDATA%/HachiTune/Cache/
  *
  * Linux:
  *   - Models: <exe_dir>/models/
  *   - Logs: ~/.config/HachiTune/logs/
  *   - Config: ~/.config/HachiTune/
+ *   - Cache: ~/.config/HachiTune/cache/
  */
 namespace PlatformPaths
 {
@@ -60,6 +63,19 @@ namespace PlatformPaths
                    .getChildFile("HachiTune");
     }
 
+    inline juce::File getCacheDirectory()
+    {
+    #if JUCE_MAC
+        // macOS: ~/Library/Caches/HachiTune/
+        return juce::File::getSpecialLocation(juce::File::userHomeDirectory)
+                   .getChildFile("Library/Caches/HachiTune");
+    #elif JUCE_WINDOWS
+        return getConfigDirectory().getChildFile("Cache");
+    #else
+        return getConfigDirectory().getChildFile("cache");
+    #endif
+    }
+
     inline juce::File getLogFile(const juce::String& name)
     {
         auto logsDir = getLogsDirectory();
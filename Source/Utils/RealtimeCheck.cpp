@@ -0,0 +1,138 @@
+#include "RealtimeCheck.h"
+
+#if HACHITUNE_RT_CHECKS
+
+#include "../JuceHeader.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+namespace {
+thread_local int audioScopeDepth = 0;
+thread_local bool reporting = false;
+std::atomic<int> violationCount{0};
+std::atomic<const char *> lastViolation{nullptr};
+
+void *allocateAligned(std::size_t size, std::align_val_t alignment) noexcept {
+  const auto align = static_cast<std::size_t>(alignment);
+  size = size != 0 ? size : 1;
+#if defined(_MSC_VER)
+  return _aligned_malloc(size, align);
+#else
+  // aligned_alloc wants a size that is a multiple of the alignment
+  return std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+}
+
+void freeAligned(void *ptr) noexcept {
+#if defined(_MSC_VER)
+  _aligned_free(ptr);
+#else
+  std::free(ptr);
+#endif
+}
+} // namespace
+
+namespace RealtimeCheck {
+ScopedAudioThread::ScopedAudioThread() { ++audioScopeDepth; }
+ScopedAudioThread::~ScopedAudioThread() { --audioScopeDepth; }
+
+bool isAudioThread() { return audioScopeDepth > 0; }
+
+void checkNotRealtime(const char *what) {
+  if (audioScopeDepth == 0 || reporting)
+    return;
+
+  // The assertion handler may allocate; don't report that recursively
+  reporting = true;
+  violationCount.fetch_add(1, std::memory_order_relaxed);
+  lastViolation.store(what, std::memory_order_relaxed);
+  jassertfalse;
+  reporting = false;
+}
+
+int getViolationCount() { return violationCount.load(); }
+const char *getLastViolation() { return lastViolation.load(); }
+
+void resetViolations() {
+  violationCount.store(0);
+  lastViolation.store(nullptr);
+}
+} // namespace RealtimeCheck
+
+void *operator new(std::size_t size) {
+  RealtimeCheck::checkNotRealtime("operator new");
+  if (void *ptr = std::malloc(size != 0 ? size : 1))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) { return ::operator new(size); }
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  RealtimeCheck::checkNotRealtime("operator new");
+  return std::malloc(size != 0 ? size : 1);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  return ::operator new(size, std::nothrow);
+}
+
+void operator delete(void *ptr) noexcept {
+  if (ptr != nullptr)
+    RealtimeCheck::checkNotRealtime("operator delete");
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept { ::operator delete(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { ::operator delete(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept {
+  ::operator delete(ptr);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+  RealtimeCheck::checkNotRealtime("operator new");
+  if (void *ptr = allocateAligned(size, alignment))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+  return ::operator new(size, alignment);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment,
+                   const std::nothrow_t &) noexcept {
+  RealtimeCheck::checkNotRealtime("operator new");
+  return allocateAligned(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment,
+                     const std::nothrow_t &) noexcept {
+  return ::operator new(size, alignment, std::nothrow);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+  if (ptr != nullptr)
+    RealtimeCheck::checkNotRealtime("operator delete");
+  freeAligned(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t alignment) noexcept {
+  ::operator delete(ptr, alignment);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t alignment) noexcept {
+  ::operator delete(ptr, alignment);
+}
+
+void operator delete[](void *ptr, std::size_t,
+                       std::align_val_t alignment) noexcept {
+  ::operator delete(ptr, alignment);
+}
+
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+
+/**
+ * Debug-only detector for real-time violations on the audio thread.
+ *
+ * Audio callbacks wrap their body in a ScopedAudioThread. When the build
+ * defines HACHITUNE_RT_CHECKS (the CMake option of the same name, Debug
+ * configurations only), global operator new/delete (aligned forms
+ * included) are replaced, and any allocation or deallocation inside such a
+ * scope is recorded as a violation. Blocking calls that must never run on
+ * the audio thread (writer locks, grace-period waits) call
+ * checkNotRealtime() themselves.
+ *
+ * The audio thread only counts violations, since logging there would
+ * itself allocate. Other threads read them back with getViolationCount():
+ * the plugin logs the count from releaseResources(), and hachitune_rt_test
+ * fails on any. Without HACHITUNE_RT_CHECKS everything here compiles to
+ * nothing.
+ */
+namespace RealtimeCheck {
+#if HACHITUNE_RT_CHECKS
+class ScopedAudioThread {
+public:
+  ScopedAudioThread();
+  ~ScopedAudioThread();
+  ScopedAudioThread(const ScopedAudioThread &) = delete;
+  ScopedAudioThread &operator=(const ScopedAudioThread &) = delete;
+};
+
+bool isAudioThread();
+
+/** Record a violation if the calling thread is inside a ScopedAudioThread. */
+void checkNotRealtime(const char *what);
+
+int getViolationCount();
+/** Description of the most recent violation, or nullptr if there was none. */
+const char *getLastViolation();
+void resetViolations();
+#else
+class ScopedAudioThread {
+public:
+  ScopedAudioThread() = default;
+};
+
+inline bool isAudioThread() { return false; }
+inline void checkNotRealtime(const char *) {}
+inline int getViolationCount() { return 0; }
+inline const char *getLastViolation() { return nullptr; }
+inline void resetViolations() {}
+#endif
+} // namespace RealtimeCheck
@@ -0,0 +1,96 @@
+#include "SincResampler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr double pi = 3.14159265358979323846;
+
+// Zeroth-order modified Bessel function of the first kind
+double besselI0(double x) {
+  double sum = 1.0;
+  double term = 1.0;
+  const double halfX = 0.5 * x;
+  for (int k = 1; k < 64; ++k) {
+    term *= (halfX / k) * (halfX / k);
+    sum += term;
+    if (term < sum * 1e-12)
+      break;
+  }
+  return sum;
+}
+} // namespace
+
+SincResampler::SincResampler(double sourceRateIn, double targetRateIn)
+    : sourceRate(sourceRateIn), targetRate(targetRateIn),
+      step(sourceRateIn / targetRateIn) {
+  // Cutoff as a fraction of the source Nyquist
+  const double cutoff = rolloff * std::min(1.0, targetRate / sourceRate);
+  radius = static_cast<int>(std::ceil(zeroCrossings / cutoff));
+  taps = 2 * radius;
+
+  const double windowNorm = 1.0 / besselI0(kaiserBeta);
+  table.resize(static_cast<size_t>(kernelPhases + 1) * taps);
+  for (int p = 0; p <= kernelPhases; ++p) {
+    const double offset = static_cast<double>(p) / kernelPhases;
+    float *row = table.data() + static_cast<size_t>(p) * taps;
+    for (int k = 0; k < taps; ++k) {
+      const double d = offset + radius - 1 - k;
+      const double t = d / radius;
+      if (std::abs(t) >= 1.0) {
+        row[k] = 0.0f;
+        continue;
+      }
+      const double x = pi * cutoff * d;
+      const double sinc = std::abs(x) < 1e-9 ? 1.0 : std::sin(x) / x;
+      const double window =
+          besselI0(kaiserBeta * std::sqrt(1.0 - t * t)) * windowNorm;
+      row[k] = static_cast<float>(cutoff * sinc * window);
+    }
+  }
+}
+
+int SincResampler::getOutputLength(int numSource) const {
+  return std::max(0, static_cast<int>(numSource / step));
+}
+
+std::pair<int, int>
+SincResampler::getAffectedOutputRange(int sourceStart, int sourceEnd,
+                                      int outputLength) const {
+  if (sourceEnd <= sourceStart || outputLength <= 0)
+    return {0, 0};
+  const int outStart = static_cast<int>(
+      std::floor(static_cast<double>(sourceStart - radius) / step));
+  const int outEnd = static_cast<int>(
+                         std::floor(static_cast<double>(sourceEnd + radius) /
+                                    step)) +
+                     1;
+  const int clampedStart = std::clamp(outStart, 0, outputLength);
+  return {clampedStart, std::clamp(outEnd, clampedStart, outputLength)};
+}
+
+void SincResampler::process(const float *source, int numSource, float *dest,
+                            int outStart, int outEnd) const {
+  for (int j = outStart; j < outEnd; ++j) {
+    const double position = j * step;
+    const double base = std::floor(position);
+    const double phase = (position - base) * kernelPhases;
+    const int row = std::min(static_cast<int>(phase), kernelPhases - 1);
+    const float blend = static_cast<float>(phase - row);
+
+    const float *k0 = table.data() + static_cast<size_t>(row) * taps;
+    const float *k1 = k0 + taps;
+    const int first = static_cast<int>(base) - radius + 1;
+
+    // Clip the kernel to the source instead of branching per tap
+    const int kBegin = std::max(0, -first);
+    const int kEnd = std::min(taps, numSource - first);
+
+    float sum = 0.0f;
+    for (int k = kBegin; k < kEnd; ++k) {
+      const float coeff = k0[k] + blend * (k1[k] - k0[k]);
+      sum += coeff * source[first + k];
+    }
+    dest[j] = sum;
+  }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+/**
+ * Band-limited sample rate converter using a Kaiser-windowed sinc kernel.
+ *
+ * The kernel is tabulated at kernelPhases fractional offsets and linearly
+ * interpolated between them, so any rate ratio works without a per-ratio
+ * polyphase table. When downsampling the cutoff follows the target Nyquist
+ * and the kernel widens to match.
+ *
+ * Output sample j sits at source position j * sourceRate / targetRate and
+ * depends only on source samples within getKernelRadius() of it, which lets
+ * callers recompute just the part of an output affected by a source edit.
+ * Source samples outside [0, numSource) are treated as zero.
+ */
+class SincResampler {
+public:
+  SincResampler(double sourceRate, double targetRate);
+
+  double getSourceRate() const { return sourceRate; }
+  double getTargetRate() const { return targetRate; }
+
+  /** Output length for a source of numSource samples. */
+  int getOutputLength(int numSource) const;
+
+  /** Half-width of the kernel, in source samples. */
+  int getKernelRadius() const { return radius; }
+
+  /** Output samples [outStart, outEnd) whose value depends on source
+   *  samples [sourceStart, sourceEnd), clamped to [0, outputLength). */
+  std::pair<int, int> getAffectedOutputRange(int sourceStart, int sourceEnd,
+                                             int outputLength) const;
+
+  /**
+   * Compute output samples [outStart, outEnd) of resampling the whole
+   * source, writing them to dest[outStart..outEnd).
+   */
+  void process(const float *source, int numSource, float *dest, int outStart,
+               int outEnd) const;
+
+private:
+  static constexpr int zeroCrossings = 16; // per side, at the cutoff rate
+  static constexpr int kernelPhases = 512;
+  static constexpr double rolloff = 0.95;
+  static constexpr double kaiserBeta = 8.0;
+
+  double sourceRate;
+  double targetRate;
+  double step; // source samples per output sample
+  int radius;
+  int taps;
+
+  // (kernelPhases + 1) rows of taps coefficients; row p is the kernel at
+  // fractional offset p / kernelPhases
+  std::vector<float> table;
+};
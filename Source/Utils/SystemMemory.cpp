@@ -0,0 +1,102 @@
+#include "SystemMemory.h"
+#include "../JuceHeader.h"
+
+#include <algorithm>
+
+#if JUCE_WINDOWS
+#include <windows.h>
+#include <psapi.h>
+#elif JUCE_MAC
+#include <mach/mach.h>
+#include <sys/resource.h>
+#else
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#endif
+
+namespace SystemMemory
+{
+    std::int64_t getAvailableBytes()
+    {
+    #if JUCE_WINDOWS
+        MEMORYSTATUSEX status;
+        status.dwLength = sizeof(status);
+        if (GlobalMemoryStatusEx(&status))
+            return static_cast<std::int64_t>(status.ullAvailPhys);
+        return 0;
+    #elif JUCE_MAC
+        vm_statistics64_data_t stats;
+        mach_msg_type_number_t count = HOST_VM_INFO64_COUNT;
+        if (host_statistics64(mach_host_self(), HOST_VM_INFO64,
+                              reinterpret_cast<host_info64_t>(&stats), &count) != KERN_SUCCESS)
+            return 0;
+        return static_cast<std::int64_t>(stats.free_count + stats.inactive_count)
+               * static_cast<std::int64_t>(vm_page_size);
+    #else
+        // MemAvailable accounts for reclaimable page cache; free pages alone do not
+        std::ifstream meminfo("/proc/meminfo");
+        std::string key;
+        std::int64_t value = 0;
+        std::string unit;
+        while (meminfo >> key >> value)
+        {
+            std::getline(meminfo, unit);
+            if (key == "MemAvailable:")
+                return value * 1024;
+        }
+
+        const long pages = sysconf(_SC_AVPHYS_PAGES);
+        const long pageSize = sysconf(_SC_PAGESIZE);
+        if (pages > 0 && pageSize > 0)
+            return static_cast<std::int64_t>(pages) * pageSize;
+        return 0;
+    #endif
+    }
+
+    int fitBatchSize(std::size_t bytesPerItem, int maxBatch, double fractionOfAvailable)
+    {
+        constexpr std::int64_t fallbackBudget = std::int64_t(1) << 30;
+
+        maxBatch = std::max(1, maxBatch);
+        if (bytesPerItem == 0)
+            return maxBatch;
+
+        const std::int64_t available = getAvailableBytes();
+        const std::int64_t budget = available > 0
+            ? static_cast<std::int64_t>(static_cast<double>(available) * fractionOfAvailable)
+            : fallbackBudget;
+        const std::int64_t fits = budget / static_cast<std::int64_t>(bytesPerItem);
+        return static_cast<int>(std::clamp<std::int64_t>(fits, 1, maxBatch));
+    }
+
+    std::int64_t getPeakResidentBytes()
+    {
+    #if JUCE_WINDOWS
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return static_cast<std::int64_t>(counters.PeakWorkingSetSize);
+        return 0;
+    #elif JUCE_MAC
+        // ru_maxrss is in bytes on macOS (kilobytes on Linux)
+        rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+            return static_cast<std::int64_t>(usage.ru_maxrss);
+        return 0;
+    #else
+        std::ifstream status("/proc/self/status");
+        std::string key;
+        while (status >> key)
+        {
+            if (key == "VmHWM:")
+            {
+                std::int64_t value = 0;
+                status >> value;
+                return value * 1024;
+            }
+            std::getline(status, key);
+        }
+        return 0;
+    #endif
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Queries of physical memory, used to size inference batches and to report
+ * the process footprint in benchmarks.
+ */
+namespace SystemMemory
+{
+    /**
+     * Physical memory that can be claimed without swapping, in bytes:
+     * MemAvailable on Linux, free plus inactive pages on macOS, available
+     * physical memory on Windows. 0 if it cannot be determined.
+     */
+    std::int64_t getAvailableBytes();
+
+    /**
+     * Largest batch in [1, maxBatch] whose estimated footprint of
+     * bytesPerItem each fits in the given fraction of available memory.
+     * Falls back to a 1 GB budget when available memory is unknown.
+     */
+    int fitBatchSize(std::size_t bytesPerItem, int maxBatch,
+                     double fractionOfAvailable = 0.25);
+
+    /**
+     * Peak resident set size of this process so far, in bytes: VmHWM on
+     * Linux, ru_maxrss on macOS, peak working set on Windows. 0 if it
+     * cannot be determined.
+     */
+    std::int64_t getPeakResidentBytes();
+}
@@ -3,6 +3,9 @@
 #include "../JuceHeader.h"
 #include "../Models/Note.h"
 #include "../Models/Project.h"
+#include "UndoStorage.h"
+#include <algorithm>
+#include <deque>
 #include <vector>
 #include <memory>
 #include <functional>
@@ -18,6 +21,13 @@ public:
     virtual void undo() = 0;
     virtual void redo() = 0;
     virtual juce::String getName() const = 0;
+
+    /** Approximate bytes held by this action, the object included. */
+    virtual size_t getMemoryUsage() const = 0;
+
+    /** Called once the action is no longer among the most recent; bulky
+     *  payloads can be compressed here. */
+    virtual void compact() {}
 };
 
 /**
@@ -32,6 +42,7 @@ public:
     void undo() override { if (note) note->setPitchOffset(oldOffset); }
     void redo() override { if (note) note->setPitchOffset(newOffset); }
     juce::String getName() const override { return "Change Pitch Offset"; }
+    size_t getMemoryUsage() const override { return sizeof(*this); }
     
 private:
     Note* note;
@@ -42,17 +53,6 @@ private:
 /**
  * Action for changing multiple F0 values (hand-drawing).
  */
-struct F0FrameEdit
-{
-    int idx = -1;
-    float oldF0 = 0.0f;
-    float newF0 = 0.0f;
-    float oldDelta = 0.0f;
-    float newDelta = 0.0f;
-    bool oldVoiced = false;
-    bool newVoiced = false;
-};
-
 class F0EditAction : public UndoableAction
 {
 public:
@@ -61,57 +61,29 @@ public:
                  std::vector<bool>* voicedMask,
                  std::vector<F0FrameEdit> edits,
                  std::function<void(int, int)> onF0Changed = nullptr)
-        : f0Array(f0Array), deltaPitchArray(deltaPitchArray), voicedMask(voicedMask), edits(std::move(edits)), onF0Changed(onF0Changed) {}
+        : f0Array(f0Array), deltaPitchArray(deltaPitchArray), voicedMask(voicedMask), edits(edits), onF0Changed(onF0Changed) {}
 
-    void undo() override
-    {
-        if (!f0Array) return;
-        int minIdx = std::numeric_limits<int>::max();
-        int maxIdx = std::numeric_limits<int>::min();
-        for (const auto& e : edits)
-        {
-            if (e.idx >= 0 && e.idx < static_cast<int>(f0Array->size())) {
-                (*f0Array)[e.idx] = e.oldF0;
-                minIdx = std::min(minIdx, e.idx);
-                maxIdx = std::max(maxIdx, e.idx);
-            }
-            if (deltaPitchArray && e.idx >= 0 && e.idx < static_cast<int>(deltaPitchArray->size()))
-                (*deltaPitchArray)[e.idx] = e.oldDelta;
-            if (voicedMask && e.idx >= 0 && e.idx < static_cast<int>(voicedMask->size()))
-                (*voicedMask)[e.idx] = e.oldVoiced;
-        }
-        if (onF0Changed && minIdx <= maxIdx)
-            onF0Changed(minIdx, maxIdx);
-    }
+    void undo() override { apply(false); }
+    void redo() override { apply(true); }
 
-    void redo() override
+    juce::String getName() const override { return "Edit Pitch Curve"; }
+    size_t getMemoryUsage() const override { return sizeof(*this) + edits.getMemoryUsage(); }
+
+private:
+    void apply(bool useNew)
     {
         if (!f0Array) return;
         int minIdx = std::numeric_limits<int>::max();
         int maxIdx = std::numeric_limits<int>::min();
-        for (const auto& e : edits)
-        {
-            if (e.idx >= 0 && e.idx < static_cast<int>(f0Array->size())) {
-                (*f0Array)[e.idx] = e.newF0;
-                minIdx = std::min(minIdx, e.idx);
-                maxIdx = std::max(maxIdx, e.idx);
-            }
-            if (deltaPitchArray && e.idx >= 0 && e.idx < static_cast<int>(deltaPitchArray->size()))
-                (*deltaPitchArray)[e.idx] = e.newDelta;
-            if (voicedMask && e.idx >= 0 && e.idx < static_cast<int>(voicedMask->size()))
-                (*voicedMask)[e.idx] = e.newVoiced;
-        }
+        edits.apply(useNew, f0Array, deltaPitchArray, voicedMask, minIdx, maxIdx);
         if (onF0Changed && minIdx <= maxIdx)
             onF0Changed(minIdx, maxIdx);
     }
 
-    juce::String getName() const override { return "Edit Pitch Curve"; }
-
-private:
     std::vector<float>* f0Array;
     std::vector<float>* deltaPitchArray;
     std::vector<bool>* voicedMask;
-    std::vector<F0FrameEdit> edits;
+    F0EditRuns edits;
     std::function<void(int, int)> onF0Changed;  // Callback with (minFrame, maxFrame) to trigger resynthesis
 };
 
@@ -126,7 +98,7 @@ public:
                         std::vector<F0FrameEdit> f0Edits,
                         std::function<void(Note*)> onNoteChanged = nullptr)
         : note(note), f0Array(f0Array), oldMidi(oldMidi), newMidi(newMidi),
-          f0Edits(std::move(f0Edits)), onNoteChanged(onNoteChanged) {}
+          f0Edits(f0Edits), onNoteChanged(onNoteChanged) {}
 
     void undo() override
     {
@@ -134,12 +106,7 @@ public:
             note->setMidiNote(oldMidi);
             note->markDirty();
         }
-        if (f0Array) {
-            for (const auto& e : f0Edits) {
-                if (e.idx >= 0 && e.idx < static_cast<int>(f0Array->size()))
-                    (*f0Array)[e.idx] = e.oldF0;
-            }
-        }
+        applyF0(false);
         // Notify that note changed, so base pitch can be recalculated
         if (onNoteChanged && note) {
             onNoteChanged(note);
@@ -152,12 +119,7 @@ public:
             note->setMidiNote(newMidi);
             note->markDirty();
         }
-        if (f0Array) {
-            for (const auto& e : f0Edits) {
-                if (e.idx >= 0 && e.idx < static_cast<int>(f0Array->size()))
-                    (*f0Array)[e.idx] = e.newF0;
-            }
-        }
+        applyF0(true);
         // Notify that note changed, so base pitch can be recalculated
         if (onNoteChanged && note) {
             onNoteChanged(note);
@@ -165,13 +127,21 @@ public:
     }
 
     juce::String getName() const override { return "Drag Note Pitch"; }
+    size_t getMemoryUsage() const override { return sizeof(*this) + f0Edits.getMemoryUsage(); }
 
 private:
+    void applyF0(bool useNew)
+    {
+        int minIdx = std::numeric_limits<int>::max();
+        int maxIdx = std::numeric_limits<int>::min();
+        f0Edits.apply(useNew, f0Array, nullptr, nullptr, minIdx, maxIdx);
+    }
+
     Note* note;
     std::vector<float>* f0Array;
     float oldMidi;
     float newMidi;
-    std::vector<F0FrameEdit> f0Edits;
+    F0EditRuns f0Edits;
     std::function<void(Note*)> onNoteChanged;  // Callback when note MIDI changes
 };
 
@@ -186,7 +156,7 @@ public:
                              std::vector<F0FrameEdit> f0Edits,
                              std::function<void(const std::vector<Note*>&)> onNotesChanged = nullptr)
         : notes(std::move(notes)), f0Array(f0Array), oldMidis(std::move(oldMidis)),
-          pitchDelta(pitchDelta), f0Edits(std::move(f0Edits)), onNotesChanged(onNotesChanged) {}
+          pitchDelta(pitchDelta), f0Edits(f0Edits), onNotesChanged(onNotesChanged) {}
 
     void undo() override
     {
@@ -196,12 +166,7 @@ public:
                 notes[i]->markDirty();
             }
         }
-        if (f0Array) {
-            for (const auto& e : f0Edits) {
-                if (e.idx >= 0 && e.idx < static_cast<int>(f0Array->size()))
-                    (*f0Array)[e.idx] = e.oldF0;
-            }
-        }
+        applyF0(false);
         if (onNotesChanged)
             onNotesChanged(notes);
     }
@@ -214,24 +179,31 @@ public:
                 notes[i]->markDirty();
             }
         }
-        if (f0Array) {
-            for (const auto& e : f0Edits) {
-                if (e.idx >= 0 && e.idx < static_cast<int>(f0Array->size()))
-                    (*f0Array)[e.idx] = e.newF0;
-            }
-        }
+        applyF0(true);
         if (onNotesChanged)
             onNotesChanged(notes);
     }
 
     juce::String getName() const override { return "Drag Multiple Notes"; }
+    size_t getMemoryUsage() const override
+    {
+        return sizeof(*this) + vectorMemoryUsage(notes) + vectorMemoryUsage(oldMidis)
+               + f0Edits.getMemoryUsage();
+    }
 
 private:
+    void applyF0(bool useNew)
+    {
+        int minIdx = std::numeric_limits<int>::max();
+        int maxIdx = std::numeric_limits<int>::min();
+        f0Edits.apply(useNew, f0Array, nullptr, nullptr, minIdx, maxIdx);
+    }
+
     std::vector<Note*> notes;
     std::vector<float>* f0Array;
     std::vector<float> oldMidis;
     float pitchDelta;
-    std::vector<F0FrameEdit> f0Edits;
+    F0EditRuns f0Edits;
     std::function<void(const std::vector<Note*>&)> onNotesChanged;
 };
 
@@ -272,6 +244,7 @@ public:
     }
 
     juce::String getName() const override { return "Snap to Semitone"; }
+    size_t getMemoryUsage() const override { return sizeof(*this); }
 
 private:
     Note* note;
@@ -327,6 +300,11 @@ public:
     }
 
     juce::String getName() const override { return "Snap Notes to Semitone"; }
+    size_t getMemoryUsage() const override
+    {
+        return sizeof(*this) + vectorMemoryUsage(notes) + vectorMemoryUsage(oldMidis)
+               + vectorMemoryUsage(oldOffsets) + vectorMemoryUsage(newMidis);
+    }
 
 private:
     std::vector<Note*> notes;
@@ -351,14 +329,15 @@ public:
     {
         if (!project) return;
         // Remove the second note and restore original
-        project->removeNoteByStartFrame(secondNote.getStartFrame());
+        project->removeNoteByStartFrame(secondNote.note.getStartFrame());
         // Find and restore the first note to original state
         for (auto& note : project->getNotes()) {
-            if (note.getStartFrame() == firstNote.getStartFrame()) {
-                note = originalNote;
+            if (note.getStartFrame() == firstNote.note.getStartFrame()) {
+                note = originalNote.load();
                 break;
             }
         }
+        project->notifyNoteLayoutChanged();
         if (onChanged) onChanged();
     }
 
@@ -367,22 +346,67 @@ public:
         if (!project) return;
         // Split again: modify first note and add second
         for (auto& note : project->getNotes()) {
-            if (note.getStartFrame() == originalNote.getStartFrame()) {
-                note = firstNote;
+            if (note.getStartFrame() == originalNote.note.getStartFrame()) {
+                note = firstNote.load();
                 break;
             }
         }
-        project->addNote(secondNote);
+        project->addNote(secondNote.load());
         if (onChanged) onChanged();
     }
 
     juce::String getName() const override { return "Split Note"; }
+    size_t getMemoryUsage() const override
+    {
+        return sizeof(*this) + originalNote.getMemoryUsage() + firstNote.getMemoryUsage()
+               + secondNote.getMemoryUsage();
+    }
+    void compact() override
+    {
+        for (auto* stored : {&originalNote, &firstNote, &secondNote})
+            stored->compress();
+    }
 
 private:
+    /** A note with its audio and mel clips held as packed payloads. */
+    struct StoredNote
+    {
+        StoredNote(const Note& source)
+            : note(source), clip(source.getClipWaveform()), mel(source.getClipMel())
+        {
+            note.setClipWaveform({});
+            note.setClipMel({});
+        }
+
+        Note load() const
+        {
+            Note result = note;
+            result.setClipWaveform(clip.load());
+            result.setClipMel(mel.load());
+            return result;
+        }
+
+        void compress()
+        {
+            clip.compress();
+            mel.compress();
+        }
+
+        size_t getMemoryUsage() const
+        {
+            return vectorMemoryUsage(note.getDeltaPitch()) + vectorMemoryUsage(note.getF0Values())
+                   + clip.getMemoryUsage() + mel.getMemoryUsage();
+        }
+
+        Note note;  // Clips cleared
+        PackedFloats clip;
+        PackedMel mel;
+    };
+
     Project* project;
-    Note originalNote;
-    Note firstNote;
-    Note secondNote;
+    StoredNote originalNote;
+    StoredNote firstNote;
+    StoredNote secondNote;
     std::function<void()> onChanged;
 };
 
@@ -392,11 +416,12 @@ private:
 class NoteTimingStretchAction : public UndoableAction
 {
 public:
-    NoteTimingStretchAction(Note* leftNote,
+    NoteTimingStretchAction(Project* proj,
+                            Note* leftNote,
                             Note* rightNote,
                             std::vector<float>* deltaPitchArray,
                             std::vector<bool>* voicedMaskArray,
-                            std::vector<std::vector<float>>* melSpectrogram,
+                            MelMatrix* melSpectrogram,
                             int rangeStart,
                             int rangeEnd,
                             int oldLeftStart, int oldLeftEnd,
@@ -411,10 +436,10 @@ public:
                             std::vector<float> newDelta,
                             std::vector<bool> oldVoiced,
                             std::vector<bool> newVoiced,
-                            std::vector<std::vector<float>> oldMel,
-                            std::vector<std::vector<float>> newMel,
+                            MelMatrix oldMel,
+                            MelMatrix newMel,
                             std::function<void(int, int)> onRangeChanged = nullptr)
-        : left(leftNote), right(rightNote),
+        : project(proj), left(leftNote), right(rightNote),
           deltaPitchArray(deltaPitchArray), voicedMaskArray(voicedMaskArray),
           melSpectrogram(melSpectrogram),
           rangeStart(rangeStart), rangeEnd(rangeEnd),
@@ -444,35 +469,57 @@ public:
     }
 
     juce::String getName() const override { return "Stretch Note Timing"; }
+    size_t getMemoryUsage() const override { return sizeof(*this) + getPayloadMemoryUsage(); }
+    void compact() override { compactPayload(); }
 
 private:
+    size_t getPayloadMemoryUsage() const
+    {
+        return oldLeftClip.getMemoryUsage() + newLeftClip.getMemoryUsage()
+               + oldRightClip.getMemoryUsage() + newRightClip.getMemoryUsage()
+               + oldDelta.getMemoryUsage() + newDelta.getMemoryUsage()
+               + vectorMemoryUsage(oldVoiced) + vectorMemoryUsage(newVoiced)
+               + oldMel.getMemoryUsage() + newMel.getMemoryUsage();
+    }
+
+    void compactPayload()
+    {
+        for (auto* payload : {&oldLeftClip, &newLeftClip, &oldRightClip,
+                              &newRightClip, &oldDelta, &newDelta})
+            payload->compress();
+        oldMel.compress();
+        newMel.compress();
+    }
+
     void applyState(int leftStart, int leftEnd,
                     int rightStart, int rightEnd,
-                    const std::vector<float>& leftClip,
-                    const std::vector<float>& rightClip,
-                    const std::vector<float>& delta,
+                    const PackedFloats& leftClip,
+                    const PackedFloats& rightClip,
+                    const PackedFloats& delta,
                     const std::vector<bool>& voiced,
-                    const std::vector<std::vector<float>>& mel)
+                    const PackedMel& mel)
     {
         if (left) {
             left->setStartFrame(leftStart);
             left->setEndFrame(leftEnd);
             left->markDirty();
-            left->setClipWaveform(leftClip);
+            left->setClipWaveform(leftClip.load());
         }
         if (right) {
             right->setStartFrame(rightStart);
             right->setEndFrame(rightEnd);
             right->markDirty();
-            right->setClipWaveform(rightClip);
+            right->setClipWaveform(rightClip.load());
         }
+        if (project)
+            project->notifyNoteLayoutChanged();
 
         if (deltaPitchArray && rangeEnd > rangeStart &&
             delta.size() == static_cast<size_t>(rangeEnd - rangeStart)) {
             if (deltaPitchArray->size() >= static_cast<size_t>(rangeEnd)) {
-                for (int i = rangeStart; i < rangeEnd; ++i)
-                    (*deltaPitchArray)[static_cast<size_t>(i)] =
-                        delta[static_cast<size_t>(i - rangeStart)];
+                const auto values = delta.load();
+                std::copy(values.begin(), values.end(),
+                          deltaPitchArray->begin() + rangeStart);
             }
         }
 
@@ -487,22 +534,20 @@ private:
 
         if (melSpectrogram && rangeEnd > rangeStart &&
             mel.size() == static_cast<size_t>(rangeEnd - rangeStart)) {
-            if (melSpectrogram->size() >= static_cast<size_t>(rangeEnd)) {
-                for (int i = rangeStart; i < rangeEnd; ++i)
-                    (*melSpectrogram)[static_cast<size_t>(i)] =
-                        mel[static_cast<size_t>(i - rangeStart)];
-            }
+            if (melSpectrogram->size() >= static_cast<size_t>(rangeEnd))
+                melSpectrogram->copyFrames(rangeStart, mel.load());
         }
 
         if (onRangeChanged && rangeEnd > rangeStart)
             onRangeChanged(rangeStart, rangeEnd);
     }
 
+    Project* project = nullptr;
     Note* left = nullptr;
     Note* right = nullptr;
     std::vector<float>* deltaPitchArray = nullptr;
     std::vector<bool>* voicedMaskArray = nullptr;
-    std::vector<std::vector<float>>* melSpectrogram = nullptr;
+    MelMatrix* melSpectrogram = nullptr;
     int rangeStart = 0;
     int rangeEnd = 0;
     int oldLeftStart = 0;
@@ -513,16 +558,16 @@ private:
     int newLeftEnd = 0;
     int newRightStart = 0;
     int newRightEnd = 0;
-    std::vector<float> oldLeftClip;
-    std::vector<float> newLeftClip;
-    std::vector<float> oldRightClip;
-    std::vector<float> newRightClip;
-    std::vector<float> oldDelta;
-    std::vector<float> newDelta;
+    PackedFloats oldLeftClip;
+    PackedFloats newLeftClip;
+    PackedFloats oldRightClip;
+    PackedFloats newRightClip;
+    PackedFloats oldDelta;
+    PackedFloats newDelta;
     std::vector<bool> oldVoiced;
     std::vector<bool> newVoiced;
-    std::vector<std::vector<float>> oldMel;
-    std::vector<std::vector<float>> newMel;
+    PackedMel oldMel;
+    PackedMel newMel;
     std::function<void(int, int)> onRangeChanged;
 };
 
@@ -532,12 +577,13 @@ private:
 class NoteTimingRippleAction : public UndoableAction
 {
 public:
-    NoteTimingRippleAction(Note* leftNote,
+    NoteTimingRippleAction(Project* proj,
+                           Note* leftNote,
                            Note* rightNote,
                            std::vector<Note*> rippleNotes,
                            std::vector<float>* deltaPitchArray,
                            std::vector<bool>* voicedMaskArray,
-                           std::vector<std::vector<float>>* melSpectrogram,
+                           MelMatrix* melSpectrogram,
                            int rangeStart,
                            int rangeEnd,
                            int oldLeftStart, int oldLeftEnd,
@@ -554,10 +600,10 @@ public:
                            std::vector<float> newDelta,
                            std::vector<bool> oldVoiced,
                            std::vector<bool> newVoiced,
-                           std::vector<std::vector<float>> oldMel,
-                           std::vector<std::vector<float>> newMel,
+                           MelMatrix oldMel,
+                           MelMatrix newMel,
                            std::function<void(int, int)> onRangeChanged = nullptr)
-        : left(leftNote), right(rightNote), rippleNotes(std::move(rippleNotes)),
+        : project(proj), left(leftNote), right(rightNote), rippleNotes(std::move(rippleNotes)),
           deltaPitchArray(deltaPitchArray), voicedMaskArray(voicedMaskArray),
           melSpectrogram(melSpectrogram),
           rangeStart(rangeStart), rangeEnd(rangeEnd),
@@ -586,25 +632,51 @@ public:
     }
 
     juce::String getName() const override { return "Ripple Stretch Timing"; }
+    size_t getMemoryUsage() const override
+    {
+        return sizeof(*this) + vectorMemoryUsage(rippleNotes)
+               + vectorMemoryUsage(oldNoteStarts) + vectorMemoryUsage(oldNoteEnds)
+               + vectorMemoryUsage(newNoteStarts) + vectorMemoryUsage(newNoteEnds)
+               + getPayloadMemoryUsage();
+    }
+    void compact() override { compactPayload(); }
 
 private:
+    size_t getPayloadMemoryUsage() const
+    {
+        return oldLeftClip.getMemoryUsage() + newLeftClip.getMemoryUsage()
+               + oldRightClip.getMemoryUsage() + newRightClip.getMemoryUsage()
+               + oldDelta.getMemoryUsage() + newDelta.getMemoryUsage()
+               + vectorMemoryUsage(oldVoiced) + vectorMemoryUsage(newVoiced)
+               + oldMel.getMemoryUsage() + newMel.getMemoryUsage();
+    }
+
+    void compactPayload()
+    {
+        for (auto* payload : {&oldLeftClip, &newLeftClip, &oldRightClip,
+                              &newRightClip, &oldDelta, &newDelta})
+            payload->compress();
+        oldMel.compress();
+        newMel.compress();
+    }
+
     void applyState(int leftStart, int leftEnd,
                     const std::vector<int>& noteStarts,
                     const std::vector<int>& noteEnds,
-                    const std::vector<float>& leftClip,
-                    const std::vector<float>& rightClip,
-                    const std::vector<float>& delta,
+                    const PackedFloats& leftClip,
+                    const PackedFloats& rightClip,
+                    const PackedFloats& delta,
                     const std::vector<bool>& voiced,
-                    const std::vector<std::vector<float>>& mel)
+                    const PackedMel& mel)
     {
         if (left) {
             left->setStartFrame(leftStart);
             left->setEndFrame(leftEnd);
             left->markDirty();
-            left->setClipWaveform(leftClip);
+            left->setClipWaveform(leftClip.load());
         }
         if (right)
-            right->setClipWaveform(rightClip);
+            right->setClipWaveform(rightClip.load());
 
         for (size_t i = 0; i < rippleNotes.size() && i < noteStarts.size() && i < noteEnds.size(); ++i) {
             if (rippleNotes[i]) {
@@ -613,13 +685,15 @@ private:
                 rippleNotes[i]->markDirty();
             }
         }
+        if (project)
+            project->notifyNoteLayoutChanged();
 
         if (deltaPitchArray && rangeEnd > rangeStart &&
             delta.size() == static_cast<size_t>(rangeEnd - rangeStart)) {
             if (deltaPitchArray->size() >= static_cast<size_t>(rangeEnd)) {
-                for (int i = rangeStart; i < rangeEnd; ++i)
-                    (*deltaPitchArray)[static_cast<size_t>(i)] =
-                        delta[static_cast<size_t>(i - rangeStart)];
+                const auto values = delta.load();
+                std::copy(values.begin(), values.end(),
+                          deltaPitchArray->begin() + rangeStart);
             }
         }
 
@@ -634,23 +708,21 @@ private:
 
         if (melSpectrogram && rangeEnd > rangeStart &&
             mel.size() == static_cast<size_t>(rangeEnd - rangeStart)) {
-            if (melSpectrogram->size() >= static_cast<size_t>(rangeEnd)) {
-                for (int i = rangeStart; i < rangeEnd; ++i)
-                    (*melSpectrogram)[static_cast<size_t>(i)] =
-                        mel[static_cast<size_t>(i - rangeStart)];
-            }
+            if (melSpectrogram->size() >= static_cast<size_t>(rangeEnd))
+                melSpectrogram->copyFrames(rangeStart, mel.load());
         }
 
         if (onRangeChanged && rangeEnd > rangeStart)
             onRangeChanged(rangeStart, rangeEnd);
     }
 
+    Project* project = nullptr;
     Note* left = nullptr;
     Note* right = nullptr;
     std::vector<Note*> rippleNotes;
     std::vector<float>* deltaPitchArray = nullptr;
     std::vector<bool>* voicedMaskArray = nullptr;
-    std::vector<std::vector<float>>* melSpectrogram = nullptr;
+    MelMatrix* melSpectrogram = nullptr;
     int rangeStart = 0;
     int rangeEnd = 0;
     int oldLeftStart = 0;
@@ -661,26 +733,34 @@ private:
     std::vector<int> oldNoteEnds;
     std::vector<int> newNoteStarts;
     std::vector<int> newNoteEnds;
-    std::vector<float> oldLeftClip;
-    std::vector<float> newLeftClip;
-    std::vector<float> oldRightClip;
-    std::vector<float> newRightClip;
-    std::vector<float> oldDelta;
-    std::vector<float> newDelta;
+    PackedFloats oldLeftClip;
+    PackedFloats newLeftClip;
+    PackedFloats oldRightClip;
+    PackedFloats newRightClip;
+    PackedFloats oldDelta;
+    PackedFloats newDelta;
     std::vector<bool> oldVoiced;
     std::vector<bool> newVoiced;
-    std::vector<std::vector<float>> oldMel;
-    std::vector<std::vector<float>> newMel;
+    PackedMel oldMel;
+    PackedMel newMel;
     std::function<void(int, int)> onRangeChanged;
 };
 
 /**
- * Simple undo manager for the pitch editor.
+ * Undo manager for the pitch editor.
+ *
+ * History is bounded by the memory its actions hold rather than by their
+ * count: once the total passes the budget the oldest undo steps are dropped.
+ * Actions older than the few most recent are compacted, so their bulky
+ * payloads (mel ranges, clip samples) sit compressed until they are applied.
  */
 class PitchUndoManager
 {
 public:
-    PitchUndoManager(size_t maxHistory = 100) : maxHistory(maxHistory) {}
+    static constexpr size_t defaultMaxBytes = 256 * 1024 * 1024;
+    static constexpr size_t numHotActions = 4;
+
+    explicit PitchUndoManager(size_t maxBytes = defaultMaxBytes) : maxBytes(maxBytes) {}
     
     void addAction(std::unique_ptr<UndoableAction> action)
     {
@@ -689,12 +769,8 @@ public:
         redoStack.shrink_to_fit();  // Release memory
 
         undoStack.push_back(std::move(action));
-
-        // Limit history size
-        while (undoStack.size() > maxHistory)
-        {
-            undoStack.erase(undoStack.begin());
-        }
+        compactColdActions();
+        trimToBudget();
 
         if (onHistoryChanged)
             onHistoryChanged();
@@ -712,6 +788,7 @@ public:
         
         action->undo();
         redoStack.push_back(std::move(action));
+        compactColdActions();
         
         if (onHistoryChanged)
             onHistoryChanged();
@@ -726,6 +803,7 @@ public:
         
         action->redo();
         undoStack.push_back(std::move(action));
+        compactColdActions();
         
         if (onHistoryChanged)
             onHistoryChanged();
@@ -751,11 +829,47 @@ public:
     {
         return redoStack.empty() ? "" : redoStack.back()->getName();
     }
+
+    /** Bytes held by the undo and redo history. */
+    size_t getMemoryUsage() const { return getMemoryUsage(undoStack) + getMemoryUsage(redoStack); }
+    size_t getMaxBytes() const { return maxBytes; }
+    void setMaxBytes(size_t bytes) { maxBytes = bytes; trimToBudget(); }
     
     std::function<void()> onHistoryChanged;
     
 private:
-    std::vector<std::unique_ptr<UndoableAction>> undoStack;
-    std::vector<std::unique_ptr<UndoableAction>> redoStack;
-    size_t maxHistory;
+    using ActionStack = std::deque<std::unique_ptr<UndoableAction>>;
+
+    static size_t getMemoryUsage(const ActionStack& stack)
+    {
+        size_t total = 0;
+        for (const auto& action : stack)
+            total += action->getMemoryUsage();
+        return total;
+    }
+
+    // The few steps either side of the cursor stay uncompressed, so stepping
+    // back and forth through recent edits does not pay for inflating
+    void compactColdActions()
+    {
+        if (undoStack.size() > numHotActions)
+            undoStack[undoStack.size() - 1 - numHotActions]->compact();
+        if (redoStack.size() > numHotActions)
+            redoStack[redoStack.size() - 1 - numHotActions]->compact();
+    }
+
+    // The most recent undo step is always kept, however large
+    void trimToBudget()
+    {
+        size_t total = getMemoryUsage();
+        while (total > maxBytes && undoStack.size() > 1)
+        {
+            total -= undoStack.front()->getMemoryUsage();
+            undoStack.pop_front();
+        }
+    }
+
+    ActionStack undoStack;
+    ActionStack redoStack;
+    size_t maxBytes;
 };
@@ -0,0 +1,205 @@
+#include "UndoStorage.h"
+#include <cstring>
+
+F0EditRuns::F0EditRuns(const std::vector<F0FrameEdit>& edits)
+{
+    size_t i = 0;
+    while (i < edits.size())
+    {
+        // A run ends at the first frame that does not follow its predecessor
+        size_t end = i + 1;
+        while (end < edits.size() && edits[end].idx == edits[end - 1].idx + 1)
+            ++end;
+
+        Run run;
+        run.start = edits[i].idx;
+        run.length = static_cast<int>(end - i);
+        for (size_t k = i; k < end; ++k)
+        {
+            const auto& e = edits[k];
+            if (e.oldF0 != e.newF0)
+                run.channels |= channelF0;
+            if (e.oldDelta != e.newDelta)
+                run.channels |= channelDelta;
+            if (e.oldVoiced != e.newVoiced)
+                run.channels |= channelVoiced;
+        }
+
+        run.f0Offset = oldF0.size();
+        run.deltaOffset = oldDelta.size();
+        run.voicedOffset = oldVoiced.size();
+        for (size_t k = i; k < end; ++k)
+        {
+            const auto& e = edits[k];
+            if (run.channels & channelF0)
+            {
+                oldF0.push_back(e.oldF0);
+                newF0.push_back(e.newF0);
+            }
+            if (run.channels & channelDelta)
+            {
+                oldDelta.push_back(e.oldDelta);
+                newDelta.push_back(e.newDelta);
+            }
+            if (run.channels & channelVoiced)
+            {
+                oldVoiced.push_back(e.oldVoiced);
+                newVoiced.push_back(e.newVoiced);
+            }
+        }
+
+        // Runs with nothing to write are kept for the range they report
+        runs.push_back(run);
+        i = end;
+    }
+
+    runs.shrink_to_fit();
+    oldF0.shrink_to_fit();
+    newF0.shrink_to_fit();
+    oldDelta.shrink_to_fit();
+    newDelta.shrink_to_fit();
+    oldVoiced.shrink_to_fit();
+    newVoiced.shrink_to_fit();
+}
+
+void F0EditRuns::apply(bool useNew, std::vector<float>* f0, std::vector<float>* delta,
+                       std::vector<bool>* voiced, int& minIdx, int& maxIdx) const
+{
+    const auto& f0Values = useNew ? newF0 : oldF0;
+    const auto& deltaValues = useNew ? newDelta : oldDelta;
+    const auto& voicedValues = useNew ? newVoiced : oldVoiced;
+
+    for (const auto& run : runs)
+    {
+        for (int k = 0; k < run.length; ++k)
+        {
+            const int idx = run.start + k;
+            if (idx < 0)
+                continue;
+            const auto frame = static_cast<size_t>(idx);
+            const auto offset = static_cast<size_t>(k);
+
+            if (f0 && frame < f0->size())
+            {
+                if (run.channels & channelF0)
+                    (*f0)[frame] = f0Values[run.f0Offset + offset];
+                minIdx = std::min(minIdx, idx);
+                maxIdx = std::max(maxIdx, idx);
+            }
+            if (delta && (run.channels & channelDelta) && frame < delta->size())
+                (*delta)[frame] = deltaValues[run.deltaOffset + offset];
+            if (voiced && (run.channels & channelVoiced) && frame < voiced->size())
+                (*voiced)[frame] = voicedValues[run.voicedOffset + offset];
+        }
+    }
+}
+
+size_t F0EditRuns::getMemoryUsage() const
+{
+    return sizeof(*this) + vectorMemoryUsage(runs)
+           + vectorMemoryUsage(oldF0) + vectorMemoryUsage(newF0)
+           + vectorMemoryUsage(oldDelta) + vectorMemoryUsage(newDelta)
+           + vectorMemoryUsage(oldVoiced) + vectorMemoryUsage(newVoiced);
+}
+
+PackedFloats::PackedFloats(std::vector<float> valuesIn)
+    : values(std::move(valuesIn)), count(values.size())
+{
+}
+
+std::vector<float> PackedFloats::load() const
+{
+    if (!isCompressed())
+        return values;
+
+    const size_t numBytes = count * sizeof(float);
+    std::vector<std::uint8_t> planes(numBytes);
+    {
+        juce::MemoryInputStream source(compressed, false);
+        juce::GZIPDecompressorInputStream gzip(source);
+        size_t filled = 0;
+        while (filled < numBytes)
+        {
+            const int toRead = static_cast<int>(std::min<size_t>(numBytes - filled, 1 << 24));
+            const int got = gzip.read(planes.data() + filled, toRead);
+            if (got <= 0)
+                break;
+            filled += static_cast<size_t>(got);
+        }
+        jassert(filled == numBytes);
+    }
+
+    std::vector<float> result(count);
+    auto* bytes = reinterpret_cast<std::uint8_t*>(result.data());
+    for (size_t b = 0; b < sizeof(float); ++b)
+    {
+        const auto* plane = planes.data() + b * count;
+        for (size_t i = 0; i < count; ++i)
+            bytes[i * sizeof(float) + b] = plane[i];
+    }
+    return result;
+}
+
+void PackedFloats::compress()
+{
+    if (isCompressed() || count == 0)
+        return;
+
+    const size_t numBytes = count * sizeof(float);
+    std::vector<std::uint8_t> planes(numBytes);
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(values.data());
+    for (size_t b = 0; b < sizeof(float); ++b)
+    {
+        auto* plane = planes.data() + b * count;
+        for (size_t i = 0; i < count; ++i)
+            plane[i] = bytes[i * sizeof(float) + b];
+    }
+
+    juce::MemoryBlock packed;
+    {
+        juce::MemoryOutputStream out(packed, false);
+        {
+            juce::GZIPCompressorOutputStream gzip(out, 1);
+            gzip.write(planes.data(), numBytes);
+            gzip.flush();
+        }
+        packed.setSize(out.getDataSize());
+    }
+
+    // Incompressible data stays as it is
+    if (packed.getSize() >= numBytes)
+        return;
+
+    compressed = std::move(packed);
+    values.clear();
+    values.shrink_to_fit();
+}
+
+size_t PackedFloats::getMemoryUsage() const
+{
+    return sizeof(*this) + vectorMemoryUsage(values) + compressed.getSize();
+}
+
+PackedMel::PackedMel(const MelMatrix& mel)
+    : frames(mel.getNumFrames()), mels(mel.getNumMels()),
+      values(std::vector<float>(mel.data(), mel.data() + mel.size() * static_cast<size_t>(mel.getNumMels())))
+{
+}
+
+MelMatrix PackedMel::load() const
+{
+    MelMatrix mel(frames, mels);
+    const auto flat = values.load();
+    const size_t expected = mel.size() * static_cast<size_t>(mels);
+    if (flat.size() != expected)
+    {
+        // Only a bug can get here; an all-zero mel would synthesize silence
+        DBG("PackedMel: stored " << static_cast<juce::int64>(flat.size())
+            << " values, expected " << static_cast<juce::int64>(expected));
+        jassertfalse;
+        return mel;
+    }
+    if (!flat.empty())
+        std::memcpy(mel.data(), flat.data(), flat.size() * sizeof(float));
+    return mel;
+}
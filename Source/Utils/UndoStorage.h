@@ -0,0 +1,131 @@
+#pragma once
+
+#include "../JuceHeader.h"
+#include "MelMatrix.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Compact storage for undo history payloads.
+ */
+
+/** One frame of a pitch curve edit, as captured by the editors. */
+struct F0FrameEdit
+{
+    int idx = -1;
+    float oldF0 = 0.0f;
+    float newF0 = 0.0f;
+    float oldDelta = 0.0f;
+    float newDelta = 0.0f;
+    bool oldVoiced = false;
+    bool newVoiced = false;
+};
+
+template <typename T>
+size_t vectorMemoryUsage(const std::vector<T>& values)
+{
+    return values.capacity() * sizeof(T);
+}
+
+inline size_t vectorMemoryUsage(const std::vector<bool>& values)
+{
+    return (values.capacity() + 7) / 8;
+}
+
+/**
+ * Pitch curve edits packed into runs of consecutive frames.
+ *
+ * Each run keeps only the channels (F0, delta pitch, voicing) that differ
+ * between its old and new side; a channel that did not change holds the
+ * same value before and after the edit, so skipping it on undo or redo
+ * leaves the curve as a full write would. Edits are applied run by run in
+ * their original order.
+ */
+class F0EditRuns
+{
+public:
+    F0EditRuns() = default;
+    explicit F0EditRuns(const std::vector<F0FrameEdit>& edits);
+
+    /**
+     * Write the old (or new) side into whichever arrays are given, skipping
+     * frames outside them. Returns the range of F0 frames written through
+     * minIdx/maxIdx, left untouched if none were.
+     */
+    void apply(bool useNew, std::vector<float>* f0, std::vector<float>* delta,
+               std::vector<bool>* voiced, int& minIdx, int& maxIdx) const;
+
+    bool empty() const { return runs.empty(); }
+    size_t getMemoryUsage() const;
+
+private:
+    enum Channel : std::uint8_t
+    {
+        channelF0 = 1,
+        channelDelta = 2,
+        channelVoiced = 4
+    };
+
+    struct Run
+    {
+        int start = 0;
+        int length = 0;
+        std::uint8_t channels = 0;
+        size_t f0Offset = 0;
+        size_t deltaOffset = 0;
+        size_t voicedOffset = 0;
+    };
+
+    std::vector<Run> runs;
+    std::vector<float> oldF0, newF0;
+    std::vector<float> oldDelta, newDelta;
+    std::vector<bool> oldVoiced, newVoiced;
+};
+
+/**
+ * Float buffer that can be deflated in place once it goes cold.
+ *
+ * The bytes of each float are regrouped by significance before compressing
+ * (all sign/exponent bytes, then the mantissa bytes), which lets deflate find
+ * the repetition that interleaved floats hide. Compression is lossless.
+ */
+class PackedFloats
+{
+public:
+    PackedFloats() = default;
+    PackedFloats(std::vector<float> values);
+
+    /** The values, inflating them if they are compressed. */
+    std::vector<float> load() const;
+
+    /** Compress the values if that saves memory. */
+    void compress();
+
+    size_t size() const { return count; }
+    bool isCompressed() const { return compressed.getSize() > 0; }
+    size_t getMemoryUsage() const;
+
+private:
+    std::vector<float> values;
+    juce::MemoryBlock compressed;
+    size_t count = 0;
+};
+
+/** A MelMatrix held as PackedFloats. */
+class PackedMel
+{
+public:
+    PackedMel() = default;
+    PackedMel(const MelMatrix& mel);
+
+    MelMatrix load() const;
+    void compress() { values.compress(); }
+
+    size_t size() const { return static_cast<size_t>(frames); }
+    size_t getMemoryUsage() const { return values.getMemoryUsage(); }
+
+private:
+    int frames = 0;
+    int mels = 0;
+    PackedFloats values;
+};
@@ -0,0 +1,202 @@
+#include "WaveformPeaks.h"
+#include "ParallelFor.h"
+
+#include <cmath>
+
+WaveformPeaks &WaveformPeaks::operator=(const WaveformPeaks &other) {
+  if (this != &other) {
+    source = nullptr;
+    numSamples = 0;
+    levels.clear();
+    {
+      std::lock_guard<std::mutex> lock(pendingMutex);
+      pendingRanges.clear();
+      hasPending = false;
+    }
+    ++revision;
+  }
+  return *this;
+}
+
+void WaveformPeaks::update(const float *samples, int numSamplesIn) {
+  if (samples == nullptr || numSamplesIn <= 0) {
+    samples = nullptr;
+    numSamplesIn = 0;
+  }
+
+  if (samples != source || numSamplesIn != numSamples) {
+    source = samples;
+    numSamples = numSamplesIn;
+    {
+      std::lock_guard<std::mutex> lock(pendingMutex);
+      pendingRanges.clear();
+      hasPending = false;
+    }
+    rebuild();
+    ++revision;
+    return;
+  }
+
+  if (!hasPending.load())
+    return;
+
+  std::vector<std::pair<int, int>> ranges;
+  {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    ranges.swap(pendingRanges);
+    hasPending = false;
+  }
+  for (const auto &[start, end] : ranges) {
+    const int clampedStart = std::clamp(start, 0, numSamples);
+    const int clampedEnd = std::clamp(end, clampedStart, numSamples);
+    if (clampedEnd > clampedStart)
+      recomputeRange(clampedStart, clampedEnd);
+  }
+  ++revision;
+}
+
+void WaveformPeaks::invalidate(int startSample, int numSamplesChanged) {
+  if (numSamplesChanged <= 0)
+    return;
+  std::lock_guard<std::mutex> lock(pendingMutex);
+  pendingRanges.emplace_back(startSample, startSample + numSamplesChanged);
+  hasPending = true;
+}
+
+WaveformPeaks::Peak WaveformPeaks::query(std::int64_t startSample,
+                                         std::int64_t endSample) const {
+  const int start = static_cast<int>(
+      std::clamp<std::int64_t>(startSample, 0, numSamples));
+  const int end =
+      static_cast<int>(std::clamp<std::int64_t>(endSample, start, numSamples));
+  if (source == nullptr || end <= start)
+    return {};
+
+  Bucket total;
+  bool empty = true;
+  auto add = [&](const Bucket &bucket) {
+    total = empty ? bucket : combine(total, bucket);
+    empty = false;
+  };
+
+  // Whole level-0 buckets [firstFull, endFull); the ragged ends are read
+  // from the samples
+  const int firstFull = (start + baseSize - 1) >> baseShift;
+  const int endFull = end >> baseShift;
+  if (firstFull >= endFull) {
+    add(scanSamples(start, end));
+  } else {
+    if (start < (firstFull << baseShift))
+      add(scanSamples(start, firstFull << baseShift));
+
+    // Climb the pyramid, taking the unpaired bucket at either end of the
+    // range at each level
+    int lo = firstFull;
+    int hi = endFull;
+    for (size_t k = 0; k < levels.size() && lo < hi; ++k) {
+      const auto &level = levels[k];
+      if (lo & 1)
+        add(level[static_cast<size_t>(lo++)]);
+      if (hi & 1)
+        add(level[static_cast<size_t>(--hi)]);
+      lo >>= 1;
+      hi >>= 1;
+    }
+
+    if ((endFull << baseShift) < end)
+      add(scanSamples(endFull << baseShift, end));
+  }
+
+  Peak peak;
+  peak.min = total.min;
+  peak.max = total.max;
+  peak.rms = std::sqrt(total.sumSquares / static_cast<float>(end - start));
+  return peak;
+}
+
+WaveformPeaks::Peak WaveformPeaks::queryTime(double startSeconds,
+                                             double endSeconds,
+                                             double sampleRate) const {
+  const auto start = static_cast<std::int64_t>(startSeconds * sampleRate);
+  const auto end = static_cast<std::int64_t>(endSeconds * sampleRate);
+  return query(std::min<std::int64_t>(start, numSamples - 1),
+               std::max(end, start + 1));
+}
+
+void WaveformPeaks::rebuild() {
+  levels.clear();
+  if (numSamples <= 0)
+    return;
+
+  const int numBuckets = (numSamples + baseSize - 1) >> baseShift;
+  levels.emplace_back(static_cast<size_t>(numBuckets));
+  auto &base = levels.front();
+  ParallelFor::forEachBlock(numBuckets, 4096, 0, [this, &base]() {
+    return [this, &base](int begin, int end) {
+      for (int i = begin; i < end; ++i)
+        base[static_cast<size_t>(i)] = scanSamples(
+            i << baseShift, std::min(numSamples, (i + 1) << baseShift));
+    };
+  });
+
+  while (levels.back().size() > 1) {
+    const auto &below = levels.back();
+    std::vector<Bucket> level((below.size() + 1) / 2);
+    for (size_t i = 0; i < level.size(); ++i)
+      level[i] = 2 * i + 1 < below.size()
+                     ? combine(below[2 * i], below[2 * i + 1])
+                     : below[2 * i];
+    levels.push_back(std::move(level));
+  }
+}
+
+void WaveformPeaks::recomputeRange(int startSample, int endSample) {
+  int first = startSample >> baseShift;
+  int last = (endSample - 1) >> baseShift;
+  auto &base = levels.front();
+  for (int i = first; i <= last; ++i)
+    base[static_cast<size_t>(i)] = scanSamples(
+        i << baseShift, std::min(numSamples, (i + 1) << baseShift));
+
+  for (size_t k = 1; k < levels.size(); ++k) {
+    first >>= 1;
+    last >>= 1;
+    const auto &below = levels[k - 1];
+    auto &level = levels[k];
+    for (int i = first; i <= last; ++i) {
+      const auto child = static_cast<size_t>(2 * i);
+      level[static_cast<size_t>(i)] =
+          child + 1 < below.size() ? combine(below[child], below[child + 1])
+                                   : below[child];
+    }
+  }
+}
+
+WaveformPeaks::Bucket WaveformPeaks::scanSamples(int start, int end) const {
+  Bucket bucket;
+  if (end <= start)
+    return bucket;
+
+  float lo = source[start];
+  float hi = source[start];
+  double sumSquares = 0.0;
+  for (int i = start; i < end; ++i) {
+    const float s = source[i];
+    lo = std::min(lo, s);
+    hi = std::max(hi, s);
+    sumSquares += static_cast<double>(s) * s;
+  }
+  bucket.min = lo;
+  bucket.max = hi;
+  bucket.sumSquares = static_cast<float>(sumSquares);
+  return bucket;
+}
+
+WaveformPeaks::Bucket WaveformPeaks::combine(const Bucket &a,
+                                             const Bucket &b) {
+  Bucket bucket;
+  bucket.min = std::min(a.min, b.min);
+  bucket.max = std::max(a.max, b.max);
+  bucket.sumSquares = a.sumSquares + b.sumSquares;
+  return bucket;
+}
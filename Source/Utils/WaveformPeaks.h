@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * Min/max/RMS peak pyramid over a waveform, for drawing it at any zoom.
+ *
+ * Level 0 summarises blocks of 2^baseShift samples and each level above
+ * halves the one below, so a query for any sample range combines O(log n)
+ * buckets plus at most two partial base blocks read from the samples
+ * themselves. Drawing a view then costs about the same whether a pixel
+ * covers ten samples or ten minutes.
+ *
+ * The pyramid keeps a pointer to the samples it was built from. update()
+ * and query() are not synchronised with each other: they must run on one
+ * thread at a time. The audio loader builds the pyramid on its own thread
+ * before handing the Project to the message thread, which then owns it for
+ * the editor views. invalidate() may be called from anywhere after the
+ * samples were rewritten in place, and the affected buckets are recomputed
+ * by the next update().
+ */
+class WaveformPeaks {
+public:
+  struct Peak {
+    float min = 0.0f;
+    float max = 0.0f;
+    float rms = 0.0f;
+
+    /** Largest absolute sample value. */
+    float getMagnitude() const { return std::max(max, -min); }
+  };
+
+  WaveformPeaks() = default;
+
+  // A copy starts empty and is built from the copy's own samples by its
+  // first update(), so a copied Project never points at the original's
+  // samples (which may be freed or rewritten while the copy is still alive)
+  WaveformPeaks(const WaveformPeaks &) {}
+  WaveformPeaks &operator=(const WaveformPeaks &other);
+
+  /**
+   * Bring the peaks up to date with samples. A different buffer or length
+   * rebuilds everything; otherwise only ranges passed to invalidate() since
+   * the last call are recomputed.
+   */
+  void update(const float *samples, int numSamples);
+
+  /** Samples [startSample, startSample + numSamples) changed in place. */
+  void invalidate(int startSample, int numSamples);
+
+  /** Peaks of samples [startSample, endSample), clamped to the waveform. */
+  Peak query(std::int64_t startSample, std::int64_t endSample) const;
+
+  /** Peaks of [startSeconds, endSeconds); always covers at least one
+   *  sample, so narrow pixel columns at high zoom are not left empty. */
+  Peak queryTime(double startSeconds, double endSeconds,
+                 double sampleRate) const;
+
+  int getNumSamples() const { return numSamples; }
+
+  /** Changes whenever the peaks do, so views can drop cached drawings. */
+  std::uint32_t getRevision() const { return revision; }
+
+private:
+  struct Bucket {
+    float min = 0.0f;
+    float max = 0.0f;
+    float sumSquares = 0.0f;
+  };
+
+  static constexpr int baseShift = 7; // 128 samples per level-0 bucket
+  static constexpr int baseSize = 1 << baseShift;
+
+  void rebuild();
+  void recomputeRange(int startSample, int endSample);
+  Bucket scanSamples(int start, int end) const;
+  static Bucket combine(const Bucket &a, const Bucket &b);
+
+  const float *source = nullptr;
+  int numSamples = 0;
+  std::uint32_t revision = 0;
+
+  // levels[k][i] covers samples [i << (baseShift + k), (i + 1) << ...)
+  std::vector<std::vector<Bucket>> levels;
+
+  std::mutex pendingMutex;
+  std::vector<std::pair<int, int>> pendingRanges; // [start, end)
+  std::atomic<bool> hasPending{false};
+};